@@ -0,0 +1,776 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Micro-benchmarks of the hot paths
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * Every benchmark runs with doubled number of iterations, until it takes at
+ * least MIN_DURATION. The result is written as one JSON object per line to
+ * stdout, which is not used by the server otherwise:
+ *
+ * {"name":"checksum","iterations":65536,"nsPerOp":12.5,"bytesPerOp":0.0,"allocsPerOp":0.0}
+ *
+ * The allocations are counted by wrapping the allocator of the glibc.
+ * The endpoint benchmarks run the complete server in the same process and
+ * send the requests via the loopback interface. They measure only requests,
+ * which are replied without waiting for the heatpump.
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+#include <EthernetClient.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <Temperature.h>
+
+#include "Rego6xxCtrl.h"
+#include "Rego6xxUtil.h"
+#include "HttpRequest.h"
+#include "WebConnection.h"
+#include "WebReqRouter.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Stream, which discards everything written and replays a canned response
+ * after every write, like the heatpump controller does.
+ */
+class ReplayStream : public Stream
+{
+public:
+
+    /**
+     * Constructs a stream without response.
+     */
+    ReplayStream() :
+        Stream(),
+        m_rsp(nullptr),
+        m_rspSize(0U),
+        m_readIdx(0U)
+    {
+    }
+
+    /**
+     * Destroys the stream.
+     */
+    ~ReplayStream()
+    {
+    }
+
+    /**
+     * Set the response, which is replayed after every write.
+     *
+     * @param[in] rsp   Response
+     * @param[in] size  Response size in bytes
+     */
+    void setResponse(const uint8_t* rsp, size_t size)
+    {
+        m_rsp       = rsp;
+        m_rspSize   = size;
+        m_readIdx   = size;
+    }
+
+    int available() override
+    {
+        return static_cast<int>(m_rspSize - m_readIdx);
+    }
+
+    int read() override
+    {
+        int data = -1;
+
+        if (m_rspSize > m_readIdx)
+        {
+            data = m_rsp[m_readIdx];
+            ++m_readIdx;
+        }
+
+        return data;
+    }
+
+    int peek() override
+    {
+        return (m_rspSize > m_readIdx) ? m_rsp[m_readIdx] : -1;
+    }
+
+    size_t write(uint8_t data) override
+    {
+        (void)data;
+        return 1U;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override
+    {
+        (void)buffer;
+        m_readIdx = 0U;
+
+        return size;
+    }
+
+private:
+
+    const uint8_t*  m_rsp;      /**< Canned response */
+    size_t          m_rspSize;  /**< Canned response size in bytes */
+    size_t          m_readIdx;  /**< Read index in the canned response */
+};
+
+/**
+ * Stream, which reads a text from memory.
+ */
+class TextStream : public Stream
+{
+public:
+
+    /**
+     * Constructs the stream.
+     *
+     * @param[in] text  Text, which to read.
+     */
+    TextStream(const char* text) :
+        Stream(),
+        m_text(text),
+        m_size(strlen(text)),
+        m_readIdx(0U)
+    {
+    }
+
+    /**
+     * Destroys the stream.
+     */
+    ~TextStream()
+    {
+    }
+
+    int available() override
+    {
+        return static_cast<int>(m_size - m_readIdx);
+    }
+
+    int read() override
+    {
+        int data = -1;
+
+        if (m_size > m_readIdx)
+        {
+            data = static_cast<uint8_t>(m_text[m_readIdx]);
+            ++m_readIdx;
+        }
+
+        return data;
+    }
+
+    int peek() override
+    {
+        return (m_size > m_readIdx) ? static_cast<uint8_t>(m_text[m_readIdx]) : -1;
+    }
+
+    size_t write(uint8_t data) override
+    {
+        (void)data;
+        return 0U;
+    }
+
+private:
+
+    const char* m_text;     /**< Text */
+    size_t      m_size;     /**< Text length in characters */
+    size_t      m_readIdx;  /**< Read index */
+};
+
+/** Benchmark function, which runs a single operation. */
+typedef void (*BenchmarkFunc)(void);
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t num, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+extern void setup();
+extern void loop();
+
+static uint64_t getTimestampNs(void);
+static void runBenchmark(const char* name, BenchmarkFunc func, uint32_t maxIterations);
+static void generateRsp(uint8_t* rsp, size_t size, const char* text);
+static void benchmarkChecksum(void);
+static void benchmarkCmdFrame(void);
+static void benchmarkStdRsp(void);
+static void benchmarkErrorRsp(void);
+static void benchmarkDisplayRsp(void);
+static void benchmarkTemperatureFromRaw(void);
+static void benchmarkTemperatureFromFloat(void);
+static void benchmarkHttpRequestParse(void);
+static void benchmarkRouter(void);
+static void handleNothing(WebConnection& conn, const HttpRequest& httpRequest);
+static void requestEndpoint(const char* uri);
+static void benchmarkEndpointRoot(void);
+static void benchmarkEndpointSensor(void);
+static void benchmarkEndpointSensors(void);
+static void benchmarkEndpointLeds(void);
+static void benchmarkEndpointLed(void);
+static void benchmarkEndpointMetrics(void);
+
+/******************************************************************************
+ * Variables
+ *****************************************************************************/
+
+/** Min. duration of a benchmark in ns. */
+static const uint64_t           MIN_DURATION            = 200ULL * 1000ULL * 1000ULL;
+
+/** Max. number of iterations of the fast benchmarks. */
+static const uint32_t           MAX_ITERATIONS          = 1UL << 24U;
+
+/**
+ * Max. number of iterations of the endpoint benchmarks. Every request uses
+ * its own connection, which shall not exhaust the local ports.
+ */
+static const uint32_t           MAX_ENDPOINT_ITERATIONS = 2048UL;
+
+/** Duration in ms, the server runs before the endpoints are measured. */
+static const uint32_t           WARM_UP_DURATION        = 5000UL;
+
+/** Port of the webserver on the host. */
+static const uint16_t           WEB_SRV_PORT            = 8080U;
+
+/** Number of allocations since start. */
+static uint64_t                 gAllocCnt               = 0U;
+
+/** Number of allocated bytes since start. */
+static uint64_t                 gAllocBytes             = 0U;
+
+/** Output of the results. */
+static FILE*                    gResults                = nullptr;
+
+/** Heatpump controller side, which replays the canned responses. */
+static ReplayStream             gReplayStream;
+
+/** Heatpump controller */
+static Rego6xxCtrl              gCtrl(gReplayStream);
+
+/** Standard response with value 312. */
+static uint8_t                  gStdRsp[5U];
+
+/** Error response */
+static uint8_t                  gErrorRsp[42U];
+
+/** Display response */
+static uint8_t                  gDisplayRsp[42U];
+
+/** Temperature */
+static Temperature              gTemperature;
+
+/** Router with the same routes as the server. */
+static WebReqRouter<15U>        gRouter;
+
+/** Web connection, which is only used as handler parameter. */
+static WebConnection            gWebConnection;
+
+/** Sink of the results, which shall not be optimized away. */
+static volatile uint32_t        gSink                   = 0U;
+
+/******************************************************************************
+ * External functions
+ *****************************************************************************/
+
+/**
+ * Count the allocation and allocate the memory.
+ *
+ * @param[in] size  Size in bytes
+ *
+ * @return Memory
+ */
+extern "C" void* malloc(size_t size)
+{
+    ++gAllocCnt;
+    gAllocBytes += size;
+
+    return __libc_malloc(size);
+}
+
+/**
+ * Count the allocation and allocate the zeroed memory.
+ *
+ * @param[in] num   Number of elements
+ * @param[in] size  Element size in bytes
+ *
+ * @return Memory
+ */
+extern "C" void* calloc(size_t num, size_t size)
+{
+    ++gAllocCnt;
+    gAllocBytes += num * size;
+
+    return __libc_calloc(num, size);
+}
+
+/**
+ * Count the allocation and reallocate the memory.
+ *
+ * @param[in] ptr   Memory
+ * @param[in] size  New size in bytes
+ *
+ * @return Memory
+ */
+extern "C" void* realloc(void* ptr, size_t size)
+{
+    ++gAllocCnt;
+    gAllocBytes += size;
+
+    return __libc_realloc(ptr, size);
+}
+
+/**
+ * Main entry point
+ *
+ * @param[in] argc  Number of command line arguments
+ * @param[in] argv  Command line arguments
+ */
+extern int main(int argc, char **argv)
+{
+    uint32_t warmUpStart = 0U;
+
+    (void)argc;
+    (void)argv;
+
+    /* The results use the original stdout, the serial console of the
+     * server is discarded.
+     */
+    gResults = fdopen(dup(STDOUT_FILENO), "w");
+
+    if ((nullptr == gResults) ||
+        (nullptr == freopen("/dev/null", "w", stdout)))
+    {
+        return 1;
+    }
+
+    generateRsp(gStdRsp, sizeof(gStdRsp), nullptr);
+    generateRsp(gErrorRsp, sizeof(gErrorRsp), "\x06" "240101 12:00:00");
+    generateRsp(gDisplayRsp, sizeof(gDisplayRsp), "GT1 Radiator return");
+
+    (void)gRouter.addRoute(HttpRequest::METHOD_GET, "/", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_GET, "/api/sensors/?", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_POST, "/api/sensors", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_POST, "/api/debug", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_GET, "/api/display/?", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_GET, "/api/lastError", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_GET, "/api/frontPanel/?", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_POST, "/api/frontPanel/macro", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_POST, "/api/frontPanel/?", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_GET, "/api/events", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_GET, "/metrics", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_GET, "/api/capture", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_GET, "/api/loop", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_GET, "/api/sysreg/?", handleNothing);
+    (void)gRouter.addRoute(HttpRequest::METHOD_POST, "/api/sysreg/?", handleNothing);
+
+    runBenchmark("checksum", benchmarkChecksum, MAX_ITERATIONS);
+    runBenchmark("cmdFrame", benchmarkCmdFrame, MAX_ITERATIONS);
+    runBenchmark("stdRsp", benchmarkStdRsp, MAX_ITERATIONS);
+    runBenchmark("errorRsp", benchmarkErrorRsp, MAX_ITERATIONS);
+    runBenchmark("displayRsp", benchmarkDisplayRsp, MAX_ITERATIONS);
+    runBenchmark("temperatureFromRaw", benchmarkTemperatureFromRaw, MAX_ITERATIONS);
+    runBenchmark("temperatureFromFloat", benchmarkTemperatureFromFloat, MAX_ITERATIONS);
+    runBenchmark("httpRequestParse", benchmarkHttpRequestParse, MAX_ITERATIONS);
+    runBenchmark("router", benchmarkRouter, MAX_ITERATIONS);
+
+    /* Run the server, until all cached values are read from the heatpump. */
+    setup();
+
+    warmUpStart = millis();
+
+    while(WARM_UP_DURATION > (millis() - warmUpStart))
+    {
+        loop();
+    }
+
+    runBenchmark("endpointRoot", benchmarkEndpointRoot, MAX_ENDPOINT_ITERATIONS);
+    runBenchmark("endpointSensor", benchmarkEndpointSensor, MAX_ENDPOINT_ITERATIONS);
+    runBenchmark("endpointSensors", benchmarkEndpointSensors, MAX_ENDPOINT_ITERATIONS);
+    runBenchmark("endpointLed", benchmarkEndpointLed, MAX_ENDPOINT_ITERATIONS);
+    runBenchmark("endpointLeds", benchmarkEndpointLeds, MAX_ENDPOINT_ITERATIONS);
+    runBenchmark("endpointMetrics", benchmarkEndpointMetrics, MAX_ENDPOINT_ITERATIONS);
+
+    (void)fclose(gResults);
+
+    return 0;
+}
+
+/******************************************************************************
+ * Local functions
+ *****************************************************************************/
+
+/**
+ * Get a monotonic timestamp.
+ *
+ * @return Timestamp in ns
+ */
+static uint64_t getTimestampNs(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (static_cast<uint64_t>(now.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(now.tv_nsec);
+}
+
+/**
+ * Run a benchmark and write its result.
+ * The number of iterations is doubled, until the benchmark takes at least
+ * MIN_DURATION or the max. number of iterations is reached.
+ *
+ * @param[in] name          Benchmark name
+ * @param[in] func          Benchmark function, which runs a single operation.
+ * @param[in] maxIterations Max. number of iterations
+ */
+static void runBenchmark(const char* name, BenchmarkFunc func, uint32_t maxIterations)
+{
+    uint32_t    iterations  = 1U;
+    uint64_t    duration    = 0U;
+    uint64_t    allocCnt    = 0U;
+    uint64_t    allocBytes  = 0U;
+    bool        isFinished  = false;
+
+    while(false == isFinished)
+    {
+        uint64_t    start           = getTimestampNs();
+        uint64_t    startAllocCnt   = gAllocCnt;
+        uint64_t    startAllocBytes = gAllocBytes;
+        uint32_t    idx             = 0U;
+
+        while(iterations > idx)
+        {
+            func();
+            ++idx;
+        }
+
+        duration    = getTimestampNs() - start;
+        allocCnt    = gAllocCnt - startAllocCnt;
+        allocBytes  = gAllocBytes - startAllocBytes;
+
+        if ((MIN_DURATION <= duration) ||
+            (maxIterations <= iterations))
+        {
+            isFinished = true;
+        }
+        else
+        {
+            iterations *= 2U;
+        }
+    }
+
+    fprintf(gResults, "{\"name\":\"%s\",\"iterations\":%u,\"nsPerOp\":%.1f,\"bytesPerOp\":%.1f,\"allocsPerOp\":%.2f}\n",
+        name,
+        iterations,
+        static_cast<double>(duration) / iterations,
+        static_cast<double>(allocBytes) / iterations,
+        static_cast<double>(allocCnt) / iterations);
+    (void)fflush(gResults);
+}
+
+/**
+ * Generate a canned heatpump response.
+ * Without text, it is a standard response with the value 312.
+ * With text, every character is coded as two nibbles. For a error response
+ * the first character is the error id.
+ *
+ * @param[out] rsp  Response buffer
+ * @param[in]  size Response size in bytes
+ * @param[in]  text Text or nullptr
+ */
+static void generateRsp(uint8_t* rsp, size_t size, const char* text)
+{
+    const uint16_t  VALUE   = 312U;
+    size_t          idx     = 1U;
+
+    memset(rsp, 0, size);
+    rsp[0U] = Rego6xxCtrl::DEV_ADDR_HOST;
+
+    if (nullptr == text)
+    {
+        rsp[1U] = (VALUE >> 14U) & 0x03U;
+        rsp[2U] = (VALUE >>  7U) & 0x7fU;
+        rsp[3U] = (VALUE >>  0U) & 0x7fU;
+    }
+    else
+    {
+        while(('\0' != *text) && ((size - 1U) > (idx + 1U)))
+        {
+            rsp[idx + 0U] = (static_cast<uint8_t>(*text) >> 4U) & 0x0fU;
+            rsp[idx + 1U] = (static_cast<uint8_t>(*text) >> 0U) & 0x0fU;
+
+            idx += 2U;
+            ++text;
+        }
+    }
+
+    rsp[size - 1U] = Rego6xxUtil::calculateChecksum(&rsp[1U], size - 2U);
+}
+
+/**
+ * Checksum of a display response.
+ */
+static void benchmarkChecksum(void)
+{
+    gSink = gSink + Rego6xxUtil::calculateChecksum(&gDisplayRsp[1U], sizeof(gDisplayRsp) - 2U);
+}
+
+/**
+ * Build and write a command frame, without waiting for the response.
+ */
+static void benchmarkCmdFrame(void)
+{
+    gReplayStream.setResponse(nullptr, 0U);
+
+    if (nullptr != gCtrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1))
+    {
+        gCtrl.release();
+    }
+}
+
+/**
+ * Request, receive and decode a standard response.
+ */
+static void benchmarkStdRsp(void)
+{
+    const Rego6xxStdRsp* rsp = nullptr;
+
+    gReplayStream.setResponse(gStdRsp, sizeof(gStdRsp));
+
+    rsp = gCtrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+
+    if (nullptr != rsp)
+    {
+        while(true == rsp->isPending())
+        {
+            gCtrl.process();
+        }
+
+        gSink = gSink + rsp->getValue();
+        gCtrl.release();
+    }
+}
+
+/**
+ * Request, receive and decode a error response.
+ */
+static void benchmarkErrorRsp(void)
+{
+    const Rego6xxErrorRsp* rsp = nullptr;
+
+    gReplayStream.setResponse(gErrorRsp, sizeof(gErrorRsp));
+
+    rsp = gCtrl.readLastError();
+
+    if (nullptr != rsp)
+    {
+        while(true == rsp->isPending())
+        {
+            gCtrl.process();
+        }
+
+        gSink = gSink + rsp->getErrorId() + rsp->getErrorLog().length();
+        gCtrl.release();
+    }
+}
+
+/**
+ * Request, receive and decode a display response.
+ */
+static void benchmarkDisplayRsp(void)
+{
+    const Rego6xxDisplayRsp* rsp = nullptr;
+
+    gReplayStream.setResponse(gDisplayRsp, sizeof(gDisplayRsp));
+
+    rsp = gCtrl.readDisplay(Rego6xxCtrl::DISPLAY_ROW_1);
+
+    if (nullptr != rsp)
+    {
+        while(true == rsp->isPending())
+        {
+            gCtrl.process();
+        }
+
+        gSink = gSink + rsp->getMsg().length();
+        gCtrl.release();
+    }
+}
+
+/**
+ * Convert a raw temperature, like read from the heatpump.
+ */
+static void benchmarkTemperatureFromRaw(void)
+{
+    gTemperature.setRawTemperature(static_cast<uint16_t>(gSink & 0x01ffU));
+    gSink = gSink + static_cast<uint32_t>(gTemperature.getTemperature());
+}
+
+/**
+ * Convert a floating point temperature, like written via REST API.
+ */
+static void benchmarkTemperatureFromFloat(void)
+{
+    gTemperature.setTemperature(static_cast<float>(gSink & 0x01ffU) / 10.0f);
+    gSink = gSink + gTemperature.getRawTemperature();
+}
+
+/**
+ * Parse a typical http request.
+ */
+static void benchmarkHttpRequestParse(void)
+{
+    TextStream  stream("GET /api/sensors/gt1 HTTP/1.1\r\n"
+                       "Host: 192.168.1.3\r\n"
+                       "Accept: application/json\r\n"
+                       "User-Agent: benchmark\r\n"
+                       "\r\n");
+    HttpRequest httpRequest;
+
+    gSink = gSink + httpRequest.parse(stream);
+}
+
+/**
+ * Route a request with dynamic URI part, which matches one of the last routes.
+ */
+static void benchmarkRouter(void)
+{
+    static HttpRequest  httpRequest;
+    static bool         isParsed    = false;
+
+    if (false == isParsed)
+    {
+        TextStream stream("GET /api/sysreg/0x020b HTTP/1.1\r\n\r\n");
+
+        (void)httpRequest.parse(stream);
+        isParsed = true;
+    }
+
+    gSink = gSink + gRouter.handle(gWebConnection, httpRequest);
+}
+
+/**
+ * Handler of the router benchmark, which does nothing.
+ *
+ * @param[in] conn          The web connection, used for the reply.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleNothing(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    (void)conn;
+    (void)httpRequest;
+}
+
+/**
+ * Send a request to the server and run the server, until the reply is
+ * completely received. Every request uses its own connection.
+ *
+ * @param[in] uri   Request URI
+ */
+static void requestEndpoint(const char* uri)
+{
+    EthernetClient client;
+
+    if (0 != client.connect(IPAddress(127U, 0U, 0U, 1U), WEB_SRV_PORT))
+    {
+        (void)client.print("GET ");
+        (void)client.print(uri);
+        (void)client.print(" HTTP/1.1\r\nConnection: close\r\n\r\n");
+
+        while((0 != client.connected()) || (0 < client.available()))
+        {
+            loop();
+
+            while(0 < client.available())
+            {
+                gSink = gSink + client.read();
+            }
+        }
+
+        client.stop();
+    }
+}
+
+/**
+ * Request the root page.
+ */
+static void benchmarkEndpointRoot(void)
+{
+    requestEndpoint("/");
+}
+
+/**
+ * Request a single temperature.
+ */
+static void benchmarkEndpointSensor(void)
+{
+    requestEndpoint("/api/sensors/gt1");
+}
+
+/**
+ * Request all temperatures, which is a streamed reply.
+ */
+static void benchmarkEndpointSensors(void)
+{
+    requestEndpoint("/api/sensors");
+}
+
+/**
+ * Request a single LED.
+ */
+static void benchmarkEndpointLed(void)
+{
+    requestEndpoint("/api/frontPanel/power");
+}
+
+/**
+ * Request all LEDs.
+ */
+static void benchmarkEndpointLeds(void)
+{
+    requestEndpoint("/api/frontPanel");
+}
+
+/**
+ * Request the metrics, which is a streamed reply.
+ */
+static void benchmarkEndpointMetrics(void)
+{
+    requestEndpoint("/metrics");
+}
@@ -0,0 +1,456 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Fault injection on the simulated serial line
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * The controller talks to the simulated heatpump at the real baudrate and
+ * every fault is injected several times. For every fault it is measured how
+ * long the controller needs to detect it and how long it takes until the
+ * next healthy response is received. At the end all faults are mixed with
+ * the probability table, to get the throughput and the worst-case stall.
+ *
+ * Usage: program [seed] [dropByte extraByte bitFlip wrongDevAddr delay silence]
+ *
+ * The probabilities of the mixed run are in %. The result is written as one
+ * JSON object per line to stdout.
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "Rego6xxCtrl.h"
+#include "Rego6xxSim.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/** Result of a single transaction. */
+enum Result
+{
+    RESULT_HEALTHY = 0, /**< Valid response with the expected value */
+    RESULT_DETECTED,    /**< Controller detected a timeout or a invalid response */
+    RESULT_UNDETECTED   /**< Controller accepted a wrong response */
+};
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static Result runTransaction(uint32_t& duration);
+static void setFaultProbabilities(const uint8_t* probabilities);
+static void measureHealthy(void);
+static void measureFault(Rego6xxSim::Fault fault);
+static void measureMixed(uint32_t seed, const uint8_t* probabilities);
+
+/******************************************************************************
+ * Variables
+ *****************************************************************************/
+
+/** Baudrate of the serial line in bit/s, like the real heatpump. */
+static const uint32_t   BAUDRATE                    = 19200U;
+
+/** Processing delay of the heatpump controller in ms. */
+static const uint32_t   PROCESSING_DELAY            = 20U;
+
+/** Number of transactions to measure the healthy serial line. */
+static const uint16_t   HEALTHY_TRANSACTIONS        = 100U;
+
+/** Number of injections of every single fault. */
+static const uint16_t   REPETITIONS                 = 20U;
+
+/** Max. number of transactions to recover from a fault. */
+static const uint16_t   MAX_RECOVERY_TRANSACTIONS   = 10U;
+
+/** Duration in ms of the run with mixed faults. */
+static const uint32_t   MIXED_DURATION              = (10UL * 1000UL);
+
+/** Default seed of the pseudo random number generator. */
+static const uint32_t   DEFAULT_SEED                = 1U;
+
+/** Default probability of every fault in % in the run with mixed faults. */
+static const uint8_t    DEFAULT_PROBABILITY         = 2U;
+
+/** Fault names, used in the results. */
+static const char*      FAULT_NAMES[Rego6xxSim::FAULT_COUNT] =
+{
+    "dropByte",
+    "extraByte",
+    "bitFlip",
+    "wrongDevAddr",
+    "delay",
+    "silence"
+};
+
+/** Output of the results. */
+static FILE*            gResults                    = nullptr;
+
+/** Simulated heatpump controller */
+static Rego6xxSim       gSim;
+
+/** Heatpump controller */
+static Rego6xxCtrl      gCtrl(gSim);
+
+/** Throughput of the healthy serial line in transactions/s. */
+static float            gHealthyThroughput          = 0.0f;
+
+/******************************************************************************
+ * External functions
+ *****************************************************************************/
+
+/**
+ * Main entry point
+ *
+ * @param[in] argc  Number of command line arguments
+ * @param[in] argv  Command line arguments
+ */
+extern int main(int argc, char **argv)
+{
+    uint32_t    seed                                    = DEFAULT_SEED;
+    uint8_t     probabilities[Rego6xxSim::FAULT_COUNT];
+    uint8_t     idx                                     = 0U;
+
+    if (1 < argc)
+    {
+        seed = strtoul(argv[1], nullptr, 0);
+    }
+
+    while(Rego6xxSim::FAULT_COUNT > idx)
+    {
+        if ((2 + idx) < argc)
+        {
+            probabilities[idx] = static_cast<uint8_t>(atoi(argv[2 + idx]));
+        }
+        else
+        {
+            probabilities[idx] = DEFAULT_PROBABILITY;
+        }
+
+        ++idx;
+    }
+
+    /* The results use the original stdout, the log of the simulator is
+     * discarded.
+     */
+    gResults = fdopen(dup(STDOUT_FILENO), "w");
+
+    if ((nullptr == gResults) ||
+        (nullptr == freopen("/dev/null", "w", stdout)))
+    {
+        return 1;
+    }
+
+    gSim.setBaudrate(BAUDRATE);
+    gSim.setProcessingDelay(PROCESSING_DELAY);
+    gSim.setFaultSeed(seed);
+    gCtrl.setBaudrate(BAUDRATE);
+
+    measureHealthy();
+
+    idx = 0U;
+    while(Rego6xxSim::FAULT_COUNT > idx)
+    {
+        measureFault(static_cast<Rego6xxSim::Fault>(idx));
+        ++idx;
+    }
+
+    measureMixed(seed, probabilities);
+
+    (void)fclose(gResults);
+
+    return 0;
+}
+
+/******************************************************************************
+ * Local functions
+ *****************************************************************************/
+
+/**
+ * Read a system register, like the sensor sweep of the server does.
+ *
+ * @param[out] duration Duration of the transaction in ms
+ *
+ * @return Result of the transaction
+ */
+static Result runTransaction(uint32_t& duration)
+{
+    uint16_t                expected    = gSim.getSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+    uint32_t                start       = millis();
+    const Rego6xxStdRsp*    rsp         = gCtrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+    Result                  result      = RESULT_DETECTED;
+
+    if (nullptr != rsp)
+    {
+        while(true == rsp->isPending())
+        {
+            gCtrl.process();
+        }
+
+        if ((true == rsp->isTimeout()) ||
+            (false == rsp->isValid()))
+        {
+            result = RESULT_DETECTED;
+        }
+        else if ((Rego6xxCtrl::DEV_ADDR_HOST != rsp->getDevAddr()) ||
+                 (expected != rsp->getValue()))
+        {
+            result = RESULT_UNDETECTED;
+        }
+        else
+        {
+            result = RESULT_HEALTHY;
+        }
+
+        gCtrl.release();
+    }
+
+    duration = millis() - start;
+
+    return result;
+}
+
+/**
+ * Set the probabilities of all faults.
+ *
+ * @param[in] probabilities Probability of every fault in %. Use nullptr for no faults.
+ */
+static void setFaultProbabilities(const uint8_t* probabilities)
+{
+    uint8_t idx = 0U;
+
+    while(Rego6xxSim::FAULT_COUNT > idx)
+    {
+        gSim.setFaultProbability(static_cast<Rego6xxSim::Fault>(idx), (nullptr == probabilities) ? 0U : probabilities[idx]);
+        ++idx;
+    }
+}
+
+/**
+ * Measure the healthy serial line, which is the reference of the recovery.
+ */
+static void measureHealthy(void)
+{
+    uint32_t    start       = millis();
+    uint32_t    durationMax = 0U;
+    uint16_t    healthy     = 0U;
+    uint16_t    idx         = 0U;
+    uint32_t    total       = 0U;
+
+    setFaultProbabilities(nullptr);
+
+    while(HEALTHY_TRANSACTIONS > idx)
+    {
+        uint32_t duration = 0U;
+
+        if (RESULT_HEALTHY == runTransaction(duration))
+        {
+            ++healthy;
+        }
+
+        if (durationMax < duration)
+        {
+            durationMax = duration;
+        }
+
+        ++idx;
+    }
+
+    total = millis() - start;
+
+    if (0U < total)
+    {
+        gHealthyThroughput = (1000.0f * healthy) / total;
+    }
+
+    fprintf(gResults, "{\"name\":\"healthy\",\"transactions\":%u,\"healthy\":%u,\"durationMsAvg\":%.1f,\"durationMsMax\":%u,\"throughput\":%.1f}\n",
+        HEALTHY_TRANSACTIONS,
+        healthy,
+        static_cast<float>(total) / HEALTHY_TRANSACTIONS,
+        durationMax,
+        gHealthyThroughput);
+    (void)fflush(gResults);
+}
+
+/**
+ * Inject a single fault several times and measure the detection and the
+ * recovery. The recovery is the time from the faulty command until the
+ * next healthy response is received.
+ *
+ * @param[in] fault Fault
+ */
+static void measureFault(Rego6xxSim::Fault fault)
+{
+    uint16_t    detected        = 0U;
+    uint16_t    undetected      = 0U;
+    uint16_t    unrecovered     = 0U;
+    uint32_t    detectSum       = 0U;
+    uint32_t    detectMax       = 0U;
+    uint32_t    recoverySum     = 0U;
+    uint32_t    recoveryMax     = 0U;
+    uint16_t    repetition      = 0U;
+
+    while(REPETITIONS > repetition)
+    {
+        uint32_t    start       = millis();
+        uint32_t    duration    = 0U;
+        uint32_t    recovery    = 0U;
+        uint16_t    cnt         = 0U;
+        Result      result      = RESULT_HEALTHY;
+
+        gSim.setFaultProbability(fault, 100U);
+        result = runTransaction(duration);
+        gSim.setFaultProbability(fault, 0U);
+
+        if (RESULT_DETECTED == result)
+        {
+            ++detected;
+            detectSum += duration;
+
+            if (detectMax < duration)
+            {
+                detectMax = duration;
+            }
+        }
+        else if (RESULT_UNDETECTED == result)
+        {
+            ++undetected;
+        }
+        else
+        {
+            /* The fault had no effect on this transaction. */
+            ;
+        }
+
+        while((RESULT_HEALTHY != result) && (MAX_RECOVERY_TRANSACTIONS > cnt))
+        {
+            result = runTransaction(duration);
+            ++cnt;
+        }
+
+        if (RESULT_HEALTHY != result)
+        {
+            ++unrecovered;
+        }
+
+        recovery     = millis() - start;
+        recoverySum += recovery;
+
+        if (recoveryMax < recovery)
+        {
+            recoveryMax = recovery;
+        }
+
+        ++repetition;
+    }
+
+    fprintf(gResults, "{\"name\":\"%s\",\"injected\":%u,\"detected\":%u,\"undetected\":%u,\"unrecovered\":%u,\"detectMsAvg\":%.1f,\"detectMsMax\":%u,\"recoveryMsAvg\":%.1f,\"recoveryMsMax\":%u}\n",
+        FAULT_NAMES[fault],
+        REPETITIONS,
+        detected,
+        undetected,
+        unrecovered,
+        (0U < detected) ? (static_cast<float>(detectSum) / detected) : 0.0f,
+        detectMax,
+        static_cast<float>(recoverySum) / REPETITIONS,
+        recoveryMax);
+    (void)fflush(gResults);
+}
+
+/**
+ * Run with all faults mixed by the probability table and measure the
+ * throughput and the longest time without a healthy response.
+ *
+ * @param[in] seed          Seed of the pseudo random number generator
+ * @param[in] probabilities Probability of every fault in %
+ */
+static void measureMixed(uint32_t seed, const uint8_t* probabilities)
+{
+    uint32_t    start           = millis();
+    uint32_t    lastHealthy     = start;
+    uint32_t    stallMax        = 0U;
+    uint32_t    transactions    = 0U;
+    uint32_t    healthy         = 0U;
+    uint32_t    undetected      = 0U;
+    uint32_t    total           = 0U;
+
+    gSim.setFaultSeed(seed);
+    setFaultProbabilities(probabilities);
+
+    while(MIXED_DURATION > (millis() - start))
+    {
+        uint32_t    duration    = 0U;
+        Result      result      = runTransaction(duration);
+
+        ++transactions;
+
+        if (RESULT_HEALTHY == result)
+        {
+            uint32_t now = millis();
+
+            ++healthy;
+
+            if (stallMax < (now - lastHealthy))
+            {
+                stallMax = now - lastHealthy;
+            }
+
+            lastHealthy = now;
+        }
+        else if (RESULT_UNDETECTED == result)
+        {
+            ++undetected;
+        }
+        else
+        {
+            /* Nothing to do. */
+            ;
+        }
+    }
+
+    total = millis() - start;
+    setFaultProbabilities(nullptr);
+
+    fprintf(gResults, "{\"name\":\"mixed\",\"seed\":%u,\"transactions\":%u,\"healthy\":%u,\"undetected\":%u,\"throughput\":%.1f,\"healthyThroughput\":%.1f,\"stallMsMax\":%u}\n",
+        seed,
+        transactions,
+        healthy,
+        undetected,
+        (1000.0f * healthy) / total,
+        gHealthyThroughput,
+        stallMax);
+    (void)fflush(gResults);
+}
@@ -0,0 +1,545 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Fuzz harness of the Rego6xx response parsers
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * Every input is a arbitrary byte stream, which the heatpump controller
+ * sends as response. The controller receives it with the response, which
+ * is selected by the first byte, and all getters of the response are called.
+ * The harness shall run with the address and undefined behaviour sanitizers,
+ * which detect every read out of bounds. A response, which doesn't finish
+ * although its complete frame was received, is reported as hang.
+ *
+ * First byte of the input:
+ * - Bit 0-2: Response (0: standard, 1: confirm, 2: error, 3: bool, 4: display, 5: raw)
+ * - Bit 3-5: Number of bytes - 1, which are received per process() call
+ * - Bit 7:   Correct the checksum of the frame, to reach the getters more often
+ *
+ * The entry point LLVMFuzzerTestOneInput() is used by libFuzzer and AFL.
+ * With FUZZ_STANDALONE a main() is added, which runs every file given as
+ * argument or stdin once, e.g. to reproduce a crash or to replay a corpus.
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Rego6xxCtrl.h"
+#include "Rego6xxUtil.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Stream, which discards everything written and provides the fuzz input
+ * after the command was written. The input is received step by step, like
+ * over the serial line.
+ */
+class FuzzStream : public Stream
+{
+public:
+
+    /**
+     * Constructs the stream.
+     *
+     * @param[in] data      Input data
+     * @param[in] size      Input size in bytes
+     * @param[in] chunkSize Number of bytes, which are received per step
+     */
+    FuzzStream(const uint8_t* data, size_t size, size_t chunkSize) :
+        Stream(),
+        m_data(data),
+        m_size(size),
+        m_chunkSize(chunkSize),
+        m_receivedCnt(0U),
+        m_readIdx(0U),
+        m_isWritten(false),
+        m_checksumIdx(0U),
+        m_checksum(0U)
+    {
+    }
+
+    /**
+     * Destroys the stream.
+     */
+    ~FuzzStream()
+    {
+    }
+
+    /**
+     * Correct the checksum of the frame, which starts with the input.
+     * Nothing happens, if the input is shorter than the frame.
+     *
+     * @param[in] frameSize Frame size in bytes, including device address and checksum
+     */
+    void correctChecksum(size_t frameSize)
+    {
+        if ((3U <= frameSize) &&
+            (frameSize <= m_size))
+        {
+            m_checksumIdx   = frameSize - 1U;
+            m_checksum      = Rego6xxUtil::calculateChecksum(&m_data[1U], frameSize - 2U);
+        }
+    }
+
+    /**
+     * Receive the next bytes of the input.
+     */
+    void receive()
+    {
+        if (true == m_isWritten)
+        {
+            m_receivedCnt += m_chunkSize;
+
+            if (m_size < m_receivedCnt)
+            {
+                m_receivedCnt = m_size;
+            }
+        }
+    }
+
+    /**
+     * Is the whole input received?
+     *
+     * @return If the whole input is received, it will return true otherwise false.
+     */
+    bool isComplete() const
+    {
+        return ((true == m_isWritten) && (m_size <= m_receivedCnt));
+    }
+
+    /**
+     * Get the number of received bytes, including the already read ones.
+     *
+     * @return Number of received bytes
+     */
+    size_t getReceivedCnt() const
+    {
+        return m_receivedCnt;
+    }
+
+    int available() override
+    {
+        return static_cast<int>(m_receivedCnt - m_readIdx);
+    }
+
+    int read() override
+    {
+        int data = peek();
+
+        if (0 <= data)
+        {
+            ++m_readIdx;
+        }
+
+        return data;
+    }
+
+    int peek() override
+    {
+        int data = -1;
+
+        if (m_receivedCnt > m_readIdx)
+        {
+            if ((0U < m_checksumIdx) && (m_checksumIdx == m_readIdx))
+            {
+                data = m_checksum;
+            }
+            else
+            {
+                data = m_data[m_readIdx];
+            }
+        }
+
+        return data;
+    }
+
+    size_t write(uint8_t data) override
+    {
+        (void)data;
+        m_isWritten = true;
+
+        return 1U;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override
+    {
+        (void)buffer;
+        m_isWritten = true;
+
+        return size;
+    }
+
+private:
+
+    const uint8_t*  m_data;         /**< Input data */
+    size_t          m_size;         /**< Input size in bytes */
+    size_t          m_chunkSize;    /**< Number of bytes, which are received per step */
+    size_t          m_receivedCnt;  /**< Number of received bytes */
+    size_t          m_readIdx;      /**< Read index */
+    bool            m_isWritten;    /**< Is the command written? The response follows afterwards. */
+    size_t          m_checksumIdx;  /**< Index of the corrected checksum. 0 if not corrected. */
+    uint8_t         m_checksum;     /**< Corrected checksum */
+
+    FuzzStream();
+    FuzzStream(const FuzzStream& stream);
+    FuzzStream& operator=(const FuzzStream& stream);
+};
+
+/** Responses, which are selected by the first input byte. */
+enum RspType
+{
+    RSP_TYPE_STD = 0,   /**< Standard response, e.g. of a system register */
+    RSP_TYPE_CONFIRM,   /**< Confirmation of a write */
+    RSP_TYPE_ERROR,     /**< Last error */
+    RSP_TYPE_BOOL,      /**< Front panel LED */
+    RSP_TYPE_DISPLAY,   /**< Display row */
+    RSP_TYPE_RAW,       /**< Raw response */
+    RSP_TYPE_MAX        /**< Number of responses */
+};
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static const Rego6xxRsp* sendCmd(Rego6xxCtrl& ctrl, RspType rspType);
+static void receiveRsp(Rego6xxCtrl& ctrl, FuzzStream& stream, const Rego6xxRsp& rsp, size_t frameSize);
+static void readRsp(RspType rspType, const Rego6xxRsp& rsp);
+static void useString(const String& str);
+
+/******************************************************************************
+ * Variables
+ *****************************************************************************/
+
+/** Frame size of every response in bytes, including device address and checksum. */
+static const size_t     FRAME_SIZES[RSP_TYPE_MAX] =
+{
+    5U,
+    1U,
+    42U,
+    5U,
+    42U,
+    Rego6xxRawRsp::RSP_SIZE
+};
+
+/**
+ * Max. number of additional process() calls after the whole input is
+ * received. The first call starts the response timeout observation, the
+ * second one reads the complete frame.
+ */
+static const uint8_t    MAX_ADDITIONAL_CALLS    = 2U;
+
+/** Max. input size in bytes, which is read by the standalone main(). */
+static const size_t     MAX_INPUT_SIZE          = 4096U;
+
+/** Sink for all read values, which keeps the getters from being optimized away. */
+static volatile uint32_t    gSink               = 0U;
+
+/******************************************************************************
+ * External functions
+ *****************************************************************************/
+
+/**
+ * Fuzz entry point, which runs a single input.
+ *
+ * @param[in] data  Input data
+ * @param[in] size  Input size in bytes
+ *
+ * @return Always 0
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    if (0U < size)
+    {
+        RspType             rspType     = static_cast<RspType>((data[0] & 0x07U) % RSP_TYPE_MAX);
+        size_t              chunkSize   = ((data[0] >> 3U) & 0x07U) + 1U;
+        FuzzStream          stream(&data[1], size - 1U, chunkSize);
+        Rego6xxCtrl         ctrl(stream);
+        const Rego6xxRsp*   rsp         = nullptr;
+
+        if (0U != (data[0] & 0x80U))
+        {
+            stream.correctChecksum(FRAME_SIZES[rspType]);
+        }
+
+        rsp = sendCmd(ctrl, rspType);
+
+        if (nullptr == rsp)
+        {
+            fprintf(stderr, "No response available.\n");
+            abort();
+        }
+
+        receiveRsp(ctrl, stream, *rsp, FRAME_SIZES[rspType]);
+        readRsp(rspType, *rsp);
+
+        ctrl.release();
+    }
+
+    return 0;
+}
+
+#if defined(FUZZ_STANDALONE)
+
+/**
+ * Main entry point, which runs every file given as argument once.
+ * Without argument, the input is read from stdin.
+ *
+ * @param[in] argc  Number of command line arguments
+ * @param[in] argv  Command line arguments
+ */
+extern int main(int argc, char **argv)
+{
+    int exitCode    = 0;
+    int argIdx      = 1;
+
+    do
+    {
+        FILE*   fd      = (argc > argIdx) ? fopen(argv[argIdx], "rb") : stdin;
+        uint8_t buffer[MAX_INPUT_SIZE];
+        size_t  size    = 0U;
+
+        if (nullptr == fd)
+        {
+            fprintf(stderr, "File %s not found.\n", argv[argIdx]);
+            exitCode = 1;
+        }
+        else
+        {
+            uint8_t* input = nullptr;
+
+            size = fread(buffer, 1U, sizeof(buffer), fd);
+
+            if (stdin != fd)
+            {
+                (void)fclose(fd);
+            }
+
+            /* The input is copied to a buffer of exactly its size, therefore
+             * the address sanitizer detects every read beyond its end.
+             */
+            input = static_cast<uint8_t*>(malloc((0U < size) ? size : 1U));
+
+            if (nullptr != input)
+            {
+                memcpy(input, buffer, size);
+                (void)LLVMFuzzerTestOneInput(input, size);
+                free(input);
+            }
+        }
+
+        ++argIdx;
+    }
+    while(argc > argIdx);
+
+    return exitCode;
+}
+
+#endif  /* defined(FUZZ_STANDALONE) */
+
+/******************************************************************************
+ * Local functions
+ *****************************************************************************/
+
+/**
+ * Send the command, which is answered with the selected response.
+ *
+ * @param[in] ctrl      Heatpump controller
+ * @param[in] rspType   Response type
+ *
+ * @return Asynchronous response
+ */
+static const Rego6xxRsp* sendCmd(Rego6xxCtrl& ctrl, RspType rspType)
+{
+    const Rego6xxRsp* rsp = nullptr;
+
+    switch(rspType)
+    {
+    case RSP_TYPE_STD:
+        rsp = ctrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+        break;
+
+    case RSP_TYPE_CONFIRM:
+        rsp = ctrl.writeSysReg(Rego6xxCtrl::SYSREG_ADDR_HEAT_CURVE, 0U);
+        break;
+
+    case RSP_TYPE_ERROR:
+        rsp = ctrl.readLastError();
+        break;
+
+    case RSP_TYPE_BOOL:
+        rsp = ctrl.readFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_POWER_LED);
+        break;
+
+    case RSP_TYPE_DISPLAY:
+        rsp = ctrl.readDisplay(Rego6xxCtrl::DISPLAY_ROW_1);
+        break;
+
+    case RSP_TYPE_RAW:
+        rsp = ctrl.writeRaw(Rego6xxCtrl::CMD_ID_READ_SYSTEM_REG, 0U, 0U);
+        break;
+
+    default:
+        break;
+    }
+
+    return rsp;
+}
+
+/**
+ * Receive the response step by step, until it finishes or the whole input
+ * is received. If the response is still pending, although its complete
+ * frame was received, the receiver hangs and the harness aborts.
+ *
+ * @param[in] ctrl      Heatpump controller
+ * @param[in] stream    Stream with the input
+ * @param[in] rsp       Response
+ * @param[in] frameSize Frame size in bytes
+ */
+static void receiveRsp(Rego6xxCtrl& ctrl, FuzzStream& stream, const Rego6xxRsp& rsp, size_t frameSize)
+{
+    uint8_t additionalCalls = 0U;
+
+    while((true == rsp.isPending()) && (MAX_ADDITIONAL_CALLS > additionalCalls))
+    {
+        if (true == stream.isComplete())
+        {
+            ++additionalCalls;
+        }
+
+        stream.receive();
+        ctrl.process();
+    }
+
+    if ((true == rsp.isPending()) &&
+        (frameSize <= stream.getReceivedCnt()))
+    {
+        fprintf(stderr, "Response pending, although %u of %u bytes are received.\n",
+            static_cast<unsigned int>(stream.getReceivedCnt()),
+            static_cast<unsigned int>(frameSize));
+        abort();
+    }
+
+    return;
+}
+
+/**
+ * Call all getters of the response.
+ *
+ * @param[in] rspType   Response type
+ * @param[in] rsp       Response
+ */
+static void readRsp(RspType rspType, const Rego6xxRsp& rsp)
+{
+    gSink += (true == rsp.isValid()) ? 1U : 0U;
+    gSink += (true == rsp.isTimeout()) ? 1U : 0U;
+    gSink += rsp.getDevAddr();
+
+    switch(rspType)
+    {
+    case RSP_TYPE_STD:
+        gSink += static_cast<const Rego6xxStdRsp&>(rsp).getValue();
+        break;
+
+    case RSP_TYPE_CONFIRM:
+        gSink += (true == static_cast<const Rego6xxConfirmRsp&>(rsp).isConfirmed()) ? 1U : 0U;
+        break;
+
+    case RSP_TYPE_ERROR:
+        {
+            const Rego6xxErrorRsp& errorRsp = static_cast<const Rego6xxErrorRsp&>(rsp);
+
+            gSink += errorRsp.getErrorId();
+            useString(errorRsp.getErrorLog());
+            useString(errorRsp.getErrorDescription());
+        }
+        break;
+
+    case RSP_TYPE_BOOL:
+        gSink += (true == static_cast<const Rego6xxBoolRsp&>(rsp).getValue()) ? 1U : 0U;
+        break;
+
+    case RSP_TYPE_DISPLAY:
+        useString(static_cast<const Rego6xxDisplayRsp&>(rsp).getMsg());
+        break;
+
+    case RSP_TYPE_RAW:
+        {
+            const Rego6xxRawRsp&    rawRsp  = static_cast<const Rego6xxRawRsp&>(rsp);
+            const uint8_t*          rawData = rawRsp.getData();
+            size_t                  idx     = 0U;
+
+            if (Rego6xxRawRsp::RSP_SIZE < rawRsp.getSize())
+            {
+                fprintf(stderr, "Raw response size %u exceeds the buffer.\n", static_cast<unsigned int>(rawRsp.getSize()));
+                abort();
+            }
+
+            while(rawRsp.getSize() > idx)
+            {
+                gSink += rawData[idx];
+                ++idx;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return;
+}
+
+/**
+ * Read every character of the string, which detects e.g. a missing string
+ * termination.
+ *
+ * @param[in] str   String
+ */
+static void useString(const String& str)
+{
+    const char* cStr    = str.c_str();
+    size_t      len     = strlen(cStr);
+    size_t      idx     = 0U;
+
+    while(len > idx)
+    {
+        gSink += static_cast<uint8_t>(cStr[idx]);
+        ++idx;
+    }
+
+    return;
+}
@@ -0,0 +1,1071 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP load generator
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * Several concurrent connections send requests to the webserver, either the
+ * native server or the device in the local network. Every connection sends
+ * its next request as soon as the reply of the previous one is received.
+ * The requests are taken from a weighted mix of URIs in a fixed order,
+ * therefore every run is repeatable.
+ *
+ * Usage: program [host] [port] [connections] [duration] [keepalive | close] [mix]
+ *
+ * The duration is in s. With keepalive every connection is kept open for
+ * the following requests, with close every request uses a new connection.
+ * The mix is a comma separated list of URIs with their weight, e.g.
+ * /api/sensors:4,/api/display/1:1,/api/frontPanel:2.
+ *
+ * The latency is measured from connecting or sending the request until the
+ * reply is completely received. The result is written as one JSON object
+ * per URI and one for all requests to stdout.
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/** Max. number of URIs in the mix. */
+static const uint8_t    MAX_ENDPOINTS       = 8U;
+
+/** Max. length of a URI in characters. */
+static const size_t     MAX_URI_LEN         = 64U;
+
+/** Max. length of a status or header line of the reply in characters. */
+static const size_t     MAX_LINE_LEN        = 128U;
+
+/** Max. size of a request in bytes. */
+static const size_t     MAX_REQUEST_SIZE    = 256U;
+
+/** A single URI of the mix with its results. */
+struct Endpoint
+{
+    char        uri[MAX_URI_LEN + 1U];  /**< URI */
+    uint8_t     weight;                 /**< Weight in the mix */
+    uint32_t    requests;               /**< Number of successful requests */
+    uint32_t    errors;                 /**< Number of failed requests */
+    uint32_t*   samples;                /**< Latencies in us of the successful requests */
+};
+
+/** Connection states */
+enum ConnState
+{
+    CONN_STATE_WAIT = 0,    /**< Wait before the next request, after a error */
+    CONN_STATE_CONNECT,     /**< Connect to the server */
+    CONN_STATE_SEND,        /**< Send the request */
+    CONN_STATE_RECEIVE      /**< Receive the reply */
+};
+
+/** Reply parser states */
+enum RspState
+{
+    RSP_STATE_STATUS_LINE = 0,  /**< Wait for the status line */
+    RSP_STATE_HEADER,           /**< Wait for the header fields */
+    RSP_STATE_BODY,             /**< Wait for the body with the given length */
+    RSP_STATE_BODY_UNTIL_CLOSE, /**< Wait for the body, which ends with the connection */
+    RSP_STATE_CHUNK_SIZE,       /**< Wait for the size line of the next chunk */
+    RSP_STATE_CHUNK_DATA,       /**< Wait for the chunk data */
+    RSP_STATE_CHUNK_END,        /**< Wait for the line end after the chunk data */
+    RSP_STATE_TRAILER,          /**< Wait for the end of the trailer */
+    RSP_STATE_COMPLETE,         /**< Reply is complete */
+    RSP_STATE_ERROR             /**< Reply is invalid */
+};
+
+/** A single client connection. */
+struct Connection
+{
+    int         fd;                             /**< Socket, -1 if closed */
+    ConnState   state;                          /**< Connection state */
+    uint8_t     endpointIdx;                    /**< Endpoint of the current request */
+    uint64_t    startTimestamp;                 /**< Start of the current request in us */
+    uint64_t    waitTimestamp;                  /**< End of the wait in us */
+    char        request[MAX_REQUEST_SIZE];      /**< Current request */
+    size_t      requestSize;                    /**< Request size in bytes */
+    size_t      requestIdx;                     /**< Index of the next byte to send */
+    uint32_t    servedCnt;                      /**< Number of replies on this socket */
+    bool        isRetried;                      /**< Is the current request retried already? */
+    RspState    rspState;                       /**< Reply parser state */
+    char        line[MAX_LINE_LEN + 1U];        /**< Current line of the reply */
+    size_t      lineLen;                        /**< Current line length in characters */
+    size_t      rspSize;                        /**< Number of received reply bytes */
+    uint16_t    statusCode;                     /**< Http status code of the reply */
+    bool        isChunked;                      /**< Body in chunked transfer encoding? */
+    bool        isClose;                        /**< Does the server close the connection? */
+    bool        hasContentLength;               /**< Is the body length given? */
+    size_t      remaining;                      /**< Remaining bytes of the body or chunk */
+};
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static uint64_t getTimestampUs(void);
+static bool parseMix(const char* mix);
+static bool resolveHost(const char* host, uint16_t port);
+static uint8_t getNextEndpoint(void);
+static void startRequest(Connection& conn);
+static void openSocket(Connection& conn);
+static void closeSocket(Connection& conn);
+static void failRequest(Connection& conn);
+static void finishRequest(Connection& conn);
+static void handleConnect(Connection& conn);
+static void handleSend(Connection& conn);
+static void handleReceive(Connection& conn);
+static void parseReply(Connection& conn, char data);
+static void handleReplyLine(Connection& conn);
+static void recordSample(uint32_t* samples, uint32_t& cnt, uint32_t latency);
+static int compareSamples(const void* a, const void* b);
+static uint32_t getPercentile(const uint32_t* samples, uint32_t cnt, uint8_t percent);
+static void writeResult(const char* uri, uint32_t* samples, uint32_t requests, uint32_t errors, double duration);
+
+/******************************************************************************
+ * Variables
+ *****************************************************************************/
+
+/** Max. number of concurrent connections. */
+static const uint16_t   MAX_CONNECTIONS     = 64U;
+
+/** Max. number of latency samples, which are kept for every endpoint. */
+static const uint32_t   MAX_SAMPLES         = 200000U;
+
+/** Max. duration of a single request in us, afterwards it fails. */
+static const uint64_t   REQUEST_TIMEOUT     = 10ULL * 1000ULL * 1000ULL;
+
+/** Wait duration in us after a failed request, which keeps a unreachable server from being flooded. */
+static const uint64_t   RETRY_DELAY         = 100ULL * 1000ULL;
+
+/** Poll period in ms. */
+static const int        POLL_PERIOD         = 10;
+
+/** Default host, which is the native server. */
+static const char*      DEFAULT_HOST        = "127.0.0.1";
+
+/** Default port of the native server. */
+static const uint16_t   DEFAULT_PORT        = 8080U;
+
+/** Default number of concurrent connections. */
+static const uint16_t   DEFAULT_CONNECTIONS = 4U;
+
+/** Default duration in s. */
+static const uint32_t   DEFAULT_DURATION    = 10U;
+
+/** Default mix of the requests. */
+static const char*      DEFAULT_MIX         = "/api/sensors:4,/api/display/1:1,/api/frontPanel:2";
+
+/** Host name, used in the Host header field. */
+static const char*      gHost               = DEFAULT_HOST;
+
+/** Server address */
+static struct sockaddr_storage  gServerAddr;
+
+/** Server address length in bytes */
+static socklen_t        gServerAddrLen      = 0;
+
+/** Keep the connections open for the following requests? */
+static bool             gIsKeepAlive        = true;
+
+/** Endpoints of the mix */
+static Endpoint         gEndpoints[MAX_ENDPOINTS];
+
+/** Number of endpoints in the mix */
+static uint8_t          gEndpointCnt        = 0U;
+
+/** Sum of all endpoint weights */
+static uint32_t         gWeightSum          = 0U;
+
+/** Number of started requests, which selects the next endpoint. */
+static uint32_t         gRequestCnt         = 0U;
+
+/** Latencies in us of all successful requests */
+static uint32_t*        gSamples            = nullptr;
+
+/** Number of successful requests */
+static uint32_t         gSampleCnt          = 0U;
+
+/** Number of failed requests */
+static uint32_t         gErrorCnt           = 0U;
+
+/** Number of requests, which were sent again on a new connection. */
+static uint32_t         gRetryCnt           = 0U;
+
+/** Client connections */
+static Connection       gConnections[MAX_CONNECTIONS];
+
+/******************************************************************************
+ * External functions
+ *****************************************************************************/
+
+/**
+ * Main entry point
+ *
+ * @param[in] argc  Number of command line arguments
+ * @param[in] argv  Command line arguments
+ */
+extern int main(int argc, char **argv)
+{
+    int         exitCode        = 0;
+    uint16_t    port            = DEFAULT_PORT;
+    uint16_t    connections     = DEFAULT_CONNECTIONS;
+    uint32_t    duration        = DEFAULT_DURATION;
+    const char* mix             = DEFAULT_MIX;
+
+    if (1 < argc)
+    {
+        gHost = argv[1];
+    }
+
+    if (2 < argc)
+    {
+        port = static_cast<uint16_t>(strtoul(argv[2], nullptr, 0));
+    }
+
+    if (3 < argc)
+    {
+        connections = static_cast<uint16_t>(strtoul(argv[3], nullptr, 0));
+    }
+
+    if (4 < argc)
+    {
+        duration = strtoul(argv[4], nullptr, 0);
+    }
+
+    if (5 < argc)
+    {
+        gIsKeepAlive = (0 != strcmp(argv[5], "close"));
+    }
+
+    if (6 < argc)
+    {
+        mix = argv[6];
+    }
+
+    if ((0U == connections) ||
+        (MAX_CONNECTIONS < connections))
+    {
+        fprintf(stderr, "Number of connections shall be 1 - %u.\n", MAX_CONNECTIONS);
+        exitCode = 1;
+    }
+    else if ((0U == duration) ||
+             (false == parseMix(mix)))
+    {
+        fprintf(stderr, "Invalid duration or mix.\n");
+        exitCode = 1;
+    }
+    else if (false == resolveHost(gHost, port))
+    {
+        fprintf(stderr, "Host %s not found.\n", gHost);
+        exitCode = 1;
+    }
+    else
+    {
+        uint64_t        startTimestamp  = getTimestampUs();
+        uint64_t        endTimestamp    = startTimestamp + (duration * 1000ULL * 1000ULL);
+        uint64_t        now             = startTimestamp;
+        struct pollfd   fds[MAX_CONNECTIONS];
+        uint16_t        idx             = 0U;
+
+        gSamples = static_cast<uint32_t*>(malloc(MAX_SAMPLES * sizeof(uint32_t)));
+
+        while(connections > idx)
+        {
+            gConnections[idx].fd = -1;
+            startRequest(gConnections[idx]);
+            ++idx;
+        }
+
+        while(endTimestamp > now)
+        {
+            idx = 0U;
+            while(connections > idx)
+            {
+                fds[idx].fd         = gConnections[idx].fd;
+                fds[idx].events     = (CONN_STATE_RECEIVE == gConnections[idx].state) ? POLLIN : POLLOUT;
+                fds[idx].revents    = 0;
+
+                if (CONN_STATE_WAIT == gConnections[idx].state)
+                {
+                    fds[idx].fd = -1;
+                }
+
+                ++idx;
+            }
+
+            (void)poll(fds, connections, POLL_PERIOD);
+            now = getTimestampUs();
+
+            idx = 0U;
+            while(connections > idx)
+            {
+                Connection& conn = gConnections[idx];
+
+                if (CONN_STATE_WAIT == conn.state)
+                {
+                    if (conn.waitTimestamp <= now)
+                    {
+                        startRequest(conn);
+                    }
+                }
+                else if ((conn.startTimestamp + REQUEST_TIMEOUT) <= now)
+                {
+                    failRequest(conn);
+                }
+                else if (0 == fds[idx].revents)
+                {
+                    /* Nothing to do. */
+                    ;
+                }
+                else if (CONN_STATE_CONNECT == conn.state)
+                {
+                    handleConnect(conn);
+                }
+                else if (CONN_STATE_SEND == conn.state)
+                {
+                    handleSend(conn);
+                }
+                else
+                {
+                    handleReceive(conn);
+                }
+
+                ++idx;
+            }
+        }
+
+        idx = 0U;
+        while(connections > idx)
+        {
+            closeSocket(gConnections[idx]);
+            ++idx;
+        }
+
+        idx = 0U;
+        while(gEndpointCnt > idx)
+        {
+            writeResult(gEndpoints[idx].uri, gEndpoints[idx].samples, gEndpoints[idx].requests, gEndpoints[idx].errors, duration);
+            ++idx;
+        }
+
+        writeResult("total", gSamples, gSampleCnt, gErrorCnt, duration);
+        printf("{\"connections\":%u,\"keepAlive\":%s,\"durationS\":%u,\"retries\":%u}\n",
+            connections,
+            (true == gIsKeepAlive) ? "true" : "false",
+            duration,
+            gRetryCnt);
+    }
+
+    return exitCode;
+}
+
+/******************************************************************************
+ * Local functions
+ *****************************************************************************/
+
+/**
+ * Get the monotonic timestamp in us.
+ *
+ * @return Timestamp in us
+ */
+static uint64_t getTimestampUs(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (static_cast<uint64_t>(now.tv_sec) * 1000000ULL) + (static_cast<uint64_t>(now.tv_nsec) / 1000ULL);
+}
+
+/**
+ * Parse the mix of the requests, e.g. "/api/sensors:4,/api/frontPanel:2".
+ * A URI without weight has the weight 1.
+ *
+ * @param[in] mix   Mix
+ *
+ * @return If the mix is valid, it will return true otherwise false.
+ */
+static bool parseMix(const char* mix)
+{
+    bool        isValid = true;
+    const char* pos     = mix;
+
+    while(('\0' != *pos) && (true == isValid))
+    {
+        const char* end     = strchr(pos, ',');
+        const char* colon   = nullptr;
+        size_t      len     = (nullptr == end) ? strlen(pos) : static_cast<size_t>(end - pos);
+        size_t      uriLen  = len;
+        long        weight  = 1;
+
+        colon = static_cast<const char*>(memchr(pos, ':', len));
+
+        if (nullptr != colon)
+        {
+            uriLen  = static_cast<size_t>(colon - pos);
+            weight  = strtol(colon + 1, nullptr, 0);
+        }
+
+        if ((MAX_ENDPOINTS <= gEndpointCnt) ||
+            (0U == uriLen) ||
+            (MAX_URI_LEN < uriLen) ||
+            ('/' != *pos) ||
+            (0 >= weight) ||
+            (UINT8_MAX < weight))
+        {
+            isValid = false;
+        }
+        else
+        {
+            Endpoint& endpoint = gEndpoints[gEndpointCnt];
+
+            memcpy(endpoint.uri, pos, uriLen);
+            endpoint.uri[uriLen]    = '\0';
+            endpoint.weight         = static_cast<uint8_t>(weight);
+            endpoint.requests       = 0U;
+            endpoint.errors         = 0U;
+            endpoint.samples        = static_cast<uint32_t*>(malloc(MAX_SAMPLES * sizeof(uint32_t)));
+
+            gWeightSum += endpoint.weight;
+            ++gEndpointCnt;
+
+            pos += len;
+
+            if (',' == *pos)
+            {
+                ++pos;
+            }
+        }
+    }
+
+    if (0U == gEndpointCnt)
+    {
+        isValid = false;
+    }
+
+    return isValid;
+}
+
+/**
+ * Resolve the server address.
+ *
+ * @param[in] host  Host name or IP address
+ * @param[in] port  Port
+ *
+ * @return If resolved, it will return true otherwise false.
+ */
+static bool resolveHost(const char* host, uint16_t port)
+{
+    bool                isResolved  = false;
+    struct addrinfo     hints;
+    struct addrinfo*    result      = nullptr;
+    char                service[8];
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family     = AF_UNSPEC;
+    hints.ai_socktype   = SOCK_STREAM;
+
+    (void)snprintf(service, sizeof(service), "%u", port);
+
+    if ((0 == getaddrinfo(host, service, &hints, &result)) &&
+        (nullptr != result))
+    {
+        memcpy(&gServerAddr, result->ai_addr, result->ai_addrlen);
+        gServerAddrLen  = result->ai_addrlen;
+        isResolved      = true;
+
+        freeaddrinfo(result);
+    }
+
+    return isResolved;
+}
+
+/**
+ * Get the endpoint of the next request. The endpoints are selected in a
+ * fixed order, which follows their weights.
+ *
+ * @return Endpoint index
+ */
+static uint8_t getNextEndpoint(void)
+{
+    uint32_t    slot    = gRequestCnt % gWeightSum;
+    uint8_t     idx     = 0U;
+
+    while(gEndpoints[idx].weight <= slot)
+    {
+        slot -= gEndpoints[idx].weight;
+        ++idx;
+    }
+
+    ++gRequestCnt;
+
+    return idx;
+}
+
+/**
+ * Start the next request. A closed connection is opened again.
+ *
+ * @param[in] conn  Connection
+ */
+static void startRequest(Connection& conn)
+{
+    conn.endpointIdx    = getNextEndpoint();
+    conn.startTimestamp = getTimestampUs();
+    conn.isRetried      = false;
+    conn.requestSize    = static_cast<size_t>(snprintf(conn.request, sizeof(conn.request),
+                            "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: %s\r\n\r\n",
+                            gEndpoints[conn.endpointIdx].uri,
+                            gHost,
+                            (true == gIsKeepAlive) ? "keep-alive" : "close"));
+    conn.requestIdx     = 0U;
+
+    if (0 > conn.fd)
+    {
+        openSocket(conn);
+    }
+    else
+    {
+        conn.state = CONN_STATE_SEND;
+    }
+
+    return;
+}
+
+/**
+ * Open a new socket and connect to the server.
+ *
+ * @param[in] conn  Connection
+ */
+static void openSocket(Connection& conn)
+{
+    int fd = socket(gServerAddr.ss_family, SOCK_STREAM, 0);
+
+    conn.servedCnt = 0U;
+
+    if (0 > fd)
+    {
+        failRequest(conn);
+    }
+    else
+    {
+        int noDelay = 1;
+
+        (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        (void)fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        conn.fd = fd;
+
+        if (0 == connect(fd, reinterpret_cast<const struct sockaddr*>(&gServerAddr), gServerAddrLen))
+        {
+            conn.state = CONN_STATE_SEND;
+        }
+        else if (EINPROGRESS == errno)
+        {
+            conn.state = CONN_STATE_CONNECT;
+        }
+        else
+        {
+            failRequest(conn);
+        }
+    }
+
+    return;
+}
+
+/**
+ * Close the socket, if open.
+ *
+ * @param[in] conn  Connection
+ */
+static void closeSocket(Connection& conn)
+{
+    if (0 <= conn.fd)
+    {
+        (void)close(conn.fd);
+        conn.fd = -1;
+    }
+
+    return;
+}
+
+/**
+ * The request failed. The connection is closed and waits before the next
+ * request.
+ *
+ * @param[in] conn  Connection
+ */
+static void failRequest(Connection& conn)
+{
+    closeSocket(conn);
+
+    ++gEndpoints[conn.endpointIdx].errors;
+    ++gErrorCnt;
+
+    conn.state          = CONN_STATE_WAIT;
+    conn.waitTimestamp  = getTimestampUs() + RETRY_DELAY;
+
+    return;
+}
+
+/**
+ * The reply is completely received. Its latency is recorded and the next
+ * request is started.
+ *
+ * @param[in] conn  Connection
+ */
+static void finishRequest(Connection& conn)
+{
+    Endpoint&   endpoint    = gEndpoints[conn.endpointIdx];
+    uint64_t    latency     = getTimestampUs() - conn.startTimestamp;
+
+    if (UINT32_MAX < latency)
+    {
+        latency = UINT32_MAX;
+    }
+
+    if ((200U > conn.statusCode) ||
+        (300U <= conn.statusCode))
+    {
+        ++endpoint.errors;
+        ++gErrorCnt;
+    }
+    else
+    {
+        recordSample(endpoint.samples, endpoint.requests, static_cast<uint32_t>(latency));
+        recordSample(gSamples, gSampleCnt, static_cast<uint32_t>(latency));
+    }
+
+    ++conn.servedCnt;
+
+    if ((false == gIsKeepAlive) ||
+        (true == conn.isClose))
+    {
+        closeSocket(conn);
+    }
+
+    startRequest(conn);
+
+    return;
+}
+
+/**
+ * Handle the finished connect.
+ *
+ * @param[in] conn  Connection
+ */
+static void handleConnect(Connection& conn)
+{
+    int         error   = 0;
+    socklen_t   len     = sizeof(error);
+
+    if ((0 != getsockopt(conn.fd, SOL_SOCKET, SO_ERROR, &error, &len)) ||
+        (0 != error))
+    {
+        failRequest(conn);
+    }
+    else
+    {
+        conn.state = CONN_STATE_SEND;
+        handleSend(conn);
+    }
+
+    return;
+}
+
+/**
+ * Send the rest of the request.
+ *
+ * @param[in] conn  Connection
+ */
+static void handleSend(Connection& conn)
+{
+    ssize_t written = send(conn.fd, &conn.request[conn.requestIdx], conn.requestSize - conn.requestIdx, MSG_NOSIGNAL);
+
+    if (0 <= written)
+    {
+        conn.requestIdx += static_cast<size_t>(written);
+
+        if (conn.requestSize <= conn.requestIdx)
+        {
+            conn.state              = CONN_STATE_RECEIVE;
+            conn.rspState           = RSP_STATE_STATUS_LINE;
+            conn.lineLen            = 0U;
+            conn.rspSize            = 0U;
+            conn.statusCode         = 0U;
+            conn.isChunked          = false;
+            conn.isClose            = false;
+            conn.hasContentLength   = false;
+            conn.remaining          = 0U;
+        }
+    }
+    else if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+    {
+        /* Nothing to do. */
+        ;
+    }
+    else
+    {
+        failRequest(conn);
+    }
+
+    return;
+}
+
+/**
+ * Receive the available reply data.
+ *
+ * If a kept open connection is closed by the server before the reply
+ * started, the server closed it in the meantime, e.g. because of its idle
+ * timeout. The request is sent again once on a new connection.
+ *
+ * @param[in] conn  Connection
+ */
+static void handleReceive(Connection& conn)
+{
+    char    buffer[512];
+    ssize_t received    = recv(conn.fd, buffer, sizeof(buffer), 0);
+
+    if (0 < received)
+    {
+        ssize_t idx = 0;
+
+        conn.rspSize += static_cast<size_t>(received);
+
+        while((received > idx) && (RSP_STATE_COMPLETE != conn.rspState) && (RSP_STATE_ERROR != conn.rspState))
+        {
+            parseReply(conn, buffer[idx]);
+            ++idx;
+        }
+
+        if (RSP_STATE_COMPLETE == conn.rspState)
+        {
+            finishRequest(conn);
+        }
+        else if (RSP_STATE_ERROR == conn.rspState)
+        {
+            failRequest(conn);
+        }
+        else
+        {
+            /* Wait for more data. */
+            ;
+        }
+    }
+    else if ((0 > received) &&
+             ((EAGAIN == errno) || (EWOULDBLOCK == errno)))
+    {
+        /* Nothing to do. */
+        ;
+    }
+    else if (RSP_STATE_BODY_UNTIL_CLOSE == conn.rspState)
+    {
+        conn.isClose = true;
+        finishRequest(conn);
+    }
+    else if ((0U == conn.rspSize) &&
+             (0U < conn.servedCnt) &&
+             (false == conn.isRetried))
+    {
+        closeSocket(conn);
+        ++gRetryCnt;
+
+        conn.requestIdx = 0U;
+        openSocket(conn);
+        conn.isRetried  = true;
+    }
+    else
+    {
+        failRequest(conn);
+    }
+
+    return;
+}
+
+/**
+ * Parse a single byte of the reply.
+ *
+ * @param[in] conn  Connection
+ * @param[in] data  Received byte
+ */
+static void parseReply(Connection& conn, char data)
+{
+    if ((RSP_STATE_BODY == conn.rspState) ||
+        (RSP_STATE_CHUNK_DATA == conn.rspState))
+    {
+        --conn.remaining;
+
+        if (0U == conn.remaining)
+        {
+            conn.rspState = (RSP_STATE_BODY == conn.rspState) ? RSP_STATE_COMPLETE : RSP_STATE_CHUNK_END;
+        }
+    }
+    else if (RSP_STATE_BODY_UNTIL_CLOSE == conn.rspState)
+    {
+        /* The body ends with the connection. */
+        ;
+    }
+    else if ('\r' == data)
+    {
+        /* Skipped, the line ends with the line feed. */
+        ;
+    }
+    else if ('\n' == data)
+    {
+        conn.line[conn.lineLen] = '\0';
+
+        handleReplyLine(conn);
+
+        conn.lineLen = 0U;
+    }
+    else if (MAX_LINE_LEN <= conn.lineLen)
+    {
+        /* Too long lines are truncated, no used header field is that long. */
+        ;
+    }
+    else
+    {
+        conn.line[conn.lineLen] = data;
+        ++conn.lineLen;
+    }
+
+    return;
+}
+
+/**
+ * Handle a complete line of the reply.
+ *
+ * @param[in] conn  Connection
+ */
+static void handleReplyLine(Connection& conn)
+{
+    switch(conn.rspState)
+    {
+    case RSP_STATE_STATUS_LINE:
+        /* E.g. "HTTP/1.1 200 OK" */
+        if ((0 != strncmp(conn.line, "HTTP/1.", 7U)) ||
+            (nullptr == strchr(conn.line, ' ')))
+        {
+            conn.rspState = RSP_STATE_ERROR;
+        }
+        else
+        {
+            conn.statusCode = static_cast<uint16_t>(atoi(strchr(conn.line, ' ') + 1));
+            conn.isClose    = (0 == strncmp(conn.line, "HTTP/1.0", 8U));
+            conn.rspState   = RSP_STATE_HEADER;
+        }
+        break;
+
+    case RSP_STATE_HEADER:
+        if (0U == conn.lineLen)
+        {
+            /* End of header */
+            if (true == conn.isChunked)
+            {
+                conn.rspState = RSP_STATE_CHUNK_SIZE;
+            }
+            else if (false == conn.hasContentLength)
+            {
+                conn.rspState = RSP_STATE_BODY_UNTIL_CLOSE;
+            }
+            else if (0U == conn.remaining)
+            {
+                conn.rspState = RSP_STATE_COMPLETE;
+            }
+            else
+            {
+                conn.rspState = RSP_STATE_BODY;
+            }
+        }
+        else if (0 == strncasecmp(conn.line, "Content-Length:", 15U))
+        {
+            conn.remaining          = strtoul(&conn.line[15U], nullptr, 10);
+            conn.hasContentLength   = true;
+        }
+        else if (0 == strncasecmp(conn.line, "Transfer-Encoding:", 18U))
+        {
+            conn.isChunked = (nullptr != strstr(&conn.line[18U], "chunked"));
+        }
+        else if (0 == strncasecmp(conn.line, "Connection:", 11U))
+        {
+            conn.isClose = (nullptr != strstr(&conn.line[11U], "close"));
+        }
+        else
+        {
+            /* Header field not used. */
+            ;
+        }
+        break;
+
+    case RSP_STATE_CHUNK_SIZE:
+        conn.remaining = strtoul(conn.line, nullptr, 16);
+
+        if (0U == conn.remaining)
+        {
+            conn.rspState = RSP_STATE_TRAILER;
+        }
+        else
+        {
+            conn.rspState = RSP_STATE_CHUNK_DATA;
+        }
+        break;
+
+    case RSP_STATE_CHUNK_END:
+        conn.rspState = RSP_STATE_CHUNK_SIZE;
+        break;
+
+    case RSP_STATE_TRAILER:
+        if (0U == conn.lineLen)
+        {
+            conn.rspState = RSP_STATE_COMPLETE;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return;
+}
+
+/**
+ * Record a latency sample. If the samples are full, the request is only
+ * counted.
+ *
+ * @param[in]       samples Latency samples in us
+ * @param[in,out]   cnt     Number of recorded requests
+ * @param[in]       latency Latency in us
+ */
+static void recordSample(uint32_t* samples, uint32_t& cnt, uint32_t latency)
+{
+    if ((nullptr != samples) &&
+        (MAX_SAMPLES > cnt))
+    {
+        samples[cnt] = latency;
+    }
+
+    ++cnt;
+
+    return;
+}
+
+/**
+ * Compare two latency samples, used to sort them.
+ *
+ * @param[in] a First sample
+ * @param[in] b Second sample
+ *
+ * @return Less than, equal to or greater than 0, if the first sample is less, equal or greater.
+ */
+static int compareSamples(const void* a, const void* b)
+{
+    uint32_t sampleA = *static_cast<const uint32_t*>(a);
+    uint32_t sampleB = *static_cast<const uint32_t*>(b);
+
+    return (sampleA < sampleB) ? -1 : ((sampleA > sampleB) ? 1 : 0);
+}
+
+/**
+ * Get the percentile of the sorted latency samples, with the nearest rank
+ * method.
+ *
+ * @param[in] samples   Sorted latency samples in us
+ * @param[in] cnt       Number of samples
+ * @param[in] percent   Percentile in %
+ *
+ * @return Latency in us
+ */
+static uint32_t getPercentile(const uint32_t* samples, uint32_t cnt, uint8_t percent)
+{
+    uint32_t latency = 0U;
+
+    if (0U < cnt)
+    {
+        uint32_t rank = static_cast<uint32_t>(((static_cast<uint64_t>(cnt) * percent) + 99U) / 100U);
+
+        if (0U == rank)
+        {
+            rank = 1U;
+        }
+
+        latency = samples[rank - 1U];
+    }
+
+    return latency;
+}
+
+/**
+ * Write the result of a endpoint or of all requests.
+ *
+ * @param[in] uri       URI or "total"
+ * @param[in] samples   Latency samples in us, which are sorted
+ * @param[in] requests  Number of successful requests
+ * @param[in] errors    Number of failed requests
+ * @param[in] duration  Duration in s
+ */
+static void writeResult(const char* uri, uint32_t* samples, uint32_t requests, uint32_t errors, double duration)
+{
+    uint32_t cnt = (MAX_SAMPLES < requests) ? MAX_SAMPLES : requests;
+
+    if (nullptr == samples)
+    {
+        cnt = 0U;
+    }
+
+    qsort(samples, cnt, sizeof(uint32_t), compareSamples);
+
+    printf("{\"uri\":\"%s\",\"requests\":%u,\"errors\":%u,\"throughput\":%.1f,\"latencyMsP50\":%.2f,\"latencyMsP95\":%.2f,\"latencyMsP99\":%.2f,\"latencyMsMax\":%.2f}\n",
+        uri,
+        requests,
+        errors,
+        requests / duration,
+        getPercentile(samples, cnt, 50U) / 1000.0,
+        getPercentile(samples, cnt, 95U) / 1000.0,
+        getPercentile(samples, cnt, 99U) / 1000.0,
+        getPercentile(samples, cnt, 100U) / 1000.0);
+
+    return;
+}
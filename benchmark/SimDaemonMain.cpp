@@ -0,0 +1,354 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Simulated heatpump on a pseudo terminal
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * The simulated heatpump controller is served on a Linux pseudo terminal,
+ * configured like the real serial line with 19200 8N1. The native server or
+ * any serial tool talks to it through real terminal I/O, therefore the
+ * system call and buffer overhead is part of every end-to-end measurement.
+ *
+ * Usage: program [link] [seed] [dropByte extraByte bitFlip wrongDevAddr delay silence]
+ *
+ * The pseudo terminal is available via the optional symbolic link, e.g.
+ * /tmp/rego6xx. The fault probabilities are in %, by default no fault is
+ * injected. The daemon runs until it is interrupted.
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "Rego6xxCtrl.h"
+#include "Rego6xxSim.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static void handleSignal(int signalNumber);
+static int openPseudoTerminal(int& slaveFd);
+static void receiveCmd(int masterFd);
+static void transmitRsp(int masterFd);
+
+/******************************************************************************
+ * Variables
+ *****************************************************************************/
+
+/** Baudrate of the serial line in bit/s, like the real heatpump. */
+static const uint32_t       BAUDRATE            = 19200U;
+
+/** Processing delay of the heatpump controller in ms. */
+static const uint32_t       PROCESSING_DELAY    = 20U;
+
+/**
+ * Max. pause in ms between the bytes of a command. A incomplete command is
+ * discarded after it, like the real controller resynchronizes.
+ */
+static const uint32_t       CMD_GAP_TIMEOUT     = 20U;
+
+/** Poll period in ms, which paces the response bytes. */
+static const int            POLL_PERIOD         = 1;
+
+/** Simulated heatpump controller */
+static Rego6xxSim           gSim;
+
+/** Command, which is currently received. */
+static uint8_t              gCmd[Rego6xxCtrl::CMD_SIZE];
+
+/** Number of received bytes of the current command. */
+static uint8_t              gCmdSize            = 0U;
+
+/** Timestamp in ms of the last received byte. */
+static uint32_t             gRxTimestamp        = 0U;
+
+/** Runs until a signal stops it. */
+static volatile sig_atomic_t gIsRunning         = 1;
+
+/******************************************************************************
+ * External functions
+ *****************************************************************************/
+
+/**
+ * Main entry point
+ *
+ * @param[in] argc  Number of command line arguments
+ * @param[in] argv  Command line arguments
+ *
+ * @return Exit code
+ */
+extern int main(int argc, char **argv)
+{
+    int         exitCode    = 0;
+    int         slaveFd     = -1;
+    int         masterFd    = openPseudoTerminal(slaveFd);
+    const char* link        = (1 < argc) ? argv[1] : nullptr;
+    uint8_t     idx         = 0U;
+
+    /* Output shall be shown immediately, like on the serial console. */
+    (void)setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    if (2 < argc)
+    {
+        gSim.setFaultSeed(strtoul(argv[2], nullptr, 0));
+    }
+
+    while(Rego6xxSim::FAULT_COUNT > idx)
+    {
+        if ((3 + idx) < argc)
+        {
+            gSim.setFaultProbability(static_cast<Rego6xxSim::Fault>(idx), static_cast<uint8_t>(atoi(argv[3 + idx])));
+        }
+
+        ++idx;
+    }
+
+    if (nullptr != link)
+    {
+        (void)unlink(link);
+    }
+
+    if (0 > masterFd)
+    {
+        fprintf(stderr, "Pseudo terminal not available.\n");
+        exitCode = 1;
+    }
+    else if ((nullptr != link) &&
+             (0 != symlink(ptsname(masterFd), link)))
+    {
+        fprintf(stderr, "Link %s not created.\n", link);
+        exitCode = 1;
+    }
+    else
+    {
+        struct pollfd fds;
+
+        (void)signal(SIGINT, handleSignal);
+        (void)signal(SIGTERM, handleSignal);
+
+        gSim.setBaudrate(BAUDRATE);
+        gSim.setProcessingDelay(PROCESSING_DELAY);
+
+        printf("Heatpump simulated on %s.\n", (nullptr != link) ? link : ptsname(masterFd));
+
+        fds.fd      = masterFd;
+        fds.events  = POLLIN;
+
+        while(0 != gIsRunning)
+        {
+            fds.revents = 0;
+
+            /* The timeout paces the response bytes, which become available
+             * one by one at the speed of the serial line.
+             */
+            if (0 < poll(&fds, 1U, POLL_PERIOD))
+            {
+                receiveCmd(masterFd);
+            }
+
+            transmitRsp(masterFd);
+        }
+
+        printf("Heatpump simulation stopped.\n");
+    }
+
+    if (nullptr != link)
+    {
+        (void)unlink(link);
+    }
+
+    if (0 <= slaveFd)
+    {
+        (void)close(slaveFd);
+    }
+
+    if (0 <= masterFd)
+    {
+        (void)close(masterFd);
+    }
+
+    return exitCode;
+}
+
+/******************************************************************************
+ * Local functions
+ *****************************************************************************/
+
+/**
+ * Stop the daemon.
+ *
+ * @param[in] signalNumber  Signal number
+ */
+static void handleSignal(int signalNumber)
+{
+    (void)signalNumber;
+
+    gIsRunning = 0;
+
+    return;
+}
+
+/**
+ * Open a pseudo terminal, which is configured raw with 19200 8N1.
+ *
+ * The slave side is kept open by the daemon, otherwise the master side
+ * reports a error every time the client closes it.
+ *
+ * @param[out] slaveFd  File descriptor of the slave side
+ *
+ * @return File descriptor of the master side. If it fails, it will return -1.
+ */
+static int openPseudoTerminal(int& slaveFd)
+{
+    int masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    slaveFd = -1;
+
+    if (0 > masterFd)
+    {
+        /* Nothing to do. */
+        ;
+    }
+    else if ((0 != grantpt(masterFd)) ||
+             (0 != unlockpt(masterFd)))
+    {
+        (void)close(masterFd);
+        masterFd = -1;
+    }
+    else
+    {
+        struct termios tio;
+
+        slaveFd = open(ptsname(masterFd), O_RDWR | O_NOCTTY);
+
+        if ((0 <= slaveFd) &&
+            (0 == tcgetattr(slaveFd, &tio)))
+        {
+            cfmakeraw(&tio);
+            tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+            tio.c_cflag |= CLOCAL | CREAD;
+            (void)cfsetispeed(&tio, B19200);
+            (void)cfsetospeed(&tio, B19200);
+            (void)tcsetattr(slaveFd, TCSANOW, &tio);
+        }
+
+        /* The master side shall never block the simulation. */
+        (void)fcntl(masterFd, F_SETFL, fcntl(masterFd, F_GETFL) | O_NONBLOCK);
+    }
+
+    return masterFd;
+}
+
+/**
+ * Receive the command bytes, which are available. A complete command is
+ * passed to the simulator.
+ *
+ * @param[in] masterFd  File descriptor of the master side
+ */
+static void receiveCmd(int masterFd)
+{
+    uint8_t buffer[32U];
+    ssize_t size    = read(masterFd, buffer, sizeof(buffer));
+    ssize_t idx     = 0;
+
+    /* A pause in the middle of a command discards it. */
+    if ((0U < gCmdSize) &&
+        (CMD_GAP_TIMEOUT < (millis() - gRxTimestamp)))
+    {
+        printf("Incomplete command discarded.\n");
+        gCmdSize = 0U;
+    }
+
+    while(size > idx)
+    {
+        /* Every command starts with the device address of the heatpump. */
+        if ((0U < gCmdSize) ||
+            (Rego6xxCtrl::DEV_ADDR_HEATPUMP == buffer[idx]))
+        {
+            gCmd[gCmdSize] = buffer[idx];
+            ++gCmdSize;
+        }
+
+        if (Rego6xxCtrl::CMD_SIZE <= gCmdSize)
+        {
+            (void)gSim.write(gCmd, gCmdSize);
+            gCmdSize = 0U;
+        }
+
+        ++idx;
+    }
+
+    if (0 < size)
+    {
+        gRxTimestamp = millis();
+    }
+
+    return;
+}
+
+/**
+ * Transmit the response bytes, which became available.
+ *
+ * @param[in] masterFd  File descriptor of the master side
+ */
+static void transmitRsp(int masterFd)
+{
+    uint8_t buffer[32U];
+    size_t  size    = 0U;
+
+    while((sizeof(buffer) > size) && (0 < gSim.available()))
+    {
+        buffer[size] = static_cast<uint8_t>(gSim.read());
+        ++size;
+    }
+
+    /* Without a client the bytes are lost, like on a open serial line. */
+    if (0U < size)
+    {
+        (void)write(masterFd, buffer, size);
+    }
+
+    return;
+}
@@ -84,7 +84,7 @@ public:
      * 
      * @return Temperature name
      */
-    String getName() const
+    const String& getName() const
     {
         return m_name;
     }
@@ -50,16 +50,50 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <inttypes.h>
 #include <time.h>
 
 #include "WString.h"
 #include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+#include "HardwareSerial.h"
 
 /******************************************************************************
  * Macros
  *****************************************************************************/
 
+/** Program memory is the same as data memory. */
+#define PSTR(__str)                 (__str)
+
+/** Read a byte from program memory. */
+#define pgm_read_byte(__addr)       (*reinterpret_cast<const uint8_t*>(__addr))
+
+/** Read a word from program memory. */
+#define pgm_read_word(__addr)       (*reinterpret_cast<const uint16_t*>(__addr))
+
+/** Read a double word from program memory. */
+#define pgm_read_dword(__addr)      (*reinterpret_cast<const uint32_t*>(__addr))
+
+/** Read a pointer from program memory. */
+#define pgm_read_ptr(__addr)        (*reinterpret_cast<void* const*>(__addr))
+
+/* String functions, which work on program memory. */
+#define strlen_P                    strlen
+#define strcpy_P                    strcpy
+#define strncpy_P                   strncpy
+#define strcmp_P                    strcmp
+#define strncmp_P                   strncmp
+#define strcasecmp_P                strcasecmp
+#define strncasecmp_P               strncasecmp
+#define strstr_P                    strstr
+#define memcpy_P                    memcpy
+#define memcmp_P                    memcmp
+#define sprintf_P                   sprintf
+#define snprintf_P                  snprintf
+#define vsnprintf_P                 vsnprintf
+
 /******************************************************************************
  * Types and Classes
  *****************************************************************************/
@@ -67,18 +101,42 @@
 /** Arduino boolean */
 typedef bool boolean;
 
+/** Arduino byte */
+typedef uint8_t byte;
+
 /******************************************************************************
  * Functions
  *****************************************************************************/
 
-static unsigned long millis()
+static inline unsigned long millis()
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return static_cast<unsigned long>((now.tv_sec * 1000UL) + (now.tv_nsec / 1000000UL));
+}
+
+static inline unsigned long micros()
 {
-    clock_t now = clock();
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return static_cast<unsigned long>((now.tv_sec * 1000000UL) + (now.tv_nsec / 1000UL));
+}
+
+static inline void delay(unsigned long ms)
+{
+    struct timespec duration;
+
+    duration.tv_sec     = ms / 1000UL;
+    duration.tv_nsec    = (ms % 1000UL) * 1000000UL;
 
-    return (now * 1000UL) / CLOCKS_PER_SEC;
+    (void)nanosleep(&duration, nullptr);
 }
 
-static uint32_t esp_log_timestamp(void)
+static inline uint32_t esp_log_timestamp(void)
 {
     return millis();
 }
@@ -0,0 +1,249 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Ethernet client
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "EthernetClient.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/sockios.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+int EthernetClient::connect(const IPAddress& ip, uint16_t port)
+{
+    int                 result  = 0;
+    struct sockaddr_in  addr;
+    struct timeval      timeout;
+
+    stop();
+
+    /* The send timeout limits the connect too. */
+    timeout.tv_sec  = m_connectTimeout / 1000U;
+    timeout.tv_usec = (m_connectTimeout % 1000U) * 1000U;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(port);
+    memcpy(&addr.sin_addr.s_addr, ip.raw(), sizeof(addr.sin_addr.s_addr));
+
+    m_fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (0 > m_fd)
+    {
+        /* Nothing to do. */
+        ;
+    }
+    else if ((0 != setsockopt(m_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout))) ||
+             (0 != ::connect(m_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr))))
+    {
+        stop();
+    }
+    else
+    {
+        int flag = 1;
+
+        (void)setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+        (void)fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+
+        result = 1;
+    }
+
+    return result;
+}
+
+uint8_t EthernetClient::connected()
+{
+    uint8_t isConnected = 0U;
+
+    if (0 <= m_fd)
+    {
+        uint8_t data    = 0U;
+        ssize_t ret     = recv(m_fd, &data, sizeof(data), MSG_PEEK | MSG_DONTWAIT);
+
+        /* Data available or nothing received yet? A closed connection
+         * returns 0 after all data is read.
+         */
+        if ((0 < ret) ||
+            ((0 > ret) && ((EAGAIN == errno) || (EWOULDBLOCK == errno))))
+        {
+            isConnected = 1U;
+        }
+    }
+
+    return isConnected;
+}
+
+int EthernetClient::available()
+{
+    int size = 0;
+
+    if (0 <= m_fd)
+    {
+        if (0 != ioctl(m_fd, FIONREAD, &size))
+        {
+            size = 0;
+        }
+    }
+
+    return size;
+}
+
+int EthernetClient::read()
+{
+    int data = -1;
+
+    if (0 <= m_fd)
+    {
+        uint8_t value = 0U;
+
+        if (1 == recv(m_fd, &value, sizeof(value), MSG_DONTWAIT))
+        {
+            data = value;
+        }
+    }
+
+    return data;
+}
+
+int EthernetClient::peek()
+{
+    int data = -1;
+
+    if (0 <= m_fd)
+    {
+        uint8_t value = 0U;
+
+        if (1 == recv(m_fd, &value, sizeof(value), MSG_PEEK | MSG_DONTWAIT))
+        {
+            data = value;
+        }
+    }
+
+    return data;
+}
+
+size_t EthernetClient::write(uint8_t data)
+{
+    return write(&data, sizeof(data));
+}
+
+size_t EthernetClient::write(const uint8_t *buffer, size_t size)
+{
+    size_t written = 0U;
+
+    if (0 <= m_fd)
+    {
+        ssize_t ret = send(m_fd, buffer, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+        if (0 < ret)
+        {
+            written = static_cast<size_t>(ret);
+        }
+    }
+
+    return written;
+}
+
+int EthernetClient::availableForWrite()
+{
+    int         size        = 0;
+    int         sendBufSize = 0;
+    int         outQueue    = 0;
+    socklen_t   optLen      = sizeof(sendBufSize);
+
+    if ((0 <= m_fd) &&
+        (0 == getsockopt(m_fd, SOL_SOCKET, SO_SNDBUF, &sendBufSize, &optLen)) &&
+        (0 == ioctl(m_fd, SIOCOUTQ, &outQueue)) &&
+        (sendBufSize > outQueue))
+    {
+        size = sendBufSize - outQueue;
+    }
+
+    return size;
+}
+
+void EthernetClient::stop()
+{
+    if (0 <= m_fd)
+    {
+        (void)close(m_fd);
+        m_fd = -1;
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,237 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Ethernet client implementation for test
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ */
+
+#ifndef __ETHERNET_CLIENT_H__
+#define __ETHERNET_CLIENT_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Stream.h"
+#include "IPAddress.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Ethernet client class for test purposes only, which is backed by a
+ * non-blocking POSIX TCP socket.
+ *
+ * Like the original, copies refer to the same socket. Stopping one of them
+ * closes the socket for all.
+ */
+class EthernetClient : public Stream
+{
+public:
+
+    /**
+     * Constructs a unconnected client.
+     */
+    EthernetClient() :
+        Stream(),
+        m_fd(-1),
+        m_connectTimeout(DEFAULT_CONNECT_TIMEOUT)
+    {
+    }
+
+    /**
+     * Constructs a client for a already connected socket.
+     *
+     * @param[in] fd    Socket file descriptor
+     */
+    explicit EthernetClient(int fd) :
+        Stream(),
+        m_fd(fd),
+        m_connectTimeout(DEFAULT_CONNECT_TIMEOUT)
+    {
+    }
+
+    /**
+     * Destroys the client, without closing the socket.
+     */
+    ~EthernetClient()
+    {
+    }
+
+    /**
+     * Set the max. duration of a connect.
+     *
+     * @param[in] timeout   Timeout in ms
+     */
+    void setConnectionTimeout(uint16_t timeout)
+    {
+        m_connectTimeout = timeout;
+    }
+
+    /**
+     * Connect to a server. It blocks until connected or the connection
+     * timeout is exceeded.
+     *
+     * @param[in] ip    IP-address of the server
+     * @param[in] port  Port of the server
+     *
+     * @return If connected, it will return 1 otherwise 0.
+     */
+    int connect(const IPAddress& ip, uint16_t port);
+
+    /**
+     * Is the client connected or is still received data available?
+     *
+     * @return If connected, it will return 1 otherwise 0.
+     */
+    uint8_t connected();
+
+    /**
+     * Get the number of available data bytes.
+     *
+     * @return Number of available data bytes.
+     */
+    int available() override;
+
+    /**
+     * Read a single data byte.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int read() override;
+
+    /**
+     * Read a single data byte, without removing it from the stream.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int peek() override;
+
+    /**
+     * Write a single data byte.
+     *
+     * @param[in] data  Data byte
+     * @return Number of written data bytes.
+     */
+    size_t write(uint8_t data) override;
+
+    /**
+     * Write several data bytes. Only as much as fits into the socket send
+     * buffer is written.
+     *
+     * @param[in] buffer    Data buffer
+     * @param[in] size      Data buffer size
+     * @return Number of written data bytes.
+     */
+    size_t write(const uint8_t *buffer, size_t size) override;
+
+    using Print::write;
+
+    /**
+     * Get the number of data bytes, which can be written without blocking.
+     *
+     * @return Number of data bytes
+     */
+    int availableForWrite() override;
+
+    /**
+     * Nothing to flush, the data is sent by the socket.
+     */
+    void flush() override
+    {
+    }
+
+    /**
+     * Close the connection.
+     */
+    void stop();
+
+    /**
+     * Is the client valid?
+     *
+     * @return If valid, it will return true otherwise false.
+     */
+    operator bool() const
+    {
+        return (0 <= m_fd);
+    }
+
+    /**
+     * Refers the client to the same socket?
+     *
+     * @param[in] client    Other client
+     *
+     * @return If same socket, it will return true otherwise false.
+     */
+    bool operator==(const EthernetClient& client) const
+    {
+        return (m_fd == client.m_fd);
+    }
+
+    /**
+     * Refers the client to another socket?
+     *
+     * @param[in] client    Other client
+     *
+     * @return If another socket, it will return true otherwise false.
+     */
+    bool operator!=(const EthernetClient& client) const
+    {
+        return (m_fd != client.m_fd);
+    }
+
+private:
+
+    /** Default max. duration of a connect in ms. */
+    static const uint16_t   DEFAULT_CONNECT_TIMEOUT = 5000U;
+
+    int         m_fd;               /**< Socket file descriptor. -1 means unconnected. */
+    uint16_t    m_connectTimeout;   /**< Max. duration of a connect in ms */
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __ETHERNET_CLIENT_H__ */
+
+/** @} */
@@ -0,0 +1,181 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Ethernet implementation for test
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ */
+
+#ifndef __ETHERNET_ENC_H__
+#define __ETHERNET_ENC_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+
+#include "IPAddress.h"
+#include "EthernetClient.h"
+#include "EthernetServer.h"
+#include "EthernetUdp.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/** Ethernet link status */
+enum EthernetLinkStatus
+{
+    Unknown = 0,    /**< Unknown */
+    LinkON,         /**< Link is up */
+    LinkOFF         /**< Link is down */
+};
+
+/** Ethernet hardware status */
+enum EthernetHardwareStatus
+{
+    EthernetNoHardware = 0, /**< No hardware found */
+    EthernetW5100,          /**< W5100 */
+    EthernetW5200,          /**< W5200 */
+    EthernetW5500,          /**< W5500 */
+    EthernetENC28J60 = 10   /**< ENC28J60 */
+};
+
+/**
+ * Ethernet interface class for test purposes only.
+ * The sockets use the network interfaces of the host, therefore the link
+ * is always up and the addresses are the loopback ones.
+ */
+class EthernetClass
+{
+public:
+
+    /**
+     * Initialize the interface with DHCP.
+     *
+     * @param[in] mac   MAC address, which is ignored.
+     *
+     * @return Always 1 for success.
+     */
+    int begin(const uint8_t* mac)
+    {
+        (void)mac;
+        return 1;
+    }
+
+    /**
+     * Maintain the DHCP lease.
+     *
+     * @return Always 0 for nothing happened.
+     */
+    int maintain()
+    {
+        return 0;
+    }
+
+    /**
+     * Get the link status.
+     *
+     * @return Link status
+     */
+    EthernetLinkStatus linkStatus()
+    {
+        return LinkON;
+    }
+
+    /**
+     * Get the hardware status.
+     *
+     * @return Hardware status
+     */
+    EthernetHardwareStatus hardwareStatus()
+    {
+        return EthernetENC28J60;
+    }
+
+    /**
+     * Get the local IP-address.
+     *
+     * @return IP-address
+     */
+    IPAddress localIP()
+    {
+        return IPAddress(127U, 0U, 0U, 1U);
+    }
+
+    /**
+     * Get the subnet mask.
+     *
+     * @return Subnet mask
+     */
+    IPAddress subnetMask()
+    {
+        return IPAddress(255U, 0U, 0U, 0U);
+    }
+
+    /**
+     * Get the gateway IP-address.
+     *
+     * @return IP-address
+     */
+    IPAddress gatewayIP()
+    {
+        return IPAddress(127U, 0U, 0U, 1U);
+    }
+
+    /**
+     * Get the DNS server IP-address.
+     *
+     * @return IP-address
+     */
+    IPAddress dnsServerIP()
+    {
+        return IPAddress(127U, 0U, 0U, 1U);
+    }
+};
+
+/** Ethernet interface */
+extern EthernetClass Ethernet;
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __ETHERNET_ENC_H__ */
+
+/** @} */
@@ -0,0 +1,147 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Ethernet server
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "EthernetServer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+EthernetServer::~EthernetServer()
+{
+    if (0 <= m_fd)
+    {
+        (void)close(m_fd);
+    }
+}
+
+void EthernetServer::begin()
+{
+    /* Max. number of pending connections */
+    const int           BACKLOG = 16;
+    struct sockaddr_in  addr;
+    int                 flag    = 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family         = AF_INET;
+    addr.sin_port           = htons(m_port);
+    addr.sin_addr.s_addr    = htonl(INADDR_ANY);
+
+    m_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+
+    if (0 > m_fd)
+    {
+        perror("socket");
+    }
+    else if ((0 != setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag))) ||
+             (0 != bind(m_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr))) ||
+             (0 != listen(m_fd, BACKLOG)))
+    {
+        perror("server");
+        (void)close(m_fd);
+        m_fd = -1;
+    }
+    else
+    {
+        /* Listening. */
+        ;
+    }
+
+    return;
+}
+
+EthernetClient EthernetServer::accept()
+{
+    EthernetClient client;
+
+    if (0 <= m_fd)
+    {
+        int fd = accept4(m_fd, nullptr, nullptr, SOCK_NONBLOCK);
+
+        if (0 <= fd)
+        {
+            int flag = 1;
+
+            (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+            client = EthernetClient(fd);
+        }
+    }
+
+    return client;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,126 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Ethernet server implementation for test
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ */
+
+#ifndef __ETHERNET_SERVER_H__
+#define __ETHERNET_SERVER_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Print.h"
+#include "EthernetClient.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Ethernet server class for test purposes only, which is backed by a
+ * non-blocking POSIX TCP socket, listening on all interfaces.
+ */
+class EthernetServer : public Print
+{
+public:
+
+    /**
+     * Constructs a server, which is not listening yet.
+     *
+     * @param[in] port  Port to listen on
+     */
+    EthernetServer(uint16_t port) :
+        Print(),
+        m_port(port),
+        m_fd(-1)
+    {
+    }
+
+    /**
+     * Destroys the server.
+     */
+    ~EthernetServer();
+
+    /**
+     * Start listening.
+     */
+    void begin();
+
+    /**
+     * Accept a new client connection.
+     *
+     * @return Client. If there is no new connection, the client is invalid.
+     */
+    EthernetClient accept();
+
+    /**
+     * Writing to all clients is not supported.
+     *
+     * @param[in] data  Data byte
+     * @return Number of written data bytes.
+     */
+    size_t write(uint8_t data) override
+    {
+        (void)data;
+        return 0U;
+    }
+
+    using Print::write;
+
+private:
+
+    uint16_t    m_port; /**< Port to listen on */
+    int         m_fd;   /**< Socket file descriptor. -1 means not listening. */
+
+    EthernetServer(const EthernetServer& server);
+    EthernetServer& operator=(const EthernetServer& server);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __ETHERNET_SERVER_H__ */
+
+/** @} */
@@ -0,0 +1,165 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Ethernet UDP
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "EthernetUdp.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+EthernetUDP::~EthernetUDP()
+{
+    if (0 <= m_fd)
+    {
+        (void)close(m_fd);
+    }
+}
+
+uint8_t EthernetUDP::begin(uint16_t port)
+{
+    uint8_t             result  = 0U;
+    struct sockaddr_in  addr;
+    int                 flag    = 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family         = AF_INET;
+    addr.sin_port           = htons(port);
+    addr.sin_addr.s_addr    = htonl(INADDR_ANY);
+
+    m_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+
+    if (0 > m_fd)
+    {
+        /* Nothing to do. */
+        ;
+    }
+    else if ((0 != setsockopt(m_fd, SOL_SOCKET, SO_BROADCAST, &flag, sizeof(flag))) ||
+             (0 != bind(m_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr))))
+    {
+        (void)close(m_fd);
+        m_fd = -1;
+    }
+    else
+    {
+        result = 1U;
+    }
+
+    return result;
+}
+
+int EthernetUDP::beginPacket(const IPAddress& ip, uint16_t port)
+{
+    m_addr          = ip;
+    m_port          = port;
+    m_packetSize    = 0U;
+
+    return (0 <= m_fd) ? 1 : 0;
+}
+
+int EthernetUDP::endPacket()
+{
+    int                 result  = 0;
+    struct sockaddr_in  addr;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(m_port);
+    memcpy(&addr.sin_addr.s_addr, m_addr.raw(), sizeof(addr.sin_addr.s_addr));
+
+    if ((0 <= m_fd) &&
+        (0 <= sendto(m_fd, m_packet, m_packetSize, 0, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr))))
+    {
+        result = 1;
+    }
+
+    m_packetSize = 0U;
+
+    return result;
+}
+
+size_t EthernetUDP::write(uint8_t data)
+{
+    size_t written = 0U;
+
+    if (MAX_PACKET_SIZE > m_packetSize)
+    {
+        m_packet[m_packetSize] = data;
+        ++m_packetSize;
+
+        written = 1U;
+    }
+
+    return written;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
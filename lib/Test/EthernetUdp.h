@@ -0,0 +1,173 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Ethernet UDP implementation for test
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ */
+
+#ifndef __ETHERNET_UDP_H__
+#define __ETHERNET_UDP_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Stream.h"
+#include "IPAddress.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Ethernet UDP class for test purposes only, which is backed by a POSIX UDP
+ * socket. Only sending is supported.
+ */
+class EthernetUDP : public Stream
+{
+public:
+
+    /** Max. packet size in bytes. */
+    static const size_t MAX_PACKET_SIZE = 512U;
+
+    /**
+     * Constructs a closed UDP socket.
+     */
+    EthernetUDP() :
+        Stream(),
+        m_fd(-1),
+        m_addr(),
+        m_port(0U),
+        m_packet(),
+        m_packetSize(0U)
+    {
+    }
+
+    /**
+     * Destroys the UDP socket.
+     */
+    ~EthernetUDP();
+
+    /**
+     * Open the socket on the given local port.
+     *
+     * @param[in] port  Local port
+     *
+     * @return If successful, it will return 1 otherwise 0.
+     */
+    uint8_t begin(uint16_t port);
+
+    /**
+     * Start a packet to the given destination.
+     *
+     * @param[in] ip    Destination IP-address
+     * @param[in] port  Destination port
+     *
+     * @return If successful, it will return 1 otherwise 0.
+     */
+    int beginPacket(const IPAddress& ip, uint16_t port);
+
+    /**
+     * Send the packet.
+     *
+     * @return If successful, it will return 1 otherwise 0.
+     */
+    int endPacket();
+
+    /**
+     * Write a single data byte to the packet.
+     *
+     * @param[in] data  Data byte
+     * @return Number of written data bytes.
+     */
+    size_t write(uint8_t data) override;
+
+    using Print::write;
+
+    /**
+     * Receiving is not supported.
+     *
+     * @return Number of available data bytes.
+     */
+    int available() override
+    {
+        return 0;
+    }
+
+    /**
+     * Receiving is not supported.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int read() override
+    {
+        return -1;
+    }
+
+    /**
+     * Receiving is not supported.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int peek() override
+    {
+        return -1;
+    }
+
+private:
+
+    int         m_fd;                       /**< Socket file descriptor. -1 means closed. */
+    IPAddress   m_addr;                     /**< Destination IP-address */
+    uint16_t    m_port;                     /**< Destination port */
+    uint8_t     m_packet[MAX_PACKET_SIZE];  /**< Packet, which to send */
+    size_t      m_packetSize;               /**< Packet size in bytes */
+
+    EthernetUDP(const EthernetUDP& udp);
+    EthernetUDP& operator=(const EthernetUDP& udp);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __ETHERNET_UDP_H__ */
+
+/** @} */
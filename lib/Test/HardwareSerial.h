@@ -0,0 +1,166 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Hardware serial implementation for test
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ */
+
+#ifndef __HARDWARE_SERIAL_H__
+#define __HARDWARE_SERIAL_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Stream.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Serial interface class for test purposes only.
+ * Written data is forwarded to stdout, nothing is received.
+ */
+class HardwareSerial : public Stream
+{
+public:
+
+    /**
+     * Constructs a serial interface object.
+     */
+    HardwareSerial() :
+        Stream()
+    {
+    }
+
+    /**
+     * Destroys a serial interface object.
+     */
+    ~HardwareSerial()
+    {
+    }
+
+    /**
+     * Open the serial interface.
+     *
+     * @param[in] baudrate  Baudrate in bit/s, which is ignored.
+     */
+    void begin(unsigned long baudrate)
+    {
+        (void)baudrate;
+    }
+
+    /**
+     * Get the number of available data bytes.
+     *
+     * @return Number of available data bytes.
+     */
+    int available() override
+    {
+        return 0;
+    }
+
+    /**
+     * Read a single data byte.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int read() override
+    {
+        return -1;
+    }
+
+    /**
+     * Read a single data byte, without removing it from the stream.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int peek() override
+    {
+        return -1;
+    }
+
+    /**
+     * Write a single data byte to stdout.
+     *
+     * @param[in] data  Data byte
+     * @return Number of written data bytes.
+     */
+    size_t write(uint8_t data) override;
+
+    /**
+     * Write several data bytes to stdout.
+     *
+     * @param[in] buffer    Data buffer
+     * @param[in] size      Data buffer size
+     * @return Number of written data bytes.
+     */
+    size_t write(const uint8_t *buffer, size_t size) override;
+
+    using Print::write;
+
+    /**
+     * Flush stdout.
+     */
+    void flush() override;
+
+    /**
+     * Is the serial interface ready?
+     *
+     * @return Always true.
+     */
+    operator bool() const
+    {
+        return true;
+    }
+};
+
+/** Serial interface */
+extern HardwareSerial Serial;
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __HARDWARE_SERIAL_H__ */
+
+/** @} */
@@ -0,0 +1,157 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  IP-address implementation for test
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ */
+
+#ifndef __IPADDRESS_H__
+#define __IPADDRESS_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <string.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * IPv4 address class for test purposes only.
+ */
+class IPAddress
+{
+public:
+
+    /**
+     * Constructs the IP-address 0.0.0.0.
+     */
+    IPAddress() :
+        m_addr()
+    {
+    }
+
+    /**
+     * Constructs a IP-address from its octets.
+     *
+     * @param[in] octet1    First octet
+     * @param[in] octet2    Second octet
+     * @param[in] octet3    Third octet
+     * @param[in] octet4    Fourth octet
+     */
+    IPAddress(uint8_t octet1, uint8_t octet2, uint8_t octet3, uint8_t octet4) :
+        m_addr()
+    {
+        m_addr[0] = octet1;
+        m_addr[1] = octet2;
+        m_addr[2] = octet3;
+        m_addr[3] = octet4;
+    }
+
+    /**
+     * Constructs a IP-address from a octet array.
+     *
+     * @param[in] addr  Four octets
+     */
+    IPAddress(const uint8_t* addr) :
+        m_addr()
+    {
+        memcpy(m_addr, addr, sizeof(m_addr));
+    }
+
+    /**
+     * Get a single octet.
+     *
+     * @param[in] idx   Octet index
+     *
+     * @return Octet
+     */
+    uint8_t operator[](int idx) const
+    {
+        return m_addr[idx];
+    }
+
+    /**
+     * Get a single octet for modification.
+     *
+     * @param[in] idx   Octet index
+     *
+     * @return Octet
+     */
+    uint8_t& operator[](int idx)
+    {
+        return m_addr[idx];
+    }
+
+    /**
+     * Compare with another IP-address.
+     *
+     * @param[in] addr  IP-address
+     *
+     * @return If equal, it will return true otherwise false.
+     */
+    bool operator==(const IPAddress& addr) const
+    {
+        return (0 == memcmp(m_addr, addr.m_addr, sizeof(m_addr)));
+    }
+
+    /**
+     * Get the octets in network byte order.
+     *
+     * @return Four octets
+     */
+    const uint8_t* raw() const
+    {
+        return m_addr;
+    }
+
+private:
+
+    uint8_t m_addr[4];  /**< Octets */
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __IPADDRESS_H__ */
+
+/** @} */
@@ -35,6 +35,8 @@
 #include "Print.h"
 
 #include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
 
 /******************************************************************************
  * Compiler Switches
@@ -87,6 +89,11 @@ size_t Print::print(const String &s)
     return write(s.c_str(), s.length());
 }
 
+size_t Print::print(const __FlashStringHelper *s)
+{
+    return write(reinterpret_cast<const char*>(s));
+}
+
 size_t Print::print(const char str[])
 {
     return write(str);
@@ -113,6 +120,49 @@ size_t Print::print(long n, int base)
     }
 }
 
+size_t Print::print(unsigned char n, int base)
+{
+    return print(static_cast<unsigned long>(n), base);
+}
+
+size_t Print::print(int n, int base)
+{
+    return print(static_cast<long>(n), base);
+}
+
+size_t Print::print(unsigned int n, int base)
+{
+    return print(static_cast<unsigned long>(n), base);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+    if(base == 0) {
+        return write(n);
+    } else {
+        return printNumber(n, base);
+    }
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char    buf[256];
+    va_list args;
+    int     len;
+
+    va_start(args, format);
+    len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    if(len < 0) {
+        return 0;
+    }
+    if(static_cast<size_t>(len) >= sizeof(buf)) {
+        len = sizeof(buf) - 1;
+    }
+    return write(buf, len);
+}
+
 size_t Print::println()
 {
     return print("\r\n");
@@ -125,6 +175,20 @@ size_t Print::println(const String &s)
     return n;
 }
 
+size_t Print::println(const char str[])
+{
+    size_t n = print(str);
+    n += println();
+    return n;
+}
+
+size_t Print::println(const __FlashStringHelper *s)
+{
+    size_t n = print(s);
+    n += println();
+    return n;
+}
+
 /******************************************************************************
  * Protected Methods
  *****************************************************************************/
@@ -123,6 +123,31 @@ public:
      */
     size_t write(const char *buffer, size_t size);
 
+    /**
+     * Get the number of data bytes, which can be written without blocking.
+     *
+     * @return Number of data bytes
+     */
+    virtual int availableForWrite()
+    {
+        return 0;
+    }
+
+    /**
+     * Wait until all data is written.
+     */
+    virtual void flush()
+    {
+    }
+
+    /**
+     * Print a string from program memory.
+     *
+     * @param[in] s String
+     * @return Number of written characters.
+     */
+    size_t print(const __FlashStringHelper *s);
+
     /**
      * Print a string.
      *
@@ -156,6 +181,51 @@ public:
      */
     size_t print(long n, int base = DEC);
 
+    /**
+     * Print a unsigned character as number.
+     *
+     * @param[in] n     Number
+     * @param[in] base  Number base
+     * @return Number of written characters.
+     */
+    size_t print(unsigned char n, int base = DEC);
+
+    /**
+     * Print a integer.
+     *
+     * @param[in] n     Integer
+     * @param[in] base  Number base
+     * @return Number of written characters.
+     */
+    size_t print(int n, int base = DEC);
+
+    /**
+     * Print a unsigned integer.
+     *
+     * @param[in] n     Unsigned integer
+     * @param[in] base  Number base
+     * @return Number of written characters.
+     */
+    size_t print(unsigned int n, int base = DEC);
+
+    /**
+     * Print a unsigned long integer.
+     *
+     * @param[in] n     Unsigned long integer
+     * @param[in] base  Number base
+     * @return Number of written characters.
+     */
+    size_t print(unsigned long n, int base = DEC);
+
+    /**
+     * Print formatted, like printf().
+     *
+     * @param[in] format    Format string
+     * @param[in] ...       Arguments
+     * @return Number of written characters.
+     */
+    size_t printf(const char *format, ...);
+
     /**
      * Print a cariage return and new line.
      *
@@ -171,6 +241,23 @@ public:
      */
     size_t println(const String &s);
 
+    /**
+     * Print a string with a carriage return and new line at the end.
+     *
+     * @param[in] str   String
+     * @return Number of written characters.
+     */
+    size_t println(const char str[]);
+
+    /**
+     * Print a string from program memory with a carriage return and new
+     * line at the end.
+     *
+     * @param[in] s String
+     * @return Number of written characters.
+     */
+    size_t println(const __FlashStringHelper *s);
+
 private:
 
     /**
@@ -0,0 +1,287 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Serial port
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "SerialPort.h"
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static speed_t getSpeed(uint32_t baudrate);
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+bool SerialPort::open(const char* device, uint32_t baudrate)
+{
+    bool    isSuccessful    = false;
+    speed_t speed           = getSpeed(baudrate);
+
+    close();
+
+    /* Opened non-blocking, otherwise it may wait for the carrier. */
+    m_fd = ::open(device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+    if (0 > m_fd)
+    {
+        /* Nothing to do. */
+        ;
+    }
+    else if (B0 == speed)
+    {
+        close();
+    }
+    else
+    {
+        struct termios tio;
+
+        if (0 != tcgetattr(m_fd, &tio))
+        {
+            close();
+        }
+        else
+        {
+            /* Raw 8N1, the modem control lines are ignored. A read returns
+             * immediately, with the data which is available.
+             */
+            cfmakeraw(&tio);
+            tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+            tio.c_cflag |= CLOCAL | CREAD;
+            tio.c_cc[VMIN]  = 0;
+            tio.c_cc[VTIME] = 0;
+            (void)cfsetispeed(&tio, speed);
+            (void)cfsetospeed(&tio, speed);
+
+            if (0 != tcsetattr(m_fd, TCSANOW, &tio))
+            {
+                close();
+            }
+            else
+            {
+                /* Writes shall block, until the data is taken over. */
+                (void)fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) & ~O_NONBLOCK);
+                (void)tcflush(m_fd, TCIOFLUSH);
+
+                isSuccessful = true;
+            }
+        }
+    }
+
+    return isSuccessful;
+}
+
+void SerialPort::close()
+{
+    if (0 <= m_fd)
+    {
+        (void)::close(m_fd);
+        m_fd = -1;
+    }
+
+    m_peek = -1;
+
+    return;
+}
+
+int SerialPort::available()
+{
+    int size = 0;
+
+    if (0 <= m_fd)
+    {
+        if (0 != ioctl(m_fd, FIONREAD, &size))
+        {
+            size = 0;
+        }
+    }
+
+    if (0 <= m_peek)
+    {
+        ++size;
+    }
+
+    return size;
+}
+
+int SerialPort::read()
+{
+    int data = m_peek;
+
+    if (0 <= m_peek)
+    {
+        m_peek = -1;
+    }
+    else if (0 <= m_fd)
+    {
+        uint8_t value = 0U;
+
+        if (1 == ::read(m_fd, &value, sizeof(value)))
+        {
+            data = value;
+        }
+    }
+    else
+    {
+        /* Nothing to do. */
+        ;
+    }
+
+    return data;
+}
+
+int SerialPort::peek()
+{
+    /* A terminal device can't peek, therefore the byte is kept until it is read. */
+    if (0 > m_peek)
+    {
+        m_peek = read();
+    }
+
+    return m_peek;
+}
+
+size_t SerialPort::write(uint8_t data)
+{
+    return write(&data, sizeof(data));
+}
+
+size_t SerialPort::write(const uint8_t *buffer, size_t size)
+{
+    size_t  written = 0U;
+    bool    isError = (0 > m_fd);
+
+    while((size > written) && (false == isError))
+    {
+        ssize_t ret = ::write(m_fd, &buffer[written], size - written);
+
+        if (0 >= ret)
+        {
+            isError = true;
+        }
+        else
+        {
+            written += static_cast<size_t>(ret);
+        }
+    }
+
+    return written;
+}
+
+void SerialPort::flush()
+{
+    if (0 <= m_fd)
+    {
+        (void)tcdrain(m_fd);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+/**
+ * Get the terminal speed of a baudrate.
+ *
+ * @param[in] baudrate  Baudrate in bit/s
+ *
+ * @return Terminal speed. If the baudrate is not supported, it will return B0.
+ */
+static speed_t getSpeed(uint32_t baudrate)
+{
+    speed_t speed = B0;
+
+    switch(baudrate)
+    {
+    case 9600U:
+        speed = B9600;
+        break;
+
+    case 19200U:
+        speed = B19200;
+        break;
+
+    case 38400U:
+        speed = B38400;
+        break;
+
+    case 57600U:
+        speed = B57600;
+        break;
+
+    case 115200U:
+        speed = B115200;
+        break;
+
+    default:
+        break;
+    }
+
+    return speed;
+}
@@ -0,0 +1,172 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Serial port implementation for test
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ */
+
+#ifndef __SERIAL_PORT_H__
+#define __SERIAL_PORT_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Stream.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Serial port class for test purposes only, which is backed by a
+ * non-blocking POSIX terminal device, e.g. a USB serial adapter or the
+ * pseudo terminal of the simulator daemon. The device is used raw with
+ * 8 data bits, no parity and 1 stop bit.
+ */
+class SerialPort : public Stream
+{
+public:
+
+    /**
+     * Constructs a closed serial port.
+     */
+    SerialPort() :
+        Stream(),
+        m_fd(-1),
+        m_peek(-1)
+    {
+    }
+
+    /**
+     * Destroys the serial port and closes it.
+     */
+    ~SerialPort()
+    {
+        close();
+    }
+
+    /**
+     * Open the serial port.
+     *
+     * @param[in] device    Device name, e.g. /dev/ttyUSB0
+     * @param[in] baudrate  Baudrate in bit/s
+     *
+     * @return If successful opened, it will return true otherwise false.
+     */
+    bool open(const char* device, uint32_t baudrate);
+
+    /**
+     * Close the serial port.
+     */
+    void close();
+
+    /**
+     * Is the serial port open?
+     *
+     * @return If open, it will return true otherwise false.
+     */
+    bool isOpen() const
+    {
+        return (0 <= m_fd);
+    }
+
+    /**
+     * Get the number of available data bytes.
+     *
+     * @return Number of available data bytes.
+     */
+    int available() override;
+
+    /**
+     * Read a single data byte.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int read() override;
+
+    /**
+     * Read a single data byte, without removing it from the stream.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int peek() override;
+
+    /**
+     * Write a single data byte.
+     *
+     * @param[in] data  Data byte
+     * @return Number of written data bytes.
+     */
+    size_t write(uint8_t data) override;
+
+    /**
+     * Write several data bytes.
+     *
+     * @param[in] buffer    Data buffer
+     * @param[in] size      Data buffer size
+     * @return Number of written data bytes.
+     */
+    size_t write(const uint8_t *buffer, size_t size) override;
+
+    using Print::write;
+
+    /**
+     * Wait until all written data bytes are transmitted.
+     */
+    void flush() override;
+
+private:
+
+    int m_fd;   /**< File descriptor of the terminal device */
+    int m_peek; /**< Data byte, which was peeked but not read yet. -1 if none. */
+
+    SerialPort(const SerialPort& port);
+    SerialPort& operator=(const SerialPort& port);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __SERIAL_PORT_H__ */
+
+/** @} */
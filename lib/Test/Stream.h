@@ -0,0 +1,142 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Stream implementation for test
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ */
+
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Print.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Stream class for test purposes only.
+ * Reading with timeout is not supported, only the data which is already
+ * available is read.
+ */
+class Stream : public Print
+{
+public:
+
+    /**
+     * Constructs a stream object.
+     */
+    Stream() :
+        Print()
+    {
+    }
+
+    /**
+     * Destroys a stream object.
+     */
+    virtual ~Stream()
+    {
+    }
+
+    /**
+     * Get the number of available data bytes.
+     *
+     * @return Number of available data bytes.
+     */
+    virtual int available() = 0;
+
+    /**
+     * Read a single data byte.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    virtual int read() = 0;
+
+    /**
+     * Read a single data byte, without removing it from the stream.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    virtual int peek() = 0;
+
+    /**
+     * Read several data bytes, which are available.
+     *
+     * @param[out] buffer   Data buffer
+     * @param[in]  length   Data buffer size
+     * @return Number of read data bytes.
+     */
+    size_t readBytes(char* buffer, size_t length);
+
+    /**
+     * Read several data bytes, which are available.
+     *
+     * @param[out] buffer   Data buffer
+     * @param[in]  length   Data buffer size
+     * @return Number of read data bytes.
+     */
+    size_t readBytes(uint8_t* buffer, size_t length)
+    {
+        return readBytes(reinterpret_cast<char*>(buffer), length);
+    }
+
+    /**
+     * Set the max. time to wait for data. Not supported.
+     *
+     * @param[in] timeout   Timeout in ms
+     */
+    void setTimeout(unsigned long timeout)
+    {
+        (void)timeout;
+    }
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __STREAM_H__ */
+
+/** @} */
@@ -45,15 +45,23 @@
  *****************************************************************************/
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <ctype.h>
 
 /******************************************************************************
  * Macros
  *****************************************************************************/
 
+/** Strings in program memory are the same as strings in data memory. */
+#define F(__str)    (reinterpret_cast<const __FlashStringHelper*>(__str))
+
 /******************************************************************************
  * Types and Classes
  *****************************************************************************/
 
+/** Marks a string in program memory. */
+class __FlashStringHelper;
+
 /**
  * String class for test purposes only.
  */
@@ -174,6 +182,76 @@ public:
         }
     }
 
+    /**
+     * Constructs a string from program memory.
+     *
+     * @param[in] str String
+     */
+    String(const __FlashStringHelper* str) :
+        String(reinterpret_cast<const char*>(str))
+    {
+    }
+
+    /**
+     * Constructs a string from a number.
+     *
+     * @param[in] value Number
+     * @param[in] base  Number base
+     */
+    explicit String(int value, unsigned char base = 10U) :
+        String()
+    {
+        appendNumber((0 > value) ? -static_cast<unsigned long>(value) : value, (0 > value), base);
+    }
+
+    /**
+     * Constructs a string from a number.
+     *
+     * @param[in] value Number
+     * @param[in] base  Number base
+     */
+    explicit String(unsigned int value, unsigned char base = 10U) :
+        String()
+    {
+        appendNumber(value, false, base);
+    }
+
+    /**
+     * Constructs a string from a number.
+     *
+     * @param[in] value Number
+     * @param[in] base  Number base
+     */
+    explicit String(long value, unsigned char base = 10U) :
+        String()
+    {
+        appendNumber((0 > value) ? -static_cast<unsigned long>(value) : value, (0 > value), base);
+    }
+
+    /**
+     * Constructs a string from a number.
+     *
+     * @param[in] value Number
+     * @param[in] base  Number base
+     */
+    explicit String(unsigned long value, unsigned char base = 10U) :
+        String()
+    {
+        appendNumber(value, false, base);
+    }
+
+    /**
+     * Constructs a string from a number.
+     *
+     * @param[in] value Number
+     * @param[in] base  Number base
+     */
+    explicit String(unsigned char value, unsigned char base = 10U) :
+        String()
+    {
+        appendNumber(value, false, base);
+    }
+
     /**
      * Assign a string.
      *
@@ -301,6 +379,219 @@ public:
         return *this;
     }
 
+    String& operator +=(const char* str)
+    {
+        (void)concat(str);
+        return *this;
+    }
+
+    String& operator +=(const __FlashStringHelper* str)
+    {
+        (void)concat(str);
+        return *this;
+    }
+
+    String& operator +=(int value)
+    {
+        (void)concat(value);
+        return *this;
+    }
+
+    String& operator +=(unsigned int value)
+    {
+        (void)concat(value);
+        return *this;
+    }
+
+    String& operator +=(long value)
+    {
+        (void)concat(value);
+        return *this;
+    }
+
+    String& operator +=(unsigned long value)
+    {
+        (void)concat(value);
+        return *this;
+    }
+
+    String& operator +=(unsigned char value)
+    {
+        (void)concat(value);
+        return *this;
+    }
+
+    /**
+     * Append a string.
+     *
+     * @param[in] str   String
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool concat(const String& str)
+    {
+        return concat(str.c_str(), str.length());
+    }
+
+    /**
+     * Append a string.
+     *
+     * @param[in] str   String
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool concat(const char* str)
+    {
+        return (nullptr == str) ? false : concat(str, strlen(str));
+    }
+
+    /**
+     * Append a string from program memory.
+     *
+     * @param[in] str   String
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool concat(const __FlashStringHelper* str)
+    {
+        return concat(reinterpret_cast<const char*>(str));
+    }
+
+    /**
+     * Append a character.
+     *
+     * @param[in] c Character
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool concat(char c)
+    {
+        return concat(&c, 1U);
+    }
+
+    /**
+     * Append a number.
+     *
+     * @param[in] value Number
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool concat(int value)
+    {
+        return concat(static_cast<long>(value));
+    }
+
+    /**
+     * Append a number.
+     *
+     * @param[in] value Number
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool concat(unsigned int value)
+    {
+        return appendNumber(value, false, 10U);
+    }
+
+    /**
+     * Append a number.
+     *
+     * @param[in] value Number
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool concat(long value)
+    {
+        return appendNumber((0 > value) ? -static_cast<unsigned long>(value) : value, (0 > value), 10U);
+    }
+
+    /**
+     * Append a number.
+     *
+     * @param[in] value Number
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool concat(unsigned long value)
+    {
+        return appendNumber(value, false, 10U);
+    }
+
+    /**
+     * Append a number.
+     *
+     * @param[in] value Number
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool concat(unsigned char value)
+    {
+        return appendNumber(value, false, 10U);
+    }
+
+    /**
+     * Append several characters.
+     *
+     * @param[in] str   Characters
+     * @param[in] len   Number of characters
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool concat(const char* str, unsigned int len)
+    {
+        bool            isSuccessful    = false;
+        unsigned int    strLen          = length();
+
+        if (true == reserve(strLen + len))
+        {
+            memcpy(&m_buffer[strLen], str, len);
+            m_buffer[strLen + len] = '\0';
+
+            isSuccessful = true;
+        }
+
+        return isSuccessful;
+    }
+
+    /**
+     * Reserve memory for the given string length.
+     *
+     * @param[in] size  String length in characters
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool reserve(unsigned int size)
+    {
+        bool isSuccessful = true;
+
+        if (m_size <= size)
+        {
+            char* tmp = new char[size + 1U];
+
+            if (nullptr == tmp)
+            {
+                isSuccessful = false;
+            }
+            else
+            {
+                if (nullptr == m_buffer)
+                {
+                    tmp[0] = '\0';
+                }
+                else
+                {
+                    strcpy(tmp, m_buffer);
+                    delete[] m_buffer;
+                }
+
+                m_buffer    = tmp;
+                m_size      = size + 1U;
+            }
+        }
+
+        return isSuccessful;
+    }
+
     String operator +(const String& str) const
     {
         String tmp = *this;
@@ -436,6 +727,218 @@ public:
         return 0 == strncmp(&m_buffer[offset], s2.m_buffer, s2.length());
     }
 
+    /**
+     * Ends string with given pattern?
+     *
+     * @param[in] s2    Pattern
+     *
+     * @return If string ends with pattern, it will return true otherwise false.
+     */
+    unsigned char endsWith(const String &s2) const
+    {
+        if(length() < s2.length())
+        {
+            return 0U;
+        }
+
+        return startsWith(s2, length() - s2.length());
+    }
+
+    /**
+     * Is string equal to the other one?
+     *
+     * @param[in] str   Other string
+     *
+     * @return If equal, it will return true otherwise false.
+     */
+    unsigned char equals(const String& str) const
+    {
+        return (*this == str) ? 1U : 0U;
+    }
+
+    /**
+     * Is string equal to the other one, ignoring the case?
+     *
+     * @param[in] str   Other string
+     *
+     * @return If equal, it will return true otherwise false.
+     */
+    unsigned char equalsIgnoreCase(const String& str) const
+    {
+        return (0 == strcasecmp(c_str(), str.c_str())) ? 1U : 0U;
+    }
+
+    /**
+     * Get the index of the first occurrence of a character.
+     *
+     * @param[in] c         Character
+     * @param[in] fromIndex Index, where to start searching
+     *
+     * @return Index of the character. If not found, it will return -1.
+     */
+    int indexOf(char c, unsigned int fromIndex = 0U) const
+    {
+        int             index   = -1;
+        const char*     found   = nullptr;
+
+        if (length() > fromIndex)
+        {
+            found = strchr(&c_str()[fromIndex], c);
+        }
+
+        if (nullptr != found)
+        {
+            index = static_cast<int>(found - c_str());
+        }
+
+        return index;
+    }
+
+    /**
+     * Get the index of the first occurrence of a string.
+     *
+     * @param[in] str       String
+     * @param[in] fromIndex Index, where to start searching
+     *
+     * @return Index of the string. If not found, it will return -1.
+     */
+    int indexOf(const String& str, unsigned int fromIndex = 0U) const
+    {
+        int             index   = -1;
+        const char*     found   = nullptr;
+
+        if (length() >= fromIndex)
+        {
+            found = strstr(&c_str()[fromIndex], str.c_str());
+        }
+
+        if (nullptr != found)
+        {
+            index = static_cast<int>(found - c_str());
+        }
+
+        return index;
+    }
+
+    /**
+     * Get the index of the last occurrence of a character.
+     *
+     * @param[in] c Character
+     *
+     * @return Index of the character. If not found, it will return -1.
+     */
+    int lastIndexOf(char c) const
+    {
+        int         index   = -1;
+        const char* found   = strrchr(c_str(), c);
+
+        if (nullptr != found)
+        {
+            index = static_cast<int>(found - c_str());
+        }
+
+        return index;
+    }
+
+    /**
+     * Get a single character.
+     *
+     * @param[in] index Index
+     *
+     * @return Character. If index is out of range, it will return '\0'.
+     */
+    char charAt(unsigned int index) const
+    {
+        return (*this)[index];
+    }
+
+    /**
+     * Set a single character.
+     *
+     * @param[in] index Index
+     * @param[in] c     Character
+     */
+    void setCharAt(unsigned int index, char c)
+    {
+        if (length() > index)
+        {
+            m_buffer[index] = c;
+        }
+    }
+
+    /**
+     * Convert to a integer number.
+     *
+     * @return Number. If invalid, it will return 0.
+     */
+    long toInt() const
+    {
+        return atol(c_str());
+    }
+
+    /**
+     * Convert to a floating point number.
+     *
+     * @return Number. If invalid, it will return 0.
+     */
+    float toFloat() const
+    {
+        return static_cast<float>(atof(c_str()));
+    }
+
+    /**
+     * Convert all characters to lower case.
+     */
+    void toLowerCase()
+    {
+        unsigned int idx = 0U;
+
+        while(length() > idx)
+        {
+            m_buffer[idx] = static_cast<char>(tolower(m_buffer[idx]));
+            ++idx;
+        }
+    }
+
+    /**
+     * Convert all characters to upper case.
+     */
+    void toUpperCase()
+    {
+        unsigned int idx = 0U;
+
+        while(length() > idx)
+        {
+            m_buffer[idx] = static_cast<char>(toupper(m_buffer[idx]));
+            ++idx;
+        }
+    }
+
+    /**
+     * Remove leading and trailing whitespace.
+     */
+    void trim()
+    {
+        unsigned int    begin   = 0U;
+        unsigned int    end     = length();
+
+        while((end > begin) && (0 != isspace(m_buffer[begin])))
+        {
+            ++begin;
+        }
+
+        while((end > begin) && (0 != isspace(m_buffer[end - 1U])))
+        {
+            --end;
+        }
+
+        if (nullptr != m_buffer)
+        {
+            memmove(m_buffer, &m_buffer[begin], end - begin);
+            m_buffer[end - begin] = '\0';
+        }
+    }
+
     /**
      * Clear string.
      */
@@ -454,6 +957,46 @@ private:
     size_t  m_size;     /**< String buffer size */
     char*   m_buffer;   /**< String buffer */
 
+    /**
+     * Append a number.
+     *
+     * @param[in] value         Absolute value of the number
+     * @param[in] isNegative    Is the number negative?
+     * @param[in] base          Number base
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool appendNumber(unsigned long value, bool isNegative, unsigned char base)
+    {
+        char    buffer[8U * sizeof(long) + 2U];
+        char*   str     = &buffer[sizeof(buffer) - 1U];
+
+        *str = '\0';
+
+        if (2U > base)
+        {
+            base = 10U;
+        }
+
+        do
+        {
+            unsigned long digit = value % base;
+
+            --str;
+            *str    = (10U > digit) ? static_cast<char>('0' + digit) : static_cast<char>('A' + digit - 10U);
+            value  /= base;
+        }
+        while(0U < value);
+
+        if (true == isNegative)
+        {
+            --str;
+            *str = '-';
+        }
+
+        return concat(str);
+    }
+
 };
 
 /******************************************************************************
@@ -34,8 +34,6 @@ char_map = {
 }
 
 ROOT_MENU_ROW_4 = 'W?rme   Info    Men?'
-BACK_BUTTON_ROW_4 = 'Zur?ck'
-CANCEL_BUTTON_ROW_4 = 'Abbr.'
 
 action_list = [{
     'row': 4,
@@ -170,46 +168,50 @@ def turn_wheel_right(base_uri):
     """
     return manipulate_keyboard(base_uri, 'wheelTR')
 
+def run_macro(base_uri, root_row, root_expected, steps):
+    """Run a front panel macro on the server. The server navigates to the
+    root menu, executes all steps and aborts to the root menu on failure.
+
+    Args:
+        base_uri (str): The base URI of the server.
+        root_row (int): Display row [1; 4], which identifies the root menu.
+        root_expected (str): Expected text in the root menu row.
+        steps (list): Steps with row, expected text and action.
+
+    Returns:
+        dict: The JSON response or None if the request failed.
+    """
+    json_doc = None
+    dst_url = base_uri + '/api/frontPanel/macro'
+    macro = {
+        'root': {
+            'row': root_row,
+            'expected': root_expected
+        },
+        'steps': steps
+    }
+    response = requests.post(dst_url, json=macro)
+
+    if response.status_code == 200:
+        # The response may contain control characters, therefore disable strict parsing.
+        json_doc = response.json(strict=False)
+
+    return json_doc
+
 if __name__ == '__main__':
 
     RET_VAL = 0 # Success
 
-    # The menu shall be in the root menu
-    row_4 = get_display_content(HEATPUMP_URL, 4)
-    while row_4 != ROOT_MENU_ROW_4:
-        if row_4.startswith(BACK_BUTTON_ROW_4) or row_4.startswith(CANCEL_BUTTON_ROW_4):
-            if press_left_button(HEATPUMP_URL) is False:
-                RET_VAL = 1 # Error
-                break
-            else:
-                row_4 = get_display_content(HEATPUMP_URL, 4)
-        else:
-            RET_VAL = 2 # Error
-            break
-
-    if RET_VAL == 0:
-        # Execute the actions in the action list to trigger
-        # extra warm water.
-        for action in action_list:
-
-            # Get expected string on the display from the specified row.
-            # This will be used to check whether we are in the correct menu
-            # and to avoid configuring something bad.
-            row_content = get_display_content(HEATPUMP_URL, action['row'])
-
-            # Does the expected string on the display not match?
-            if row_content.startswith(action['expected']) is False:
-                show_display(HEATPUMP_URL)
-                print('Expected: "' + action['expected'] + '"')
-                RET_VAL = 3 # Error
-                break
-            else:
-                # We are in the correct menu, execute action on HMI.
-                if manipulate_keyboard(HEATPUMP_URL, action['action']) is False:
-                    print('Invalid action.')
-                    RET_VAL = 4 # Error
-                    break
-
-    #show_display(HEATPUMP_URL)
+    # Execute the actions in the action list to trigger extra warm water.
+    # The expected strings on the display are used to check whether we are
+    # in the correct menu and to avoid configuring something bad.
+    rsp = run_macro(HEATPUMP_URL, 4, ROOT_MENU_ROW_4, action_list)
+
+    if rsp is None:
+        RET_VAL = 1 # Error
+    elif rsp['status'] != 0:
+        show_display(HEATPUMP_URL)
+        print('Macro failed in step ' + str(rsp['data']['step']) + ' with status ' + str(rsp['status']) + '.')
+        RET_VAL = 3 # Error
 
     sys.exit(RET_VAL)
@@ -0,0 +1,117 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Event ring buffer
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "EventRing.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void EventRing::push(Type type, uint8_t id, int16_t value)
+{
+    Event& event = m_events[m_nextSeq % MAX_EVENTS];
+
+    event.seq   = m_nextSeq;
+    event.type  = type;
+    event.id    = id;
+    event.value = value;
+
+    ++m_nextSeq;
+
+    if (MAX_EVENTS > m_cnt)
+    {
+        ++m_cnt;
+    }
+
+    return;
+}
+
+bool EventRing::read(uint16_t& seq, Event& event) const
+{
+    bool        isRead      = false;
+    uint16_t    oldestSeq   = m_nextSeq - m_cnt;
+
+    /* The sequence numbers wrap around, therefore only the distances are compared. */
+    if (static_cast<uint16_t>(seq - oldestSeq) > m_cnt)
+    {
+        /* Events were overwritten, continue with the oldest one. */
+        seq = oldestSeq;
+    }
+
+    if (seq != m_nextSeq)
+    {
+        event   = m_events[seq % MAX_EVENTS];
+        isRead  = true;
+
+        ++seq;
+    }
+
+    return isRead;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
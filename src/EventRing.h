@@ -0,0 +1,154 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Event ring buffer
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __EVENT_RING_H__
+#define __EVENT_RING_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Ring buffer of state change events with a single writer and any number
+ * of readers. Every event gets a sequence number and every reader keeps the
+ * sequence number of the next event it wants to read. The writer never
+ * waits for a reader, it overwrites the oldest event instead. A slow reader
+ * misses the overwritten events and continues with the oldest available one.
+ */
+class EventRing
+{
+public:
+
+    /** Event types */
+    enum Type
+    {
+        TYPE_SENSOR = 0,    /**< Temperature sensor value changed, value in 0.1 °C */
+        TYPE_LED,           /**< Front panel LED changed, value is the state */
+        TYPE_ALARM,         /**< Alarm changed, value is the state */
+        TYPE_WRITE          /**< Temperature write completed, value is the status */
+    };
+
+    /**
+     * A single event.
+     */
+    struct Event
+    {
+        uint16_t    seq;    /**< Sequence number */
+        uint8_t     type;   /**< Event type */
+        uint8_t     id;     /**< Id of the source, depends on the type */
+        int16_t     value;  /**< Value, depends on the type */
+    };
+
+    /** Max. number of events in the ring buffer. */
+    static const uint8_t    MAX_EVENTS  = 8U;
+
+    /**
+     * Constructs a empty event ring buffer.
+     */
+    EventRing() :
+        m_events(),
+        m_nextSeq(0U),
+        m_cnt(0U)
+    {
+    }
+
+    /**
+     * Destroys the event ring buffer.
+     */
+    ~EventRing()
+    {
+    }
+
+    /**
+     * Push a event into the ring buffer. If the ring buffer is full, the
+     * oldest event will be overwritten.
+     *
+     * @param[in] type  Event type
+     * @param[in] id    Id of the source
+     * @param[in] value Value
+     */
+    void push(Type type, uint8_t id, int16_t value);
+
+    /**
+     * Get sequence number of the next pushed event. A new reader starts
+     * with it, to get only the events which happen after it was connected.
+     *
+     * @return Sequence number
+     */
+    uint16_t getNextSeq() const
+    {
+        return m_nextSeq;
+    }
+
+    /**
+     * Read the event with the given sequence number. If it was already
+     * overwritten, the oldest available event is read instead.
+     * After a successful read, the sequence number points to the next event.
+     *
+     * @param[in,out]   seq     Sequence number of the event, which to read
+     * @param[out]      event   Event
+     *
+     * @return If a event was read, it will return true otherwise false.
+     */
+    bool read(uint16_t& seq, Event& event) const;
+
+private:
+
+    Event       m_events[MAX_EVENTS];   /**< Events */
+    uint16_t    m_nextSeq;              /**< Sequence number of the next pushed event */
+    uint8_t     m_cnt;                  /**< Number of events in the ring buffer */
+
+    EventRing(const EventRing& ring);
+    EventRing& operator=(const EventRing& ring);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __EVENT_RING_H__ */
+
+/** @} */
@@ -0,0 +1,200 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Front panel LEDs
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "FrontPanelLeds.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** LED names, in the order of the LED ids. */
+static const char*                          LED_NAMES[FrontPanelLeds::LED_ID_MAX]   =
+{
+    "power",
+    "pump",
+    "heating",
+    "boiler",
+    "alarm"
+};
+
+/** LED front panel addresses, in the order of the LED ids. */
+static const Rego6xxCtrl::FrontPanelAddr    LED_ADDRS[FrontPanelLeds::LED_ID_MAX]   =
+{
+    Rego6xxCtrl::FRONTPANEL_ADDR_POWER_LED,
+    Rego6xxCtrl::FRONTPANEL_ADDR_PUMP_LED,
+    Rego6xxCtrl::FRONTPANEL_ADDR_HEATING_LED,
+    Rego6xxCtrl::FRONTPANEL_ADDR_BOILER_LED,
+    Rego6xxCtrl::FRONTPANEL_ADDR_ALARM_LED
+};
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void FrontPanelLeds::setLed(LedId id, bool isOn)
+{
+    if (LED_ID_MAX > id)
+    {
+        uint8_t mask = 1U << id;
+
+        if (isOn != (0U != (m_state & mask)))
+        {
+            m_state             ^= mask;
+            m_changed           |= mask;
+            m_lastChange[id]    = millis();
+        }
+    }
+
+    return;
+}
+
+bool FrontPanelLeds::subscribe(ChangeHandler handler)
+{
+    uint8_t idx         = 0U;
+    bool    isSlotFound = false;
+
+    while((MAX_SUBSCRIBERS > idx) && (false == isSlotFound))
+    {
+        if (nullptr == m_subscribers[idx])
+        {
+            m_subscribers[idx] = handler;
+            isSlotFound = true;
+        }
+        else
+        {
+            ++idx;
+        }
+    }
+
+    return isSlotFound;
+}
+
+void FrontPanelLeds::publish()
+{
+    if (0U != m_changed)
+    {
+        uint8_t idx = 0U;
+
+        while(MAX_SUBSCRIBERS > idx)
+        {
+            if (nullptr != m_subscribers[idx])
+            {
+                m_subscribers[idx](m_changed, m_state);
+            }
+
+            ++idx;
+        }
+
+        m_changed = 0U;
+    }
+
+    return;
+}
+
+const char* FrontPanelLeds::getName(LedId id)
+{
+    const char* name = "";
+
+    if (LED_ID_MAX > id)
+    {
+        name = LED_NAMES[id];
+    }
+
+    return name;
+}
+
+bool FrontPanelLeds::getId(const String& name, LedId& id)
+{
+    uint8_t idx     = 0U;
+    bool    isFound = false;
+
+    while((LED_ID_MAX > idx) && (false == isFound))
+    {
+        if (0 != name.equalsIgnoreCase(LED_NAMES[idx]))
+        {
+            id      = static_cast<LedId>(idx);
+            isFound = true;
+        }
+        else
+        {
+            ++idx;
+        }
+    }
+
+    return isFound;
+}
+
+Rego6xxCtrl::FrontPanelAddr FrontPanelLeds::getAddr(LedId id)
+{
+    Rego6xxCtrl::FrontPanelAddr addr = Rego6xxCtrl::FRONTPANEL_ADDR_POWER_LED;
+
+    if (LED_ID_MAX > id)
+    {
+        addr = LED_ADDRS[id];
+    }
+
+    return addr;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
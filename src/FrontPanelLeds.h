@@ -0,0 +1,216 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Front panel LEDs
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __FRONT_PANEL_LEDS_H__
+#define __FRONT_PANEL_LEDS_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+#include "Rego6xxCtrl.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The state of all front panel LEDs as bitmask, which is updated by polling
+ * the heatpump. Every LED has its own bit and the timestamp of its last change.
+ * Subscribers are notified only about changed bits.
+ */
+class FrontPanelLeds
+{
+public:
+
+    /** LED identifiers, which are the bit positions in the state bitmask. */
+    enum LedId
+    {
+        LED_ID_POWER = 0,   /**< Power LED */
+        LED_ID_PUMP,        /**< Pump LED */
+        LED_ID_HEATING,     /**< Heating LED */
+        LED_ID_BOILER,      /**< Boiler LED */
+        LED_ID_ALARM,       /**< Alarm LED */
+
+        LED_ID_MAX          /**< Value used to determine max. number of LEDs. */
+    };
+
+    /**
+     * LED change handler.
+     *
+     * @param[in] changed   Bitmask of the changed LEDs
+     * @param[in] state     Bitmask of the current LED states
+     */
+    typedef void (*ChangeHandler)(uint8_t changed, uint8_t state);
+
+    /** Max. number of subscribers. */
+    static const uint8_t    MAX_SUBSCRIBERS = 2U;
+
+    /**
+     * Constructs the front panel LEDs, all switched off.
+     */
+    FrontPanelLeds() :
+        m_state(0U),
+        m_changed(0U),
+        m_lastChange(),
+        m_subscribers()
+    {
+    }
+
+    /**
+     * Destroys the front panel LEDs.
+     */
+    ~FrontPanelLeds()
+    {
+    }
+
+    /**
+     * Get the state of all LEDs as bitmask. The bit position is the LED id.
+     *
+     * @return LED bitmask
+     */
+    uint8_t getState() const
+    {
+        return m_state;
+    }
+
+    /**
+     * Get the state of a single LED.
+     *
+     * @param[in] id    LED id
+     *
+     * @return If LED is on, it will return true otherwise false.
+     */
+    bool isOn(LedId id) const
+    {
+        return (0U != (m_state & (1U << id)));
+    }
+
+    /**
+     * Get the timestamp of the last LED change.
+     *
+     * @param[in] id    LED id
+     *
+     * @return Timestamp in ms
+     */
+    uint32_t getLastChange(LedId id) const
+    {
+        uint32_t timestamp = 0U;
+
+        if (LED_ID_MAX > id)
+        {
+            timestamp = m_lastChange[id];
+        }
+
+        return timestamp;
+    }
+
+    /**
+     * Set the polled state of a single LED.
+     * If it changed, the timestamp is updated and the LED is marked for
+     * the next publication.
+     *
+     * @param[in] id    LED id
+     * @param[in] isOn  LED state
+     */
+    void setLed(LedId id, bool isOn);
+
+    /**
+     * Subscribe for LED changes.
+     *
+     * @param[in] handler   Change handler
+     *
+     * @return If successful subscribed, it will return true otherwise false.
+     */
+    bool subscribe(ChangeHandler handler);
+
+    /**
+     * Notify all subscribers about the LEDs, which changed since the last
+     * publication. If nothing changed, nobody will be notified.
+     */
+    void publish();
+
+    /**
+     * Get the LED name.
+     *
+     * @param[in] id    LED id
+     *
+     * @return LED name
+     */
+    static const char* getName(LedId id);
+
+    /**
+     * Get LED id by its name. The name is case insensitive.
+     *
+     * @param[in]   name    LED name
+     * @param[out]  id      LED id
+     *
+     * @return If LED is found, it will return true otherwise false.
+     */
+    static bool getId(const String& name, LedId& id);
+
+    /**
+     * Get the front panel address of the LED.
+     *
+     * @param[in] id    LED id
+     *
+     * @return Front panel address
+     */
+    static Rego6xxCtrl::FrontPanelAddr getAddr(LedId id);
+
+private:
+
+    uint8_t         m_state;                        /**< LED states as bitmask */
+    uint8_t         m_changed;                      /**< Changed LEDs since last publication as bitmask */
+    uint32_t        m_lastChange[LED_ID_MAX];       /**< Timestamps in ms of the last change per LED */
+    ChangeHandler   m_subscribers[MAX_SUBSCRIBERS]; /**< Subscribers, which are notified about changes */
+
+    FrontPanelLeds(const FrontPanelLeds& leds);
+    FrontPanelLeds& operator=(const FrontPanelLeds& leds);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __FRONT_PANEL_LEDS_H__ */
+
+/** @} */
@@ -0,0 +1,476 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Front panel macro
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "FrontPanelMacro.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+bool FrontPanelMacro::clear()
+{
+    bool isCleared = false;
+
+    if (false == isRunning())
+    {
+        m_stepCnt       = 0U;
+        m_stepIdx       = 0U;
+        m_isRootEnabled = false;
+
+        isCleared = true;
+    }
+
+    return isCleared;
+}
+
+bool FrontPanelMacro::setRoot(Rego6xxCtrl::Row row, const char* expected)
+{
+    bool isSet = false;
+
+    if ((false == isRunning()) &&
+        (true == setExpected(m_root, expected)))
+    {
+        m_root.row      = row;
+        m_isRootEnabled = true;
+
+        isSet = true;
+    }
+
+    return isSet;
+}
+
+bool FrontPanelMacro::addStep(Rego6xxCtrl::Row row, const char* expected, Rego6xxCtrl::FrontPanelAddr addr, uint16_t value)
+{
+    bool isAdded = false;
+
+    if ((false == isRunning()) &&
+        (MAX_STEPS > m_stepCnt) &&
+        (true == setExpected(m_steps[m_stepCnt], expected)))
+    {
+        m_steps[m_stepCnt].row      = row;
+        m_steps[m_stepCnt].addr     = addr;
+        m_steps[m_stepCnt].value    = value;
+        ++m_stepCnt;
+
+        isAdded = true;
+    }
+
+    return isAdded;
+}
+
+bool FrontPanelMacro::start(uint32_t stepTimeout)
+{
+    bool isStarted = false;
+
+    if ((false == isRunning()) &&
+        (0U < m_stepCnt))
+    {
+        m_stepIdx       = 0U;
+        m_rootPressCnt  = 0U;
+        m_result        = RESULT_RUNNING;
+        m_stepTimeout   = stepTimeout;
+        m_isAbortReq    = false;
+        m_lastMsg       = "";
+
+        m_pauseTimer.stop();
+
+        if (true == m_isRootEnabled)
+        {
+            m_state = STATE_ROOT_READ;
+        }
+        else
+        {
+            m_state = STATE_STEP_READ;
+            m_stepTimer.start(m_stepTimeout);
+        }
+
+        isStarted = true;
+    }
+
+    return isStarted;
+}
+
+void FrontPanelMacro::abort()
+{
+    if ((STATE_ROOT_READ == m_state) ||
+        (STATE_ROOT_LEAVE == m_state) ||
+        (STATE_STEP_READ == m_state) ||
+        (STATE_STEP_ACTION == m_state))
+    {
+        m_isAbortReq = true;
+    }
+
+    return;
+}
+
+void FrontPanelMacro::process()
+{
+    bool isDone = false;
+
+    /* Pause before the next request to the heatpump? */
+    if ((true == m_pauseTimer.isTimerRunning()) &&
+        (false == m_pauseTimer.isTimeout()))
+    {
+        /* Nothing to do. */
+        ;
+    }
+    /* Abort requested and no heatpump request pending? */
+    else if ((true == m_isAbortReq) &&
+             (nullptr == m_displayRsp) &&
+             (nullptr == m_confirmRsp))
+    {
+        m_pauseTimer.stop();
+        m_isAbortReq = false;
+        finish(RESULT_EABORTED);
+    }
+    else
+    {
+        m_pauseTimer.stop();
+
+        switch(m_state)
+        {
+        case STATE_IDLE:
+            /* Nothing to do. */
+            break;
+
+        case STATE_ROOT_READ:
+            if (false == readRow(m_root.row, isDone))
+            {
+                finish(RESULT_EINVALID);
+            }
+            else if (false == isDone)
+            {
+                /* Wait for display content. */
+                ;
+            }
+            else if (true == isMatch(m_lastMsg, m_root.expected))
+            {
+                m_state = STATE_STEP_READ;
+                m_stepTimer.start(m_stepTimeout);
+            }
+            else if (MAX_ROOT_PRESS_CNT <= m_rootPressCnt)
+            {
+                finish(RESULT_ENOT_ROOT);
+            }
+            else
+            {
+                m_state = STATE_ROOT_LEAVE;
+            }
+            break;
+
+        case STATE_ROOT_LEAVE:
+            if (false == writeFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_LEFT_BUTTON, 1U, isDone))
+            {
+                finish(RESULT_EINVALID);
+            }
+            else if (true == isDone)
+            {
+                ++m_rootPressCnt;
+                m_state = STATE_ROOT_READ;
+                m_pauseTimer.start(PAUSE);
+            }
+            else
+            {
+                /* Wait for confirmation. */
+                ;
+            }
+            break;
+
+        case STATE_STEP_READ:
+            if (false == readRow(m_steps[m_stepIdx].row, isDone))
+            {
+                finish(RESULT_EINVALID);
+            }
+            else if (false == isDone)
+            {
+                /* Wait for display content. */
+                ;
+            }
+            else if (true == isMatch(m_lastMsg, m_steps[m_stepIdx].expected))
+            {
+                m_state = STATE_STEP_ACTION;
+            }
+            else if (true == m_stepTimer.isTimeout())
+            {
+                finish(RESULT_EMISMATCH);
+            }
+            else
+            {
+                /* The menu may be not updated yet, read again later. */
+                m_pauseTimer.start(PAUSE);
+            }
+            break;
+
+        case STATE_STEP_ACTION:
+            if (false == writeFrontPanel(m_steps[m_stepIdx].addr, m_steps[m_stepIdx].value, isDone))
+            {
+                finish(RESULT_EINVALID);
+            }
+            else if (false == isDone)
+            {
+                /* Wait for confirmation. */
+                ;
+            }
+            else if (m_stepCnt <= (m_stepIdx + 1U))
+            {
+                finish(RESULT_OK);
+            }
+            else
+            {
+                ++m_stepIdx;
+                m_state = STATE_STEP_READ;
+                m_stepTimer.start(m_stepTimeout);
+                m_pauseTimer.start(PAUSE);
+            }
+            break;
+
+        case STATE_ABORT_READ:
+            /* The abort is done on best effort, the result is already set. */
+            if (false == readRow(m_root.row, isDone))
+            {
+                m_state = STATE_IDLE;
+            }
+            else if (false == isDone)
+            {
+                /* Wait for display content. */
+                ;
+            }
+            else if ((true == isMatch(m_lastMsg, m_root.expected)) ||
+                     (MAX_ROOT_PRESS_CNT <= m_rootPressCnt))
+            {
+                m_state = STATE_IDLE;
+            }
+            else
+            {
+                m_state = STATE_ABORT_LEAVE;
+            }
+            break;
+
+        case STATE_ABORT_LEAVE:
+            if (false == writeFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_LEFT_BUTTON, 1U, isDone))
+            {
+                m_state = STATE_IDLE;
+            }
+            else if (true == isDone)
+            {
+                ++m_rootPressCnt;
+                m_state = STATE_ABORT_READ;
+                m_pauseTimer.start(PAUSE);
+            }
+            else
+            {
+                /* Wait for confirmation. */
+                ;
+            }
+            break;
+
+        default:
+            m_state = STATE_IDLE;
+            break;
+        }
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+bool FrontPanelMacro::setExpected(Step& step, const char* expected)
+{
+    bool isSet = false;
+
+    if ((nullptr != expected) &&
+        (MAX_TEXT_LEN >= strlen(expected)))
+    {
+        strcpy(step.expected, expected);
+        isSet = true;
+    }
+
+    return isSet;
+}
+
+bool FrontPanelMacro::isMatch(const String& msg, const char* expected)
+{
+    bool            isMatch = true;
+    unsigned int    idx     = 0U;
+
+    while((true == isMatch) && ('\0' != expected[idx]))
+    {
+        if (msg.length() <= idx)
+        {
+            isMatch = false;
+        }
+        else if (('?' != expected[idx]) &&
+                 (msg[idx] != expected[idx]))
+        {
+            isMatch = false;
+        }
+        else
+        {
+            ++idx;
+        }
+    }
+
+    return isMatch;
+}
+
+bool FrontPanelMacro::readRow(Rego6xxCtrl::Row row, bool& isDone)
+{
+    bool isValid = true;
+
+    isDone = false;
+
+    if (nullptr == m_displayRsp)
+    {
+        /* If the controller is busy, it will be tried again in the next call. */
+        m_displayRsp = m_ctrl.readDisplay(row);
+    }
+    else if (false == m_displayRsp->isPending())
+    {
+        /* Check response, the data and the destination address of the
+         * response message must be valid.
+         * If a timeout happened, the data is valid but the destination
+         * address won't match.
+         */
+        if ((false == m_displayRsp->isValid()) ||
+            (Rego6xxCtrl::DEV_ADDR_HOST != m_displayRsp->getDevAddr()))
+        {
+            isValid = false;
+        }
+        else
+        {
+            m_lastMsg   = m_displayRsp->getMsg();
+            isDone      = true;
+        }
+
+        m_ctrl.release();
+        m_displayRsp = nullptr;
+    }
+    else
+    {
+        /* Waiting for response. */
+        ;
+    }
+
+    return isValid;
+}
+
+bool FrontPanelMacro::writeFrontPanel(Rego6xxCtrl::FrontPanelAddr addr, uint16_t value, bool& isDone)
+{
+    bool isValid = true;
+
+    isDone = false;
+
+    if (nullptr == m_confirmRsp)
+    {
+        /* If the controller is busy, it will be tried again in the next call. */
+        m_confirmRsp = m_ctrl.writeFrontPanel(addr, value);
+    }
+    else if (false == m_confirmRsp->isPending())
+    {
+        if ((false == m_confirmRsp->isValid()) ||
+            (Rego6xxCtrl::DEV_ADDR_HOST != m_confirmRsp->getDevAddr()))
+        {
+            isValid = false;
+        }
+        else
+        {
+            isDone = true;
+        }
+
+        m_ctrl.release();
+        m_confirmRsp = nullptr;
+    }
+    else
+    {
+        /* Waiting for response. */
+        ;
+    }
+
+    return isValid;
+}
+
+void FrontPanelMacro::finish(Result result)
+{
+    m_result = result;
+    m_stepTimer.stop();
+
+    if ((RESULT_OK != result) &&
+        (true == m_isRootEnabled))
+    {
+        m_rootPressCnt  = 0U;
+        m_state         = STATE_ABORT_READ;
+        m_pauseTimer.start(PAUSE);
+    }
+    else
+    {
+        m_state = STATE_IDLE;
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,337 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Front panel macro
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __FRONT_PANEL_MACRO_H__
+#define __FRONT_PANEL_MACRO_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+#include "Rego6xxCtrl.h"
+#include "SimpleTimer.hpp"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * A front panel macro navigates through the heatpump menu, like the user
+ * in front of the heatpump would do it. Every step waits until the expected
+ * text is shown in the given display row and then manipulates the keyboard
+ * or the wheel.
+ *
+ * If a root menu is set, the macro leaves any open menu with the left button
+ * before the first step is executed. If a step fails, it does the same to
+ * abort to the root menu again.
+ */
+class FrontPanelMacro
+{
+public:
+
+    /** Macro result */
+    enum Result
+    {
+        RESULT_OK = 0,      /**< All steps executed successful */
+        RESULT_RUNNING,     /**< Macro is running */
+        RESULT_ENOT_ROOT,   /**< Root menu not reached */
+        RESULT_EMISMATCH,   /**< Expected display content not shown within step timeout */
+        RESULT_EINVALID,    /**< Invalid response from heatpump */
+        RESULT_EABORTED     /**< Aborted on request */
+    };
+
+    /**
+     * Max. number of steps in a macro.
+     * Every step costs RAM permanently, see Step.
+     */
+    static const uint8_t    MAX_STEPS           = 4U;
+
+    /** Max. length of expected text in characters, which is the display row length. */
+    static const uint8_t    MAX_TEXT_LEN        = 20U;
+
+    /** Default step timeout in ms. */
+    static const uint32_t   STEP_TIMEOUT        = (3UL * 1000UL);
+
+    /** Min. step timeout in ms, which covers at least one display read. */
+    static const uint32_t   MIN_STEP_TIMEOUT    = 500UL;
+
+    /** Max. step timeout in ms. */
+    static const uint32_t   MAX_STEP_TIMEOUT    = (10UL * 1000UL);
+
+    /**
+     * Constructs a empty front panel macro.
+     *
+     * @param[in] ctrl  Rego6xx heatpump controller
+     */
+    FrontPanelMacro(Rego6xxCtrl& ctrl) :
+        m_ctrl(ctrl),
+        m_steps(),
+        m_stepCnt(0U),
+        m_stepIdx(0U),
+        m_root(),
+        m_isRootEnabled(false),
+        m_rootPressCnt(0U),
+        m_state(STATE_IDLE),
+        m_result(RESULT_OK),
+        m_stepTimeout(STEP_TIMEOUT),
+        m_isAbortReq(false),
+        m_stepTimer(),
+        m_pauseTimer(),
+        m_displayRsp(nullptr),
+        m_confirmRsp(nullptr),
+        m_lastMsg()
+    {
+    }
+
+    /**
+     * Destroys the front panel macro.
+     */
+    ~FrontPanelMacro()
+    {
+    }
+
+    /**
+     * Remove all steps and the root menu.
+     * A running macro will not be affected.
+     *
+     * @return If cleared, it will return true otherwise false.
+     */
+    bool clear();
+
+    /**
+     * Set root menu, which is identified by the expected text in the given
+     * display row. The text may contain '?' as wildcard for any character.
+     *
+     * @param[in] row       Display row
+     * @param[in] expected  Expected text in the display row
+     *
+     * @return If successful set, it will return true otherwise false.
+     */
+    bool setRoot(Rego6xxCtrl::Row row, const char* expected);
+
+    /**
+     * Append a step to the macro.
+     * The expected text may contain '?' as wildcard for any character.
+     *
+     * @param[in] row       Display row
+     * @param[in] expected  Expected text in the display row, before the action is executed
+     * @param[in] addr      Front panel address of the action
+     * @param[in] value     Value which to write to the front panel address
+     *
+     * @return If successful added, it will return true otherwise false.
+     */
+    bool addStep(Rego6xxCtrl::Row row, const char* expected, Rego6xxCtrl::FrontPanelAddr addr, uint16_t value);
+
+    /**
+     * Start the macro.
+     *
+     * @param[in] stepTimeout   Max. duration in ms until the expected text of a step is shown.
+     *
+     * @return If macro is started, it will return true otherwise false.
+     */
+    bool start(uint32_t stepTimeout);
+
+    /**
+     * Abort a running macro. A pending heatpump request is finished first,
+     * afterwards the macro returns to the root menu, if available.
+     */
+    void abort();
+
+    /**
+     * Process the macro. Call it periodically until the macro is not running
+     * anymore. Note, the Rego6xx controller must be processed separately.
+     */
+    void process();
+
+    /**
+     * Is macro running?
+     *
+     * @return If running, it will return true otherwise false.
+     */
+    bool isRunning() const
+    {
+        return (STATE_IDLE != m_state);
+    }
+
+    /**
+     * Get result of the last macro run.
+     *
+     * @return Macro result
+     */
+    Result getResult() const
+    {
+        return m_result;
+    }
+
+    /**
+     * Get index of the current step. After the macro failed, it is the index
+     * of the failed step.
+     *
+     * @return Step index
+     */
+    uint8_t getStepIdx() const
+    {
+        return m_stepIdx;
+    }
+
+    /**
+     * Get the display row content, which was read at last.
+     *
+     * @return Display row content
+     */
+    const String& getLastMsg() const
+    {
+        return m_lastMsg;
+    }
+
+private:
+
+    /** Max. number of left button presses to reach the root menu. */
+    static const uint8_t    MAX_ROOT_PRESS_CNT  = 8U;
+
+    /** Pause in ms between reading a display row again or after an action. */
+    static const uint32_t   PAUSE               = 250UL;
+
+    /**
+     * Macro states
+     */
+    enum State
+    {
+        STATE_IDLE = 0,     /**< Macro is not running */
+        STATE_ROOT_READ,    /**< Read display row to check for root menu */
+        STATE_ROOT_LEAVE,   /**< Leave current menu towards root menu */
+        STATE_STEP_READ,    /**< Read display row to check for expected text */
+        STATE_STEP_ACTION,  /**< Execute step action */
+        STATE_ABORT_READ,   /**< Abort: Read display row to check for root menu */
+        STATE_ABORT_LEAVE   /**< Abort: Leave current menu towards root menu */
+    };
+
+    /**
+     * A single macro step.
+     */
+    struct Step
+    {
+        Rego6xxCtrl::Row            row;                        /**< Display row */
+        char                        expected[MAX_TEXT_LEN + 1]; /**< Expected text in display row */
+        Rego6xxCtrl::FrontPanelAddr addr;                       /**< Front panel address of action */
+        uint16_t                    value;                      /**< Value of action */
+    };
+
+    Rego6xxCtrl&                m_ctrl;             /**< Rego6xx heatpump controller */
+    Step                        m_steps[MAX_STEPS]; /**< Macro steps */
+    uint8_t                     m_stepCnt;          /**< Number of macro steps */
+    uint8_t                     m_stepIdx;          /**< Current step index */
+    Step                        m_root;             /**< Root menu, action is not used. */
+    bool                        m_isRootEnabled;    /**< Is root menu handling enabled? */
+    uint8_t                     m_rootPressCnt;     /**< Number of left button presses towards root menu */
+    State                       m_state;            /**< Current macro state */
+    Result                      m_result;           /**< Macro result */
+    uint32_t                    m_stepTimeout;      /**< Step timeout in ms */
+    bool                        m_isAbortReq;       /**< Is abort requested? */
+    SimpleTimer                 m_stepTimer;        /**< Step timeout observation */
+    SimpleTimer                 m_pauseTimer;       /**< Pause between two heatpump requests */
+    const Rego6xxDisplayRsp*    m_displayRsp;       /**< Pending display response */
+    const Rego6xxConfirmRsp*    m_confirmRsp;       /**< Pending confirmation response */
+    String                      m_lastMsg;          /**< Last read display row */
+
+    FrontPanelMacro();
+    FrontPanelMacro(const FrontPanelMacro& macro);
+    FrontPanelMacro& operator=(const FrontPanelMacro& macro);
+
+    /**
+     * Copy the expected text into the step.
+     *
+     * @param[out]  step        Step
+     * @param[in]   expected    Expected text
+     *
+     * @return If text fits into the step, it will return true otherwise false.
+     */
+    static bool setExpected(Step& step, const char* expected);
+
+    /**
+     * Checks whether the display row content matches the expected text.
+     * A '?' in the expected text matches any character.
+     *
+     * @param[in] msg       Display row content
+     * @param[in] expected  Expected text
+     *
+     * @return If content starts with the expected text, it will return true otherwise false.
+     */
+    static bool isMatch(const String& msg, const char* expected);
+
+    /**
+     * Read display row and handle the response.
+     * If the response is available, the display row content is stored.
+     *
+     * @param[in]   row     Display row
+     * @param[out]  isDone  Signals whether the display row content is available.
+     *
+     * @return If the response is invalid, it will return false otherwise true.
+     */
+    bool readRow(Rego6xxCtrl::Row row, bool& isDone);
+
+    /**
+     * Write to front panel and handle the response.
+     *
+     * @param[in]   addr    Front panel address
+     * @param[in]   value   Value to write
+     * @param[out]  isDone  Signals whether the write was confirmed.
+     *
+     * @return If the response is invalid, it will return false otherwise true.
+     */
+    bool writeFrontPanel(Rego6xxCtrl::FrontPanelAddr addr, uint16_t value, bool& isDone);
+
+    /**
+     * Finish the macro with the given result. If it failed and a root
+     * menu is set, it aborts to the root menu.
+     *
+     * @param[in] result    Macro result
+     */
+    void finish(Result result);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __FRONT_PANEL_MACRO_H__ */
+
+/** @} */
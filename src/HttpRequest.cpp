@@ -0,0 +1,438 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Http request
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "HttpRequest.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void HttpRequest::clear()
+{
+    m_state             = STATE_REQUEST_LINE;
+    m_method            = METHOD_UNKNOWN;
+    m_uri               = "";
+    m_query             = "";
+    m_body              = "";
+    m_contentLength     = 0U;
+    m_isHttp11          = false;
+    m_isKeepAlive       = false;
+    m_ifNoneMatch       = "";
+    m_isMsgPackAccepted = false;
+    m_lineLen           = 0U;
+    m_isLineTooLong     = false;
+    m_errorCode         = 0U;
+
+    return;
+}
+
+HttpRequest::Status HttpRequest::parse(Stream& stream)
+{
+    Status status = STATUS_PENDING;
+
+    while(((STATE_REQUEST_LINE == m_state) || (STATE_HEADER == m_state) || (STATE_BODY == m_state)) &&
+          (0 < stream.available()))
+    {
+        int data = stream.read();
+
+        if (0 > data)
+        {
+            /* Nothing to do. */
+            ;
+        }
+        else if (STATE_BODY == m_state)
+        {
+            m_body += static_cast<char>(data);
+
+            if (m_contentLength <= m_body.length())
+            {
+                m_state = STATE_COMPLETE;
+            }
+        }
+        else if ('\r' == data)
+        {
+            /* Skipped, the line ends with the line feed. */
+            ;
+        }
+        else if ('\n' == data)
+        {
+            m_line[m_lineLen] = '\0';
+
+            handleLine();
+
+            m_lineLen       = 0U;
+            m_isLineTooLong = false;
+        }
+        else if (MAX_LINE_LEN <= m_lineLen)
+        {
+            m_isLineTooLong = true;
+        }
+        else
+        {
+            m_line[m_lineLen] = static_cast<char>(data);
+            ++m_lineLen;
+        }
+    }
+
+    if (STATE_COMPLETE == m_state)
+    {
+        status = STATUS_COMPLETE;
+    }
+    else if (STATE_ERROR == m_state)
+    {
+        status = STATUS_ERROR;
+    }
+    else
+    {
+        /* Wait for more data. */
+        ;
+    }
+
+    return status;
+}
+
+String HttpRequest::getUriPart(uint8_t idx) const
+{
+    String          part;
+    uint8_t         partIdx = 0U;
+    unsigned int    pos     = 0U;
+
+    /* Skip the leading slash. */
+    if ((0U < m_uri.length()) &&
+        ('/' == m_uri[0U]))
+    {
+        pos = 1U;
+    }
+
+    while((m_uri.length() > pos) && (idx >= partIdx))
+    {
+        if ('/' == m_uri[pos])
+        {
+            ++partIdx;
+        }
+        else if (idx == partIdx)
+        {
+            part += m_uri[pos];
+        }
+        else
+        {
+            /* Nothing to do. */
+            ;
+        }
+
+        ++pos;
+    }
+
+    return part;
+}
+
+String HttpRequest::getQueryParam(const char* name) const
+{
+    String          value;
+    size_t          nameLen = strlen(name);
+    unsigned int    pos     = 0U;
+    bool            isFound = false;
+
+    while((m_query.length() > pos) && (false == isFound))
+    {
+        int             nextPos = m_query.indexOf('&', pos);
+        unsigned int    endPos  = (0 > nextPos) ? m_query.length() : static_cast<unsigned int>(nextPos);
+
+        /* Parameter name followed by '='? */
+        if (((pos + nameLen) < endPos) &&
+            (0 == strncmp(&m_query.c_str()[pos], name, nameLen)) &&
+            ('=' == m_query[pos + nameLen]))
+        {
+            value   = m_query.substring(pos + nameLen + 1U, endPos);
+            isFound = true;
+        }
+
+        pos = endPos + 1U;
+    }
+
+    return value;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+void HttpRequest::handleLine()
+{
+    if (STATE_REQUEST_LINE == m_state)
+    {
+        /* Empty lines before the request line shall be ignored, see RFC 9112. */
+        if (true == m_isLineTooLong)
+        {
+            /* URI Too Long */
+            setError(414U);
+        }
+        else if (0U < m_lineLen)
+        {
+            parseRequestLine();
+        }
+        else
+        {
+            /* Nothing to do. */
+            ;
+        }
+    }
+    else if (0U == m_lineLen)
+    {
+        /* End of header */
+        if (0U == m_contentLength)
+        {
+            m_state = STATE_COMPLETE;
+        }
+        else
+        {
+            m_body.reserve(m_contentLength);
+            m_state = STATE_BODY;
+        }
+    }
+    else if (true == m_isLineTooLong)
+    {
+        /* Header fields, which are used by the server are short.
+         * Every too long field is skipped.
+         */
+        ;
+    }
+    else
+    {
+        parseHeaderField();
+    }
+
+    return;
+}
+
+void HttpRequest::parseRequestLine()
+{
+    char*   method  = m_line;
+    char*   uri     = strchr(m_line, ' ');
+    char*   version = nullptr;
+    char*   query   = nullptr;
+
+    if (nullptr != uri)
+    {
+        *uri = '\0';
+        ++uri;
+
+        version = strchr(uri, ' ');
+    }
+
+    if (nullptr == version)
+    {
+        /* Bad Request */
+        setError(400U);
+    }
+    else
+    {
+        *version = '\0';
+        ++version;
+
+        /* The query is kept separate from the URI. */
+        query = strchr(uri, '?');
+
+        if (nullptr != query)
+        {
+            *query = '\0';
+            ++query;
+        }
+
+        if (0 == strcmp(method, "GET"))
+        {
+            m_method = METHOD_GET;
+        }
+        else if (0 == strcmp(method, "HEAD"))
+        {
+            m_method = METHOD_HEAD;
+        }
+        else if (0 == strcmp(method, "POST"))
+        {
+            m_method = METHOD_POST;
+        }
+        else if (0 == strcmp(method, "PUT"))
+        {
+            m_method = METHOD_PUT;
+        }
+        else if (0 == strcmp(method, "DELETE"))
+        {
+            m_method = METHOD_DELETE;
+        }
+        else
+        {
+            m_method = METHOD_UNKNOWN;
+        }
+
+        if (METHOD_UNKNOWN == m_method)
+        {
+            /* Not Implemented */
+            setError(501U);
+        }
+        else if (('/' != uri[0]) ||
+                 (0 != strncmp(version, "HTTP/1.", 7U)))
+        {
+            /* Bad Request */
+            setError(400U);
+        }
+        else
+        {
+            m_uri           = uri;
+            m_query         = (nullptr != query) ? query : "";
+            m_isHttp11      = (0 != strcmp(version, "HTTP/1.0"));
+            m_isKeepAlive   = m_isHttp11;
+            m_state         = STATE_HEADER;
+        }
+    }
+
+    return;
+}
+
+void HttpRequest::parseHeaderField()
+{
+    char* value = strchr(m_line, ':');
+
+    if (nullptr == value)
+    {
+        /* Bad Request */
+        setError(400U);
+    }
+    else
+    {
+        *value = '\0';
+        ++value;
+
+        /* Skip optional whitespace. */
+        while((' ' == *value) || ('\t' == *value))
+        {
+            ++value;
+        }
+
+        if (0 == strcasecmp(m_line, "Content-Length"))
+        {
+            long contentLength = atol(value);
+
+            if (0 > contentLength)
+            {
+                /* Bad Request */
+                setError(400U);
+            }
+            else if (MAX_BODY_SIZE < static_cast<unsigned long>(contentLength))
+            {
+                /* Payload Too Large */
+                setError(413U);
+            }
+            else
+            {
+                m_contentLength = static_cast<size_t>(contentLength);
+            }
+        }
+        else if (0 == strcasecmp(m_line, "Connection"))
+        {
+            if (0 == strcasecmp(value, "close"))
+            {
+                m_isKeepAlive = false;
+            }
+            else if (0 == strcasecmp(value, "keep-alive"))
+            {
+                m_isKeepAlive = true;
+            }
+            else
+            {
+                /* Nothing to do. */
+                ;
+            }
+        }
+        else if (0 == strcasecmp(m_line, "If-None-Match"))
+        {
+            m_ifNoneMatch = value;
+        }
+        else if (0 == strcasecmp(m_line, "Accept"))
+        {
+            /* Both media types are in use, the registered one and the older one. */
+            if ((nullptr != strstr(value, "application/msgpack")) ||
+                (nullptr != strstr(value, "application/x-msgpack")))
+            {
+                m_isMsgPackAccepted = true;
+            }
+        }
+        else
+        {
+            /* Header field not used. */
+            ;
+        }
+    }
+
+    return;
+}
+
+void HttpRequest::setError(uint16_t errorCode)
+{
+    m_errorCode = errorCode;
+    m_state     = STATE_ERROR;
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
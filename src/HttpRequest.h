@@ -0,0 +1,314 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Http request
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __HTTP_REQUEST_H__
+#define __HTTP_REQUEST_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Http request, which is parsed incrementally from a stream.
+ * Every call consumes only the data which is already available, therefore
+ * a slow client never blocks. The parsing stops after the request is
+ * complete, further data stays in the stream.
+ *
+ * Only the header fields, which are used by the server are kept. All others
+ * are skipped, which keeps the memory consumption low.
+ */
+class HttpRequest
+{
+public:
+
+    /** Http request methods */
+    enum Method
+    {
+        METHOD_UNKNOWN = 0, /**< Unknown method */
+        METHOD_GET,         /**< GET */
+        METHOD_HEAD,        /**< HEAD */
+        METHOD_POST,        /**< POST */
+        METHOD_PUT,         /**< PUT */
+        METHOD_DELETE       /**< DELETE */
+    };
+
+    /** Parse status */
+    enum Status
+    {
+        STATUS_PENDING = 0, /**< Request is not complete yet */
+        STATUS_COMPLETE,    /**< Request is complete */
+        STATUS_ERROR        /**< Request is invalid */
+    };
+
+    /** Max. length of the request line and every header line in characters. */
+    static const uint8_t    MAX_LINE_LEN    = 80U;
+
+    /**
+     * Max. body size in bytes.
+     * It is limited by the biggest request, which is a front panel macro.
+     */
+    static const size_t     MAX_BODY_SIZE   = 384U;
+
+    /**
+     * Constructs a empty http request.
+     */
+    HttpRequest() :
+        m_state(STATE_REQUEST_LINE),
+        m_method(METHOD_UNKNOWN),
+        m_uri(),
+        m_query(),
+        m_body(),
+        m_contentLength(0U),
+        m_isHttp11(false),
+        m_isKeepAlive(false),
+        m_ifNoneMatch(),
+        m_isMsgPackAccepted(false),
+        m_line(),
+        m_lineLen(0U),
+        m_isLineTooLong(false),
+        m_errorCode(0U)
+    {
+    }
+
+    /**
+     * Destroys the http request.
+     */
+    ~HttpRequest()
+    {
+    }
+
+    /**
+     * Clear the request to parse the next one.
+     */
+    void clear();
+
+    /**
+     * Parse the request from the data, which is available in the stream.
+     *
+     * @param[in] stream    Input stream
+     *
+     * @return Parse status
+     */
+    Status parse(Stream& stream);
+
+    /**
+     * Get request method.
+     *
+     * @return Request method
+     */
+    Method getMethod() const
+    {
+        return m_method;
+    }
+
+    /**
+     * Get the requested URI, without the query.
+     *
+     * @return URI
+     */
+    const String& getUri() const
+    {
+        return m_uri;
+    }
+
+    /**
+     * Get a single part of the URI path. The parts are separated by '/'.
+     * Example: "/api/sensors/gt1" has the parts "api", "sensors" and "gt1".
+     *
+     * @param[in] idx   Part index
+     *
+     * @return URI part. If not available, it will be empty.
+     */
+    String getUriPart(uint8_t idx) const;
+
+    /**
+     * Get the value of a query parameter.
+     * Example: "/api/sysreg?from=0&to=10" has the parameters "from" and "to".
+     * Note, the value is not percent-decoded.
+     *
+     * @param[in] name  Parameter name
+     *
+     * @return Parameter value. If not available, it will be empty.
+     */
+    String getQueryParam(const char* name) const;
+
+    /**
+     * Get the body.
+     *
+     * @return Body
+     */
+    const char* getBody() const
+    {
+        return m_body.c_str();
+    }
+
+    /**
+     * Is nothing of the request received yet?
+     *
+     * @return If nothing is received, it will return true otherwise false.
+     */
+    bool isEmpty() const
+    {
+        return ((STATE_REQUEST_LINE == m_state) && (0U == m_lineLen) && (false == m_isLineTooLong));
+    }
+
+    /**
+     * Does the client speak HTTP/1.1 or later? Only then the reply can
+     * use e.g. the chunked transfer encoding.
+     *
+     * @return If HTTP/1.1 or later, it will return true otherwise false.
+     */
+    bool isHttp11() const
+    {
+        return m_isHttp11;
+    }
+
+    /**
+     * Shall the connection be kept open after the reply?
+     * HTTP/1.1 keeps it open by default, HTTP/1.0 only on request.
+     *
+     * @return If the connection shall be kept open, it will return true otherwise false.
+     */
+    bool isKeepAlive() const
+    {
+        return m_isKeepAlive;
+    }
+
+    /**
+     * Get the entity tags of the If-None-Match header field.
+     *
+     * @return Entity tags. If not requested, it will be empty.
+     */
+    const String& getIfNoneMatch() const
+    {
+        return m_ifNoneMatch;
+    }
+
+    /**
+     * Does the client accept the MessagePack format, according to the Accept
+     * header field? Only this media type is evaluated, therefore the header
+     * field itself is not kept.
+     * Note, a too long header field is skipped.
+     *
+     * @return If MessagePack is accepted, it will return true otherwise false.
+     */
+    bool isMsgPackAccepted() const
+    {
+        return m_isMsgPackAccepted;
+    }
+
+    /**
+     * Get the http status code, which describes why the parsing failed.
+     *
+     * @return Http status code
+     */
+    uint16_t getErrorCode() const
+    {
+        return m_errorCode;
+    }
+
+private:
+
+    /**
+     * Parser states
+     */
+    enum State
+    {
+        STATE_REQUEST_LINE = 0, /**< Wait for the request line */
+        STATE_HEADER,           /**< Wait for the header fields */
+        STATE_BODY,             /**< Wait for the body */
+        STATE_COMPLETE,         /**< Request is complete */
+        STATE_ERROR             /**< Request is invalid */
+    };
+
+    State       m_state;                    /**< Parser state */
+    Method      m_method;                   /**< Request method */
+    String      m_uri;                      /**< Request URI */
+    String      m_query;                    /**< Request URI query, without '?' */
+    String      m_body;                     /**< Request body */
+    size_t      m_contentLength;            /**< Body size in bytes */
+    bool        m_isHttp11;                 /**< HTTP/1.1 or later? */
+    bool        m_isKeepAlive;              /**< Keep connection open after the reply? */
+    String      m_ifNoneMatch;              /**< Entity tags of the If-None-Match header field */
+    bool        m_isMsgPackAccepted;        /**< MessagePack in the Accept header field? */
+    char        m_line[MAX_LINE_LEN + 1];   /**< Current line */
+    uint8_t     m_lineLen;                  /**< Current line length in characters */
+    bool        m_isLineTooLong;            /**< Current line didn't fit into the line buffer */
+    uint16_t    m_errorCode;                /**< Http status code in case of a error */
+
+    HttpRequest(const HttpRequest& req);
+    HttpRequest& operator=(const HttpRequest& req);
+
+    /**
+     * Handle a complete line of the request line or the header.
+     */
+    void handleLine();
+
+    /**
+     * Parse the request line, e.g. "GET /api/sensors/gt1 HTTP/1.1".
+     */
+    void parseRequestLine();
+
+    /**
+     * Parse a single header field.
+     */
+    void parseHeaderField();
+
+    /**
+     * Stop parsing, because of a error.
+     *
+     * @param[in] errorCode Http status code
+     */
+    void setError(uint16_t errorCode);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __HTTP_REQUEST_H__ */
+
+/** @} */
@@ -0,0 +1,151 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Line buffer
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __LINE_BUFFER_H__
+#define __LINE_BUFFER_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Print destination, which writes into a buffer provided by the caller,
+ * e.g. on the stack. In contrast to a String, it never allocates memory
+ * on the heap. Characters, which don't fit into the buffer are dropped
+ * and the overflow is remembered.
+ */
+class LineBuffer : public Print
+{
+public:
+
+    /**
+     * Constructs a empty line buffer.
+     *
+     * @param[in] buffer    Buffer, which is used to store the characters.
+     * @param[in] size      Buffer size in bytes, including the string termination.
+     */
+    LineBuffer(char* buffer, size_t size) :
+        Print(),
+        m_buffer(buffer),
+        m_size(size),
+        m_length(0U),
+        m_isOverflow(false)
+    {
+        clear();
+    }
+
+    /**
+     * Destroys the line buffer.
+     */
+    ~LineBuffer()
+    {
+    }
+
+    /**
+     * Write a single character.
+     *
+     * @param[in] data  Character
+     *
+     * @return Number of written characters
+     */
+    size_t write(uint8_t data) override;
+
+    using Print::write;
+
+    /**
+     * Clear the buffer.
+     */
+    void clear();
+
+    /**
+     * Get the buffered characters as string.
+     *
+     * @return String
+     */
+    const char* c_str() const
+    {
+        return m_buffer;
+    }
+
+    /**
+     * Get number of buffered characters.
+     *
+     * @return Number of characters
+     */
+    size_t length() const
+    {
+        return m_length;
+    }
+
+    /**
+     * Were characters dropped, because the buffer was full?
+     *
+     * @return If characters were dropped, it will return true otherwise false.
+     */
+    bool isOverflow() const
+    {
+        return m_isOverflow;
+    }
+
+private:
+
+    char*   m_buffer;       /**< Buffer */
+    size_t  m_size;         /**< Buffer size in bytes */
+    size_t  m_length;       /**< Number of buffered characters */
+    bool    m_isOverflow;   /**< Characters dropped? */
+
+    LineBuffer();
+    LineBuffer(const LineBuffer& buffer);
+    LineBuffer& operator=(const LineBuffer& buffer);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __LINE_BUFFER_H__ */
+
+/** @} */
@@ -0,0 +1,246 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Main loop profiler
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "LoopProfiler.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void LoopProfiler::beginIteration()
+{
+    m_iterationBegin        = micros();
+    m_phaseBegin            = m_iterationBegin;
+    m_phase                 = NO_PHASE;
+    m_longestPhase          = NO_PHASE;
+    m_longestPhaseDuration  = 0U;
+    m_cause[0]              = '\0';
+    m_causePhase            = NO_PHASE;
+    m_causeDuration         = 0U;
+
+    return;
+}
+
+void LoopProfiler::enterPhase(uint8_t phase)
+{
+    endPhase(micros());
+
+    if (MAX_PHASES > phase)
+    {
+        m_phase = phase;
+    }
+
+    return;
+}
+
+void LoopProfiler::setCause(const char* cause, uint32_t duration)
+{
+    if ((nullptr != cause) &&
+        (m_causeDuration < duration))
+    {
+        uint8_t idx = 0U;
+
+        /* The cause is reported as JSON string, therefore characters which
+         * would need escaping are replaced.
+         */
+        while((MAX_CAUSE_LEN > idx) && ('\0' != cause[idx]))
+        {
+            char character = cause[idx];
+
+            if ((' ' > character) || ('~' < character) || ('"' == character) || ('\\' == character))
+            {
+                character = '?';
+            }
+
+            m_cause[idx] = character;
+            ++idx;
+        }
+
+        m_cause[idx]    = '\0';
+        m_causePhase    = m_phase;
+        m_causeDuration = duration;
+    }
+
+    return;
+}
+
+void LoopProfiler::endIteration()
+{
+    uint32_t    timestamp   = micros();
+    uint32_t    duration    = timestamp - m_iterationBegin;
+
+    endPhase(timestamp);
+
+    ++m_iterations;
+    m_durationSum += duration;
+
+    if (m_durationMax < duration)
+    {
+        m_durationMax = duration;
+    }
+
+#if defined(LOOP_HISTOGRAM)
+    ++m_histogram[getBucket(duration)];
+#endif  /* defined(LOOP_HISTOGRAM) */
+
+    if (m_stallDuration < duration)
+    {
+        m_stallDuration     = duration;
+        m_stallPhase        = m_longestPhase;
+        m_stallTimestamp    = millis();
+
+        /* A cause of a other phase doesn't explain the stall. */
+        if (m_longestPhase == m_causePhase)
+        {
+            memcpy(m_stallCause, m_cause, sizeof(m_stallCause));
+        }
+        else
+        {
+            m_stallCause[0] = '\0';
+        }
+    }
+
+    m_phase = NO_PHASE;
+
+    return;
+}
+
+void LoopProfiler::reset()
+{
+    uint8_t idx = 0U;
+
+    m_iterations    = 0U;
+    m_durationSum   = 0U;
+    m_durationMax   = 0U;
+
+#if defined(LOOP_HISTOGRAM)
+    while(NUM_BUCKETS > idx)
+    {
+        m_histogram[idx] = 0U;
+        ++idx;
+    }
+
+    idx = 0U;
+#endif  /* defined(LOOP_HISTOGRAM) */
+    while(MAX_PHASES > idx)
+    {
+        m_phaseSums[idx]    = 0U;
+        m_phaseMax[idx]     = 0U;
+        ++idx;
+    }
+
+    m_stallDuration     = 0U;
+    m_stallPhase        = NO_PHASE;
+    m_stallCause[0]     = '\0';
+    m_stallTimestamp    = 0U;
+
+    return;
+}
+
+#if defined(LOOP_HISTOGRAM)
+
+uint8_t LoopProfiler::getBucket(uint32_t duration)
+{
+    uint8_t bucket = 0U;
+
+    while(((NUM_BUCKETS - 1U) > bucket) && (getBucketBound(bucket) < duration))
+    {
+        ++bucket;
+    }
+
+    return bucket;
+}
+
+#endif  /* defined(LOOP_HISTOGRAM) */
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+void LoopProfiler::endPhase(uint32_t timestamp)
+{
+    uint32_t duration = timestamp - m_phaseBegin;
+
+    if (MAX_PHASES > m_phase)
+    {
+        m_phaseSums[m_phase] += duration;
+
+        if (m_phaseMax[m_phase] < duration)
+        {
+            m_phaseMax[m_phase] = duration;
+        }
+
+        if (m_longestPhaseDuration < duration)
+        {
+            m_longestPhase          = m_phase;
+            m_longestPhaseDuration  = duration;
+        }
+    }
+
+    m_phaseBegin = timestamp;
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,336 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Main loop profiler
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __LOOP_PROFILER_H__
+#define __LOOP_PROFILER_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Profiler of the main loop. Every iteration is divided into phases, e.g.
+ * network handling or the sensor read cycle, which are measured in us.
+ * It keeps the average and max. duration of every phase and of the whole
+ * iteration, a histogram of the iteration durations with logarithmic
+ * buckets and the longest iteration as stall. The histogram is only built
+ * with LOOP_HISTOGRAM, because of the little RAM on the device.
+ *
+ * The cause of a stall is the longest phase of the iteration. Within a
+ * phase, the longest section which reported a cause, e.g. a web request
+ * handler, refines it.
+ */
+class LoopProfiler
+{
+public:
+
+    /** Max. number of phases. */
+    static const uint8_t    MAX_PHASES          = 8U;
+
+    /** Number of histogram buckets. The last one has no upper bound. */
+    static const uint8_t    NUM_BUCKETS         = 7U;
+
+    /** Upper bound in us of the first histogram bucket. Every further bucket is 4 times bigger. */
+    static const uint32_t   FIRST_BUCKET_BOUND  = 256U;
+
+    /** Max. length of a cause in characters. */
+    static const uint8_t    MAX_CAUSE_LEN       = 16U;
+
+    /** Phase, which is reported if no iteration was measured. */
+    static const uint8_t    NO_PHASE            = 0xFFU;
+
+    /**
+     * Constructs a profiler without measurements.
+     */
+    LoopProfiler() :
+        m_iterations(0U),
+        m_durationSum(0U),
+        m_durationMax(0U),
+#if defined(LOOP_HISTOGRAM)
+        m_histogram(),
+#endif  /* defined(LOOP_HISTOGRAM) */
+        m_phaseSums(),
+        m_phaseMax(),
+        m_stallDuration(0U),
+        m_stallPhase(NO_PHASE),
+        m_stallCause(),
+        m_stallTimestamp(0U),
+        m_iterationBegin(0U),
+        m_phaseBegin(0U),
+        m_phase(NO_PHASE),
+        m_longestPhase(NO_PHASE),
+        m_longestPhaseDuration(0U),
+        m_cause(),
+        m_causePhase(NO_PHASE),
+        m_causeDuration(0U)
+    {
+    }
+
+    /**
+     * Destroys the profiler.
+     */
+    ~LoopProfiler()
+    {
+    }
+
+    /**
+     * Begin a iteration of the main loop.
+     */
+    void beginIteration();
+
+    /**
+     * Enter the next phase of the iteration. The previous phase ends.
+     *
+     * @param[in] phase Phase, less than MAX_PHASES.
+     */
+    void enterPhase(uint8_t phase);
+
+    /**
+     * Report a section of the current phase, which is a possible cause of
+     * a stall, e.g. a web request handler. The longest section per
+     * iteration is kept.
+     *
+     * @param[in] cause     Cause, e.g. the request URI. It is truncated to MAX_CAUSE_LEN.
+     * @param[in] duration  Duration of the section in us
+     */
+    void setCause(const char* cause, uint32_t duration);
+
+    /**
+     * End the iteration of the main loop and take over its measurements.
+     */
+    void endIteration();
+
+    /**
+     * Clear all measurements. A running iteration is not affected.
+     */
+    void reset();
+
+    /**
+     * Get the number of measured iterations.
+     *
+     * @return Number of iterations
+     */
+    uint32_t getIterations() const
+    {
+        return m_iterations;
+    }
+
+    /**
+     * Get the average duration of a iteration.
+     *
+     * @return Duration in us
+     */
+    uint32_t getDurationAvg() const
+    {
+        return getAvg(m_durationSum);
+    }
+
+    /**
+     * Get the max. duration of a iteration.
+     *
+     * @return Duration in us
+     */
+    uint32_t getDurationMax() const
+    {
+        return m_durationMax;
+    }
+
+    /**
+     * Get the average duration of a phase per iteration.
+     *
+     * @param[in] phase Phase
+     *
+     * @return Duration in us
+     */
+    uint32_t getPhaseAvg(uint8_t phase) const
+    {
+        return (MAX_PHASES > phase) ? getAvg(m_phaseSums[phase]) : 0U;
+    }
+
+    /**
+     * Get the max. duration of a phase.
+     *
+     * @param[in] phase Phase
+     *
+     * @return Duration in us
+     */
+    uint32_t getPhaseMax(uint8_t phase) const
+    {
+        return (MAX_PHASES > phase) ? m_phaseMax[phase] : 0U;
+    }
+
+#if defined(LOOP_HISTOGRAM)
+
+    /**
+     * Get the number of iterations in a histogram bucket.
+     *
+     * @param[in] bucket    Histogram bucket
+     *
+     * @return Number of iterations
+     */
+    uint32_t getBucketCount(uint8_t bucket) const
+    {
+        return (NUM_BUCKETS > bucket) ? m_histogram[bucket] : 0U;
+    }
+
+    /**
+     * Get the inclusive upper bound of a histogram bucket. A iteration
+     * belongs to the first bucket, whose bound is greater than or equal to
+     * its duration.
+     *
+     * @param[in] bucket    Histogram bucket, the last one has no upper bound.
+     *
+     * @return Upper bound in us
+     */
+    static uint32_t getBucketBound(uint8_t bucket)
+    {
+        return FIRST_BUCKET_BOUND << (2U * bucket);
+    }
+
+    /**
+     * Get the histogram bucket of a iteration duration.
+     *
+     * @param[in] duration  Iteration duration in us
+     *
+     * @return Histogram bucket
+     */
+    static uint8_t getBucket(uint32_t duration);
+
+#endif  /* defined(LOOP_HISTOGRAM) */
+
+    /**
+     * Get the duration of the longest iteration.
+     *
+     * @return Duration in us
+     */
+    uint32_t getStallDuration() const
+    {
+        return m_stallDuration;
+    }
+
+    /**
+     * Get the longest phase of the longest iteration.
+     *
+     * @return Phase. If no iteration was measured, it will return NO_PHASE.
+     */
+    uint8_t getStallPhase() const
+    {
+        return m_stallPhase;
+    }
+
+    /**
+     * Get the cause of the longest iteration, reported within its longest phase.
+     *
+     * @return Cause. If none was reported, it will be empty.
+     */
+    const char* getStallCause() const
+    {
+        return m_stallCause;
+    }
+
+    /**
+     * Get the uptime, when the longest iteration ended.
+     *
+     * @return Uptime in ms
+     */
+    uint32_t getStallTimestamp() const
+    {
+        return m_stallTimestamp;
+    }
+
+private:
+
+    uint32_t    m_iterations;                   /**< Number of measured iterations */
+    uint64_t    m_durationSum;                  /**< Sum of the iteration durations in us */
+    uint32_t    m_durationMax;                  /**< Max. iteration duration in us */
+#if defined(LOOP_HISTOGRAM)
+    uint32_t    m_histogram[NUM_BUCKETS];       /**< Number of iterations per bucket */
+#endif  /* defined(LOOP_HISTOGRAM) */
+    uint64_t    m_phaseSums[MAX_PHASES];        /**< Sum of the durations in us per phase */
+    uint32_t    m_phaseMax[MAX_PHASES];         /**< Max. duration in us per phase */
+    uint32_t    m_stallDuration;                /**< Duration of the longest iteration in us */
+    uint8_t     m_stallPhase;                   /**< Longest phase of the longest iteration */
+    char        m_stallCause[MAX_CAUSE_LEN + 1];/**< Cause of the longest iteration */
+    uint32_t    m_stallTimestamp;               /**< Uptime in ms, when the longest iteration ended */
+    uint32_t    m_iterationBegin;               /**< Timestamp in us, when the current iteration began */
+    uint32_t    m_phaseBegin;                   /**< Timestamp in us, when the current phase began */
+    uint8_t     m_phase;                        /**< Current phase */
+    uint8_t     m_longestPhase;                 /**< Longest phase of the current iteration */
+    uint32_t    m_longestPhaseDuration;         /**< Duration in us of the longest phase of the current iteration */
+    char        m_cause[MAX_CAUSE_LEN + 1];     /**< Longest cause of the current iteration */
+    uint8_t     m_causePhase;                   /**< Phase, in which the longest cause was reported */
+    uint32_t    m_causeDuration;                /**< Duration in us of the longest cause of the current iteration */
+
+    LoopProfiler(const LoopProfiler& profiler);
+    LoopProfiler& operator=(const LoopProfiler& profiler);
+
+    /**
+     * End the current phase and take over its duration.
+     *
+     * @param[in] timestamp Timestamp in us, when it ended.
+     */
+    void endPhase(uint32_t timestamp);
+
+    /**
+     * Get the average per iteration.
+     *
+     * @param[in] sum   Sum over all iterations
+     *
+     * @return Average
+     */
+    uint32_t getAvg(uint64_t sum) const
+    {
+        return (0U == m_iterations) ? 0U : static_cast<uint32_t>(sum / m_iterations);
+    }
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __LOOP_PROFILER_H__ */
+
+/** @} */
@@ -0,0 +1,472 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MQTT client
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "MqttClient.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void MqttClient::begin(const IPAddress& brokerAddr, uint16_t brokerPort, const char* clientId, const char* statusTopic, const char* subscription, MessageHandler handler)
+{
+    m_brokerAddr    = brokerAddr;
+    m_brokerPort    = brokerPort;
+    m_clientId      = clientId;
+    m_statusTopic   = statusTopic;
+    m_subscription  = subscription;
+    m_handler       = handler;
+    m_backoff       = MIN_BACKOFF;
+    m_state         = STATE_DISCONNECTED;
+
+    /* Connect in the next process() call. */
+    m_timer.start(0U);
+
+    return;
+}
+
+void MqttClient::process()
+{
+    switch(m_state)
+    {
+    case STATE_IDLE:
+        /* Nothing to do. */
+        break;
+
+    case STATE_DISCONNECTED:
+        if (true == m_timer.isTimeout())
+        {
+            connect();
+        }
+        break;
+
+    case STATE_CONNECTING:
+        if (0 == m_client.connected())
+        {
+            disconnect();
+        }
+        else if (true == m_timer.isTimeout())
+        {
+            /* No connection acknowledge from broker. */
+            disconnect();
+        }
+        else
+        {
+            receive();
+        }
+        break;
+
+    case STATE_CONNECTED:
+        if (0 == m_client.connected())
+        {
+            disconnect();
+        }
+        else if (false == m_pingTimer.isTimeout())
+        {
+            receive();
+        }
+        /* Broker didn't answer the last ping? */
+        else if (true == m_isPingPending)
+        {
+            disconnect();
+        }
+        else
+        {
+            /* A failed ping is not sent again, the broker will notice it. */
+            m_isPingPending = sendPacket(PACKET_TYPE_PINGREQ, m_txBuffer, HEADER_SIZE);
+            m_pingTimer.start(KEEP_ALIVE * 1000UL);
+        }
+        break;
+
+    default:
+        disconnect();
+        break;
+    }
+
+    return;
+}
+
+bool MqttClient::publish(const char* topic, const char* payload, bool isRetained)
+{
+    bool isPublished = false;
+
+    if (STATE_CONNECTED == m_state)
+    {
+        size_t  idx         = HEADER_SIZE;
+        size_t  payloadLen  = (nullptr == payload) ? 0U : strlen(payload);
+
+        if ((true == appendString(m_txBuffer, idx, topic)) &&
+            (sizeof(m_txBuffer) >= (idx + payloadLen)))
+        {
+            memcpy(&m_txBuffer[idx], payload, payloadLen);
+            idx += payloadLen;
+
+            isPublished = sendPacket(PACKET_TYPE_PUBLISH | ((true == isRetained) ? 0x01U : 0x00U), m_txBuffer, idx);
+        }
+    }
+
+    return isPublished;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+void MqttClient::connect()
+{
+    uint8_t*    packet  = m_txBuffer;
+    size_t      idx     = HEADER_SIZE;
+    bool        isSent  = false;
+
+    /* Variable header: protocol name, level 4 (3.1.1), flags and keep alive.
+     * The flags are clean session and a retained last will with QoS 0.
+     */
+    (void)appendString(packet, idx, "MQTT");
+    packet[idx++] = 0x04U;
+    packet[idx++] = 0x02U | 0x04U | 0x20U;
+    packet[idx++] = static_cast<uint8_t>(KEEP_ALIVE >> 8U);
+    packet[idx++] = static_cast<uint8_t>(KEEP_ALIVE & 0xffU);
+
+    /* Payload: client id, will topic and will message. */
+    if ((true == appendString(packet, idx, m_clientId)) &&
+        (true == appendString(packet, idx, m_statusTopic)) &&
+        (true == appendString(packet, idx, "offline")))
+    {
+        /* The connect blocks, until connected or the timeout is exceeded. */
+        m_client.setConnectionTimeout(CONNECT_TIMEOUT);
+
+        if (0 != m_client.connect(m_brokerAddr, m_brokerPort))
+        {
+            isSent = sendPacket(PACKET_TYPE_CONNECT, packet, idx);
+        }
+    }
+
+    if (false == isSent)
+    {
+        disconnect();
+    }
+    else
+    {
+        m_rxState   = RX_STATE_HEADER;
+        m_state     = STATE_CONNECTING;
+
+        m_timer.start(CONNACK_TIMEOUT);
+    }
+
+    return;
+}
+
+void MqttClient::disconnect()
+{
+    if (STATE_CONNECTED == m_state)
+    {
+        (void)sendPacket(PACKET_TYPE_DISCONNECT, m_txBuffer, HEADER_SIZE);
+    }
+
+    /* A successful connection resets the backoff, otherwise it is increased. */
+    if (STATE_CONNECTED != m_state)
+    {
+        m_backoff *= 2U;
+
+        if (MAX_BACKOFF < m_backoff)
+        {
+            m_backoff = MAX_BACKOFF;
+        }
+    }
+    else
+    {
+        m_backoff = MIN_BACKOFF;
+    }
+
+    m_client.stop();
+
+    m_isPingPending = false;
+    m_rxState       = RX_STATE_HEADER;
+    m_state         = STATE_DISCONNECTED;
+
+    m_pingTimer.stop();
+    m_timer.start(m_backoff);
+
+    return;
+}
+
+void MqttClient::receive()
+{
+    /* Stop after a complete packet, because its handling may change the state. */
+    bool isComplete = false;
+
+    while((false == isComplete) && (0 < m_client.available()))
+    {
+        int data = m_client.read();
+
+        if (0 > data)
+        {
+            /* Nothing to do. */
+            ;
+        }
+        else if (RX_STATE_HEADER == m_rxState)
+        {
+            m_rxType    = static_cast<uint8_t>(data);
+            m_rxLength  = 0U;
+            m_rxShift   = 0U;
+            m_rxIdx     = 0U;
+            m_rxState   = RX_STATE_LENGTH;
+        }
+        else if (RX_STATE_LENGTH == m_rxState)
+        {
+            /* The remaining length has up to 4 bytes, 7 bits each. */
+            m_rxLength |= static_cast<uint32_t>(data & 0x7f) << m_rxShift;
+            m_rxShift  += 7U;
+
+            if ((0 != (data & 0x80)) &&
+                (28U <= m_rxShift))
+            {
+                /* Malformed packet, the data can't be trusted anymore. */
+                disconnect();
+                isComplete = true;
+            }
+            else if (0 != (data & 0x80))
+            {
+                /* Continues in the next byte. */
+                ;
+            }
+            else if (0U == m_rxLength)
+            {
+                isComplete = true;
+            }
+            else
+            {
+                m_rxState = RX_STATE_DATA;
+            }
+        }
+        else
+        {
+            /* Data, which doesn't fit into the buffer is skipped. */
+            if (MAX_PACKET_SIZE > m_rxIdx)
+            {
+                m_rxBuffer[m_rxIdx] = static_cast<uint8_t>(data);
+            }
+
+            ++m_rxIdx;
+
+            if (m_rxLength <= m_rxIdx)
+            {
+                isComplete = true;
+            }
+        }
+    }
+
+    if ((true == isComplete) &&
+        (RX_STATE_HEADER != m_rxState))
+    {
+        m_rxState = RX_STATE_HEADER;
+
+        if (MAX_PACKET_SIZE >= m_rxLength)
+        {
+            handlePacket();
+        }
+    }
+
+    return;
+}
+
+void MqttClient::handlePacket()
+{
+    /* Any packet from the broker shows that it is alive. */
+    m_isPingPending = false;
+
+    switch(m_rxType & 0xf0U)
+    {
+    case PACKET_TYPE_CONNACK:
+        /* Return code 0 means connection accepted. */
+        if ((STATE_CONNECTING == m_state) &&
+            (2U == m_rxLength) &&
+            (0U == m_rxBuffer[1]))
+        {
+            uint8_t*    packet  = m_txBuffer;
+            size_t      idx     = HEADER_SIZE;
+
+            m_state = STATE_CONNECTED;
+            m_pingTimer.start(KEEP_ALIVE * 1000UL);
+
+            /* The publish is sent before the transmit buffer is used again. */
+            (void)publish(m_statusTopic, "online", true);
+
+            if (nullptr != m_subscription)
+            {
+                /* Packet identifier, topic filter and requested QoS 0. */
+                packet[idx++] = 0x00U;
+                packet[idx++] = 0x01U;
+
+                if (true == appendString(packet, idx, m_subscription))
+                {
+                    packet[idx++] = 0x00U;
+
+                    (void)sendPacket(PACKET_TYPE_SUBSCRIBE, packet, idx);
+                }
+            }
+        }
+        else
+        {
+            disconnect();
+        }
+        break;
+
+    case PACKET_TYPE_PUBLISH:
+        /* Retained messages are skipped, otherwise a retained command
+         * would be executed again after every reconnect.
+         */
+        if ((STATE_CONNECTED == m_state) &&
+            (nullptr != m_handler) &&
+            (0U == (m_rxType & 0x01U)) &&
+            (2U <= m_rxLength))
+        {
+            size_t  topicLen    = (static_cast<size_t>(m_rxBuffer[0]) << 8U) | m_rxBuffer[1];
+            size_t  payloadIdx  = 2U + topicLen;
+
+            /* QoS 1 and 2 have a packet identifier. */
+            if (0U != (m_rxType & 0x06U))
+            {
+                payloadIdx += 2U;
+            }
+
+            if (m_rxLength >= payloadIdx)
+            {
+                /* Terminate topic and payload like strings. The topic is
+                 * moved to the begin, which frees the bytes after it.
+                 */
+                memmove(&m_rxBuffer[0], &m_rxBuffer[2], topicLen);
+                m_rxBuffer[topicLen]    = '\0';
+                m_rxBuffer[m_rxLength]  = '\0';
+
+                m_handler(reinterpret_cast<const char*>(&m_rxBuffer[0]), reinterpret_cast<const char*>(&m_rxBuffer[payloadIdx]));
+            }
+        }
+        break;
+
+    case PACKET_TYPE_SUBACK:
+    case PACKET_TYPE_PINGRESP:
+    default:
+        /* Nothing to do. */
+        break;
+    }
+
+    return;
+}
+
+bool MqttClient::appendString(uint8_t* packet, size_t& idx, const char* str)
+{
+    bool    isAppended  = false;
+    size_t  length      = (nullptr == str) ? 0U : strlen(str);
+
+    if (MAX_PACKET_SIZE >= (idx + 2U + length))
+    {
+        packet[idx++] = static_cast<uint8_t>(length >> 8U);
+        packet[idx++] = static_cast<uint8_t>(length & 0xffU);
+
+        if (0U < length)
+        {
+            memcpy(&packet[idx], str, length);
+            idx += length;
+        }
+
+        isAppended = true;
+    }
+
+    return isAppended;
+}
+
+bool MqttClient::sendPacket(uint8_t type, uint8_t* packet, size_t size)
+{
+    bool    isSent          = false;
+    size_t  remainingLength = size - HEADER_SIZE;
+    size_t  begin           = HEADER_SIZE;
+
+    /* The fixed header is written right-aligned in front of the variable
+     * header, therefore the whole packet is written at once.
+     */
+    if (0x7fU < remainingLength)
+    {
+        --begin;
+        packet[begin] = static_cast<uint8_t>(remainingLength >> 7U);
+        --begin;
+        packet[begin] = static_cast<uint8_t>((remainingLength & 0x7fU) | 0x80U);
+    }
+    else
+    {
+        --begin;
+        packet[begin] = static_cast<uint8_t>(remainingLength);
+    }
+
+    --begin;
+    packet[begin] = type;
+
+    if (static_cast<int>(size - begin) <= m_client.availableForWrite())
+    {
+        isSent = ((size - begin) == m_client.write(&packet[begin], size - begin));
+    }
+
+    return isSent;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
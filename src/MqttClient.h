@@ -0,0 +1,306 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MQTT client
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __MQTT_CLIENT_H__
+#define __MQTT_CLIENT_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+#include <EthernetClient.h>
+
+#include "SimpleTimer.hpp"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Lightweight MQTT 3.1.1 client, which supports only QoS 0 and a single
+ * subscription. All packets are built in fixed buffers on the stack, a
+ * received packet which doesn't fit into the receive buffer is skipped.
+ *
+ * The connection is established and kept by process() step by step. After
+ * a connection loss, it is established again with a increasing backoff.
+ * Only the TCP connect blocks, limited by CONNECT_TIMEOUT. Use isConnectDue()
+ * to hold it off, while a blocked main loop would disturb others.
+ * All packets are built in a single transmit buffer, which is owned by the
+ * client, instead of on the stack.
+ * The last will publishes "offline" retained to the status topic, after
+ * every successful connect "online" is published to it.
+ */
+class MqttClient
+{
+public:
+
+    /**
+     * Handler of a received message.
+     *
+     * @param[in] topic     Topic
+     * @param[in] payload   Payload, terminated like a string.
+     */
+    typedef void (*MessageHandler)(const char* topic, const char* payload);
+
+    /** Keep alive interval in s, requested from the broker. */
+    static const uint16_t   KEEP_ALIVE          = 60U;
+
+    /**
+     * Max. packet size in bytes. It covers the connect packet and a publish
+     * with a 32 character topic and a short payload. Bigger received packets
+     * are skipped.
+     */
+    static const size_t     MAX_PACKET_SIZE     = 64U;
+
+    /**
+     * Max. duration in ms of the TCP connect. The ethernet library connects
+     * blocking, therefore it is kept short.
+     */
+    static const uint16_t   CONNECT_TIMEOUT     = 500U;
+
+    /** Max. duration in ms to wait for the connection acknowledge of the broker. */
+    static const uint32_t   CONNACK_TIMEOUT     = (5UL * 1000UL);
+
+    /** Duration in ms to wait before the first reconnect. It is doubled after every failed try. */
+    static const uint32_t   MIN_BACKOFF         = (1UL * 1000UL);
+
+    /** Max. duration in ms to wait before a reconnect. */
+    static const uint32_t   MAX_BACKOFF         = (5UL * 60UL * 1000UL);
+
+    /**
+     * Constructs a MQTT client, which is not used yet.
+     */
+    MqttClient() :
+        m_state(STATE_IDLE),
+        m_client(),
+        m_brokerAddr(),
+        m_brokerPort(0U),
+        m_clientId(nullptr),
+        m_statusTopic(nullptr),
+        m_subscription(nullptr),
+        m_handler(nullptr),
+        m_backoff(MIN_BACKOFF),
+        m_timer(),
+        m_pingTimer(),
+        m_isPingPending(false),
+        m_rxState(RX_STATE_HEADER),
+        m_rxType(0U),
+        m_rxLength(0U),
+        m_rxShift(0U),
+        m_rxIdx(0U),
+        m_rxBuffer(),
+        m_txBuffer()
+    {
+    }
+
+    /**
+     * Destroys the MQTT client.
+     */
+    ~MqttClient()
+    {
+    }
+
+    /**
+     * Start using the MQTT client. The connection is established by the
+     * next process() calls. All strings must stay valid, until the client
+     * is not used anymore.
+     *
+     * @param[in] brokerAddr    IP-address of the broker
+     * @param[in] brokerPort    Port of the broker
+     * @param[in] clientId      Client id
+     * @param[in] statusTopic   Topic of the online/offline status
+     * @param[in] subscription  Topic filter, which to subscribe. Use nullptr for none.
+     * @param[in] handler       Handler of received messages
+     */
+    void begin(const IPAddress& brokerAddr, uint16_t brokerPort, const char* clientId, const char* statusTopic, const char* subscription, MessageHandler handler);
+
+    /**
+     * Process the client. It establishes and keeps the connection and
+     * handles received messages.
+     */
+    void process();
+
+    /**
+     * Is the client connected to the broker?
+     *
+     * @return If connected, it will return true otherwise false.
+     */
+    bool isConnected() const
+    {
+        return (STATE_CONNECTED == m_state);
+    }
+
+    /**
+     * Will the next process() call connect to the broker, which blocks?
+     *
+     * @return If a connect is due, it will return true otherwise false.
+     */
+    bool isConnectDue()
+    {
+        return ((STATE_DISCONNECTED == m_state) && (true == m_timer.isTimeout()));
+    }
+
+    /**
+     * Publish a message with QoS 0. It is only written as a whole, if
+     * the transmit buffer has not enough space, it will fail and can be
+     * tried again later.
+     *
+     * @param[in] topic         Topic
+     * @param[in] payload       Payload
+     * @param[in] isRetained    Shall the broker retain the message?
+     *
+     * @return If published, it will return true otherwise false.
+     */
+    bool publish(const char* topic, const char* payload, bool isRetained);
+
+private:
+
+    /**
+     * Client states
+     */
+    enum State
+    {
+        STATE_IDLE = 0,         /**< Client is not used */
+        STATE_DISCONNECTED,     /**< Wait for the next connect */
+        STATE_CONNECTING,       /**< Wait for the connection acknowledge */
+        STATE_CONNECTED         /**< Connected to the broker */
+    };
+
+    /**
+     * Receive states
+     */
+    enum RxState
+    {
+        RX_STATE_HEADER = 0,    /**< Wait for the packet type */
+        RX_STATE_LENGTH,        /**< Wait for the remaining length */
+        RX_STATE_DATA           /**< Wait for the remaining data */
+    };
+
+    /** MQTT control packet types, including the fixed header flags. */
+    enum PacketType
+    {
+        PACKET_TYPE_CONNECT     = 0x10, /**< Connect */
+        PACKET_TYPE_CONNACK     = 0x20, /**< Connection acknowledge */
+        PACKET_TYPE_PUBLISH     = 0x30, /**< Publish */
+        PACKET_TYPE_SUBSCRIBE   = 0x82, /**< Subscribe */
+        PACKET_TYPE_SUBACK      = 0x90, /**< Subscribe acknowledge */
+        PACKET_TYPE_PINGREQ     = 0xc0, /**< Ping request */
+        PACKET_TYPE_PINGRESP    = 0xd0, /**< Ping response */
+        PACKET_TYPE_DISCONNECT  = 0xe0  /**< Disconnect */
+    };
+
+    /** Size of the fixed header, which is the type and up to 2 bytes remaining length. */
+    static const size_t     HEADER_SIZE = 3U;
+
+    State           m_state;                        /**< Client state */
+    EthernetClient  m_client;                       /**< Connection to the broker */
+    IPAddress       m_brokerAddr;                   /**< IP-address of the broker */
+    uint16_t        m_brokerPort;                   /**< Port of the broker */
+    const char*     m_clientId;                     /**< Client id */
+    const char*     m_statusTopic;                  /**< Topic of the online/offline status */
+    const char*     m_subscription;                 /**< Topic filter, which to subscribe */
+    MessageHandler  m_handler;                      /**< Handler of received messages */
+    uint32_t        m_backoff;                      /**< Duration in ms until the next reconnect */
+    SimpleTimer     m_timer;                        /**< Observes reconnect backoff and connection acknowledge */
+    SimpleTimer     m_pingTimer;                    /**< Observes the keep alive interval */
+    bool            m_isPingPending;                /**< Waiting for the ping response? */
+    RxState         m_rxState;                      /**< Receive state */
+    uint8_t         m_rxType;                       /**< Type of the received packet */
+    uint32_t        m_rxLength;                     /**< Remaining length of the received packet */
+    uint8_t         m_rxShift;                      /**< Bit position of the next remaining length byte */
+    uint32_t        m_rxIdx;                        /**< Number of received data bytes */
+    uint8_t         m_rxBuffer[MAX_PACKET_SIZE + 1];/**< Received data, with space for a string termination. */
+    uint8_t         m_txBuffer[MAX_PACKET_SIZE];    /**< Packet, which is built to be sent. */
+
+    MqttClient(const MqttClient& client);
+    MqttClient& operator=(const MqttClient& client);
+
+    /**
+     * Connect to the broker and send the connect packet.
+     */
+    void connect();
+
+    /**
+     * Close the connection and wait for the reconnect.
+     */
+    void disconnect();
+
+    /**
+     * Receive the available data, until a packet is complete.
+     */
+    void receive();
+
+    /**
+     * Handle a completely received packet.
+     */
+    void handlePacket();
+
+    /**
+     * Append a string with its length prefix to the packet.
+     *
+     * @param[in]       packet  Packet buffer
+     * @param[in,out]   idx     Index of the next byte in the packet buffer
+     * @param[in]       str     String
+     *
+     * @return If the string fits into the packet, it will return true otherwise false.
+     */
+    static bool appendString(uint8_t* packet, size_t& idx, const char* str);
+
+    /**
+     * Send a packet. The packet buffer must contain the variable header and
+     * the payload after HEADER_SIZE bytes, the fixed header is added.
+     *
+     * @param[in] type      Packet type with its flags
+     * @param[in] packet    Packet buffer
+     * @param[in] size      Size of the packet buffer content in bytes, including HEADER_SIZE.
+     *
+     * @return If sent, it will return true otherwise false.
+     */
+    bool sendPacket(uint8_t type, uint8_t* packet, size_t size);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __MQTT_CLIENT_H__ */
+
+/** @} */
@@ -0,0 +1,230 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MessagePack writer
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "MsgPackWriter.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void MsgPackWriter::writeMap(uint16_t size)
+{
+    if (0x0fU >= size)
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_FIXMAP | size));
+    }
+    else
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_MAP16));
+        writeBigEndian(size, 2U);
+    }
+
+    return;
+}
+
+void MsgPackWriter::writeArray(uint16_t size)
+{
+    if (0x0fU >= size)
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_FIXARRAY | size));
+    }
+    else
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_ARRAY16));
+        writeBigEndian(size, 2U);
+    }
+
+    return;
+}
+
+void MsgPackWriter::writeInt(int32_t value)
+{
+    if (0 <= value)
+    {
+        writeUInt(static_cast<uint32_t>(value));
+    }
+    /* Negative fixint */
+    else if (-32 <= value)
+    {
+        (void)m_out.write(static_cast<uint8_t>(value));
+    }
+    else if (INT8_MIN <= value)
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_INT8));
+        writeBigEndian(static_cast<uint32_t>(value), 1U);
+    }
+    else if (INT16_MIN <= value)
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_INT16));
+        writeBigEndian(static_cast<uint32_t>(value), 2U);
+    }
+    else
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_INT32));
+        writeBigEndian(static_cast<uint32_t>(value), 4U);
+    }
+
+    return;
+}
+
+void MsgPackWriter::writeUInt(uint32_t value)
+{
+    /* Positive fixint */
+    if (0x7fU >= value)
+    {
+        (void)m_out.write(static_cast<uint8_t>(value));
+    }
+    else if (UINT8_MAX >= value)
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_UINT8));
+        writeBigEndian(value, 1U);
+    }
+    else if (UINT16_MAX >= value)
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_UINT16));
+        writeBigEndian(value, 2U);
+    }
+    else
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_UINT32));
+        writeBigEndian(value, 4U);
+    }
+
+    return;
+}
+
+void MsgPackWriter::writeBool(bool value)
+{
+    (void)m_out.write(static_cast<uint8_t>((true == value) ? FORMAT_TRUE : FORMAT_FALSE));
+
+    return;
+}
+
+void MsgPackWriter::writeString(const char* str)
+{
+    size_t length = (nullptr == str) ? 0U : strlen(str);
+
+    writeStringHeader(length);
+
+    if (0U < length)
+    {
+        (void)m_out.write(reinterpret_cast<const uint8_t*>(str), length);
+    }
+
+    return;
+}
+
+void MsgPackWriter::writeString(const String& str)
+{
+    writeStringHeader(str.length());
+    (void)m_out.print(str);
+
+    return;
+}
+
+void MsgPackWriter::writeString(const __FlashStringHelper* str)
+{
+    writeStringHeader(strlen_P(reinterpret_cast<const char*>(str)));
+    (void)m_out.print(str);
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+void MsgPackWriter::writeStringHeader(size_t length)
+{
+    if (0x1fU >= length)
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_FIXSTR | length));
+    }
+    else if (UINT8_MAX >= length)
+    {
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_STR8));
+        writeBigEndian(length, 1U);
+    }
+    else
+    {
+        /* Longer strings are not used, because they won't fit into RAM. */
+        (void)m_out.write(static_cast<uint8_t>(FORMAT_STR16));
+        writeBigEndian(length, 2U);
+    }
+
+    return;
+}
+
+void MsgPackWriter::writeBigEndian(uint32_t value, uint8_t size)
+{
+    while(0U < size)
+    {
+        --size;
+        (void)m_out.write(static_cast<uint8_t>(value >> (8U * size)));
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,191 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MessagePack writer
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __MSG_PACK_WRITER_H__
+#define __MSG_PACK_WRITER_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Writes MessagePack encoded data directly to the output, without any
+ * intermediate document. The caller is responsible for the structure, e.g.
+ * a map with 2 entries is written as map header, followed by 2 key/value
+ * pairs. Integers are always written in the smallest possible encoding.
+ *
+ * See https://github.com/msgpack/msgpack/blob/master/spec.md
+ */
+class MsgPackWriter
+{
+public:
+
+    /**
+     * Constructs a MessagePack writer.
+     *
+     * @param[in] out   Output
+     */
+    MsgPackWriter(Print& out) :
+        m_out(out)
+    {
+    }
+
+    /**
+     * Destroys the MessagePack writer.
+     */
+    ~MsgPackWriter()
+    {
+    }
+
+    /**
+     * Write a map header. It shall be followed by the given number of
+     * key/value pairs.
+     *
+     * @param[in] size  Number of key/value pairs
+     */
+    void writeMap(uint16_t size);
+
+    /**
+     * Write a array header. It shall be followed by the given number of
+     * elements.
+     *
+     * @param[in] size  Number of elements
+     */
+    void writeArray(uint16_t size);
+
+    /**
+     * Write a signed integer.
+     *
+     * @param[in] value Value
+     */
+    void writeInt(int32_t value);
+
+    /**
+     * Write a unsigned integer.
+     *
+     * @param[in] value Value
+     */
+    void writeUInt(uint32_t value);
+
+    /**
+     * Write a boolean.
+     *
+     * @param[in] value Value
+     */
+    void writeBool(bool value);
+
+    /**
+     * Write a string.
+     *
+     * @param[in] str   String
+     */
+    void writeString(const char* str);
+
+    /**
+     * Write a string.
+     *
+     * @param[in] str   String
+     */
+    void writeString(const String& str);
+
+    /**
+     * Write a string, which is located in program memory.
+     *
+     * @param[in] str   String
+     */
+    void writeString(const __FlashStringHelper* str);
+
+private:
+
+    /** MessagePack format types */
+    enum Format
+    {
+        FORMAT_FIXMAP   = 0x80, /**< Map with up to 15 entries */
+        FORMAT_FIXARRAY = 0x90, /**< Array with up to 15 elements */
+        FORMAT_FIXSTR   = 0xa0, /**< String with up to 31 bytes */
+        FORMAT_FALSE    = 0xc2, /**< Boolean false */
+        FORMAT_TRUE     = 0xc3, /**< Boolean true */
+        FORMAT_UINT8    = 0xcc, /**< 8 bit unsigned integer */
+        FORMAT_UINT16   = 0xcd, /**< 16 bit unsigned integer */
+        FORMAT_UINT32   = 0xce, /**< 32 bit unsigned integer */
+        FORMAT_INT8     = 0xd0, /**< 8 bit signed integer */
+        FORMAT_INT16    = 0xd1, /**< 16 bit signed integer */
+        FORMAT_INT32    = 0xd2, /**< 32 bit signed integer */
+        FORMAT_STR8     = 0xd9, /**< String with up to 255 bytes */
+        FORMAT_STR16    = 0xda, /**< String with up to 65535 bytes */
+        FORMAT_ARRAY16  = 0xdc, /**< Array with up to 65535 elements */
+        FORMAT_MAP16    = 0xde  /**< Map with up to 65535 entries */
+    };
+
+    Print&  m_out;  /**< Output */
+
+    MsgPackWriter();
+    MsgPackWriter(const MsgPackWriter& writer);
+    MsgPackWriter& operator=(const MsgPackWriter& writer);
+
+    /**
+     * Write the header of a string.
+     *
+     * @param[in] length    String length in bytes
+     */
+    void writeStringHeader(size_t length);
+
+    /**
+     * Write a value in big endian byte order.
+     *
+     * @param[in] value Value
+     * @param[in] size  Number of bytes, which to write.
+     */
+    void writeBigEndian(uint32_t value, uint8_t size);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __MSG_PACK_WRITER_H__ */
+
+/** @} */
@@ -0,0 +1,214 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Main entry point of the native build
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * On the host there is no Arduino core, which calls setup() and loop().
+ * The heatpump is simulated and the webserver uses the host network.
+ *
+ * Usage: program [trace | device]
+ *
+ * With a trace, which was exported via /api/capture, the heatpump is
+ * replayed instead of simulated. With a serial device, e.g. the pseudo
+ * terminal of the simulator daemon or a USB serial adapter, the heatpump
+ * is connected via real terminal I/O.
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#if defined(NATIVE) && !defined(PIO_UNIT_TESTING)
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <SerialPort.h>
+#include "SerialReplay.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+extern void setup();
+extern void loop();
+extern void setRego6xxStream(Stream& stream);
+
+static uint8_t* loadFile(const char* fileName, size_t& size);
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** Baudrate of the serial line to the heatpump in bit/s. */
+static const uint32_t   REGO6XX_BAUDRATE    = 19200U;
+
+/** Serial line to the heatpump. */
+static SerialPort       gSerialPort;
+
+/** Replay of a captured trace. */
+static SerialReplay gSerialReplay;
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/**
+ * Main entry point
+ *
+ * @param[in] argc  Number of command line arguments
+ * @param[in] argv  Command line arguments
+ *
+ * @return Exit code
+ */
+extern int main(int argc, char **argv)
+{
+    int         exitCode    = 0;
+    uint8_t*    trace       = nullptr;
+    size_t      traceSize   = 0U;
+    bool        isReplay    = false;
+    struct stat fileStat;
+
+    /* Output shall be shown immediately, like on the serial console. */
+    (void)setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    if (1 >= argc)
+    {
+        /* Simulated heatpump */
+        ;
+    }
+    else if ((0 == stat(argv[1], &fileStat)) &&
+             (S_IFCHR == (fileStat.st_mode & S_IFMT)))
+    {
+        if (false == gSerialPort.open(argv[1], REGO6XX_BAUDRATE))
+        {
+            fprintf(stderr, "Serial device %s not available.\n", argv[1]);
+            exitCode = 1;
+        }
+        else
+        {
+            setRego6xxStream(gSerialPort);
+        }
+    }
+    else
+    {
+        trace = loadFile(argv[1], traceSize);
+
+        if (false == gSerialReplay.load(trace, traceSize))
+        {
+            fprintf(stderr, "Invalid trace %s.\n", argv[1]);
+            exitCode = 1;
+        }
+        else
+        {
+            setRego6xxStream(gSerialReplay);
+            isReplay = true;
+        }
+    }
+
+    if (0 == exitCode)
+    {
+        setup();
+
+        while(1)
+        {
+            loop();
+
+            if ((true == isReplay) &&
+                (true == gSerialReplay.isFinished()))
+            {
+                printf("Replay finished, %u bytes differ from the trace.\n", gSerialReplay.getMismatches());
+                isReplay = false;
+            }
+        }
+    }
+
+    free(trace);
+
+    return exitCode;
+}
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+/**
+ * Load a file completely into memory.
+ *
+ * @param[in]  fileName Name of the file
+ * @param[out] size     File size in bytes
+ *
+ * @return File content, which shall be released with free(). If it fails, it will return nullptr.
+ */
+static uint8_t* loadFile(const char* fileName, size_t& size)
+{
+    uint8_t*    buffer  = nullptr;
+    FILE*       fd      = fopen(fileName, "rb");
+
+    size = 0U;
+
+    if (nullptr != fd)
+    {
+        long fileSize = -1;
+
+        if (0 == fseek(fd, 0, SEEK_END))
+        {
+            fileSize = ftell(fd);
+        }
+
+        if ((0 < fileSize) &&
+            (0 == fseek(fd, 0, SEEK_SET)))
+        {
+            buffer = static_cast<uint8_t*>(malloc(static_cast<size_t>(fileSize)));
+        }
+
+        if (nullptr != buffer)
+        {
+            size = fread(buffer, 1U, static_cast<size_t>(fileSize), fd);
+        }
+
+        (void)fclose(fd);
+    }
+
+    return buffer;
+}
+
+#endif  /* defined(NATIVE) && !defined(PIO_UNIT_TESTING) */
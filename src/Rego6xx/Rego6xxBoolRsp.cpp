@@ -63,7 +63,8 @@ bool Rego6xxBoolRsp::isValid() const
 {
     bool isValid = false;
 
-    if (false == isPending())
+    if ((false == isPending()) &&
+        (false == isRejected()))
     {
         if (m_response[RSP_SIZE - 1] == Rego6xxUtil::calculateChecksum(&m_response[1], RSP_SIZE - 2))
         {
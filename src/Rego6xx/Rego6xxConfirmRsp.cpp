@@ -63,7 +63,8 @@ bool Rego6xxConfirmRsp::isValid() const
 {
     bool isValid = false;
 
-    if (false == m_isPending)
+    if ((false == m_isPending) &&
+        (false == m_isRejected))
     {
         isValid = true;
     }
@@ -88,7 +89,8 @@ bool Rego6xxConfirmRsp::isConfirmed() const
 {
     bool isConfirmed = false;
 
-    if (false == m_isPending)
+    if ((false == m_isPending) &&
+        (false == m_isRejected))
     {
         isConfirmed = true;
     }
@@ -66,8 +66,7 @@ const Rego6xxStdRsp* Rego6xxCtrl::readSysReg(Rego6xxCtrl::SysRegAddr sysRegAddr)
     if (nullptr == m_pendingRsp)
     {
         writeCmd(DEV_ADDR_HEATPUMP, CMD_ID_READ_SYSTEM_REG, sysRegAddr, 0);
-        m_stdRsp.acquire();
-        m_pendingRsp    = &m_stdRsp;
+        startRsp(m_stdRsp);
         rsp             = &m_stdRsp;
     }
 
@@ -81,8 +80,7 @@ const Rego6xxConfirmRsp* Rego6xxCtrl::writeSysReg(Rego6xxCtrl::SysRegAddr sysReg
     if (nullptr == m_pendingRsp)
     {
         writeCmd(DEV_ADDR_HEATPUMP, CMD_ID_WRITE_SYSTEM_REG, sysRegAddr, data);
-        m_confirmRsp.acquire();
-        m_pendingRsp    = &m_confirmRsp;
+        startRsp(m_confirmRsp);
         rsp             = &m_confirmRsp;
     }
 
@@ -96,8 +94,7 @@ const Rego6xxErrorRsp* Rego6xxCtrl::readLastError()
     if (nullptr == m_pendingRsp)
     {
         writeCmd(DEV_ADDR_HEATPUMP, CMD_ID_READ_LAST_ERROR, 0, 0);
-        m_errorRsp.acquire();
-        m_pendingRsp    = &m_errorRsp;
+        startRsp(m_errorRsp);
         rsp             = &m_errorRsp;
     }
 
@@ -111,8 +108,7 @@ const Rego6xxStdRsp* Rego6xxCtrl::readRegoVersion()
     if (nullptr == m_pendingRsp)
     {
         writeCmd(DEV_ADDR_HEATPUMP, CMD_ID_READ_REGO_VERSION, 0, 0);
-        m_stdRsp.acquire();
-        m_pendingRsp    = &m_stdRsp;
+        startRsp(m_stdRsp);
         rsp             = &m_stdRsp;
     }
 
@@ -126,8 +122,7 @@ const Rego6xxBoolRsp* Rego6xxCtrl::readFrontPanel(Rego6xxCtrl::FrontPanelAddr ad
     if (nullptr == m_pendingRsp)
     {
         writeCmd(DEV_ADDR_HEATPUMP, CMD_ID_READ_FRONT_PANEL, addr, 0);
-        m_boolRsp.acquire();
-        m_pendingRsp    = &m_boolRsp;
+        startRsp(m_boolRsp);
         rsp             = &m_boolRsp;
     }
 
@@ -141,8 +136,7 @@ const Rego6xxConfirmRsp* Rego6xxCtrl::writeFrontPanel(Rego6xxCtrl::FrontPanelAdd
     if (nullptr == m_pendingRsp)
     {
         writeCmd(DEV_ADDR_HEATPUMP, CMD_ID_WRITE_FRONT_PANEL, addr, value);
-        m_confirmRsp.acquire();
-        m_pendingRsp    = &m_confirmRsp;
+        startRsp(m_confirmRsp);
         rsp             = &m_confirmRsp;
     }
 
@@ -156,66 +150,96 @@ const Rego6xxDisplayRsp* Rego6xxCtrl::readDisplay(Rego6xxCtrl::Row row)
     if (nullptr == m_pendingRsp)
     {
         writeCmd(DEV_ADDR_HEATPUMP, CMD_ID_READ_DISPLAY, row, 0);
-        m_displayRsp.acquire();
-        m_pendingRsp    = &m_displayRsp;
+        startRsp(m_displayRsp);
         rsp             = &m_displayRsp;
     }
 
     return rsp;
 }
 
-String Rego6xxCtrl::writeDbg(uint8_t cmdId, uint16_t addr, uint16_t data)
+const Rego6xxRawRsp* Rego6xxCtrl::writeRaw(uint8_t cmdId, uint16_t addr, uint16_t data)
 {
-    uint8_t             cmdBuffer[CMD_SIZE];
-    const size_t        RCV_BUFFER_SIZE = 64;
-    uint8_t             rcvBuffer[RCV_BUFFER_SIZE];
-    const unsigned long TIMEOUT         = 4000;
-    unsigned long       lastTimeout     = m_stream.getTimeout();
-    size_t              read            = 0;
-    size_t              idx             = 0;
-    String              rsp;
+    const Rego6xxRawRsp*    rsp = nullptr;
 
-    /*
-        *----------------*------------*------------------*------*----------*
-        |       1        |      1     |         3        |   3  |     1    | <- Number of bytes
-        *----------------*------------*------------------*------*----------*
-        | Device Address | Command ID | Register Address | Data | Checksum |
-        *----------------*------------*------------------*------*----------*
-    */
-    
-    /* Common rules:
-        - MSB first
-        - 7 bit communication is used,
-            e.g. register address 0x1234 in binary form 00010010 001101000
-            will be expanded to 7bit form 00 0100100 01101000
-    */
-    cmdBuffer[0] = DEV_ADDR_HEATPUMP;
-    cmdBuffer[1] = cmdId;
-    cmdBuffer[2] = (addr >> 14) & 0x03;
-    cmdBuffer[3] = (addr >>  7) & 0x7f;
-    cmdBuffer[4] = (addr >>  0) & 0x7f;
-    cmdBuffer[5] = (data >> 14) & 0x03;
-    cmdBuffer[6] = (data >>  7) & 0x7f;
-    cmdBuffer[7] = (data >>  0) & 0x7f;
-    cmdBuffer[8] = Rego6xxUtil::calculateChecksum(&cmdBuffer[2], CMD_SIZE - 3);
-
-    (void)m_stream.write(cmdBuffer, CMD_SIZE);
+    if (nullptr == m_pendingRsp)
+    {
+        writeCmd(DEV_ADDR_HEATPUMP, cmdId, addr, data);
+        startRsp(m_rawRsp);
+        rsp             = &m_rawRsp;
+    }
 
-    m_stream.setTimeout(TIMEOUT);
-    read = m_stream.readBytes(rcvBuffer, RCV_BUFFER_SIZE);
-    m_stream.setTimeout(lastTimeout);
+    return rsp;
+}
 
-    while(read > idx)
+void Rego6xxCtrl::process()
+{
+    if (nullptr != m_pendingRsp)
     {
-        char buffer[3];
+        bool wasPending = m_pendingRsp->isPending();
+
+        m_pendingRsp->receive();
+
+        /* Response finished just now? */
+        if ((true == wasPending) &&
+            (false == m_pendingRsp->isPending()))
+        {
+            uint32_t duration = millis() - m_cmdTimestamp;
+
+            /* A response from another device is rejected like a corrupted
+             * one. The raw response is excluded, because it is handed over
+             * to the user as it is.
+             */
+            if ((&m_rawRsp != m_pendingRsp) &&
+                (false == m_pendingRsp->isTimeout()) &&
+                (true == m_pendingRsp->isValid()) &&
+                (DEV_ADDR_HOST != m_pendingRsp->getDevAddr()))
+            {
+                m_pendingRsp->reject();
+            }
+
+            updateStatistics(duration);
+
+            if (UINT16_MAX < duration)
+            {
+                duration = UINT16_MAX;
+            }
+
+            /* Moving average over about 8 transactions. */
+            if (0U == m_avgDuration)
+            {
+                m_avgDuration = static_cast<uint16_t>(duration);
+            }
+            else
+            {
+                m_avgDuration = static_cast<uint16_t>(((7UL * m_avgDuration) + duration) / 8UL);
+            }
+        }
+    }
 
-        sprintf(buffer, "%02X", rcvBuffer[idx]);
-        rsp += buffer;
+    updateUtilization();
 
+    return;
+}
+
+Rego6xxCtrl::Statistics Rego6xxCtrl::getStatistics() const
+{
+    Statistics  statistics;
+    uint8_t     idx         = 0U;
+
+    statistics.transactions     = 0U;
+    statistics.timeouts         = 0U;
+    statistics.checksumErrors   = 0U;
+    statistics.avgDuration      = m_avgDuration;
+
+    while(CMD_STATS_ID_MAX > idx)
+    {
+        statistics.transactions     += m_cmdStatistics[idx].issued;
+        statistics.timeouts         += m_cmdStatistics[idx].timeouts;
+        statistics.checksumErrors   += m_cmdStatistics[idx].checksumErrors;
         ++idx;
     }
 
-    return rsp;
+    return statistics;
 }
 
 /******************************************************************************
@@ -226,7 +250,7 @@ String Rego6xxCtrl::writeDbg(uint8_t cmdId, uint16_t addr, uint16_t data)
  * Private Methods
  *****************************************************************************/
 
-void Rego6xxCtrl::writeCmd(uint8_t devAddr, CmdId cmdId, uint16_t regAddr, uint16_t data)
+void Rego6xxCtrl::writeCmd(uint8_t devAddr, uint8_t cmdId, uint16_t regAddr, uint16_t data)
 {
     uint8_t cmdBuffer[CMD_SIZE];
 
@@ -254,11 +278,153 @@ void Rego6xxCtrl::writeCmd(uint8_t devAddr, CmdId cmdId, uint16_t regAddr, uint1
     cmdBuffer[7] = (data >>  0) & 0x7f;
     cmdBuffer[8] = Rego6xxUtil::calculateChecksum(&cmdBuffer[2], CMD_SIZE - 3);
 
+    /* Discard stale bytes, e.g. the rest of a too long or late response.
+     * Otherwise every following response would be shifted.
+     */
+    while(0 < m_stream.available())
+    {
+        (void)m_stream.read();
+    }
+
     (void)m_stream.write(cmdBuffer, CMD_SIZE);
+    m_cmdStatsId = getCmdStatsId(cmdId);
+    ++m_cmdStatistics[m_cmdStatsId].issued;
+    m_cmdTimestamp = millis();
+
+    return;
+}
+
+void Rego6xxCtrl::startRsp(Rego6xxRsp& rsp)
+{
+    uint32_t timeout = Rego6xxRsp::DEFAULT_TIMEOUT;
+
+    if (0U < m_baudrate)
+    {
+        uint8_t*    buffer  = nullptr;
+        size_t      size    = 0U;
+
+        rsp.getResponse(buffer, size);
+
+        timeout = ((CMD_SIZE + size) * BITS_PER_BYTE * 1000UL) / m_baudrate;
+        timeout += RSP_TIMEOUT_MARGIN;
+
+        if (MIN_RSP_TIMEOUT > timeout)
+        {
+            timeout = MIN_RSP_TIMEOUT;
+        }
+    }
+
+    /* The timeout starts with the command, which was just written. */
+    rsp.acquire(timeout);
+
+    m_pendingRsp = &rsp;
+
+    return;
+}
+
+void Rego6xxCtrl::updateStatistics(uint32_t duration)
+{
+    CmdStatistics& cmdStatistics = m_cmdStatistics[m_cmdStatsId];
+
+    m_windowBusyTime += duration;
+
+    if (true == m_pendingRsp->isTimeout())
+    {
+        ++cmdStatistics.timeouts;
+    }
+    else
+    {
+#if defined(TURNAROUND_HISTOGRAM)
+        uint8_t bucket = 0U;
+
+        while(((NUM_TURNAROUND_BUCKETS - 1U) > bucket) && (getTurnaroundBound(bucket) < duration))
+        {
+            ++bucket;
+        }
+
+        ++cmdStatistics.turnaroundHistogram[bucket];
+#endif  /* defined(TURNAROUND_HISTOGRAM) */
+
+        ++cmdStatistics.completed;
+        cmdStatistics.turnaroundSum += duration;
+
+        if (true == m_pendingRsp->isRejected())
+        {
+            ++cmdStatistics.wrongDevAddrs;
+        }
+        else if (false == m_pendingRsp->isValid())
+        {
+            ++cmdStatistics.checksumErrors;
+        }
+        else
+        {
+            /* Nothing to do. */
+            ;
+        }
+    }
 
     return;
 }
 
+void Rego6xxCtrl::updateUtilization()
+{
+    uint32_t elapsed = millis() - m_windowTimestamp;
+
+    if (UTILIZATION_WINDOW <= elapsed)
+    {
+        /* A transaction is accounted in the window, where it ends. Therefore
+         * the busy time may exceed the window a little.
+         */
+        if (elapsed < m_windowBusyTime)
+        {
+            m_windowBusyTime = elapsed;
+        }
+
+        m_utilization       = static_cast<uint16_t>((m_windowBusyTime * 1000UL) / elapsed);
+        m_windowTimestamp   = millis();
+        m_windowBusyTime    = 0U;
+    }
+
+    return;
+}
+
+Rego6xxCtrl::CmdStatsId Rego6xxCtrl::getCmdStatsId(uint8_t cmdId)
+{
+    CmdStatsId id = CMD_STATS_ID_OTHER;
+
+    switch(cmdId)
+    {
+    case CMD_ID_READ_FRONT_PANEL:
+        id = CMD_STATS_ID_READ_FRONT_PANEL;
+        break;
+
+    case CMD_ID_WRITE_FRONT_PANEL:
+        id = CMD_STATS_ID_WRITE_FRONT_PANEL;
+        break;
+
+    case CMD_ID_READ_SYSTEM_REG:
+        id = CMD_STATS_ID_READ_SYSTEM_REG;
+        break;
+
+    case CMD_ID_WRITE_SYSTEM_REG:
+        id = CMD_STATS_ID_WRITE_SYSTEM_REG;
+        break;
+
+    case CMD_ID_READ_DISPLAY:
+        id = CMD_STATS_ID_READ_DISPLAY;
+        break;
+
+    case CMD_ID_READ_LAST_ERROR:
+        id = CMD_STATS_ID_READ_LAST_ERROR;
+        break;
+
+    default:
+        break;
+    }
+
+    return id;
+}
+
 /******************************************************************************
  * External Functions
  *****************************************************************************/
@@ -47,6 +47,7 @@
 #include "Rego6xxErrorRsp.h"
 #include "Rego6xxBoolRsp.h"
 #include "Rego6xxDisplayRsp.h"
+#include "Rego6xxRawRsp.h"
 
 /******************************************************************************
  * Macros
@@ -168,6 +169,62 @@ public:
         DISPLAY_ROW_4 = 0x03    /**< Row 4 */
     };
 
+    /**
+     * Statistics of the communication with the heatpump. The counters are
+     * the totals of all command statistics.
+     */
+    struct Statistics
+    {
+        uint32_t    transactions;   /**< Number of sent commands */
+        uint32_t    timeouts;       /**< Number of responses, which timed out */
+        uint32_t    checksumErrors; /**< Number of invalid responses */
+        uint16_t    avgDuration;    /**< Moving average of the transaction duration in ms, 0 if unknown. */
+    };
+
+    /**
+     * Commands, which are counted separately in the command statistics.
+     * All other command ids, e.g. raw commands, are counted together.
+     */
+    enum CmdStatsId
+    {
+        CMD_STATS_ID_READ_FRONT_PANEL = 0,  /**< Read from front panel */
+        CMD_STATS_ID_WRITE_FRONT_PANEL,     /**< Write to front panel */
+        CMD_STATS_ID_READ_SYSTEM_REG,       /**< Read system register */
+        CMD_STATS_ID_WRITE_SYSTEM_REG,      /**< Write system register */
+        CMD_STATS_ID_READ_DISPLAY,          /**< Read display */
+        CMD_STATS_ID_READ_LAST_ERROR,       /**< Read last error line */
+        CMD_STATS_ID_OTHER,                 /**< Any other command */
+        CMD_STATS_ID_MAX                    /**< Number of command statistics */
+    };
+
+    /** Number of turnaround histogram buckets. The last one has no upper bound. */
+    static const uint8_t    NUM_TURNAROUND_BUCKETS  = 5U;
+
+    /** Upper bound in ms of the first turnaround histogram bucket. Every further bucket is 2 times bigger. */
+    static const uint32_t   FIRST_TURNAROUND_BOUND  = 10U;
+
+    /** Duration in ms of the window, over which the bus utilization is determined. */
+    static const uint32_t   UTILIZATION_WINDOW      = (60UL * 1000UL);
+
+    /**
+     * Statistics of a single command. The turnaround is the time from
+     * sending the command until the response is completely received.
+     * The turnaround histogram is only built with TURNAROUND_HISTOGRAM,
+     * because of the little RAM on the device.
+     */
+    struct CmdStatistics
+    {
+        uint32_t    issued;                                     /**< Number of sent commands */
+        uint32_t    completed;                                  /**< Number of received responses, valid or not */
+        uint32_t    timeouts;                                   /**< Number of responses, which timed out */
+        uint32_t    checksumErrors;                             /**< Number of invalid responses */
+        uint32_t    wrongDevAddrs;                              /**< Number of valid responses with a wrong device address */
+        uint32_t    turnaroundSum;                              /**< Sum of the turnaround of all received responses in ms */
+#if defined(TURNAROUND_HISTOGRAM)
+        uint32_t    turnaroundHistogram[NUM_TURNAROUND_BUCKETS];/**< Number of received responses per turnaround bucket */
+#endif  /* defined(TURNAROUND_HISTOGRAM) */
+    };
+
     /**
      * Constructs the Rego6xx controller.
      * 
@@ -180,7 +237,16 @@ public:
         m_confirmRsp(stream),
         m_errorRsp(stream),
         m_boolRsp(stream),
-        m_displayRsp(stream)
+        m_displayRsp(stream),
+        m_rawRsp(stream),
+        m_cmdStatistics(),
+        m_cmdStatsId(CMD_STATS_ID_OTHER),
+        m_cmdTimestamp(0U),
+        m_baudrate(0U),
+        m_windowTimestamp(0U),
+        m_windowBusyTime(0U),
+        m_utilization(0U),
+        m_avgDuration(0U)
     {
     }
 
@@ -191,6 +257,18 @@ public:
     {
     }
 
+    /**
+     * Set the baudrate of the stream. It is used to derive the response
+     * timeout from the expected frame length. Without, every response
+     * uses a conservative default timeout.
+     * 
+     * @param[in] baudrate  Baudrate in bit/s
+     */
+    void setBaudrate(uint32_t baudrate)
+    {
+        m_baudrate = baudrate;
+    }
+
     /**
      * Read from system register.
      * 
@@ -255,9 +333,9 @@ public:
     const Rego6xxDisplayRsp* readDisplay(Row row);
 
     /**
-     * Write a value to the given address.
+     * Write a raw command with any command id to the given address.
      * Only used for debugging purposes and reverse engineering of the Rego6xx controller
-     * communication.
+     * communication. The response is collected as raw bytes.
      * 
      * @param[in] cmdId Command id
      * @param[in] addr  Address
@@ -265,19 +343,13 @@ public:
      * 
      * @return Asynchronous response
      */
-    String writeDbg(uint8_t cmdId, uint16_t addr, uint16_t value);
+    const Rego6xxRawRsp* writeRaw(uint8_t cmdId, uint16_t addr, uint16_t value);
 
     /**
      * Process the controller, which is necessary to receive responses from
      * the heatpump.
      */
-    void process()
-    {
-        if (nullptr != m_pendingRsp)
-        {
-            m_pendingRsp->receive();
-        }
-    }
+    void process();
 
     /**
      * Release response.
@@ -308,6 +380,50 @@ public:
         return isPending;
     }
 
+    /**
+     * Get the statistics of the communication with the heatpump.
+     * 
+     * @return Statistics
+     */
+    Statistics getStatistics() const;
+
+    /**
+     * Get the statistics of a single command.
+     *
+     * @param[in] id    Command statistics id
+     *
+     * @return Command statistics
+     */
+    const CmdStatistics& getCmdStatistics(CmdStatsId id) const
+    {
+        return m_cmdStatistics[(CMD_STATS_ID_MAX > id) ? id : CMD_STATS_ID_OTHER];
+    }
+
+    /**
+     * Get the inclusive upper bound of a turnaround histogram bucket. A
+     * turnaround belongs to the first bucket, whose bound is greater than
+     * or equal to it, like the le label of a Prometheus histogram.
+     *
+     * @param[in] bucket    Histogram bucket, the last one has no upper bound.
+     *
+     * @return Upper bound in ms
+     */
+    static uint32_t getTurnaroundBound(uint8_t bucket)
+    {
+        return FIRST_TURNAROUND_BOUND << bucket;
+    }
+
+    /**
+     * Get the bus utilization, which is the share of the time spent in
+     * transactions during the last complete utilization window.
+     *
+     * @return Bus utilization in 0.1 %
+     */
+    uint16_t getUtilization() const
+    {
+        return m_utilization;
+    }
+
     /** Device address of heat pump controller */
     static const uint8_t    DEV_ADDR_HEATPUMP   = 0x81;
 
@@ -326,6 +442,28 @@ private:
     Rego6xxErrorRsp     m_errorRsp;     /**< Error log response */
     Rego6xxBoolRsp      m_boolRsp;      /**< Boolean response */
     Rego6xxDisplayRsp   m_displayRsp;   /**< Display response */
+    Rego6xxRawRsp       m_rawRsp;       /**< Raw response */
+    CmdStatistics       m_cmdStatistics[CMD_STATS_ID_MAX];  /**< Communication statistics per command */
+    CmdStatsId          m_cmdStatsId;                       /**< Command statistics id of the last command */
+    uint32_t            m_cmdTimestamp;                     /**< Timestamp in ms, when the last command was sent. */
+    uint32_t            m_baudrate;                         /**< Baudrate in bit/s, 0 if unknown. */
+    uint32_t            m_windowTimestamp;                  /**< Timestamp in ms, when the current utilization window started. */
+    uint32_t            m_windowBusyTime;                   /**< Time in ms spent in transactions in the current utilization window. */
+    uint16_t            m_utilization;                      /**< Bus utilization in 0.1 % of the last utilization window. */
+    uint16_t            m_avgDuration;                      /**< Moving average of the transaction duration in ms, 0 if unknown. */
+
+    /** Time in ms, which the heatpump needs in addition to the transmission of command and response. */
+    static const uint32_t   RSP_TIMEOUT_MARGIN  = 80U;
+
+    /**
+     * Min. response timeout in ms. The margin above is not measured on a real
+     * heatpump yet, therefore the timeout is never shorter than this. A stuck
+     * transaction clears after this time for the short responses.
+     */
+    static const uint32_t   MIN_RSP_TIMEOUT     = 100U;
+
+    /** Number of bits, which are transmitted per byte: start bit, 8 data bits and stop bit. */
+    static const uint32_t   BITS_PER_BYTE       = 10U;
 
     Rego6xxCtrl();
 
@@ -336,7 +474,38 @@ private:
      * @param[in] cmdId     Command id
      * @param[in] data      Command data
      */
-    void writeCmd(uint8_t devAddr, CmdId cmdId, uint16_t regAddr, uint16_t data);
+    void writeCmd(uint8_t devAddr, uint8_t cmdId, uint16_t regAddr, uint16_t data);
+
+    /**
+     * Start waiting for the response of the command, which was just sent.
+     * It must be called right after writeCmd(), because the response timeout
+     * starts immediately. The timeout is derived from the length of the
+     * command and the response at the current baudrate.
+     * 
+     * @param[in] rsp   Response
+     */
+    void startRsp(Rego6xxRsp& rsp);
+
+    /**
+     * Take over the finished transaction in the statistics.
+     *
+     * @param[in] duration  Duration of the transaction in ms
+     */
+    void updateStatistics(uint32_t duration);
+
+    /**
+     * Determine the bus utilization, after the utilization window elapsed.
+     */
+    void updateUtilization();
+
+    /**
+     * Get the command statistics id of a command id.
+     *
+     * @param[in] cmdId Command id
+     *
+     * @return Command statistics id
+     */
+    static CmdStatsId getCmdStatsId(uint8_t cmdId);
 
 };
 
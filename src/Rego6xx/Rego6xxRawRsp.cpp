@@ -0,0 +1,153 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Rego6xx heatpump controller raw response
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "Rego6xxRawRsp.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+bool Rego6xxRawRsp::isValid() const
+{
+    bool isValid = false;
+
+    if ((false == m_isPending) &&
+        (0U < m_size))
+    {
+        isValid = true;
+    }
+
+    return isValid;
+}
+
+uint8_t Rego6xxRawRsp::getDevAddr() const
+{
+    uint8_t devAddr = 0;
+
+    if (true == isValid())
+    {
+        devAddr = m_response[0];
+    }
+
+    return devAddr;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+void Rego6xxRawRsp::acquire(uint32_t timeout)
+{
+    (void)timeout;
+
+    Rego6xxRsp::acquire(RAW_TIMEOUT);
+
+    m_size = 0U;
+    m_gapTimer.stop();
+
+    return;
+}
+
+void Rego6xxRawRsp::receive()
+{
+    /* Response pending? */
+    if (true == m_isPending)
+    {
+        /* Collect all bytes, which are available. */
+        while((RSP_SIZE > m_size) &&
+              (0 < m_stream.available()))
+        {
+            m_response[m_size] = m_stream.read();
+            ++m_size;
+
+            m_gapTimer.start(GAP_TIMEOUT);
+        }
+
+        /* Response complete, because the buffer is full or no further byte followed? */
+        if ((RSP_SIZE <= m_size) ||
+            ((true == m_gapTimer.isTimerRunning()) && (true == m_gapTimer.isTimeout())))
+        {
+            m_isPending = false;
+            m_timer.stop();
+            m_gapTimer.stop();
+        }
+        /* Timeout, without any response? */
+        else if ((0U == m_size) &&
+                 (true == m_timer.isTimeout()))
+        {
+            m_stream.flush();
+            m_isPending = false;
+            m_isTimeout = true;
+            m_timer.stop();
+        }
+        /* Waiting for response. */
+        else
+        {
+            /* Nothing to do. */
+            ;
+        }
+    }
+}
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,175 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Rego6xx heatpump controller raw response
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __REGO6XX_RAW_RSP_H__
+#define __REGO6XX_RAW_RSP_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+#include "Rego6xxRsp.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/* Forward declaration. */
+class Rego6xxCtrl;
+
+/**
+ * A raw response of the Rego6xx heatpump controller with unknown length.
+ * It is used for debugging purposes and reverse engineering.
+ * All bytes are collected, until no further byte is received for a short
+ * time, the buffer is full or the response timed out.
+ */
+class Rego6xxRawRsp : public Rego6xxRsp
+{
+public:
+
+    /** Max. response size in bytes, which is the longest known response (display row, error log). */
+    static const size_t RSP_SIZE    = 42U;
+
+    /**
+     * Constructs a empty response.
+     * 
+     * @param[in] stream    Input stream from heatpump controller.
+     */
+    Rego6xxRawRsp(Stream& stream) :
+        Rego6xxRsp(stream),
+        m_response(),
+        m_size(0U),
+        m_gapTimer()
+    {
+    }
+
+    /**
+     * Destroys a response.
+     */
+    ~Rego6xxRawRsp()
+    {
+    }
+
+    /**
+     * Is response valid?
+     * 
+     * @return If at least one byte is received, it will return true otherwise false.
+     */
+    bool isValid() const override;
+
+    /**
+     * Get device address.
+     * 
+     * @return Device address
+     */
+    uint8_t getDevAddr() const override;
+
+    /**
+     * Get the received bytes.
+     * 
+     * @return Response buffer
+     */
+    const uint8_t* getData() const
+    {
+        return m_response;
+    }
+
+    /**
+     * Get the number of received bytes.
+     * 
+     * @return Response size in bytes
+     */
+    size_t getSize() const
+    {
+        return m_size;
+    }
+
+protected:
+
+    /**
+     * Acquire response, see Rego6xxRsp. The length of a raw response is
+     * unknown, therefore it always uses its own timeout.
+     *
+     * @param[in] timeout   Not used
+     */
+    void acquire(uint32_t timeout) override;
+
+    /**
+     * Receive response. This is called by the controller.
+     */
+    void receive() override;
+
+private:
+
+    /** Timeout in ms, if the heatpump doesn't respond at all. */
+    static const uint32_t   RAW_TIMEOUT = (4UL * 1000UL);
+
+    /** Max. time in ms between two bytes of the response. */
+    static const uint32_t   GAP_TIMEOUT = 50U;
+
+    uint8_t     m_response[RSP_SIZE];   /**< Response message */
+    size_t      m_size;                 /**< Number of received bytes */
+    SimpleTimer m_gapTimer;             /**< Observes the time since the last received byte. */
+
+    Rego6xxRawRsp();
+
+    /**
+     * Get response buffer and its size.
+     * 
+     * @param[out]  buffer  Response buffer
+     * @param[out]  size    Response buffer size in byte
+     */
+    void getResponse(uint8_t*& buffer, size_t& size) override
+    {
+        buffer  = m_response;
+        size    = sizeof(m_response);
+    }
+
+    friend Rego6xxCtrl;
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __REGO6XX_RAW_RSP_H__ */
+
+/** @} */
\ No newline at end of file
@@ -80,20 +80,9 @@ void Rego6xxRsp::receive()
             m_isPending = false;
             m_timer.stop();
         }
-        /* Start response timeout observation as soon as possible. */
-        else if (false == m_timer.isTimerRunning())
-        {
-            m_timer.start(TIMEOUT);
-        }
-        /* Timeout? */
-        else if (true == m_timer.isTimeout())
-        {
-            m_stream.flush();
-            m_isPending = false;
-            memset(buffer, 0, size);
-            m_timer.stop();
-        }
-        /* Response complete received? */
+        /* Response complete received? It is checked before the timeout,
+         * because a late call shall not discard a complete response.
+         */
         else if (static_cast<int>(size) <= m_stream.available())
         {
             uint8_t idx = 0;
@@ -107,6 +96,15 @@ void Rego6xxRsp::receive()
             m_isPending = false;
             m_timer.stop();
         }
+        /* Timeout? */
+        else if (true == m_timer.isTimeout())
+        {
+            m_stream.flush();
+            m_isPending = false;
+            m_isTimeout = true;
+            memset(buffer, 0, size);
+            m_timer.stop();
+        }
         /* Waiting for response. */
         else
         {
@@ -71,6 +71,8 @@ public:
         m_stream(stream),
         m_isUsed(false),
         m_isPending(false),
+        m_isTimeout(false),
+        m_isRejected(false),
         m_timer()
     {
     }
@@ -102,6 +104,27 @@ public:
         return m_isPending;
     }
 
+    /**
+     * Did the response time out?
+     * 
+     * @return If the heatpump didn't respond in time, it will return true otherwise false.
+     */
+    bool isTimeout() const
+    {
+        return m_isTimeout;
+    }
+
+    /**
+     * Was the response rejected by the controller, because it was sent
+     * by another device than the heatpump controller?
+     * 
+     * @return If the response was rejected, it will return true otherwise false.
+     */
+    bool isRejected() const
+    {
+        return m_isRejected;
+    }
+
     /**
      * Is response valid?
      * 
@@ -118,24 +141,42 @@ public:
 
 protected:
 
-    /** Timeout in ms */
-    static const uint32_t   TIMEOUT     = (30UL * 1000UL);
+    /** Timeout in ms, used if the controller doesn't know the baudrate. */
+    static const uint32_t   DEFAULT_TIMEOUT = (30UL * 1000UL);
 
     Stream&     m_stream;               /**< Input stream from heatpump controller. */
     bool        m_isUsed;               /**< Is response used by application. If no, the controller can use it again. */
     bool        m_isPending;            /**< Is response pending or not. */
+    bool        m_isTimeout;            /**< Did the response time out? */
+    bool        m_isRejected;           /**< Was the response rejected, because of a wrong device address? */
     SimpleTimer m_timer;                /**< Used for response timeout observation. */
 
     Rego6xxRsp();
 
     /**
      * Acquire response. Used by the controller to signal that this response
-     * is used.
+     * is used, right after the command was sent. The timeout observation
+     * starts immediately.
+     *
+     * @param[in] timeout   Timeout in ms, derived by the controller from the expected duration.
+     */
+    virtual void acquire(uint32_t timeout)
+    {
+        m_isUsed     = true;
+        m_isPending  = true;
+        m_isTimeout  = false;
+        m_isRejected = false;
+
+        m_timer.start(timeout);
+    }
+
+    /**
+     * Reject the received response. Used by the controller, if the response
+     * is from another device. A rejected response is invalid.
      */
-    void acquire()
+    void reject()
     {
-        m_isUsed    = true;
-        m_isPending = true;
+        m_isRejected = true;
     }
 
     /**
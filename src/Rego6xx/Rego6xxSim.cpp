@@ -60,11 +60,122 @@
  * Public Methods
  *****************************************************************************/
 
+void Rego6xxSim::reset()
+{
+    m_regCnt        = 0U;
+    m_isPowerOn     = true;
+    m_pageIdx       = 0U;
+    m_isEditing     = false;
+    m_errorCnt      = 0U;
+    m_errorWrIdx    = 0U;
+    m_errorAge      = 0U;
+
+    /* Settings and control data */
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_HEAT_CURVE, 50U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT1_TARGET, 320U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT3_TARGET, 500U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT4_TARGET, 350U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_ADDHEAT_POWER, 0U);
+
+    /* Device values */
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_P3, 1U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_COMPRESSOR, 1U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_ADDHEAT_3KW, 0U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_ADDHEAT_6KW, 0U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_P1, 1U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_P2, 1U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_VXV, 0U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_ALARM, 0U);
+
+    /* Sensor values in 0.1 °C */
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT1, 312U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT2, static_cast<uint16_t>(-25));
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT3, 487U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT4, 345U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT5, 215U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT6, 780U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT8, 370U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT9, 310U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT10, 40U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT11, 10U);
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_GT3X, 0U);
+
+    return;
+}
+
+uint16_t Rego6xxSim::getSystemReg(uint16_t addr) const
+{
+    uint16_t    value   = 0U;
+    uint8_t     idx     = 0U;
+
+    while((m_regCnt > idx) && (addr != m_regs[idx].addr))
+    {
+        ++idx;
+    }
+
+    if (m_regCnt > idx)
+    {
+        value = m_regs[idx].value;
+    }
+
+    return value;
+}
+
+void Rego6xxSim::setSystemReg(uint16_t addr, uint16_t value)
+{
+    uint8_t idx = 0U;
+
+    while((m_regCnt > idx) && (addr != m_regs[idx].addr))
+    {
+        ++idx;
+    }
+
+    if (m_regCnt > idx)
+    {
+        m_regs[idx].value = value;
+    }
+    else if (MAX_REGS > m_regCnt)
+    {
+        m_regs[m_regCnt].addr   = addr;
+        m_regs[m_regCnt].value  = value;
+        ++m_regCnt;
+    }
+    else
+    {
+        /* Register file is full. */
+        ;
+    }
+
+    return;
+}
+
+void Rego6xxSim::raiseError(uint8_t errorId)
+{
+    m_errors[m_errorWrIdx].id           = errorId;
+    m_errors[m_errorWrIdx].timestamp    = millis();
+
+    m_errorWrIdx = (m_errorWrIdx + 1U) % MAX_ERRORS;
+
+    if (MAX_ERRORS > m_errorCnt)
+    {
+        ++m_errorCnt;
+    }
+
+    setSystemReg(Rego6xxCtrl::SYSREG_ADDR_ALARM, 1U);
+
+    return;
+}
+
+int Rego6xxSim::available()
+{
+    return static_cast<int>(getTransmittedSize()) - m_readIndex;
+}
+
 int Rego6xxSim::read()
 {
     int result = -1;
 
-    if (m_rspSize > m_readIndex)
+    if (getTransmittedSize() > m_readIndex)
     {
         Serial.printf("Rx: %02X\n", m_rspBuffer[m_readIndex]);
 
@@ -79,7 +190,7 @@ int Rego6xxSim::peek()
 {
     int result = -1;
 
-    if (m_rspSize > m_readIndex)
+    if (getTransmittedSize() > m_readIndex)
     {
         result = m_rspBuffer[m_readIndex];
     }
@@ -89,7 +200,17 @@ int Rego6xxSim::peek()
 
 size_t Rego6xxSim::write(const uint8_t* buffer, size_t size)
 {
-    size_t index = 0;
+    uint8_t stale[RSP_BUFFER_SIZE];
+    size_t  staleSize   = 0U;
+    size_t  index       = 0;
+
+    /* Keep the bytes, which were received but not read yet. */
+    while((getTransmittedSize() > m_readIndex) && (RSP_BUFFER_SIZE > staleSize))
+    {
+        stale[staleSize] = m_rspBuffer[m_readIndex];
+        ++staleSize;
+        ++m_readIndex;
+    }
 
     Serial.printf("Tx: ");
 
@@ -102,8 +223,22 @@ size_t Rego6xxSim::write(const uint8_t* buffer, size_t size)
     Serial.printf("\n");
 
     /* Prepare response */
-    m_readIndex = 0;
+    m_readIndex     = 0;
+    m_cmdTimestamp  = millis();
+    m_cmdSize       = size;
     prepareRsp(buffer, size);
+    injectFault();
+
+    /* The stale bytes are received in front of the response. */
+    if ((RSP_BUFFER_SIZE - m_rspSize) < staleSize)
+    {
+        staleSize = RSP_BUFFER_SIZE - m_rspSize;
+    }
+
+    memmove(&m_rspBuffer[staleSize], m_rspBuffer, m_rspSize);
+    memcpy(m_rspBuffer, stale, staleSize);
+    m_rspSize   += staleSize;
+    m_staleSize  = staleSize;
 
     return size;
 }
@@ -116,6 +251,358 @@ size_t Rego6xxSim::write(const uint8_t* buffer, size_t size)
  * Private Methods
  *****************************************************************************/
 
+size_t Rego6xxSim::getTransmittedSize() const
+{
+    const uint32_t  BITS_PER_S_TO_MS    = 1000UL;
+    size_t          size                = m_rspSize;
+    uint32_t        elapsed             = millis() - m_cmdTimestamp;
+    uint32_t        rspStart            = m_rspDelay;
+
+    if (0U < m_baudrate)
+    {
+        uint32_t cmdDuration = (m_cmdSize * BITS_PER_BYTE * BITS_PER_S_TO_MS) / m_baudrate;
+
+        rspStart += cmdDuration + m_processingDelay;
+    }
+
+    /* The stale bytes were already received before the command. */
+    if (rspStart > elapsed)
+    {
+        size = m_staleSize;
+    }
+    else if (0U < m_baudrate)
+    {
+        uint32_t transmitted = m_staleSize + (((elapsed - rspStart) * m_baudrate) / (BITS_PER_BYTE * BITS_PER_S_TO_MS));
+
+        if (m_rspSize > transmitted)
+        {
+            size = transmitted;
+        }
+    }
+    else
+    {
+        /* Nothing to do. */
+        ;
+    }
+
+    return size;
+}
+
+uint32_t Rego6xxSim::getRandom()
+{
+    m_faultRandom ^= m_faultRandom << 13U;
+    m_faultRandom ^= m_faultRandom >> 17U;
+    m_faultRandom ^= m_faultRandom << 5U;
+
+    return m_faultRandom;
+}
+
+void Rego6xxSim::injectFault()
+{
+    const uint8_t   PERCENT     = 100U;
+    const uint8_t   DATA_BITS   = 7U;   /* The protocol uses only 7 bit per byte. */
+    uint8_t         value       = static_cast<uint8_t>(getRandom() % PERCENT);
+    uint16_t        limit       = 0U;
+    uint8_t         idx         = 0U;
+
+    m_lastFault = FAULT_NONE;
+    m_rspDelay  = 0U;
+
+    while((FAULT_COUNT > idx) && (FAULT_NONE == m_lastFault))
+    {
+        limit += m_faultProbabilities[idx];
+
+        if (limit > value)
+        {
+            m_lastFault = static_cast<Fault>(idx);
+        }
+
+        ++idx;
+    }
+
+    switch(m_lastFault)
+    {
+    case FAULT_DROP_BYTE:
+        {
+            size_t pos = getRandom() % m_rspSize;
+
+            memmove(&m_rspBuffer[pos], &m_rspBuffer[pos + 1U], m_rspSize - pos - 1U);
+            --m_rspSize;
+        }
+        break;
+
+    case FAULT_EXTRA_BYTE:
+        if (RSP_BUFFER_SIZE > m_rspSize)
+        {
+            m_rspBuffer[m_rspSize] = static_cast<uint8_t>(getRandom() & 0x7fU);
+            ++m_rspSize;
+        }
+        break;
+
+    case FAULT_BIT_FLIP:
+        {
+            /* The device address is kept, if there is more. */
+            size_t pos = (1U < m_rspSize) ? (1U + (getRandom() % (m_rspSize - 1U))) : 0U;
+
+            m_rspBuffer[pos] ^= static_cast<uint8_t>(1U << (getRandom() % DATA_BITS));
+        }
+        break;
+
+    case FAULT_WRONG_DEV_ADDR:
+        m_rspBuffer[0] = Rego6xxCtrl::DEV_ADDR_HEATPUMP;
+        break;
+
+    case FAULT_DELAY:
+        m_rspDelay = m_faultDelay;
+        break;
+
+    case FAULT_SILENCE:
+        m_rspSize = 0U;
+        break;
+
+    default:
+        /* No fault. */
+        break;
+    }
+
+    if (FAULT_NONE != m_lastFault)
+    {
+        Serial.printf("Inject fault %u.\n", static_cast<unsigned int>(m_lastFault));
+    }
+
+    return;
+}
+
+bool Rego6xxSim::readFrontPanel(uint16_t addr) const
+{
+    bool isOn = false;
+
+    if (true == m_isPowerOn)
+    {
+        switch(addr)
+        {
+        case Rego6xxCtrl::FRONTPANEL_ADDR_POWER_LED:
+            isOn = true;
+            break;
+
+        case Rego6xxCtrl::FRONTPANEL_ADDR_PUMP_LED:
+            isOn = (0U != getSystemReg(Rego6xxCtrl::SYSREG_ADDR_P1));
+            break;
+
+        case Rego6xxCtrl::FRONTPANEL_ADDR_HEATING_LED:
+            isOn = (0U != getSystemReg(Rego6xxCtrl::SYSREG_ADDR_COMPRESSOR));
+            break;
+
+        case Rego6xxCtrl::FRONTPANEL_ADDR_BOILER_LED:
+            isOn = (0U != getSystemReg(Rego6xxCtrl::SYSREG_ADDR_VXV));
+            break;
+
+        case Rego6xxCtrl::FRONTPANEL_ADDR_ALARM_LED:
+            isOn = (0U != getSystemReg(Rego6xxCtrl::SYSREG_ADDR_ALARM));
+            break;
+
+        default:
+            /* Buttons and wheel are never on. */
+            break;
+        }
+    }
+
+    return isOn;
+}
+
+void Rego6xxSim::writeFrontPanel(uint16_t addr, uint16_t value)
+{
+    /* Wheel values from 0x1000 on turn left, see the two's complement in 13 bit. */
+    const uint16_t  WHEEL_LEFT  = 0x1000U;
+    const uint16_t  WHEEL_RANGE = 0x2000U;
+
+    if (Rego6xxCtrl::FRONTPANEL_ADDR_POWER_BUTTON == addr)
+    {
+        if (0U != value)
+        {
+            m_isPowerOn = !m_isPowerOn;
+            m_pageIdx   = 0U;
+            m_isEditing = false;
+        }
+    }
+    else if (false == m_isPowerOn)
+    {
+        /* Only the power button works, if powered off. */
+        ;
+    }
+    else if (0U == value)
+    {
+        /* Nothing to do. */
+        ;
+    }
+    else if (Rego6xxCtrl::FRONTPANEL_ADDR_LEFT_BUTTON == addr)
+    {
+        /* Back to the home page. */
+        m_pageIdx   = 0U;
+        m_isEditing = false;
+    }
+    else if (Rego6xxCtrl::FRONTPANEL_ADDR_MIDDLE_BUTTON == addr)
+    {
+        /* Start or finish editing the value. */
+        if (true == isPageEditable(m_pageIdx))
+        {
+            m_isEditing = !m_isEditing;
+        }
+    }
+    else if (Rego6xxCtrl::FRONTPANEL_ADDR_RIGHT_BUTTON == addr)
+    {
+        /* Acknowledge the alarm. */
+        setSystemReg(Rego6xxCtrl::SYSREG_ADDR_ALARM, 0U);
+    }
+    else if (Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL == addr)
+    {
+        if (WHEEL_LEFT > value)
+        {
+            turnWheel(static_cast<int16_t>(value));
+        }
+        else
+        {
+            turnWheel(-static_cast<int16_t>((WHEEL_RANGE - value) % WHEEL_RANGE));
+        }
+    }
+    else
+    {
+        /* Nothing to do. */
+        ;
+    }
+
+    return;
+}
+
+void Rego6xxSim::turnWheel(int16_t steps)
+{
+    if (true == m_isEditing)
+    {
+        uint16_t addr = 0U;
+
+        (void)getPage(m_pageIdx, addr);
+
+        setSystemReg(addr, static_cast<uint16_t>(static_cast<int16_t>(getSystemReg(addr)) + steps));
+    }
+    else
+    {
+        int16_t pageIdx = (static_cast<int16_t>(m_pageIdx) + steps) % static_cast<int16_t>(NUM_PAGES);
+
+        if (0 > pageIdx)
+        {
+            pageIdx += NUM_PAGES;
+        }
+
+        m_pageIdx = static_cast<uint8_t>(pageIdx);
+    }
+
+    return;
+}
+
+const __FlashStringHelper* Rego6xxSim::getPage(uint8_t pageIdx, uint16_t& addr) const
+{
+    const __FlashStringHelper* title = nullptr;
+
+    switch(pageIdx)
+    {
+    case 0U:
+        title   = F("GT1 Radiator return");
+        addr    = Rego6xxCtrl::SYSREG_ADDR_GT1;
+        break;
+
+    case 1U:
+        title   = F("GT2 Outdoor");
+        addr    = Rego6xxCtrl::SYSREG_ADDR_GT2;
+        break;
+
+    case 2U:
+        title   = F("GT3 Hot water");
+        addr    = Rego6xxCtrl::SYSREG_ADDR_GT3;
+        break;
+
+    case 3U:
+        title   = F("GT4 Forward");
+        addr    = Rego6xxCtrl::SYSREG_ADDR_GT4;
+        break;
+
+    case 4U:
+        title   = F("GT1 Target value");
+        addr    = Rego6xxCtrl::SYSREG_ADDR_GT1_TARGET;
+        break;
+
+    case 5U:
+        title   = F("GT3 Target value");
+        addr    = Rego6xxCtrl::SYSREG_ADDR_GT3_TARGET;
+        break;
+
+    default:
+        title   = F("Heat curve");
+        addr    = Rego6xxCtrl::SYSREG_ADDR_HEAT_CURVE;
+        break;
+    }
+
+    return title;
+}
+
+bool Rego6xxSim::isPageEditable(uint8_t pageIdx) const
+{
+    /* The sensor pages are read only, all following pages are settings. */
+    const uint8_t FIRST_SETTINGS_PAGE = 4U;
+
+    return (FIRST_SETTINGS_PAGE <= pageIdx);
+}
+
+String Rego6xxSim::getDisplayRow(uint8_t row) const
+{
+    String text;
+
+    if (true == m_isPowerOn)
+    {
+        uint16_t                    addr    = 0U;
+        const __FlashStringHelper*  title   = getPage(m_pageIdx, addr);
+        int16_t                     value   = static_cast<int16_t>(getSystemReg(addr));
+
+        switch(row)
+        {
+        case Rego6xxCtrl::DISPLAY_ROW_1:
+            text = F("Rego600 Sim");
+            break;
+
+        case Rego6xxCtrl::DISPLAY_ROW_2:
+            text = title;
+            break;
+
+        case Rego6xxCtrl::DISPLAY_ROW_3:
+            /* Value in 0.1 °C */
+            text = (true == m_isEditing) ? F("> ") : F("  ");
+
+            if (0 > value)
+            {
+                text += '-';
+                value = -value;
+            }
+
+            text += value / 10;
+            text += '.';
+            text += value % 10;
+            text += F(" C");
+            break;
+
+        case Rego6xxCtrl::DISPLAY_ROW_4:
+            if (0U != getSystemReg(Rego6xxCtrl::SYSREG_ADDR_ALARM))
+            {
+                text = F("Alarm");
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return text;
+}
+
 void Rego6xxSim::generateStdRsp(uint16_t value)
 {
     m_rspSize = 5;
@@ -166,28 +653,61 @@ void Rego6xxSim::generateTextRsp(const String& text)
     m_rspBuffer[m_rspSize - 1] = Rego6xxUtil::calculateChecksum(&m_rspBuffer[1], m_rspSize - 2);
 }
 
-void Rego6xxSim::generateErrprRsp()
+void Rego6xxSim::generateErrorRsp(uint8_t age)
 {
-    const uint8_t   data[]  =
-    {
-        0x01, 0x06, 0x03, 0x00, 0x03, 0x02, 0x03, 0x01,
-        0x03, 0x00, 0x03, 0x00, 0x03, 0x09, 0x02, 0x00,
-        0x03, 0x01, 0x03, 0x08, 0x03, 0x0A, 0x03, 0x02,
-        0x03, 0x01, 0x03, 0x0A, 0x03, 0x00, 0x03, 0x03,
-        0x00, 0x00, 0x00, 0x01, 0x04, 0x06, 0x00, 0x02
-    };
-    uint8_t         dataIdx = 0;
-    uint8_t         rspIdx  = 0;
+    const uint16_t  MS_PER_S    = 1000U;
+    const uint8_t   S_PER_MIN   = 60U;
+    const uint8_t   MIN_PER_H   = 60U;
+    const uint8_t   H_MODULO    = 100U;
+    uint8_t         errorId     = NO_ERROR_ID;
+    String          text;
+    uint8_t         textIdx     = 0;
+    uint8_t         rspIdx      = 0;
+
+    /* The log text is the timestamp "YYMMDD HH:MM:SS". The simulator has no
+     * date, therefore the uptime is used.
+     */
+    if (m_errorCnt > age)
+    {
+        const Error&    error   = m_errors[(m_errorWrIdx + MAX_ERRORS - 1U - age) % MAX_ERRORS];
+        uint32_t        seconds = error.timestamp / MS_PER_S;
+        uint32_t        minutes = seconds / S_PER_MIN;
+        uint32_t        hours   = minutes / MIN_PER_H;
+        char            buffer[16];
+
+        snprintf(buffer, sizeof(buffer), "000000 %02u:%02u:%02u",
+            static_cast<unsigned int>(hours % H_MODULO),
+            static_cast<unsigned int>(minutes % MIN_PER_H),
+            static_cast<unsigned int>(seconds % S_PER_MIN));
+
+        errorId = error.id;
+        text    = buffer;
+    }
 
     m_rspSize = 42;
 
     m_rspBuffer[rspIdx] = Rego6xxCtrl::DEV_ADDR_HOST;
     ++rspIdx;
+    m_rspBuffer[rspIdx] = (errorId & 0xf0) >> 4;
+    ++rspIdx;
+    m_rspBuffer[rspIdx] = (errorId & 0x0f) >> 0;
+    ++rspIdx;
 
-    while((sizeof(data) / sizeof(data[1])) > dataIdx)
+    while(text.length() > textIdx)
     {
-        m_rspBuffer[rspIdx] = data[dataIdx];
-        ++dataIdx;
+        m_rspBuffer[rspIdx] = (static_cast<uint8_t>(text[textIdx]) & 0xf0) >> 4;
+        ++rspIdx;
+
+        m_rspBuffer[rspIdx] = (static_cast<uint8_t>(text[textIdx]) & 0x0f) >> 0;
+        ++rspIdx;
+
+        ++textIdx;
+    }
+
+    /* Fill up with zeros. */
+    while((m_rspSize - 1) > rspIdx)
+    {
+        m_rspBuffer[rspIdx] = 0;
         ++rspIdx;
     }
 
@@ -220,72 +740,35 @@ void Rego6xxSim::prepareRsp(const uint8_t* buffer, size_t size)
     }
     else
     {
+        uint16_t    addr    = getValue(&buffer[2]);
+        uint16_t    value   = getValue(&buffer[5]);
+
         switch(buffer[1])
         {
         case Rego6xxCtrl::CMD_ID_READ_FRONT_PANEL:
-            {
-                uint16_t    addr;
-
-                addr  = ((uint16_t)(buffer[2] & 0x03)) << 14;
-                addr |= ((uint16_t)(buffer[3] & 0x7f)) <<  7;
-                addr |= ((uint16_t)(buffer[4] & 0x7f)) <<  0;
-
-                Serial.printf("Read front panel addr 0x%04X.\n", addr);
+            Serial.printf("Read front panel addr 0x%04X.\n", addr);
 
-                generateBoolRsp(true);
-            }
+            generateBoolRsp(readFrontPanel(addr));
             break;
 
         case Rego6xxCtrl::CMD_ID_WRITE_FRONT_PANEL:
-            {
-                uint16_t    addr;
-                uint16_t    value;
-
-                addr  = ((uint16_t)(buffer[2] & 0x03)) << 14;
-                addr |= ((uint16_t)(buffer[3] & 0x7f)) <<  7;
-                addr |= ((uint16_t)(buffer[4] & 0x7f)) <<  0;
-
-                value  = ((uint16_t)(buffer[5] & 0x03)) << 14;
-                value |= ((uint16_t)(buffer[6] & 0x7f)) <<  7;
-                value |= ((uint16_t)(buffer[7] & 0x7f)) <<  0;
+            Serial.printf("Write 0x%04X to front panel 0x%04X.\n", value, addr);
 
-                Serial.printf("Write 0x%04X to front panel 0x%04X.\n", value, addr);
-
-                generateConfirmRsp();
-            }
+            writeFrontPanel(addr, value);
+            generateConfirmRsp();
             break;
 
         case Rego6xxCtrl::CMD_ID_READ_SYSTEM_REG:
-            {
-                uint16_t    addr;
-
-                addr  = ((uint16_t)(buffer[2] & 0x03)) << 14;
-                addr |= ((uint16_t)(buffer[3] & 0x7f)) <<  7;
-                addr |= ((uint16_t)(buffer[4] & 0x7f)) <<  0;
+            Serial.printf("Read system register 0x%04X.\n", addr);
 
-                Serial.printf("Read system register 0x%04X.\n", addr);
-
-                generateStdRsp(240);    /* 24.0 °C ... just a value */
-            }
+            generateStdRsp(getSystemReg(addr));
             break;
 
         case Rego6xxCtrl::CMD_ID_WRITE_SYSTEM_REG:
-            {
-                uint16_t    addr;
-                uint16_t    value;
-
-                addr  = ((uint16_t)(buffer[2] & 0x03)) << 14;
-                addr |= ((uint16_t)(buffer[3] & 0x7f)) <<  7;
-                addr |= ((uint16_t)(buffer[4] & 0x7f)) <<  0;
+            Serial.printf("Write %u to system register 0x%04X.\n", value, addr);
 
-                value  = ((uint16_t)(buffer[5] & 0x03)) << 14;
-                value |= ((uint16_t)(buffer[6] & 0x7f)) <<  7;
-                value |= ((uint16_t)(buffer[7] & 0x7f)) <<  0;
-
-                Serial.printf("Write %u to system register 0x%04X.\n", value, addr);
-
-                generateConfirmRsp();
-            }
+            setSystemReg(addr, value);
+            generateConfirmRsp();
             break;
 
         case Rego6xxCtrl::CMD_ID_READ_TIMER_REG:
@@ -305,15 +788,21 @@ void Rego6xxSim::prepareRsp(const uint8_t* buffer, size_t size)
             break;
 
         case Rego6xxCtrl::CMD_ID_READ_DISPLAY:
-            generateTextRsp("abc");
+            generateTextRsp(getDisplayRow(static_cast<uint8_t>(addr)));
             break;
 
         case Rego6xxCtrl::CMD_ID_READ_LAST_ERROR:
-            generateErrprRsp();
+            m_errorAge = 0U;
+            generateErrorRsp(m_errorAge);
             break;
 
         case Rego6xxCtrl::CMD_ID_READ_PREV_ERROR:
-            generateErrprRsp();
+            if (m_errorCnt > m_errorAge)
+            {
+                ++m_errorAge;
+            }
+
+            generateErrorRsp(m_errorAge);
             break;
 
         case Rego6xxCtrl::CMD_ID_READ_REGO_VERSION:
@@ -329,6 +818,17 @@ void Rego6xxSim::prepareRsp(const uint8_t* buffer, size_t size)
     }
 }
 
+uint16_t Rego6xxSim::getValue(const uint8_t* buffer)
+{
+    uint16_t value;
+
+    value  = ((uint16_t)(buffer[0] & 0x03)) << 14;
+    value |= ((uint16_t)(buffer[1] & 0x7f)) <<  7;
+    value |= ((uint16_t)(buffer[2] & 0x7f)) <<  0;
+
+    return value;
+}
+
 /******************************************************************************
  * External Functions
  *****************************************************************************/
@@ -54,19 +54,73 @@
 /**
  * Rego6xx heatpump controller simulator.
  * Used for testing purposes.
+ *
+ * It keeps the state like a real controller: a register file, where written
+ * system registers persist, a display with a small menu, which reacts on the
+ * front panel buttons and the wheel, the front panel LEDs and a error log.
+ *
+ * By default every response is available immediately. After the baudrate is
+ * set, the response bytes become available one by one at the speed of the
+ * serial line, after the command was transmitted and the controller
+ * processing delay elapsed.
+ *
+ * Faults of the serial line can be injected into the responses. Every
+ * response gets at most one fault, which is drawn from a probability table
+ * with a seeded pseudo random number generator. Therefore a run with the same
+ * seed and the same sequence of commands injects the same faults. Bytes,
+ * which are not read until the next command, stay in front of the next
+ * response, like in the receive buffer of a real serial port.
  */
 class Rego6xxSim : public Stream
 {
 public:
 
     /**
-     * Constructs the Rego6xx heatpump controller simulator.
+     * Faults, which can be injected into a response.
+     */
+    enum Fault
+    {
+        FAULT_DROP_BYTE = 0,    /**< A single byte of the response is lost. */
+        FAULT_EXTRA_BYTE,       /**< A additional byte follows the response. */
+        FAULT_BIT_FLIP,         /**< A single bit of the response is flipped. */
+        FAULT_WRONG_DEV_ADDR,   /**< The response has a wrong device address. */
+        FAULT_DELAY,            /**< The response is delayed. */
+        FAULT_SILENCE,          /**< There is no response at all. */
+        FAULT_COUNT,            /**< Number of faults */
+        FAULT_NONE = FAULT_COUNT/**< No fault */
+    };
+
+    /** Default delay in ms of a delayed response, which exceeds the response timeout of the controller. */
+    static const uint32_t   DEFAULT_FAULT_DELAY = 200U;
+
+    /**
+     * Constructs the Rego6xx heatpump controller simulator in its power on state.
      */
     Rego6xxSim() :
         m_readIndex(0),
         m_rspBuffer(),
-        m_rspSize(0)
+        m_rspSize(0),
+        m_baudrate(0U),
+        m_processingDelay(0U),
+        m_cmdTimestamp(0U),
+        m_cmdSize(0U),
+        m_staleSize(0U),
+        m_faultProbabilities(),
+        m_faultRandom(1U),
+        m_faultDelay(DEFAULT_FAULT_DELAY),
+        m_rspDelay(0U),
+        m_lastFault(FAULT_NONE),
+        m_regs(),
+        m_regCnt(0U),
+        m_isPowerOn(true),
+        m_pageIdx(0U),
+        m_isEditing(false),
+        m_errors(),
+        m_errorCnt(0U),
+        m_errorWrIdx(0U),
+        m_errorAge(0U)
     {
+        reset();
     }
 
     /**
@@ -76,15 +130,114 @@ public:
     {
     }
 
+    /**
+     * Set the baudrate of the simulated serial line. Use 0 to make every
+     * response available immediately.
+     *
+     * @param[in] baudrate  Baudrate in bit/s
+     */
+    void setBaudrate(uint32_t baudrate)
+    {
+        m_baudrate = baudrate;
+    }
+
+    /**
+     * Set the processing delay of the controller, which elapses between the
+     * received command and the first byte of the response.
+     * It is only considered, if the baudrate is set.
+     *
+     * @param[in] delay Processing delay in ms
+     */
+    void setProcessingDelay(uint32_t delay)
+    {
+        m_processingDelay = delay;
+    }
+
+    /**
+     * Set the seed of the pseudo random number generator, which draws the
+     * faults.
+     *
+     * @param[in] seed  Seed
+     */
+    void setFaultSeed(uint32_t seed)
+    {
+        /* The generator stucks with 0. */
+        m_faultRandom = (0U == seed) ? 1U : seed;
+    }
+
+    /**
+     * Set the probability of a fault per response. The sum of all
+     * probabilities shall not exceed 100 %.
+     *
+     * @param[in] fault         Fault
+     * @param[in] probability   Probability in %
+     */
+    void setFaultProbability(Fault fault, uint8_t probability)
+    {
+        if (FAULT_COUNT > fault)
+        {
+            m_faultProbabilities[fault] = probability;
+        }
+    }
+
+    /**
+     * Set the delay of a delayed response.
+     *
+     * @param[in] delay Delay in ms
+     */
+    void setFaultDelay(uint32_t delay)
+    {
+        m_faultDelay = delay;
+    }
+
+    /**
+     * Get the fault, which was injected into the last response.
+     *
+     * @return Fault
+     */
+    Fault getLastFault() const
+    {
+        return m_lastFault;
+    }
+
+    /**
+     * Restore the power on state: default register values, home menu page,
+     * empty error log.
+     */
+    void reset();
+
+    /**
+     * Get the value of a system register.
+     *
+     * @param[in] addr  System register address
+     *
+     * @return Register value. If the register is unknown, it will return 0.
+     */
+    uint16_t getSystemReg(uint16_t addr) const;
+
+    /**
+     * Set the value of a system register. If the register file is full,
+     * a unknown register is not stored.
+     *
+     * @param[in] addr  System register address
+     * @param[in] value Register value
+     */
+    void setSystemReg(uint16_t addr, uint16_t value);
+
+    /**
+     * Raise a error. It is appended to the error log and the alarm is set.
+     * The alarm is acknowledged with the right button.
+     *
+     * @param[in] errorId   Error id
+     */
+    void raiseError(uint8_t errorId);
+
     /**
      * Get the number of available data.
      * 
      * @return Number of byte which are available
      */
-    int available() override
-    {
-        return m_rspSize - m_readIndex;
-    }
+    int available() override;
 
     /**
      * Read a single data byte.
@@ -110,6 +263,7 @@ public:
     size_t write(uint8_t data) override
     {
         /* Not supported. */
+        (void)data;
         return 0;
     }
 
@@ -125,11 +279,123 @@ public:
 
 private:
 
-    static const uint8_t    RSP_BUFFER_SIZE = 64;    /**< Rego6xx response buffer size in byte. */
+    /** A single system register in the register file. */
+    struct Register
+    {
+        uint16_t    addr;   /**< System register address */
+        uint16_t    value;  /**< Register value */
+    };
+
+    /** A single entry of the error log. */
+    struct Error
+    {
+        uint8_t     id;         /**< Error id */
+        uint32_t    timestamp;  /**< Uptime in ms, when the error was raised */
+    };
+
+    static const uint8_t    RSP_BUFFER_SIZE = 64;   /**< Rego6xx response buffer size in byte. */
+    static const uint8_t    MAX_REGS        = 40U;  /**< Max. number of system registers in the register file. */
+    static const uint8_t    MAX_ERRORS      = 4U;   /**< Max. number of errors in the error log. */
+    static const uint8_t    NUM_PAGES       = 7U;   /**< Number of menu pages. */
+    static const uint8_t    BITS_PER_BYTE   = 10U;  /**< Bits per byte on the serial line, incl. start and stop bit. */
+    static const uint8_t    NO_ERROR_ID     = 0xFFU;/**< Error id, which is answered if there is no error. */
+
+    uint8_t     m_readIndex;                    /**< Read index in the standard response buffer. */
+    uint8_t     m_rspBuffer[RSP_BUFFER_SIZE];   /**< Standard response buffer */
+    size_t      m_rspSize;                      /**< Size of current filled response buffer */
+    uint32_t    m_baudrate;                     /**< Baudrate of the simulated serial line in bit/s. 0 means no timing. */
+    uint32_t    m_processingDelay;              /**< Processing delay of the controller in ms */
+    uint32_t    m_cmdTimestamp;                 /**< Timestamp in ms, when the last command was written */
+    size_t      m_cmdSize;                      /**< Size of the last command in byte */
+    size_t      m_staleSize;                    /**< Number of unread bytes of the previous response in front of the response */
+    uint8_t     m_faultProbabilities[FAULT_COUNT];/**< Probability of every fault in % */
+    uint32_t    m_faultRandom;                  /**< State of the pseudo random number generator of the faults */
+    uint32_t    m_faultDelay;                   /**< Delay in ms of a delayed response */
+    uint32_t    m_rspDelay;                     /**< Delay in ms of the current response */
+    Fault       m_lastFault;                    /**< Fault, which was injected into the last response */
+    Register    m_regs[MAX_REGS];               /**< Register file */
+    uint8_t     m_regCnt;                       /**< Number of used registers in the register file */
+    bool        m_isPowerOn;                    /**< Is the heatpump powered on? */
+    uint8_t     m_pageIdx;                      /**< Index of the shown menu page */
+    bool        m_isEditing;                    /**< Is the value of the shown menu page edited? */
+    Error       m_errors[MAX_ERRORS];           /**< Error log, used as ring buffer */
+    uint8_t     m_errorCnt;                     /**< Number of errors in the error log */
+    uint8_t     m_errorWrIdx;                   /**< Index of the next error in the error log */
+    uint8_t     m_errorAge;                     /**< Age of the error log entry, which was read last. 0 is the newest one. */
 
-    uint8_t m_readIndex;                    /**< Read index in the standard response buffer. */
-    uint8_t m_rspBuffer[RSP_BUFFER_SIZE];   /**< Standard response buffer */
-    size_t  m_rspSize;                      /**< Size of current filled response buffer */
+    /**
+     * Get the number of response bytes, which were already transmitted on the
+     * simulated serial line.
+     *
+     * @return Number of transmitted response bytes
+     */
+    size_t getTransmittedSize() const;
+
+    /**
+     * Get the next pseudo random number (xorshift32).
+     *
+     * @return Pseudo random number
+     */
+    uint32_t getRandom();
+
+    /**
+     * Draw a fault from the probability table and inject it into the
+     * prepared response.
+     */
+    void injectFault();
+
+    /**
+     * Get the state of a front panel LED or button.
+     *
+     * @param[in] addr  Front panel address
+     *
+     * @return If on, it will return true otherwise false.
+     */
+    bool readFrontPanel(uint16_t addr) const;
+
+    /**
+     * Handle a front panel button or wheel.
+     *
+     * @param[in] addr  Front panel address
+     * @param[in] value Written value
+     */
+    void writeFrontPanel(uint16_t addr, uint16_t value);
+
+    /**
+     * Turn the wheel, which either scrolls through the menu pages or
+     * changes the value of the edited page.
+     *
+     * @param[in] steps Number of steps, negative ones turn left.
+     */
+    void turnWheel(int16_t steps);
+
+    /**
+     * Get the title and system register of a menu page.
+     *
+     * @param[in]   pageIdx Menu page index
+     * @param[out]  addr    System register address, which is shown on the page
+     *
+     * @return Title
+     */
+    const __FlashStringHelper* getPage(uint8_t pageIdx, uint16_t& addr) const;
+
+    /**
+     * Can the value of a menu page be edited?
+     *
+     * @param[in] pageIdx   Menu page index
+     *
+     * @return If editable, it will return true otherwise false.
+     */
+    bool isPageEditable(uint8_t pageIdx) const;
+
+    /**
+     * Get the text of a display row.
+     *
+     * @param[in] row   Display row, starting with 0.
+     *
+     * @return Text
+     */
+    String getDisplayRow(uint8_t row) const;
 
     /**
      * Generate a valid standard response with the given value.
@@ -151,9 +417,11 @@ private:
     void generateTextRsp(const String& text);
     
     /**
-     * Generate a valid text response with the given value.
+     * Generate a valid error response with the error log entry of the given age.
+     *
+     * @param[in] age   Age of the error log entry, 0 is the newest one.
      */
-    void generateErrprRsp();
+    void generateErrorRsp(uint8_t age);
 
     /**
      * Generate a valid boolean response with the given value.
@@ -169,6 +437,15 @@ private:
      * @param[in] size      Command buffer size in byte
      */
     void prepareRsp(const uint8_t* buffer, size_t size);
+
+    /**
+     * Get a 16-bit value, which is transmitted in 3 bytes.
+     *
+     * @param[in] buffer    Buffer with the 3 bytes
+     *
+     * @return Value
+     */
+    static uint16_t getValue(const uint8_t* buffer);
 };
 
 /******************************************************************************
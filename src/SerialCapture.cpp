@@ -0,0 +1,224 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Serial capture
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "SerialCapture.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+const char SerialCapture::MAGIC[4U] = { 'R', '6', 'X', 'C' };
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+int SerialCapture::read()
+{
+    int data = m_stream->read();
+
+    if (0 <= data)
+    {
+        record(FLAG_RX, static_cast<uint8_t>(data));
+    }
+
+    return data;
+}
+
+size_t SerialCapture::write(uint8_t data)
+{
+    size_t written = m_stream->write(data);
+
+    if (0U < written)
+    {
+        record(0U, data);
+    }
+
+    return written;
+}
+
+size_t SerialCapture::write(const uint8_t* buffer, size_t size)
+{
+    size_t written  = m_stream->write(buffer, size);
+    size_t idx      = 0U;
+
+    while(written > idx)
+    {
+        record(0U, buffer[idx]);
+        ++idx;
+    }
+
+    return written;
+}
+
+bool SerialCapture::getEntry(uint16_t seq, Entry& entry) const
+{
+    bool        isAvailable = false;
+    uint16_t    distance    = m_nextSeq - seq;
+
+    /* The sequence numbers wrap around, therefore only the distances are compared. */
+    if ((0U < distance) &&
+        (m_cnt >= distance))
+    {
+        entry       = m_entries[(m_wrIdx + m_maxEntries - distance) % m_maxEntries];
+        isAvailable = true;
+    }
+
+    return isAvailable;
+}
+
+void SerialCapture::writeHeader(Print& out, uint16_t cnt)
+{
+    (void)out.write(reinterpret_cast<const uint8_t*>(MAGIC), sizeof(MAGIC));
+    (void)out.write(VERSION);
+    (void)out.write(static_cast<uint8_t>(0U));
+    (void)out.write(static_cast<uint8_t>((cnt >> 0U) & 0xffU));
+    (void)out.write(static_cast<uint8_t>((cnt >> 8U) & 0xffU));
+
+    return;
+}
+
+void SerialCapture::writeEntry(Print& out, const Entry& entry)
+{
+    (void)out.write(entry.flags);
+    (void)out.write(entry.data);
+    (void)out.write(static_cast<uint8_t>((entry.delta >> 0U) & 0xffU));
+    (void)out.write(static_cast<uint8_t>((entry.delta >> 8U) & 0xffU));
+
+    return;
+}
+
+bool SerialCapture::readHeader(const uint8_t* buffer, size_t size, uint16_t& cnt)
+{
+    bool isValid = false;
+
+    if ((nullptr != buffer) &&
+        (HEADER_SIZE <= size) &&
+        (0 == memcmp(buffer, MAGIC, sizeof(MAGIC))) &&
+        (VERSION == buffer[4U]))
+    {
+        cnt = static_cast<uint16_t>(buffer[6U]) | (static_cast<uint16_t>(buffer[7U]) << 8U);
+
+        if ((HEADER_SIZE + (static_cast<size_t>(cnt) * ENTRY_SIZE)) <= size)
+        {
+            isValid = true;
+        }
+    }
+
+    return isValid;
+}
+
+void SerialCapture::readEntry(const uint8_t* buffer, Entry& entry)
+{
+    entry.flags = buffer[0U];
+    entry.data  = buffer[1U];
+    entry.delta = static_cast<uint16_t>(buffer[2U]) | (static_cast<uint16_t>(buffer[3U]) << 8U);
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+void SerialCapture::record(uint8_t flags, uint8_t data)
+{
+    uint32_t    now     = micros();
+    uint32_t    delta   = now - m_timestamp;
+
+    if ((nullptr != m_entries) &&
+        (0U < m_maxEntries))
+    {
+        Entry& entry = m_entries[m_wrIdx];
+
+        /* The first entry has no predecessor. */
+        if (0U == m_cnt)
+        {
+            delta = 0U;
+        }
+        else if (MAX_DELTA < delta)
+        {
+            delta = MAX_DELTA;
+        }
+        else
+        {
+            /* Nothing to do. */
+            ;
+        }
+
+        entry.flags = flags | static_cast<uint8_t>((delta >> 16U) & FLAG_DELTA_MASK);
+        entry.data  = data;
+        entry.delta = static_cast<uint16_t>(delta & 0xffffU);
+
+        ++m_nextSeq;
+        m_wrIdx = (m_wrIdx + 1U) % m_maxEntries;
+
+        if (m_maxEntries > m_cnt)
+        {
+            ++m_cnt;
+        }
+
+        m_timestamp = now;
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,308 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Serial capture
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __SERIAL_CAPTURE_H__
+#define __SERIAL_CAPTURE_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Stream decorator, which records every transmitted and received byte of the
+ * decorated stream with a timestamp in us. The entries are kept in a ring
+ * buffer provided by the caller, the oldest one is overwritten if it is full.
+ *
+ * Every entry has 4 bytes. The timestamp is stored as distance to the
+ * previous entry, which is limited to MAX_DELTA. Longer gaps are shortened.
+ *
+ * A exported trace is a header followed by the entries, see writeHeader()
+ * and writeEntry(). All values are little endian.
+ */
+class SerialCapture : public Stream
+{
+public:
+
+    /**
+     * A single entry, in the same layout as exported.
+     */
+    struct Entry
+    {
+        uint8_t     flags;      /**< Flags and the upper bits of the delta */
+        uint8_t     data;       /**< Transmitted or received byte */
+        uint16_t    delta;      /**< Lower bits of the distance to the previous entry in us */
+    };
+
+    /** Flag of a received byte. Without it, the byte was transmitted. */
+    static const uint8_t    FLAG_RX         = 0x80U;
+
+    /** Flag of a entry, which was overwritten during the export. */
+    static const uint8_t    FLAG_LOST       = 0x40U;
+
+    /** Mask of the upper delta bits in the flags. */
+    static const uint8_t    FLAG_DELTA_MASK = 0x3FU;
+
+    /** Max. distance in us between two entries. */
+    static const uint32_t   MAX_DELTA       = 0x3FFFFFUL;
+
+    /** Exported header size in bytes: magic, version, reserved and number of entries. */
+    static const size_t     HEADER_SIZE     = 8U;
+
+    /** Exported entry size in bytes. */
+    static const size_t     ENTRY_SIZE      = 4U;
+
+    /** Version of the exported format. */
+    static const uint8_t    VERSION         = 1U;
+
+    /**
+     * Constructs a empty capture.
+     *
+     * @param[in] stream        Stream, which to decorate.
+     * @param[in] entries       Buffer, which is used to store the entries.
+     * @param[in] maxEntries    Max. number of entries in the buffer.
+     */
+    SerialCapture(Stream& stream, Entry* entries, uint16_t maxEntries) :
+        Stream(),
+        m_stream(&stream),
+        m_entries(entries),
+        m_maxEntries(maxEntries),
+        m_nextSeq(0U),
+        m_wrIdx(0U),
+        m_cnt(0U),
+        m_timestamp(0U)
+    {
+    }
+
+    /**
+     * Destroys the capture.
+     */
+    ~SerialCapture()
+    {
+    }
+
+    /**
+     * Replace the decorated stream, e.g. by a replay.
+     *
+     * @param[in] stream    Stream, which to decorate.
+     */
+    void setStream(Stream& stream)
+    {
+        m_stream = &stream;
+    }
+
+    /**
+     * Get the number of available data bytes.
+     *
+     * @return Number of available data bytes.
+     */
+    int available() override
+    {
+        return m_stream->available();
+    }
+
+    /**
+     * Read a single data byte and record it.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int read() override;
+
+    /**
+     * Read a single data byte, without removing it from the stream.
+     * It is not recorded.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int peek() override
+    {
+        return m_stream->peek();
+    }
+
+    /**
+     * Write a single data byte and record it.
+     *
+     * @param[in] data  Data byte
+     *
+     * @return Number of written data bytes
+     */
+    size_t write(uint8_t data) override;
+
+    /**
+     * Write several data bytes and record them.
+     *
+     * @param[in] buffer    Data buffer
+     * @param[in] size      Data buffer size in bytes
+     *
+     * @return Number of written data bytes
+     */
+    size_t write(const uint8_t* buffer, size_t size) override;
+
+    /**
+     * Flush the decorated stream.
+     */
+    void flush() override
+    {
+        m_stream->flush();
+    }
+
+    /**
+     * Remove all entries.
+     */
+    void clear()
+    {
+        m_cnt = 0U;
+    }
+
+    /**
+     * Get sequence number of the next recorded entry.
+     *
+     * @return Sequence number
+     */
+    uint16_t getNextSeq() const
+    {
+        return m_nextSeq;
+    }
+
+    /**
+     * Get number of entries in the ring buffer.
+     *
+     * @return Number of entries
+     */
+    uint16_t getCount() const
+    {
+        return m_cnt;
+    }
+
+    /**
+     * Get the entry with the given sequence number.
+     *
+     * @param[in]  seq      Sequence number
+     * @param[out] entry    Entry
+     *
+     * @return If the entry is available, it will return true. If it was overwritten or not recorded yet, it will return false.
+     */
+    bool getEntry(uint16_t seq, Entry& entry) const;
+
+    /**
+     * Get the distance of a entry to the previous one.
+     *
+     * @param[in] entry Entry
+     *
+     * @return Distance in us
+     */
+    static uint32_t getDelta(const Entry& entry)
+    {
+        return (static_cast<uint32_t>(entry.flags & FLAG_DELTA_MASK) << 16U) | entry.delta;
+    }
+
+    /**
+     * Write the header of a exported trace.
+     *
+     * @param[in] out   Output
+     * @param[in] cnt   Number of entries, which follow.
+     */
+    static void writeHeader(Print& out, uint16_t cnt);
+
+    /**
+     * Write a single entry of a exported trace.
+     *
+     * @param[in] out   Output
+     * @param[in] entry Entry
+     */
+    static void writeEntry(Print& out, const Entry& entry);
+
+    /**
+     * Read the header of a exported trace.
+     *
+     * @param[in]  buffer   Trace
+     * @param[in]  size     Trace size in bytes
+     * @param[out] cnt      Number of entries
+     *
+     * @return If the header is valid and all entries are in the trace, it will return true otherwise false.
+     */
+    static bool readHeader(const uint8_t* buffer, size_t size, uint16_t& cnt);
+
+    /**
+     * Read a single entry of a exported trace.
+     *
+     * @param[in]  buffer   Entry in the exported trace
+     * @param[out] entry    Entry
+     */
+    static void readEntry(const uint8_t* buffer, Entry& entry);
+
+private:
+
+    /** Magic number at the begin of a exported trace. */
+    static const char       MAGIC[4U];
+
+    Stream*     m_stream;       /**< Decorated stream */
+    Entry*      m_entries;      /**< Entries */
+    uint16_t    m_maxEntries;   /**< Max. number of entries */
+    uint16_t    m_nextSeq;      /**< Sequence number of the next recorded entry */
+    uint16_t    m_wrIdx;        /**< Index of the next recorded entry in the buffer */
+    uint16_t    m_cnt;          /**< Number of entries in the ring buffer */
+    uint32_t    m_timestamp;    /**< Timestamp in us of the last recorded entry */
+
+    SerialCapture();
+    SerialCapture(const SerialCapture& capture);
+    SerialCapture& operator=(const SerialCapture& capture);
+
+    /**
+     * Record a single byte.
+     *
+     * @param[in] flags Flags, e.g. FLAG_RX
+     * @param[in] data  Transmitted or received byte
+     */
+    void record(uint8_t flags, uint8_t data);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __SERIAL_CAPTURE_H__ */
+
+/** @} */
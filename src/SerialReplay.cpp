@@ -0,0 +1,208 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Serial replay
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "SerialReplay.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+bool SerialReplay::load(const uint8_t* trace, size_t size)
+{
+    uint16_t    cnt     = 0U;
+    bool        isValid = SerialCapture::readHeader(trace, size, cnt);
+
+    if (true == isValid)
+    {
+        m_entries       = &trace[SerialCapture::HEADER_SIZE];
+        m_cnt           = cnt;
+        m_idx           = 0U;
+        m_due           = 0U;
+        m_timestamp     = micros();
+        m_mismatches    = 0U;
+    }
+
+    return isValid;
+}
+
+int SerialReplay::available()
+{
+    int         cnt     = 0;
+    uint16_t    idx     = m_idx;
+    uint32_t    due     = m_due;
+    uint8_t     data    = 0U;
+
+    while(true == getNextRx(idx, due, data))
+    {
+        ++cnt;
+    }
+
+    return cnt;
+}
+
+int SerialReplay::read()
+{
+    int     result  = -1;
+    uint8_t data    = 0U;
+
+    if (true == getNextRx(m_idx, m_due, data))
+    {
+        result = data;
+    }
+
+    return result;
+}
+
+int SerialReplay::peek()
+{
+    int         result  = -1;
+    uint16_t    idx     = m_idx;
+    uint32_t    due     = m_due;
+    uint8_t     data    = 0U;
+
+    if (true == getNextRx(idx, due, data))
+    {
+        result = data;
+    }
+
+    return result;
+}
+
+size_t SerialReplay::write(const uint8_t* buffer, size_t size)
+{
+    size_t pos = 0U;
+
+    while(size > pos)
+    {
+        SerialCapture::Entry entry;
+
+        /* Skip everything up to the next transmitted byte. */
+        while((m_cnt > m_idx) &&
+              (0U != (m_entries[m_idx * SerialCapture::ENTRY_SIZE] & (SerialCapture::FLAG_RX | SerialCapture::FLAG_LOST))))
+        {
+            ++m_idx;
+        }
+
+        if (m_cnt > m_idx)
+        {
+            SerialCapture::readEntry(&m_entries[m_idx * SerialCapture::ENTRY_SIZE], entry);
+
+            if (buffer[pos] != entry.data)
+            {
+                ++m_mismatches;
+            }
+
+            ++m_idx;
+        }
+
+        ++pos;
+    }
+
+    /* The received bytes are due relative to the write. */
+    m_timestamp = micros();
+    m_due       = 0U;
+
+    return size;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+bool SerialReplay::getNextRx(uint16_t& idx, uint32_t& due, uint8_t& data) const
+{
+    uint32_t    elapsed = micros() - m_timestamp;
+    bool        isDue   = false;
+    bool        isEnd   = false;
+
+    while((m_cnt > idx) && (false == isDue) && (false == isEnd))
+    {
+        SerialCapture::Entry entry;
+
+        SerialCapture::readEntry(&m_entries[idx * SerialCapture::ENTRY_SIZE], entry);
+
+        if (0U != (entry.flags & SerialCapture::FLAG_LOST))
+        {
+            ++idx;
+        }
+        else if ((0U != (entry.flags & SerialCapture::FLAG_RX)) &&
+                 (elapsed >= (due + SerialCapture::getDelta(entry))))
+        {
+            due    += SerialCapture::getDelta(entry);
+            data    = entry.data;
+            isDue   = true;
+
+            ++idx;
+        }
+        else
+        {
+            /* Not due yet or the next transmitted byte follows. */
+            isEnd = true;
+        }
+    }
+
+    return isDue;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,194 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Serial replay
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __SERIAL_REPLAY_H__
+#define __SERIAL_REPLAY_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+
+#include "SerialCapture.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Stream, which plays the other side of a captured trace, see SerialCapture.
+ *
+ * Every write is compared with the next transmitted bytes of the trace and
+ * differences are counted. The received bytes, which follow in the trace,
+ * become available with the same timing as captured, relative to the write.
+ * Received bytes, which are not read until the next write, are skipped.
+ * After the end of the trace, nothing is received anymore.
+ */
+class SerialReplay : public Stream
+{
+public:
+
+    /**
+     * Constructs a replay without trace.
+     */
+    SerialReplay() :
+        Stream(),
+        m_entries(nullptr),
+        m_cnt(0U),
+        m_idx(0U),
+        m_due(0U),
+        m_timestamp(0U),
+        m_mismatches(0U)
+    {
+    }
+
+    /**
+     * Destroys the replay.
+     */
+    ~SerialReplay()
+    {
+    }
+
+    /**
+     * Load a exported trace and start the replay from its begin.
+     * The trace is not copied, it must be kept by the caller.
+     *
+     * @param[in] trace Trace
+     * @param[in] size  Trace size in bytes
+     *
+     * @return If the trace is valid, it will return true otherwise false.
+     */
+    bool load(const uint8_t* trace, size_t size);
+
+    /**
+     * Is the end of the trace reached?
+     *
+     * @return If finished, it will return true otherwise false.
+     */
+    bool isFinished() const
+    {
+        return (m_cnt <= m_idx);
+    }
+
+    /**
+     * Get the number of written bytes, which differ from the trace.
+     *
+     * @return Number of differences
+     */
+    uint16_t getMismatches() const
+    {
+        return m_mismatches;
+    }
+
+    /**
+     * Get the number of received bytes, which are due.
+     *
+     * @return Number of available data bytes.
+     */
+    int available() override;
+
+    /**
+     * Read a single received byte, which is due.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int read() override;
+
+    /**
+     * Read a single received byte, which is due, without removing it.
+     *
+     * @return Data byte. If no data is available, it will return -1.
+     */
+    int peek() override;
+
+    /**
+     * Write a single data byte.
+     *
+     * @param[in] data  Data byte
+     *
+     * @return Number of written data bytes
+     */
+    size_t write(uint8_t data) override
+    {
+        return write(&data, 1U);
+    }
+
+    /**
+     * Write several data bytes, which are compared with the trace.
+     *
+     * @param[in] buffer    Data buffer
+     * @param[in] size      Data buffer size in bytes
+     *
+     * @return Number of written data bytes
+     */
+    size_t write(const uint8_t* buffer, size_t size) override;
+
+private:
+
+    const uint8_t*  m_entries;      /**< Entries of the trace */
+    uint16_t        m_cnt;          /**< Number of entries */
+    uint16_t        m_idx;          /**< Index of the next entry */
+    uint32_t        m_due;          /**< Time in us after the last write, when the previous entry was due */
+    uint32_t        m_timestamp;    /**< Timestamp in us of the last write */
+    uint16_t        m_mismatches;   /**< Number of written bytes, which differ from the trace */
+
+    SerialReplay(const SerialReplay& replay);
+    SerialReplay& operator=(const SerialReplay& replay);
+
+    /**
+     * Get the next received byte, which is due. Lost entries are skipped.
+     *
+     * @param[in,out]   idx     Index of the next entry
+     * @param[in,out]   due     Time in us after the last write, when the previous entry was due
+     * @param[out]      data    Received byte
+     *
+     * @return If a received byte is due, it will return true otherwise false.
+     */
+    bool getNextRx(uint16_t& idx, uint32_t& due, uint8_t& data) const;
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __SERIAL_REPLAY_H__ */
+
+/** @} */
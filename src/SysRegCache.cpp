@@ -0,0 +1,162 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  System register cache
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "SysRegCache.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+bool SysRegCache::get(uint16_t addr, uint16_t& value) const
+{
+    bool    isCached    = false;
+    uint8_t idx         = find(addr);
+
+    if ((MAX_ENTRIES > idx) &&
+        (MAX_AGE > (millis() - m_entries[idx].timestamp)))
+    {
+        value       = m_entries[idx].value;
+        isCached    = true;
+    }
+
+    return isCached;
+}
+
+void SysRegCache::put(uint16_t addr, uint16_t value)
+{
+    uint32_t    timestamp   = millis();
+    uint8_t     idx         = find(addr);
+
+    /* Not cached yet? Use a free entry or replace the oldest one. */
+    if (MAX_ENTRIES <= idx)
+    {
+        uint8_t     entryIdx    = 0U;
+        uint32_t    maxAge      = 0U;
+        bool        isFreeFound = false;
+
+        idx = 0U;
+
+        while((MAX_ENTRIES > entryIdx) && (false == isFreeFound))
+        {
+            uint32_t age = timestamp - m_entries[entryIdx].timestamp;
+
+            if (false == m_entries[entryIdx].isUsed)
+            {
+                idx         = entryIdx;
+                isFreeFound = true;
+            }
+            else if (maxAge <= age)
+            {
+                idx     = entryIdx;
+                maxAge  = age;
+            }
+            else
+            {
+                /* Nothing to do. */
+                ;
+            }
+
+            ++entryIdx;
+        }
+    }
+
+    m_entries[idx].addr         = addr;
+    m_entries[idx].value        = value;
+    m_entries[idx].timestamp    = timestamp;
+    m_entries[idx].isUsed       = true;
+
+    return;
+}
+
+void SysRegCache::remove(uint16_t addr)
+{
+    uint8_t idx = find(addr);
+
+    if (MAX_ENTRIES > idx)
+    {
+        m_entries[idx].isUsed = false;
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+uint8_t SysRegCache::find(uint16_t addr) const
+{
+    uint8_t idx = 0U;
+
+    while((MAX_ENTRIES > idx) &&
+          ((false == m_entries[idx].isUsed) || (addr != m_entries[idx].addr)))
+    {
+        ++idx;
+    }
+
+    return idx;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
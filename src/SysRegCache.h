@@ -0,0 +1,146 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  System register cache
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __SYSREG_CACHE_H__
+#define __SYSREG_CACHE_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Cache of the last read or written system register values. A value is only
+ * valid for a short time, because the heatpump may change it by itself.
+ * If the cache is full, the oldest value is replaced.
+ */
+class SysRegCache
+{
+public:
+
+    /**
+     * Max. number of cached system registers. A few are enough, because
+     * the values are only valid for a short time.
+     */
+    static const uint8_t    MAX_ENTRIES = 4U;
+
+    /** Max. age of a cached value in ms. */
+    static const uint32_t   MAX_AGE     = (5UL * 1000UL);
+
+    /**
+     * Constructs a empty system register cache.
+     */
+    SysRegCache() :
+        m_entries()
+    {
+    }
+
+    /**
+     * Destroys the system register cache.
+     */
+    ~SysRegCache()
+    {
+    }
+
+    /**
+     * Get the cached value of a system register.
+     *
+     * @param[in]   addr    System register address
+     * @param[out]  value   Value
+     *
+     * @return If a valid value is cached, it will return true otherwise false.
+     */
+    bool get(uint16_t addr, uint16_t& value) const;
+
+    /**
+     * Put the current value of a system register into the cache.
+     *
+     * @param[in] addr  System register address
+     * @param[in] value Value
+     */
+    void put(uint16_t addr, uint16_t value);
+
+    /**
+     * Remove a system register from the cache, e.g. if its write failed.
+     *
+     * @param[in] addr  System register address
+     */
+    void remove(uint16_t addr);
+
+private:
+
+    /**
+     * A single cached system register.
+     */
+    struct Entry
+    {
+        uint16_t    addr;       /**< System register address */
+        uint16_t    value;      /**< Value */
+        uint32_t    timestamp;  /**< Timestamp in ms, when the value was cached */
+        bool        isUsed;     /**< Is entry in use? */
+    };
+
+    Entry   m_entries[MAX_ENTRIES]; /**< Cached system registers */
+
+    SysRegCache(const SysRegCache& cache);
+    SysRegCache& operator=(const SysRegCache& cache);
+
+    /**
+     * Find the entry of a system register.
+     *
+     * @param[in] addr  System register address
+     *
+     * @return Index of the entry. If not found, it will return MAX_ENTRIES.
+     */
+    uint8_t find(uint16_t addr) const;
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __SYSREG_CACHE_H__ */
+
+/** @} */
@@ -0,0 +1,589 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Web connection
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "WebConnection.h"
+#include "LineBuffer.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void WebConnection::open(const EthernetClient& client)
+{
+    m_client        = client;
+    m_continuation  = nullptr;
+    m_producer      = nullptr;
+    m_reqCnt        = 0U;
+    m_state         = STATE_RECEIVE;
+    m_isAborted     = false;
+
+    m_request.clear();
+    m_timer.start(RECEIVE_TIMEOUT);
+
+    return;
+}
+
+void WebConnection::process(Handler dispatcher)
+{
+    switch(m_state)
+    {
+    case STATE_IDLE:
+        /* Nothing to do. */
+        break;
+
+    case STATE_RECEIVE:
+    {
+        bool                isEmpty = m_request.isEmpty();
+        HttpRequest::Status status  = m_request.parse(m_client);
+
+        /* The next request started, it must be received completely within the timeout. */
+        if ((true == isEmpty) &&
+            (false == m_request.isEmpty()))
+        {
+            m_timer.start(RECEIVE_TIMEOUT);
+        }
+
+        switch(status)
+        {
+        case HttpRequest::STATUS_COMPLETE:
+            m_state = STATE_PROCESS;
+
+            if (nullptr != dispatcher)
+            {
+                dispatcher(*this, m_request);
+            }
+
+            /* Neither replied nor deferred? */
+            if ((STATE_PROCESS == m_state) &&
+                (nullptr == m_continuation))
+            {
+                /* Internal Server Error */
+                sendError(500U);
+            }
+            break;
+
+        case HttpRequest::STATUS_ERROR:
+            sendError(m_request.getErrorCode());
+            break;
+
+        case HttpRequest::STATUS_PENDING:
+        default:
+            if (0 == m_client.connected())
+            {
+                close();
+            }
+            else if (false == m_timer.isTimeout())
+            {
+                /* Wait for more data. */
+                ;
+            }
+            else if (true == m_request.isEmpty())
+            {
+                /* Idle connection */
+                close();
+            }
+            else
+            {
+                /* Request Timeout */
+                sendError(408U);
+            }
+            break;
+        }
+        break;
+    }
+
+    case STATE_PROCESS:
+        /* A deferred request of a client, which is gone, is aborted. The
+         * application releases its resources, see isAborted().
+         */
+        if (0 == m_client.connected())
+        {
+            close();
+            m_isAborted = true;
+        }
+        else if (nullptr != m_continuation)
+        {
+            m_continuation(*this, m_request);
+        }
+        else
+        {
+            /* Nothing to do. */
+            ;
+        }
+        break;
+
+    case STATE_SEND:
+        sendChunk();
+        break;
+
+    case STATE_STREAM:
+        sendItem();
+        break;
+
+    default:
+        close();
+        break;
+    }
+
+    return;
+}
+
+void WebConnection::defer(Handler continuation)
+{
+    if (STATE_PROCESS == m_state)
+    {
+        m_continuation = continuation;
+        m_deadlineTimer.stop();
+    }
+
+    return;
+}
+
+void WebConnection::defer(Handler continuation, uint32_t deadline)
+{
+    if (STATE_PROCESS == m_state)
+    {
+        m_continuation = continuation;
+        m_deadlineTimer.start(deadline);
+    }
+
+    return;
+}
+
+void WebConnection::sendReply(uint16_t statusCode, const __FlashStringHelper* contentType, const String& body)
+{
+    sendReply(statusCode, contentType, body, nullptr);
+
+    return;
+}
+
+void WebConnection::sendReply(uint16_t statusCode, const __FlashStringHelper* contentType, const String& body, const char* eTag)
+{
+    if ((STATE_RECEIVE == m_state) ||
+        (STATE_PROCESS == m_state))
+    {
+        beginReply(statusCode, contentType, body.length(), eTag, 0U);
+
+        if (HttpRequest::METHOD_HEAD != m_request.getMethod())
+        {
+            m_tx += body;
+        }
+    }
+
+    return;
+}
+
+void WebConnection::sendNotModified(const char* eTag)
+{
+    if ((STATE_RECEIVE == m_state) ||
+        (STATE_PROCESS == m_state))
+    {
+        beginReply(304U, nullptr, 0U, eTag, 0U);
+    }
+
+    return;
+}
+
+void WebConnection::sendStream(uint16_t statusCode, const __FlashStringHelper* contentType, Producer producer)
+{
+    sendStream(statusCode, contentType, producer, nullptr);
+
+    return;
+}
+
+void WebConnection::sendStream(uint16_t statusCode, const __FlashStringHelper* contentType, Producer producer, const char* eTag)
+{
+    if ((STATE_RECEIVE == m_state) ||
+        (STATE_PROCESS == m_state))
+    {
+        m_producer  = producer;
+        m_itemIdx   = 0U;
+        m_isChunked = m_request.isHttp11();
+
+        beginReply(statusCode, contentType, 0U, eTag, 0U);
+
+        if (HttpRequest::METHOD_HEAD == m_request.getMethod())
+        {
+            m_producer = nullptr;
+        }
+    }
+
+    return;
+}
+
+void WebConnection::sendError(uint16_t statusCode)
+{
+    sendReply(statusCode, F("text/plain"), getStatusText(statusCode));
+
+    return;
+}
+
+void WebConnection::sendServiceUnavailable(uint16_t retryAfter)
+{
+    if ((STATE_RECEIVE == m_state) ||
+        (STATE_PROCESS == m_state))
+    {
+        String body = getStatusText(503U);
+
+        beginReply(503U, F("text/plain"), body.length(), nullptr, retryAfter);
+
+        if (HttpRequest::METHOD_HEAD != m_request.getMethod())
+        {
+            m_tx += body;
+        }
+    }
+
+    return;
+}
+
+void WebConnection::detach()
+{
+    m_client        = EthernetClient();
+    m_continuation  = nullptr;
+    m_producer      = nullptr;
+    m_tx            = "";
+    m_state         = STATE_IDLE;
+
+    m_request.clear();
+    m_timer.stop();
+    m_deadlineTimer.stop();
+
+    return;
+}
+
+void WebConnection::close()
+{
+    m_client.stop();
+
+    m_continuation  = nullptr;
+    m_producer      = nullptr;
+    m_tx            = "";
+    m_state         = STATE_IDLE;
+
+    m_request.clear();
+    m_timer.stop();
+    m_deadlineTimer.stop();
+
+    return;
+}
+
+const __FlashStringHelper* WebConnection::getStatusText(uint16_t statusCode)
+{
+    const __FlashStringHelper* text = nullptr;
+
+    switch(statusCode)
+    {
+    case 200U:
+        text = F("OK");
+        break;
+
+    case 304U:
+        text = F("Not Modified");
+        break;
+
+    case 400U:
+        text = F("Bad Request");
+        break;
+
+    case 404U:
+        text = F("Not Found");
+        break;
+
+    case 408U:
+        text = F("Request Timeout");
+        break;
+
+    case 413U:
+        text = F("Payload Too Large");
+        break;
+
+    case 414U:
+        text = F("URI Too Long");
+        break;
+
+    case 501U:
+        text = F("Not Implemented");
+        break;
+
+    case 503U:
+        text = F("Service Unavailable");
+        break;
+
+    case 500U:
+    default:
+        text = F("Internal Server Error");
+        break;
+    }
+
+    return text;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+void WebConnection::beginReply(uint16_t statusCode, const __FlashStringHelper* contentType, size_t bodySize, const char* eTag, uint16_t retryAfter)
+{
+    /* If the request is invalid, the following data can't be trusted.
+     * Therefore the connection is only kept open after a valid request.
+     */
+    m_isKeepAlive = (STATE_PROCESS == m_state) &&
+                    (true == m_request.isKeepAlive()) &&
+                    (MAX_REQUESTS > (m_reqCnt + 1U));
+
+    m_tx = F("HTTP/1.1 ");
+    m_tx += statusCode;
+    m_tx += ' ';
+    m_tx += getStatusText(statusCode);
+
+    if (nullptr != contentType)
+    {
+        m_tx += F("\r\nContent-Type: ");
+        m_tx += contentType;
+
+        if (nullptr == m_producer)
+        {
+            m_tx += F("\r\nContent-Length: ");
+            m_tx += bodySize;
+        }
+        else if (true == m_isChunked)
+        {
+            m_tx += F("\r\nTransfer-Encoding: chunked");
+        }
+        else
+        {
+            /* The size of a streamed body is unknown, its end is signalled by closing the connection. */
+            m_isKeepAlive = false;
+        }
+    }
+
+    if (nullptr != eTag)
+    {
+        m_tx += F("\r\nETag: ");
+        m_tx += eTag;
+    }
+
+    if (0U < retryAfter)
+    {
+        m_tx += F("\r\nRetry-After: ");
+        m_tx += retryAfter;
+    }
+
+    m_tx += F("\r\nConnection: ");
+    m_tx += (true == m_isKeepAlive) ? F("keep-alive") : F("close");
+    m_tx += F("\r\n\r\n");
+
+    m_txIdx         = 0U;
+    m_continuation  = nullptr;
+    m_state         = STATE_SEND;
+
+    m_timer.start(SEND_TIMEOUT);
+    m_deadlineTimer.stop();
+
+    return;
+}
+
+void WebConnection::sendChunk()
+{
+    size_t  remaining   = m_tx.length() - m_txIdx;
+    int     available   = m_client.availableForWrite();
+
+    if (0 == m_client.connected())
+    {
+        close();
+    }
+    else if ((0U == remaining) &&
+             (nullptr != m_producer))
+    {
+        /* Header is sent, continue with the streamed body. */
+        m_tx    = "";
+        m_state = STATE_STREAM;
+    }
+    else if (0U == remaining)
+    {
+        finishReply();
+    }
+    else if (true == m_timer.isTimeout())
+    {
+        close();
+    }
+    else if (0 < available)
+    {
+        size_t chunkSize = remaining;
+
+        if (static_cast<size_t>(available) < chunkSize)
+        {
+            chunkSize = static_cast<size_t>(available);
+        }
+
+        if (MAX_CHUNK_SIZE < chunkSize)
+        {
+            chunkSize = MAX_CHUNK_SIZE;
+        }
+
+        m_txIdx += m_client.write(reinterpret_cast<const uint8_t*>(&m_tx.c_str()[m_txIdx]), chunkSize);
+    }
+    else
+    {
+        /* Wait until the transmit buffer has space. */
+        ;
+    }
+
+    return;
+}
+
+void WebConnection::sendItem()
+{
+    /* The chunk header is written right-aligned in front of the item,
+     * therefore the whole chunk is written at once.
+     */
+    char        chunk[CHUNK_HEADER_SIZE + MAX_ITEM_SIZE + CHUNK_TRAILER_SIZE];
+    LineBuffer  item(&chunk[CHUNK_HEADER_SIZE], MAX_ITEM_SIZE);
+    int         available   = m_client.availableForWrite();
+
+    if (0 == m_client.connected())
+    {
+        close();
+    }
+    else if (true == m_timer.isTimeout())
+    {
+        close();
+    }
+    else if (0 >= available)
+    {
+        /* Wait until the transmit buffer has space. */
+        ;
+    }
+    else if (false == m_producer(item, m_itemIdx))
+    {
+        /* End of the body */
+        if (true == m_isChunked)
+        {
+            (void)m_client.print(F("0\r\n\r\n"));
+        }
+
+        finishReply();
+    }
+    else if ((true == item.isOverflow()) ||
+             (0U == item.length()))
+    {
+        /* A truncated or missing item would corrupt the body. The reply is
+         * aborted without the last chunk, therefore the client detects it.
+         */
+        close();
+    }
+    else
+    {
+        size_t  begin   = CHUNK_HEADER_SIZE;
+        size_t  end     = CHUNK_HEADER_SIZE + item.length();
+
+        if (true == m_isChunked)
+        {
+            char    header[CHUNK_HEADER_SIZE + 1U];
+            size_t  headerLen = static_cast<size_t>(snprintf(header, sizeof(header), "%X\r\n", static_cast<unsigned int>(item.length())));
+
+            begin -= headerLen;
+            memcpy(&chunk[begin], header, headerLen);
+
+            chunk[end] = '\r';
+            ++end;
+            chunk[end] = '\n';
+            ++end;
+        }
+
+        /* The item is produced again in the next call, if it doesn't fit. */
+        if (static_cast<size_t>(available) >= (end - begin))
+        {
+            (void)m_client.write(reinterpret_cast<const uint8_t*>(&chunk[begin]), end - begin);
+            ++m_itemIdx;
+        }
+    }
+
+    return;
+}
+
+void WebConnection::finishReply()
+{
+    m_client.flush();
+
+    if (false == m_isKeepAlive)
+    {
+        close();
+    }
+    else
+    {
+        /* Wait for the next request, which may be already in the socket. */
+        ++m_reqCnt;
+        m_tx        = "";
+        m_producer  = nullptr;
+        m_state     = STATE_RECEIVE;
+
+        m_request.clear();
+        m_timer.start(IDLE_TIMEOUT);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
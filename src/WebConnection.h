@@ -0,0 +1,410 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 - 2024 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Web connection
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @{
+ */
+
+#ifndef __WEB_CONNECTION_H__
+#define __WEB_CONNECTION_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+#include <EthernetClient.h>
+
+#include "HttpRequest.h"
+#include "SimpleTimer.hpp"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * A single web connection, which is served step by step. Every call of
+ * process() does only a bounded amount of work: it reads the request data
+ * which is available, dispatches the complete request or writes the next
+ * chunk of the reply. Several connections can be served interleaved this way.
+ *
+ * The connection is kept open after the reply, if the client wants it.
+ * Further requests are served in sequence, pipelined requests wait in the
+ * socket until the reply of the previous request is sent. A idle connection
+ * is closed after a timeout or if its slot is needed for a new client.
+ *
+ * A request handler either replies immediately or defers the request.
+ * A deferred request is continued in every process() call, until the
+ * continuation sends the reply. This is used to wait for the heatpump
+ * without blocking.
+ *
+ * A big reply can be streamed instead, item by item. Every item is produced
+ * on the stack right before it is written, therefore the reply is never kept
+ * completely in memory.
+ */
+class WebConnection
+{
+public:
+
+    /**
+     * Web request handler. It is also used to continue a deferred request.
+     *
+     * @param[in] conn          The web connection, used for the reply.
+     * @param[in] httpRequest   The http request itself.
+     */
+    typedef void (*Handler)(WebConnection& conn, const HttpRequest& httpRequest);
+
+    /**
+     * Producer of a streamed reply. It writes a single item of the body.
+     *
+     * @param[in] out   Output, the item shall not exceed MAX_ITEM_SIZE - 1 characters.
+     * @param[in] idx   Index of the item, which to write.
+     *
+     * @return If the item was written, it will return true. If there is no item anymore, it will return false.
+     */
+    typedef bool (*Producer)(Print& out, uint16_t idx);
+
+    /** Max. duration in ms to receive a complete request. */
+    static const uint32_t   RECEIVE_TIMEOUT = (5UL * 1000UL);
+
+    /** Max. duration in ms a kept open connection waits for the next request. */
+    static const uint32_t   IDLE_TIMEOUT    = (5UL * 1000UL);
+
+    /** Max. number of requests per connection. */
+    static const uint8_t    MAX_REQUESTS    = 100U;
+
+    /** Max. duration in ms to send the complete reply. */
+    static const uint32_t   SEND_TIMEOUT    = (10UL * 1000UL);
+
+    /** Max. number of bytes, which are written per process() call. */
+    static const size_t     MAX_CHUNK_SIZE  = 128U;
+
+    /** Max. size of a streamed item in bytes, including the string termination. */
+    static const size_t     MAX_ITEM_SIZE   = 128U;
+
+    /**
+     * Constructs a unused web connection.
+     */
+    WebConnection() :
+        m_state(STATE_IDLE),
+        m_client(),
+        m_request(),
+        m_continuation(nullptr),
+        m_tx(),
+        m_txIdx(0U),
+        m_isKeepAlive(false),
+        m_reqCnt(0U),
+        m_producer(nullptr),
+        m_itemIdx(0U),
+        m_isChunked(false),
+        m_timer(),
+        m_deadlineTimer(),
+        m_isAborted(false)
+    {
+    }
+
+    /**
+     * Destroys the web connection.
+     */
+    ~WebConnection()
+    {
+    }
+
+    /**
+     * Open the connection with a new client.
+     *
+     * @param[in] client    Ethernet client
+     */
+    void open(const EthernetClient& client);
+
+    /**
+     * Is connection used?
+     *
+     * @return If used, it will return true otherwise false.
+     */
+    bool isUsed() const
+    {
+        return (STATE_IDLE != m_state);
+    }
+
+    /**
+     * Is connection kept open and waits for the next request?
+     *
+     * @return If idle, it will return true otherwise false.
+     */
+    bool isIdle() const
+    {
+        return ((STATE_RECEIVE == m_state) && (0U < m_reqCnt) && (true == m_request.isEmpty()));
+    }
+
+    /**
+     * Is the request deferred and waits e.g. for the heatpump?
+     *
+     * @return If deferred, it will return true otherwise false.
+     */
+    bool isDeferred() const
+    {
+        return ((STATE_PROCESS == m_state) && (nullptr != m_continuation));
+    }
+
+    /**
+     * Was the deferred request aborted, because the client is gone?
+     * It stays set until the connection is opened again.
+     *
+     * @return If aborted, it will return true otherwise false.
+     */
+    bool isAborted() const
+    {
+        return m_isAborted;
+    }
+
+    /**
+     * Process the connection.
+     *
+     * @param[in] dispatcher    Handler, which is called with every complete request.
+     */
+    void process(Handler dispatcher);
+
+    /**
+     * Defer the request. The continuation is called in every process() call,
+     * until it sends the reply.
+     *
+     * @param[in] continuation  Handler, which continues the request.
+     */
+    void defer(Handler continuation);
+
+    /**
+     * Defer the request with a deadline. The continuation is called in every
+     * process() call, until it sends the reply. A deferred request again
+     * restarts the deadline.
+     *
+     * @param[in] continuation  Handler, which continues the request.
+     * @param[in] deadline      Deadline in ms, starting now.
+     */
+    void defer(Handler continuation, uint32_t deadline);
+
+    /**
+     * Is the deadline of the deferred request exceeded?
+     * The continuation decides how to handle it, e.g. drop the request if
+     * it wasn't started yet.
+     *
+     * @return If the deadline is exceeded, it will return true otherwise false.
+     */
+    bool isDeadlineExceeded()
+    {
+        return ((true == m_deadlineTimer.isTimerRunning()) && (true == m_deadlineTimer.isTimeout()));
+    }
+
+    /**
+     * Send the reply. It is written in chunks by the next process() calls.
+     *
+     * @param[in] statusCode    Http status code
+     * @param[in] contentType   Content type of the body
+     * @param[in] body          Body
+     */
+    void sendReply(uint16_t statusCode, const __FlashStringHelper* contentType, const String& body);
+
+    /**
+     * Send the reply with a entity tag, which identifies the version of the
+     * body. It is written in chunks by the next process() calls.
+     *
+     * @param[in] statusCode    Http status code
+     * @param[in] contentType   Content type of the body
+     * @param[in] body          Body
+     * @param[in] eTag          Entity tag
+     */
+    void sendReply(uint16_t statusCode, const __FlashStringHelper* contentType, const String& body, const char* eTag);
+
+    /**
+     * Send 304 Not Modified without body, because the client has the
+     * current version already.
+     *
+     * @param[in] eTag          Entity tag of the current version
+     */
+    void sendNotModified(const char* eTag);
+
+    /**
+     * Send a streamed reply. Its body is produced item by item by the next
+     * process() calls. A HTTP/1.1 client gets it in chunked transfer encoding,
+     * otherwise the end of the body is signalled by closing the connection.
+     *
+     * @param[in] statusCode    Http status code
+     * @param[in] contentType   Content type of the body
+     * @param[in] producer      Producer of the body items
+     */
+    void sendStream(uint16_t statusCode, const __FlashStringHelper* contentType, Producer producer);
+
+    /**
+     * Send a streamed reply with a entity tag, which identifies the version
+     * of the body. See sendStream() without entity tag for the details.
+     *
+     * @param[in] statusCode    Http status code
+     * @param[in] contentType   Content type of the body
+     * @param[in] producer      Producer of the body items
+     * @param[in] eTag          Entity tag
+     */
+    void sendStream(uint16_t statusCode, const __FlashStringHelper* contentType, Producer producer, const char* eTag);
+
+    /**
+     * Send a error reply, with the status text as body.
+     *
+     * @param[in] statusCode    Http status code
+     */
+    void sendError(uint16_t statusCode);
+
+    /**
+     * Send 503 Service Unavailable, with the time after which the client
+     * shall retry the request.
+     *
+     * @param[in] retryAfter    Time in s, after which the client shall retry. Use 0 for none.
+     */
+    void sendServiceUnavailable(uint16_t retryAfter);
+
+    /**
+     * Get the ethernet client, e.g. to take over the connection.
+     *
+     * @return Ethernet client
+     */
+    EthernetClient& getClient()
+    {
+        return m_client;
+    }
+
+    /**
+     * Get the current http request.
+     *
+     * @return Http request
+     */
+    const HttpRequest& getRequest() const
+    {
+        return m_request;
+    }
+
+    /**
+     * Release the connection without closing the client. Used after the
+     * client was taken over.
+     */
+    void detach();
+
+    /**
+     * Close the connection.
+     * Note, a connection with a deferred request shall not be closed, because
+     * the continuation must finish it.
+     */
+    void close();
+
+    /**
+     * Get the status text of the http status code.
+     *
+     * @param[in] statusCode    Http status code
+     *
+     * @return Status text
+     */
+    static const __FlashStringHelper* getStatusText(uint16_t statusCode);
+
+private:
+
+    /**
+     * Connection states
+     */
+    enum State
+    {
+        STATE_IDLE = 0, /**< Connection is not used */
+        STATE_RECEIVE,  /**< Receive request */
+        STATE_PROCESS,  /**< Request is deferred */
+        STATE_SEND,     /**< Send reply */
+        STATE_STREAM    /**< Send streamed body of the reply */
+    };
+
+    /** Size of a chunk header, which is the hex. chunk size and CRLF. */
+    static const size_t     CHUNK_HEADER_SIZE   = 4U;
+
+    /** Size of a chunk trailer, which is CRLF. */
+    static const size_t     CHUNK_TRAILER_SIZE  = 2U;
+
+    State           m_state;        /**< Connection state */
+    EthernetClient  m_client;       /**< Ethernet client */
+    HttpRequest     m_request;      /**< Http request */
+    Handler         m_continuation; /**< Continuation of a deferred request */
+    String          m_tx;           /**< Reply, which to send */
+    size_t          m_txIdx;        /**< Index of the next byte of the reply, which to send */
+    bool            m_isKeepAlive;  /**< Keep connection open after the reply? */
+    uint8_t         m_reqCnt;       /**< Number of completely served requests */
+    Producer        m_producer;     /**< Producer of a streamed body */
+    uint16_t        m_itemIdx;      /**< Index of the next streamed item */
+    bool            m_isChunked;    /**< Streamed body in chunked transfer encoding? */
+    SimpleTimer     m_timer;        /**< Observes receiving and sending */
+    SimpleTimer     m_deadlineTimer;/**< Observes the deadline of a deferred request */
+    bool            m_isAborted;    /**< Deferred request aborted, because the client is gone? */
+
+    WebConnection(const WebConnection& conn);
+    WebConnection& operator=(const WebConnection& conn);
+
+    /**
+     * Prepare the reply header and switch to sending.
+     *
+     * @param[in] statusCode    Http status code
+     * @param[in] contentType   Content type of the body. Use nullptr for no body.
+     * @param[in] bodySize      Body size in bytes
+     * @param[in] eTag          Entity tag. Use nullptr for none.
+     * @param[in] retryAfter    Retry-After time in s. Use 0 for none.
+     */
+    void beginReply(uint16_t statusCode, const __FlashStringHelper* contentType, size_t bodySize, const char* eTag, uint16_t retryAfter);
+
+    /**
+     * Write the next chunk of the reply.
+     */
+    void sendChunk();
+
+    /**
+     * Produce and write the next item of a streamed body.
+     */
+    void sendItem();
+
+    /**
+     * The reply is completely sent. Either close the connection or wait for
+     * the next request.
+     */
+    void finishReply();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __WEB_CONNECTION_H__ */
+
+/** @} */
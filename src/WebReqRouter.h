@@ -41,9 +41,8 @@
 /******************************************************************************
  * Includes
  *****************************************************************************/
-#include <ArduinoHttpServer.h>
-
-#include "EthernetClient.h"
+#include "HttpRequest.h"
+#include "WebConnection.h"
 
 /******************************************************************************
  * Macros
@@ -53,11 +52,6 @@
  * Types and Classes
  *****************************************************************************/
 
-/**
- * Http request stream buffer type.
- */
-typedef ArduinoHttpServer::StreamHttpRequest<256> HttpRequest;
-
 /**
  * The web request router is responsible to route a web request to the
  * right route and handle it.
@@ -72,25 +66,25 @@ public:
     /**
      * Web request handler.
      *
-     * @param[in] client        The ethernet client, used for the response.
+     * @param[in] conn          The web connection, used for the response.
      * @param[in] httpRequest   The web request itself.
      */
-    typedef void (*WebReqHandler)(EthernetClient& client, const HttpRequest& httpRequest);
+    typedef WebConnection::Handler WebReqHandler;
 
     /**
      * A single route.
      */
     struct Route
     {
-        ArduinoHttpServer::Method   method;     /**< Http request method */
-        String                      uri;        /**< Http request URI */
-        WebReqHandler               handler;    /**< Handler of the web request */
+        HttpRequest::Method method;     /**< Http request method */
+        String              uri;        /**< Http request URI */
+        WebReqHandler       handler;    /**< Handler of the web request */
 
         /**
          * Constructs a empty route.
          */
         Route() :
-            method(ArduinoHttpServer::Method::Invalid),
+            method(HttpRequest::METHOD_UNKNOWN),
             uri(),
             handler(nullptr)
         {
@@ -128,7 +122,7 @@ public:
      *
      * @return If the route is added, it will return true otherwise false.
      */
-    bool addRoute(ArduinoHttpServer::Method method, const String& uri, WebReqHandler handler)
+    bool addRoute(HttpRequest::Method method, const String& uri, WebReqHandler handler)
     {
         uint8_t idx         = 0;
         bool    isSlotFound = false;
@@ -155,12 +149,12 @@ public:
     /**
      * Handle a web request.
      *
-     * @param[in] client        The ethernet client, used for the response.
+     * @param[in] conn          The web connection, used for the response.
      * @param[in] httpRequest   The http web request.
      *
      * @return If the request is handled, it will return true otherwise false.
      */
-    bool handle(EthernetClient& client, const HttpRequest& httpRequest)
+    bool handle(WebConnection& conn, const HttpRequest& httpRequest)
     {
         uint8_t idx             = 0;
         bool    isRouteFound    = false;
@@ -177,7 +171,7 @@ public:
                 {
                     String staticUriPart = m_routes[idx].uri.substring(0, lastIndex - 1);
 
-                    if (0 != httpRequest.getResource().toString().startsWith(staticUriPart))
+                    if (0 != httpRequest.getUri().startsWith(staticUriPart))
                     {
                         isRouteFound = true;
                     }
@@ -185,7 +179,7 @@ public:
                 else
                 /* No dynamic part in URI */
                 {
-                    if (0 != m_routes[idx].uri.equals(httpRequest.getResource().toString()))
+                    if (0 != m_routes[idx].uri.equals(httpRequest.getUri()))
                     {
                         isRouteFound = true;
                     }
@@ -200,7 +194,7 @@ public:
 
         if (true == isRouteFound)
         {
-            m_routes[idx].handler(client, httpRequest);
+            m_routes[idx].handler(conn, httpRequest);
         }
 
         return isRouteFound;
@@ -37,15 +37,24 @@
 #include <EthernetENC.h>
 #include <EthernetClient.h>
 #include <EthernetServer.h>
-#include <ArduinoHttpServer.h>
+#include <EthernetUdp.h>
 #include <ArduinoJson.h>
 
 #include "Logging.h"
 #include "EthernetClient.h"
 #include "WebReqRouter.h"
+#include "WebConnection.h"
 #include "Rego6xxCtrl.h"
 #include "Rego6xxUtil.h"
 #include "SimpleTimer.hpp"
+#include "FrontPanelMacro.h"
+#include "FrontPanelLeds.h"
+#include "EventRing.h"
+#include "MsgPackWriter.h"
+#include "MqttClient.h"
+#include "LineBuffer.h"
+#include "SysRegCache.h"
+#include "LoopProfiler.h"
 
 #include <Temperature.h>
 
@@ -53,6 +62,19 @@
 #include "Rego6xxSim.h"
 #endif  /* defined(DEBUG) */
 
+#if defined(SERIAL_CAPTURE)
+#include "SerialCapture.h"
+#endif  /* defined(SERIAL_CAPTURE) */
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/* The native server replaces the heatpump stream via the capture. */
+#if defined(NATIVE) && !defined(SERIAL_CAPTURE)
+#error SERIAL_CAPTURE is required on the host.
+#endif  /* defined(NATIVE) && !defined(SERIAL_CAPTURE) */
+
 /******************************************************************************
  * Macros
  *****************************************************************************/
@@ -103,10 +125,49 @@ typedef enum
     STATUS_ID_EINPUT,   /**< Input data invalid */
     STATUS_ID_EPAR,     /**< Parameter is missing */
     STATUS_ID_EINTERNAL,/**< Unknown internal error */
-    STATUS_ID_EINVALID  /**< Response is invalid */
+    STATUS_ID_EINVALID, /**< Response is invalid */
+    STATUS_ID_EABORTED  /**< Macro aborted */
 
 } StatusId;
 
+/**
+ * A single temperature write.
+ */
+typedef struct
+{
+    TemperatureId   id;         /**< Temperature, which to write */
+    uint16_t        rawValue;   /**< Raw temperature value */
+    StatusId        statusId;   /**< Status of the write, valid after it is done. */
+
+} TemperatureWrite;
+
+/**
+ * A client, which is subscribed to the event stream.
+ */
+typedef struct
+{
+    EthernetClient  client; /**< Ethernet client */
+    uint16_t        seq;    /**< Sequence number of the next event, which to send. */
+    bool            isUsed; /**< Is slot in use? */
+
+} EventClient;
+
+/** This type defines the phases of the main loop, which are profiled. */
+typedef enum
+{
+    LOOP_PHASE_NETWORK = 0,         /**< Ethernet link and new web clients */
+    LOOP_PHASE_EVENTS,              /**< Event stream clients */
+    LOOP_PHASE_MQTT,                /**< MQTT client and front panel requests via MQTT */
+    LOOP_PHASE_WEB,                 /**< Web connections and their request handlers */
+    LOOP_PHASE_TEMPERATURE_WRITE,   /**< Temperature write state machine */
+    LOOP_PHASE_LED_READ,            /**< Front panel LED read cycle */
+    LOOP_PHASE_SENSOR_READ,         /**< Temperature sensor read cycle, incl. telemetry */
+    LOOP_PHASE_REGO6XX,             /**< Heatpump controller */
+
+    LOOP_PHASE_MAX                  /**< Value used to determine max. number of loop phases. */
+
+} LoopPhase;
+
 /******************************************************************************
  * Prototypes
  *****************************************************************************/
@@ -114,15 +175,90 @@ typedef enum
 static String ipToStr(IPAddress ip);
 static void printNetworkSettings(void);
 static void handleNetwork(void);
-static void handleRoot(EthernetClient& client, const HttpRequest& httpRequest);
-static void handleSensorGetReq(EthernetClient& client, const HttpRequest& httpRequest);
-static void handleSensorPostReq(EthernetClient& client, const HttpRequest& httpRequest);
-static void handleDebugPostReq(EthernetClient& client, const HttpRequest& httpRequest);
-static void handleLastErrorGetReq(EthernetClient& client, const HttpRequest& httpRequest);
-static void handleFrontPanelGetReq(EthernetClient& client, const HttpRequest& httpRequest);
-static void handleFrontPanelPostReq(EthernetClient& client, const HttpRequest& httpRequest);
-static void handleDisplayGetReq(EthernetClient& client, const HttpRequest& httpRequest);
+static void handleWebConnections(void);
+static void dispatchWebReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void releaseWebBus(void);
+static void releaseAbortedWebReq(WebConnection& conn);
+static bool admitBusReq(WebConnection& conn, uint32_t duration);
+static uint32_t getBusWaitTime(void);
+static uint32_t getBusDuration(void);
+static uint16_t getRetryAfter(uint32_t waitTime);
+static bool dropExpiredBusReq(WebConnection& conn);
+static void setDataChanged(void);
+static void getDataETag(char* eTag, size_t size);
+static bool isDataCached(const HttpRequest& httpRequest, const char* eTag);
+static uint16_t getHash(const String& str);
+static void handleRoot(WebConnection& conn, const HttpRequest& httpRequest);
+static void handleSensorGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static bool writeSensorsJson(Print& out, uint16_t idx);
+static bool writeSensorsMsgPack(Print& out, uint16_t idx);
+static void sendTelemetry(void);
+static void handleSensorPostReq(WebConnection& conn, const HttpRequest& httpRequest);
+static StatusId requestTemperatureWrite(const String& name, float value);
+static StatusId requestTemperatureWrites(JsonArray writes, uint8_t& invalidIdx);
+static void continueSensorPostReq(WebConnection& conn, const HttpRequest& httpRequest);
+static bool isTemperatureWriteBusy(void);
+static bool getWriteableTemperature(const String& name, TemperatureId& id);
+static Rego6xxCtrl::SysRegAddr getTemperatureSysRegAddr(TemperatureId id);
+static void handleDebugPostReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void continueDebugPostReq(WebConnection& conn, const HttpRequest& httpRequest);
+static bool getDebugCmd(const HttpRequest& httpRequest, uint8_t& cmdId, uint16_t& addr, uint16_t& value);
+static void handleSysRegGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void continueSysRegGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void continueSysRegScanGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void handleSysRegPostReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void continueSysRegPostReq(WebConnection& conn, const HttpRequest& httpRequest);
+static bool parseSysRegAddr(const String& str, uint16_t& addr);
+static bool getSysRegWriteValue(const HttpRequest& httpRequest, uint16_t& value);
+static void sendSysRegStatus(WebConnection& conn, StatusId statusId);
+static void handleLastErrorGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void continueLastErrorGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void handleFrontPanelGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void handleFrontPanelPostReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void continueFrontPanelPostReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void handleFrontPanelMacroPostReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void continueFrontPanelMacroPostReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void handleDisplayGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void continueDisplayGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void handleEventsGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static void handleEventClients(void);
+static void stopEventClients(void);
+static bool sendEvent(EthernetClient& client, const EventRing::Event& event);
+static void handleMetricsGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static bool writeMetrics(Print& out, uint16_t idx);
+static void writeMetric(Print& out, const __FlashStringHelper* name, const __FlashStringHelper* type, uint32_t value);
+static bool writeBusCmdMetrics(Print& out, uint16_t idx);
+static const __FlashStringHelper* getBusCmdCounter(uint8_t counterIdx, const Rego6xxCtrl::CmdStatistics& statistics, uint32_t& value);
+static void writeBusCmdSample(Print& out, const __FlashStringHelper* name, Rego6xxCtrl::CmdStatsId id);
+static const __FlashStringHelper* getCmdStatsName(Rego6xxCtrl::CmdStatsId id);
+static void handleLoopGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static bool writeLoopProfile(Print& out, uint16_t idx);
+static const __FlashStringHelper* getLoopPhaseName(uint8_t phase);
+
+#if defined(SERIAL_CAPTURE)
+
+static void handleCaptureGetReq(WebConnection& conn, const HttpRequest& httpRequest);
+static bool writeCapture(Print& out, uint16_t idx);
+
+#endif  /* defined(SERIAL_CAPTURE) */
+
+static void writeMetricType(Print& out, const __FlashStringHelper* name, const __FlashStringHelper* type);
+static void writeDecimal(Print& out, int16_t value);
+static uint16_t getQueueDepth(void);
+static bool isWebReqInProgress(void);
+static uint16_t getFreeRam(void);
+static void handleMqtt(void);
+static void handleMqttFrontPanelReq(void);
+static bool publishMqttSensor(uint8_t idx, int16_t rawValue);
+static bool publishMqttLed(FrontPanelLeds::LedId ledId, bool isOn);
+static bool publishMqtt(const __FlashStringHelper* topicBase, const char* name, const char* payload);
+static void onMqttMessage(const char* topic, const char* payload);
+static bool getHmiAction(const String& hmiName, Rego6xxCtrl::FrontPanelAddr& addr, uint16_t& value);
+static bool getDisplayRow(uint8_t rowId, Rego6xxCtrl::Row& row);
 static const Rego6xxStdRsp* readNextTemperatures(const TemperatureId& lastTemperature, TemperatureId& nextTemperature);
+static const Rego6xxBoolRsp* readNextLed(const FrontPanelLeds::LedId& lastLed, FrontPanelLeds::LedId& nextLed);
+static void logLedChanges(uint8_t changed, uint8_t state);
+static void pushLedEvents(uint8_t changed, uint8_t state);
 
 /******************************************************************************
  * Variables
@@ -133,6 +269,12 @@ static const Rego6xxStdRsp* readNextTemperatures(const TemperatureId& lastTemper
 /** Serial interface baudrate. */
 static const uint32_t           SERIAL_BAUDRATE             = 115200U;
 
+/** Baudrate of the simulated heatpump serial line, like the real one. */
+static const uint32_t           REGO6XX_SIM_BAUDRATE        = 19200U;
+
+/** Processing delay of the simulated heatpump controller in ms. */
+static const uint32_t           REGO6XX_SIM_PROC_DELAY      = 20U;
+
 #else
 
 /** Serial interface baudrate. */
@@ -158,30 +300,144 @@ static const char               HTML_PAGE_HEAD[] PROGMEM    = "<!DOCTYPE html>\r
 static const char               HTML_PAGE_TAIL[] PROGMEM    = "</body>\r\n"
                                                             "</html>";
 
+#if defined(SERIAL_CAPTURE)
+
+/** Number of supported web request routes. */
+static const uint8_t            NUM_ROUTES                  = 15;
+
+#else
+
 /** Number of supported web request routes. */
-static const uint8_t            NUM_ROUTES                  = 8;
+static const uint8_t            NUM_ROUTES                  = 14;
+
+#endif  /* defined(SERIAL_CAPTURE) */
 
 /** Web request router */
 static WebReqRouter<NUM_ROUTES> gWebReqRouter;
 
+#if defined(NATIVE)
+
+/** Webserver port number, which needs no privileges on the host. */
+static const uint16_t           WEB_SRV_PORT                = 8080;
+
+#else
+
 /** Webserver port number */
 static const uint16_t           WEB_SRV_PORT                = 80;
 
+#endif  /* defined(NATIVE) */
+
 /** Webserver */
 static EthernetServer           gWebServer(WEB_SRV_PORT);
 
+/**
+ * Max. number of web connections, which are served at the same time.
+ * Every connection costs RAM permanently and its request body on the heap.
+ * Together with the event client and MQTT it shall not exceed the 4 sockets
+ * of the ethernet stack.
+ */
+static const uint8_t            MAX_WEB_CONNECTIONS         = 2U;
+
+/** Web connections */
+static WebConnection            gWebConnections[MAX_WEB_CONNECTIONS];
+
+/** Web connection, which owns the pending Rego6xx response of a web request. */
+static WebConnection*           gWebBusConn                 = nullptr;
+
+/** Pending Rego6xx response of a web request. */
+static const Rego6xxRsp*        gWebBusRsp                  = nullptr;
+
+/**
+ * Pending Rego6xx response of an aborted web request. The controller is
+ * released after it is finished, because a late response would disturb the
+ * next one.
+ */
+static const Rego6xxRsp*        gWebBusAbortedRsp           = nullptr;
+
+/**
+ * Max. time in ms a web request shall wait for the heatpump. If it is expected
+ * to take longer, it is rejected with 503 Service Unavailable.
+ */
+static const uint32_t           WEB_BUS_MAX_WAIT            = (10UL * 1000UL);
+
+/** Assumed duration in ms of a single heatpump transaction, as long as none was measured. */
+static const uint32_t           DEFAULT_BUS_DURATION        = 100UL;
+
+/** Destination address of the telemetry datagrams. Default is the local broadcast. */
+static const IPAddress          TELEMETRY_HOST_ADDR(255, 255, 255, 255);
+
+/** Destination and local UDP port of the telemetry datagrams. */
+static const uint16_t           TELEMETRY_PORT              = 50600U;
+
+/** UDP socket, used to push the telemetry. */
+static EthernetUDP              gTelemetryUdp;
+
+/** Sequence number of the next telemetry datagram. */
+static uint16_t                 gTelemetrySeq               = 0U;
+
+/** IP-address of the MQTT broker. MQTT is disabled with 0.0.0.0. */
+static const byte               MQTT_BROKER_ADDR[]          = { 0, 0, 0, 0 };
+
+/** Port of the MQTT broker. */
+static const uint16_t           MQTT_BROKER_PORT            = 1883U;
+
+/** MQTT client id */
+static const char               MQTT_CLIENT_ID[]            = "rego6xx";
+
+/** MQTT topic of the online/offline status. */
+static const char               MQTT_STATUS_TOPIC[]         = "rego6xx/status";
+
+/** MQTT topic filter of the commands. */
+static const char               MQTT_CMD_TOPICS[]           = "rego6xx/cmd/#";
+
+/** Max. MQTT topic size in bytes, including the string termination. */
+static const size_t             MQTT_TOPIC_SIZE             = 32U;
+
+/** MQTT client, which publishes the state and receives commands. */
+static MqttClient               gMqttClient;
+
+/** Was the MQTT client connected in the last cycle? Used to detect a new connection. */
+static bool                     gIsMqttConnected            = false;
+
+/** Index of the next state item, which to publish after a new MQTT connection. */
+static uint8_t                  gMqttStateIdx               = 0U;
+
+/** Sequence number of the next event, which to publish via MQTT. */
+static uint16_t                 gMqttEventSeq               = 0U;
+
+/** Signals a front panel action, requested via MQTT. */
+static bool                     gMqttFrontPanelReq          = false;
+
+/** Front panel address of the requested front panel action. */
+static Rego6xxCtrl::FrontPanelAddr gMqttFrontPanelAddr      = Rego6xxCtrl::FRONTPANEL_ADDR_LEFT_BUTTON;
+
+/** Value of the requested front panel action. */
+static uint16_t                 gMqttFrontPanelValue        = 0U;
+
+/** Pending Rego6xx response of the requested front panel action. */
+static const Rego6xxConfirmRsp* gMqttBusRsp                 = nullptr;
+
 /** Duration after the first time all sensors are read. */
 static const uint32_t           SENSOR_READ_INITIAL         = (2UL * 1000UL);
 
 /** Period in ms for reading all sensors from heatpump. */
 static const uint32_t           SENSOR_READ_PERIOD          = (5UL * 60UL * 1000UL);
 
+/** Duration after the first time all front panel LEDs are read. */
+static const uint32_t           LED_READ_INITIAL            = (4UL * 1000UL);
+
+/** Period in ms for reading all front panel LEDs from heatpump. */
+static const uint32_t           LED_READ_PERIOD             = (10UL * 1000UL);
+
 /** Pause between every request to the heatpump controller in ms. */
 static const uint32_t           REGO6xx_REQ_PAUSE           = (1UL * 1000UL);
 
 /** Timer used to read cyclic all sensors values from heatpump. */
 static SimpleTimer              gSensorReadCycleTimer;
 
+/** Timer used to read cyclic all front panel LEDs from heatpump. */
+static SimpleTimer              gLedReadCycleTimer;
+
 /**
  * Timer used to pause between each heatpump request. This shall avoid problems with
  * the Rego6xx controller.
@@ -193,6 +449,51 @@ static SimpleTimer              gRego6xxReqPauseTimer;
 /** Rego6xx heatpump controller simulator. */
 static Rego6xxSim               gRego6xxSim;
 
+#endif  /* defined(DEBUG) */
+
+#if defined(SERIAL_CAPTURE)
+
+#if defined(NATIVE)
+
+/** Max. number of captured bytes on the serial line to the heatpump. */
+static const uint16_t           MAX_CAPTURE_ENTRIES         = 4096U;
+
+#else
+
+/** Max. number of captured bytes on the serial line to the heatpump. */
+static const uint16_t           MAX_CAPTURE_ENTRIES         = 64U;
+
+#endif  /* defined(NATIVE) */
+
+/** Captured bytes on the serial line to the heatpump. */
+static SerialCapture::Entry     gCaptureEntries[MAX_CAPTURE_ENTRIES];
+
+#if defined(DEBUG)
+
+/** Capture of the serial line to the heatpump controller simulator. */
+static SerialCapture            gSerialCapture(gRego6xxSim, gCaptureEntries, MAX_CAPTURE_ENTRIES);
+
+#else
+
+/** Capture of the serial line to the heatpump. */
+static SerialCapture            gSerialCapture(Serial, gCaptureEntries, MAX_CAPTURE_ENTRIES);
+
+#endif  /* defined(DEBUG) */
+
+/** Rego6xx heatpump controller */
+static Rego6xxCtrl              gRego6xxCtrl(gSerialCapture);
+
+/** Number of captured entries, which are exported as single item. */
+static const uint16_t           CAPTURE_ENTRIES_PER_ITEM    = 16U;
+
+/** Sequence number of the first captured entry, which is exported. */
+static uint16_t                 gCaptureExportSeq           = 0U;
+
+/** Number of captured entries, which are exported. */
+static uint16_t                 gCaptureExportCnt           = 0U;
+
+#elif defined(DEBUG)
+
 /** Rego6xx heatpump controller */
 static Rego6xxCtrl              gRego6xxCtrl(gRego6xxSim);
 
@@ -201,7 +502,34 @@ static Rego6xxCtrl              gRego6xxCtrl(gRego6xxSim);
 /** Rego6xx heatpump controller */
 static Rego6xxCtrl              gRego6xxCtrl(Serial);
 
-#endif  /* defined(DEBUG) */
+#endif  /* defined(SERIAL_CAPTURE) */
+
+/** Front panel macro, which navigates through the heatpump menu. */
+static FrontPanelMacro          gFrontPanelMacro(gRego6xxCtrl);
+
+/** Cache of the system registers, which were read via web. */
+static SysRegCache              gSysRegCache;
+
+/** Max. number of system registers, which can be read at once. */
+static const uint8_t            MAX_SYSREG_SCAN             = 16U;
+
+/** Web connection, which owns the system register scan. */
+static WebConnection*           gSysRegScanConn             = nullptr;
+
+/** Address of the first system register of the scan. */
+static uint16_t                 gSysRegScanAddr             = 0U;
+
+/** Number of system registers of the scan. */
+static uint8_t                  gSysRegScanCnt              = 0U;
+
+/** Index of the next system register of the scan. */
+static uint8_t                  gSysRegScanIdx              = 0U;
+
+/** Values of the scanned system registers. */
+static uint16_t                 gSysRegScanValues[MAX_SYSREG_SCAN];
+
+/** Bitfield of the successfully scanned system registers, bit 0 is the first one. */
+static uint16_t                 gSysRegScanValid            = 0U;
 
 /** Array of all heatpump temperatures, read in the last interval. */
 static Temperature              gTemperatures[TEMPERATURE_ID_MAX];
@@ -209,11 +537,37 @@ static Temperature              gTemperatures[TEMPERATURE_ID_MAX];
 /** Current requested temperature value. */
 static TemperatureId            gReqTemp                    = TEMPERATURE_ID_MAX;
 
-/** Contains the temperature, which shall be written. */
-static Temperature              gTemperatureToWrite;
+/**
+ * Max. number of temperature writes, which can be requested at once.
+ * They shall fit into the max. request body size.
+ */
+static const uint8_t            MAX_TEMPERATURE_WRITES      = 8U;
+
+/** Size of the JSON document, which contains the max. number of temperature writes. */
+static const size_t             TEMPERATURE_WRITES_DOC_SIZE = JSON_ARRAY_SIZE(MAX_TEMPERATURE_WRITES) + (MAX_TEMPERATURE_WRITES * JSON_OBJECT_SIZE(2U)) + 64U;
 
-/** Signals to set a new temperature value. */
-static bool                     gWriteTemperature           = false;
+/**
+ * JSON document size of a front panel macro request: the object itself,
+ * the root and every step with 3 members, the copied expected texts and
+ * a reserve for the keys and the action names.
+ */
+static const size_t             MACRO_DOC_SIZE              = (2U * JSON_OBJECT_SIZE(3U)) +
+                                                              JSON_ARRAY_SIZE(FrontPanelMacro::MAX_STEPS) +
+                                                              (FrontPanelMacro::MAX_STEPS * JSON_OBJECT_SIZE(3U)) +
+                                                              ((FrontPanelMacro::MAX_STEPS + 1U) * (FrontPanelMacro::MAX_TEXT_LEN + 1U)) +
+                                                              96U;
+
+/** Requested temperature writes, which are written in order. */
+static TemperatureWrite         gTemperatureWrites[MAX_TEMPERATURE_WRITES];
+
+/** Number of requested temperature writes. */
+static uint8_t                  gTemperatureWriteCnt        = 0U;
+
+/** Index of the next temperature write. */
+static uint8_t                  gTemperatureWriteIdx        = 0U;
+
+/** Web connection, which waits for the status of the temperature writes. */
+static WebConnection*           gTemperatureWriteConn       = nullptr;
 
 /** Pending Rego6xx response, used to read temperatures. */
 static const Rego6xxStdRsp*     gRegoRsp                    = nullptr;
@@ -221,6 +575,64 @@ static const Rego6xxStdRsp*     gRegoRsp                    = nullptr;
 /** Pending Rego6xx response, used to write temperature value. */
 static const Rego6xxConfirmRsp* gRegoWriteTemperatureRsp    = nullptr;
 
+/** Front panel LEDs, read in the last interval. */
+static FrontPanelLeds           gFrontPanelLeds;
+
+/** Current requested front panel LED. */
+static FrontPanelLeds::LedId    gReqLed                     = FrontPanelLeds::LED_ID_MAX;
+
+/** Pending Rego6xx response, used to read front panel LEDs. */
+static const Rego6xxBoolRsp*    gRegoLedRsp                 = nullptr;
+
+/** Events of sensor and state changes, which are streamed to the event clients. */
+static EventRing                gEventRing;
+
+/**
+ * Max. number of clients, which are subscribed to the event stream.
+ * Every client keeps a ethernet socket open permanently.
+ */
+static const uint8_t            MAX_EVENT_CLIENTS           = 1U;
+
+/** Clients, which are subscribed to the event stream. */
+static EventClient              gEventClients[MAX_EVENT_CLIENTS];
+
+/** Period in ms of the heartbeat, which keeps idle event streams alive. */
+static const uint32_t           EVENT_HEARTBEAT_PERIOD      = (15UL * 1000UL);
+
+/** Timer used to send the heartbeat to the event clients. */
+static SimpleTimer              gEventHeartbeatTimer;
+
+/**
+ * Data generation, which is incremented whenever a cached sensor, LED or
+ * display value changes. It is used as entity tag of the data.
+ */
+static uint16_t                 gDataGen                    = 0U;
+
+/** Size of the data entity tag buffer, e.g. W/"1a2b". */
+static const size_t             DATA_ETAG_SIZE              = 10U;
+
+/** Hash of every display row content, read at last. Used to detect changes. */
+static uint16_t                 gDisplayRowHashes[4U];
+
+/** Max. duration of a main loop cycle in us, since the metrics were sent completely at last. */
+static uint32_t                 gLoopDurationMax            = 0U;
+
+/** Max. duration of a main loop cycle in us, taken when the metrics were requested. */
+static uint32_t                 gMetricsLoopDurationMax     = 0U;
+
+/** Profiler of the main loop phases, since the loop profile was sent completely at last. */
+static LoopProfiler             gLoopProfiler;
+
+#if defined(__AVR__)
+
+/** Begin of the heap, provided by the linker. */
+extern char                     __heap_start;
+
+/** End of the heap, provided by the memory allocator. It is nullptr as long as nothing was allocated. */
+extern char*                    __brkval;
+
+#endif  /* defined(__AVR__) */
+
 /******************************************************************************
  * External functions
  *****************************************************************************/
@@ -235,6 +647,14 @@ void setup()
     /* Setup serial interface */
     Serial.begin(SERIAL_BAUDRATE);
 
+#if defined(DEBUG)
+    gRego6xxSim.setBaudrate(REGO6XX_SIM_BAUDRATE);
+    gRego6xxSim.setProcessingDelay(REGO6XX_SIM_PROC_DELAY);
+    gRego6xxCtrl.setBaudrate(REGO6XX_SIM_BAUDRATE);
+#else
+    gRego6xxCtrl.setBaudrate(SERIAL_BAUDRATE);
+#endif  /* defined(DEBUG) */
+
     LOG_INFO(F("Device starts up."));
 
     if (0 == Ethernet.begin(DEVICE_MAC_ADDR))
@@ -259,6 +679,12 @@ void setup()
     {
         LOG_INFO(F("Ethernet controller initialized."));
 
+        /* The data generation shall differ after every start, otherwise a
+         * client may take cached data of the last run as current.
+         * The duration of the ethernet initialization varies enough.
+         */
+        gDataGen = static_cast<uint16_t>(micros());
+
         gTemperatures[TEMPERATURE_ID_GT1].setName("gt1");
         gTemperatures[TEMPERATURE_ID_GT2].setName("gt2");
         gTemperatures[TEMPERATURE_ID_GT3].setName("gt3");
@@ -275,49 +701,104 @@ void setup()
         gTemperatures[TEMPERATURE_ID_GT3_OFF].setName("gt3Off");
 
         gSensorReadCycleTimer.start(SENSOR_READ_INITIAL);
+        gLedReadCycleTimer.start(LED_READ_INITIAL);
+
+        if ((false == gFrontPanelLeds.subscribe(logLedChanges)) ||
+            (false == gFrontPanelLeds.subscribe(pushLedEvents)))
+        {
+            LOG_ERROR(F("Failed to subscribe for LED changes."));
+        }
+
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_GET, "/", handleRoot))
+        {
+            LOG_ERROR(F("Failed to add route."));
+        }
+
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_GET, "/api/sensors/?", handleSensorGetReq))
+        {
+            LOG_ERROR(F("Failed to add route."));
+        }
+
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_POST, "/api/sensors", handleSensorPostReq))
+        {
+            LOG_ERROR(F("Failed to add route."));
+        }
+
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_POST, "/api/debug", handleDebugPostReq))
+        {
+            LOG_ERROR(F("Failed to add route."));
+        }
+
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_GET, "/api/display/?", handleDisplayGetReq))
+        {
+            LOG_ERROR(F("Failed to add route."));
+        }
 
-        if (false == gWebReqRouter.addRoute(ArduinoHttpServer::Method::Get, "/", handleRoot))
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_GET, "/api/lastError", handleLastErrorGetReq))
         {
             LOG_ERROR(F("Failed to add route."));
         }
 
-        if (false == gWebReqRouter.addRoute(ArduinoHttpServer::Method::Get, "/api/sensors/?", handleSensorGetReq))
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_GET, "/api/frontPanel/?", handleFrontPanelGetReq))
         {
             LOG_ERROR(F("Failed to add route."));
         }
 
-        if (false == gWebReqRouter.addRoute(ArduinoHttpServer::Method::Post, "/api/sensors", handleSensorPostReq))
+        /* Must be added before the front panel route with the dynamic part. */
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_POST, "/api/frontPanel/macro", handleFrontPanelMacroPostReq))
         {
             LOG_ERROR(F("Failed to add route."));
         }
 
-        if (false == gWebReqRouter.addRoute(ArduinoHttpServer::Method::Post, "/api/debug", handleDebugPostReq))
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_POST, "/api/frontPanel/?", handleFrontPanelPostReq))
         {
             LOG_ERROR(F("Failed to add route."));
         }
 
-        if (false == gWebReqRouter.addRoute(ArduinoHttpServer::Method::Get, "/api/display/?", handleDisplayGetReq))
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_GET, "/api/events", handleEventsGetReq))
         {
             LOG_ERROR(F("Failed to add route."));
         }
 
-        if (false == gWebReqRouter.addRoute(ArduinoHttpServer::Method::Get, "/api/lastError", handleLastErrorGetReq))
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_GET, "/metrics", handleMetricsGetReq))
         {
             LOG_ERROR(F("Failed to add route."));
         }
 
-        if (false == gWebReqRouter.addRoute(ArduinoHttpServer::Method::Get, "/api/frontPanel/?", handleFrontPanelGetReq))
+#if defined(SERIAL_CAPTURE)
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_GET, "/api/capture", handleCaptureGetReq))
         {
             LOG_ERROR(F("Failed to add route."));
         }
+#endif  /* defined(SERIAL_CAPTURE) */
 
-        if (false == gWebReqRouter.addRoute(ArduinoHttpServer::Method::Post, "/api/frontPanel/?", handleFrontPanelPostReq))
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_GET, "/api/loop", handleLoopGetReq))
+        {
+            LOG_ERROR(F("Failed to add route."));
+        }
+
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_GET, "/api/sysreg/?", handleSysRegGetReq))
+        {
+            LOG_ERROR(F("Failed to add route."));
+        }
+
+        if (false == gWebReqRouter.addRoute(HttpRequest::METHOD_POST, "/api/sysreg/?", handleSysRegPostReq))
         {
             LOG_ERROR(F("Failed to add route."));
         }
 
         /* Start listening for clients. */
         gWebServer.begin();
+
+        if (0 == gTelemetryUdp.begin(TELEMETRY_PORT))
+        {
+            LOG_ERROR(F("Failed to open telemetry socket."));
+        }
+
+        if (0U != MQTT_BROKER_ADDR[0])
+        {
+            gMqttClient.begin(IPAddress(MQTT_BROKER_ADDR), MQTT_BROKER_PORT, MQTT_CLIENT_ID, MQTT_STATUS_TOPIC, MQTT_CMD_TOPICS, onMqttMessage);
+        }
     }
 
     if (true == isError)
@@ -337,38 +818,39 @@ void setup()
  */
 void loop()
 {
+    uint32_t loopBegin      = micros();
+    uint32_t loopDuration   = 0U;
+
+    gLoopProfiler.beginIteration();
+
     handleNetwork();
 
     /* Shall a temperature value be written?
      * Precondition is that no other Rego6xx command is pending.
-     * Note, this may pause an ongoing temperature read cycle for a moment.
+     * Note, this may pause an ongoing temperature or LED read cycle for a moment.
      */
-    if ((true == gWriteTemperature) &&
-        (nullptr == gRegoRsp))
+    if ((gTemperatureWriteCnt > gTemperatureWriteIdx) &&
+        (nullptr == gRegoRsp) &&
+        (nullptr == gRegoLedRsp))
     {
+        TemperatureWrite& temperatureWrite = gTemperatureWrites[gTemperatureWriteIdx];
+
+        gLoopProfiler.enterPhase(LOOP_PHASE_TEMPERATURE_WRITE);
+
         /* Nothing already pending? */
         if (nullptr == gRegoWriteTemperatureRsp)
         {
-            /* No pause necessary? */
-            if ((false == gRego6xxReqPauseTimer.isTimerRunning()) ||
-                (true == gRego6xxReqPauseTimer.isTimeout()))
+            /* No pause necessary and controller not busy with a web request? */
+            if (((false == gRego6xxReqPauseTimer.isTimerRunning()) ||
+                 (true == gRego6xxReqPauseTimer.isTimeout())) &&
+                (false == gRego6xxCtrl.isPending()))
             {
-                if (0 != gTemperatureToWrite.getName().equals("gt3Target"))
-                {
-                    gRegoWriteTemperatureRsp = gRego6xxCtrl.writeSysReg(Rego6xxCtrl::SYSREG_ADDR_GT3_TARGET, gTemperatureToWrite.getRawTemperature());
-                }
-                else if (0 != gTemperatureToWrite.getName().equals("gt3On"))
-                {
-                    gRegoWriteTemperatureRsp = gRego6xxCtrl.writeSysReg(Rego6xxCtrl::SYSREG_ADDR_GT3_ON, gTemperatureToWrite.getRawTemperature());
-                }
-                else if (0 != gTemperatureToWrite.getName().equals("gt3Off"))
-                {
-                    gRegoWriteTemperatureRsp = gRego6xxCtrl.writeSysReg(Rego6xxCtrl::SYSREG_ADDR_GT3_OFF, gTemperatureToWrite.getRawTemperature());
-                }
-                else
-                /* Should never happen. */
+                gRegoWriteTemperatureRsp = gRego6xxCtrl.writeSysReg(getTemperatureSysRegAddr(temperatureWrite.id), temperatureWrite.rawValue);
+
+                /* The cached value is outdated, as soon as the write is sent. */
+                if (nullptr != gRegoWriteTemperatureRsp)
                 {
-                    gWriteTemperature = false;
+                    gSysRegCache.remove(getTemperatureSysRegAddr(temperatureWrite.id));
                 }
             }
         }
@@ -376,9 +858,19 @@ void loop()
         else if ((true == gRegoWriteTemperatureRsp->isUsed()) &&
                  (false == gRegoWriteTemperatureRsp->isPending()))
         {
+            temperatureWrite.statusId = STATUS_ID_OK;
+
+            if ((false == gRegoWriteTemperatureRsp->isValid()) ||
+                (Rego6xxCtrl::DEV_ADDR_HOST != gRegoWriteTemperatureRsp->getDevAddr()))
+            {
+                temperatureWrite.statusId = STATUS_ID_EINVALID;
+            }
+
+            gEventRing.push(EventRing::TYPE_WRITE, temperatureWrite.id, temperatureWrite.statusId);
+
             gRego6xxCtrl.release();
 
-            gWriteTemperature           = false;
+            ++gTemperatureWriteIdx;
             gRegoWriteTemperatureRsp    = nullptr;
 
             /* Pause sending requests, after response. */
@@ -391,22 +883,83 @@ void loop()
             ;
         }
     }
+    /* Read front panel LEDs?
+     * Precondition is that no temperature read is pending.
+     * Note, this may pause an ongoing temperature read cycle for a moment.
+     */
+    else if ((nullptr == gRegoRsp) &&
+             (true == gLedReadCycleTimer.isTimerRunning()) &&
+             (true == gLedReadCycleTimer.isTimeout()))
+    {
+        gLoopProfiler.enterPhase(LOOP_PHASE_LED_READ);
+
+        /* Nothing already pending? */
+        if (nullptr == gRegoLedRsp)
+        {
+            /* No pause necessary and controller not busy with a web request? */
+            if (((false == gRego6xxReqPauseTimer.isTimerRunning()) ||
+                 (true == gRego6xxReqPauseTimer.isTimeout())) &&
+                (false == gRego6xxCtrl.isPending()))
+            {
+                gRegoLedRsp = readNextLed(gReqLed, gReqLed);
+
+                /* If all LEDs are read, publish the changes and continue in the next interval. */
+                if (nullptr == gRegoLedRsp)
+                {
+                    gFrontPanelLeds.publish();
+                    gLedReadCycleTimer.start(LED_READ_PERIOD);
+                }
+            }
+        }
+        /* Response received? */
+        else if ((true == gRegoLedRsp->isUsed()) &&
+                 (false == gRegoLedRsp->isPending()))
+        {
+            /* The LED state is taken over only if the response is valid and there was no timeout. */
+            if ((true == gRegoLedRsp->isValid()) &&
+                (Rego6xxCtrl::DEV_ADDR_HOST == gRegoLedRsp->getDevAddr()))
+            {
+                gFrontPanelLeds.setLed(gReqLed, gRegoLedRsp->getValue());
+            }
+            else
+            {
+                /* LED skipped */
+                ;
+            }
+
+            gRego6xxCtrl.release();
+            gRegoLedRsp = nullptr;
+
+            /* Pause sending requests, after response. */
+            gRego6xxReqPauseTimer.start(REGO6xx_REQ_PAUSE);
+        }
+        else
+        /* Wait for pending response. */
+        {
+            /* Nothing to do */
+            ;
+        }
+    }
     /* Read temperature sensors? */
     else if ((true == gSensorReadCycleTimer.isTimerRunning()) &&
              (true == gSensorReadCycleTimer.isTimeout()))
     {
+        gLoopProfiler.enterPhase(LOOP_PHASE_SENSOR_READ);
+
         /* Nothing already pending? */
         if (nullptr == gRegoRsp)
         {
-            /* No pause necessary? */
-            if ((false == gRego6xxReqPauseTimer.isTimerRunning()) ||
-                (true == gRego6xxReqPauseTimer.isTimeout()))
+            /* No pause necessary and controller not busy with a web request? */
+            if (((false == gRego6xxReqPauseTimer.isTimerRunning()) ||
+                 (true == gRego6xxReqPauseTimer.isTimeout())) &&
+                (false == gRego6xxCtrl.isPending()))
             {
                 gRegoRsp = readNextTemperatures(gReqTemp, gReqTemp);
 
-                /* If all temperatures are read, continoue in the next interval. */
+                /* If all temperatures are read, push them and continoue in the next interval. */
                 if (nullptr == gRegoRsp)
                 {
+                    sendTelemetry();
                     gSensorReadCycleTimer.start(SENSOR_READ_PERIOD);
                 }
             }
@@ -419,6 +972,12 @@ void loop()
             if ((true == gRegoRsp->isValid()) &&
                 (Rego6xxCtrl::DEV_ADDR_HOST == gRegoRsp->getDevAddr()))
             {
+                if (gTemperatures[gReqTemp].getRawTemperature() != gRegoRsp->getValue())
+                {
+                    gEventRing.push(EventRing::TYPE_SENSOR, gReqTemp, static_cast<int16_t>(gRegoRsp->getValue()));
+                    setDataChanged();
+                }
+
                 gTemperatures[gReqTemp].setRawTemperature(gRegoRsp->getValue());
             }
             else
@@ -442,11 +1001,38 @@ void loop()
     }
 
     /* Process the heatpump Rego6xx controller */
+    gLoopProfiler.enterPhase(LOOP_PHASE_REGO6XX);
     gRego6xxCtrl.process();
 
+    gLoopProfiler.endIteration();
+
+    loopDuration = micros() - loopBegin;
+
+    if (gLoopDurationMax < loopDuration)
+    {
+        gLoopDurationMax = loopDuration;
+    }
+
+    return;
+}
+
+#if defined(NATIVE)
+
+/**
+ * Replace the simulated heatpump, e.g. by the replay of a captured trace.
+ * It shall be called before setup().
+ *
+ * @param[in] stream    Stream to the heatpump
+ */
+void setRego6xxStream(Stream& stream)
+{
+    gSerialCapture.setStream(stream);
+
     return;
 }
 
+#endif  /* defined(NATIVE) */
+
 /******************************************************************************
  * Local functions
  *****************************************************************************/
@@ -507,8 +1093,11 @@ static void printNetworkSettings(void)
  */
 static void handleNetwork(void)
 {
-    EthernetLinkStatus  linkStatus = Ethernet.linkStatus();
+    EthernetLinkStatus  linkStatus;
 
+    gLoopProfiler.enterPhase(LOOP_PHASE_NETWORK);
+
+    linkStatus = Ethernet.linkStatus();
     Ethernet.maintain();
 
     /* Link status unknown? */
@@ -517,6 +1106,8 @@ static void handleNetwork(void)
         if (LINK_STATUS_UNKNOWN != gLinkStatus)
         {
             LOG_INFO(F("Link is unknown."));
+
+            stopEventClients();
         }
 
         gLinkStatus = LINK_STATUS_UNKNOWN;
@@ -527,6 +1118,8 @@ static void handleNetwork(void)
         if (LINK_STATUS_DOWN != gLinkStatus)
         {
             LOG_INFO(F("Link is down."));
+
+            stopEventClients();
         }
 
         gLinkStatus = LINK_STATUS_DOWN;
@@ -534,7 +1127,7 @@ static void handleNetwork(void)
     else
     /* Link is up */
     {
-        EthernetClient client = gWebServer.available();
+        EthernetClient client = gWebServer.accept();
 
         if (LINK_STATUS_UP != gLinkStatus)
         {
@@ -547,56 +1140,382 @@ static void handleNetwork(void)
 
         if (true == client)
         {
-            HttpRequest httpRequest(client);
+            uint8_t idx = 0U;
 
-            /* Parse the request */
-            if (true == httpRequest.readRequest())
+            while((MAX_WEB_CONNECTIONS > idx) && (true == gWebConnections[idx].isUsed()))
             {
-                if (false == gWebReqRouter.handle(client, httpRequest))
-                {
-                    /* Send a 404 back, which means "Not Found" */
-                    ArduinoHttpServer::StreamHttpErrorReply httpReply(client, httpRequest.getContentType(), "404");
+                ++idx;
+            }
 
-                    LOG_ERROR(F("Requested page not found."));
-                    LOG_ERROR(httpRequest.getResource().toString().c_str());
+            /* No free connection? Take over one, which is kept open but idle. */
+            if (MAX_WEB_CONNECTIONS <= idx)
+            {
+                idx = 0U;
 
-                    httpReply.send("Not Found");
+                while((MAX_WEB_CONNECTIONS > idx) && (false == gWebConnections[idx].isIdle()))
+                {
+                    ++idx;
                 }
-            }
-            else
-            {
-                /* HTTP parsing failed. Client did not provide correct HTTP data or
-                 * client requested an unsupported feature.
-                 *
-                 * Send a 400 back, which means "Bad Request".
-                 */
-                ArduinoHttpServer::StreamHttpErrorReply httpReply(client, httpRequest.getContentType(), "400");
 
-                LOG_ERROR(F("HTTP parsing failed."));
-                LOG_ERROR(httpRequest.getError().cStr());
+                if (MAX_WEB_CONNECTIONS > idx)
+                {
+                    gWebConnections[idx].close();
+                }
+            }
+
+            if (MAX_WEB_CONNECTIONS > idx)
+            {
+                gWebConnections[idx].open(client);
+            }
+            else
+            {
+                LOG_ERROR(F("No web connection available."));
 
-                httpReply.send("Bad Request");
+                client.print(F("HTTP/1.1 503 Service Unavailable\r\n"
+                               "Content-Length: 0\r\n"
+                               "Connection: close\r\n"
+                               "\r\n"));
+                client.stop();
             }
         }
+
+        gLoopProfiler.enterPhase(LOOP_PHASE_EVENTS);
+        handleEventClients();
+
+        gLoopProfiler.enterPhase(LOOP_PHASE_MQTT);
+        handleMqtt();
+    }
+
+    /* The web connections are served independent of the link status,
+     * because a deferred request must be finished in any case.
+     * The same applies to a front panel action, requested via MQTT.
+     */
+    gLoopProfiler.enterPhase(LOOP_PHASE_WEB);
+    handleWebConnections();
+
+    gLoopProfiler.enterPhase(LOOP_PHASE_MQTT);
+    handleMqttFrontPanelReq();
+}
+
+/**
+ * Serve all web connections. Every connection does only a bounded amount of
+ * work per call, so a slow client doesn't stall the others.
+ * The request URI is reported to the loop profiler as possible stall cause,
+ * because the request handler or its continuation runs within.
+ */
+static void handleWebConnections(void)
+{
+    uint8_t idx = 0U;
+
+    /* A macro is finished, even if the client is gone in the meantime. */
+    gFrontPanelMacro.process();
+
+    if ((nullptr != gWebBusAbortedRsp) &&
+        (false == gWebBusAbortedRsp->isPending()))
+    {
+        gRego6xxCtrl.release();
+        gWebBusAbortedRsp = nullptr;
+    }
+
+    while(MAX_WEB_CONNECTIONS > idx)
+    {
+        uint32_t        begin   = micros();
+        const String&   uri     = gWebConnections[idx].getRequest().getUri();
+
+        gWebConnections[idx].process(dispatchWebReq);
+
+        if (0U < uri.length())
+        {
+            gLoopProfiler.setCause(uri.c_str(), micros() - begin);
+        }
+
+        if (true == gWebConnections[idx].isAborted())
+        {
+            releaseAbortedWebReq(gWebConnections[idx]);
+        }
+
+        ++idx;
+    }
+
+    return;
+}
+
+/**
+ * Dispatch a complete web request to its route.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void dispatchWebReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    if (false == gWebReqRouter.handle(conn, httpRequest))
+    {
+        LOG_ERROR(F("Requested page not found."));
+        LOG_ERROR(httpRequest.getUri().c_str());
+
+        /* Send a 404 back, which means "Not Found" */
+        conn.sendError(404U);
+    }
+
+    return;
+}
+
+/**
+ * Release the Rego6xx response of the web request, so that the controller
+ * can be used by the next one.
+ */
+static void releaseWebBus(void)
+{
+    gRego6xxCtrl.release();
+
+    gWebBusRsp  = nullptr;
+    gWebBusConn = nullptr;
+
+    return;
+}
+
+/**
+ * Release the resources of a deferred web request, which was aborted because
+ * its client is gone. A pending heatpump response is awaited, before the
+ * controller is released.
+ *
+ * @param[in] conn  Web connection of the aborted request.
+ */
+static void releaseAbortedWebReq(WebConnection& conn)
+{
+    if (&conn == gSysRegScanConn)
+    {
+        gSysRegScanConn = nullptr;
+    }
+
+    /* The temperature writes are finished, but nobody waits for their status. */
+    if (&conn == gTemperatureWriteConn)
+    {
+        gTemperatureWriteConn = nullptr;
+    }
+
+    if (&conn == gWebBusConn)
+    {
+        LOG_INFO(F("Web request aborted, while waiting for the heatpump."));
+
+        gWebBusAbortedRsp   = gWebBusRsp;
+        gWebBusRsp          = nullptr;
+        gWebBusConn         = nullptr;
+    }
+
+    return;
+}
+
+/**
+ * Admit a web request, which needs the heatpump. If it can't be finished in
+ * time, because of the requests which are waiting already, it is rejected with
+ * 503 Service Unavailable and a Retry-After, derived from the current wait time.
+ *
+ * @param[in] conn      Web connection, used to send the rejection.
+ * @param[in] duration  Expected duration in ms of the request itself.
+ *
+ * @return If admitted, it will return true otherwise false.
+ */
+static bool admitBusReq(WebConnection& conn, uint32_t duration)
+{
+    bool        isAdmitted  = true;
+    uint32_t    waitTime    = getBusWaitTime();
+
+    if (WEB_BUS_MAX_WAIT < (waitTime + duration))
+    {
+        conn.sendServiceUnavailable(getRetryAfter(waitTime));
+        isAdmitted = false;
+    }
+
+    return isAdmitted;
+}
+
+/**
+ * Drop a deferred web request with 503 Service Unavailable, if its deadline
+ * is exceeded before its heatpump request was started. A started heatpump
+ * request is finished, its response is observed by the controller.
+ *
+ * @param[in] conn  Web connection of the deferred request.
+ *
+ * @return If dropped, it will return true otherwise false.
+ */
+static bool dropExpiredBusReq(WebConnection& conn)
+{
+    bool isDropped = false;
+
+    if ((&conn != gWebBusConn) &&
+        (true == conn.isDeadlineExceeded()))
+    {
+        conn.sendServiceUnavailable(getRetryAfter(getBusWaitTime()));
+        isDropped = true;
+    }
+
+    return isDropped;
+}
+
+/**
+ * Estimate the time until the heatpump is free for a new web request.
+ * It considers all deferred web requests, the remaining registers of a
+ * scan and the pending temperature writes, which are paused after every
+ * single one.
+ *
+ * @return Wait time in ms
+ */
+static uint32_t getBusWaitTime(void)
+{
+    uint32_t duration       = getBusDuration();
+    uint32_t transactions   = getQueueDepth();
+    uint32_t waitTime       = 0U;
+
+    /* The scan is already counted once as deferred request. */
+    if ((nullptr != gSysRegScanConn) &&
+        (gSysRegScanCnt > gSysRegScanIdx))
+    {
+        transactions += gSysRegScanCnt - gSysRegScanIdx - 1U;
+    }
+
+    /* The periodic reading or a MQTT request may use the heatpump right now. */
+    if (true == gRego6xxCtrl.isPending())
+    {
+        ++transactions;
+    }
+
+    waitTime = transactions * duration;
+    waitTime += (gTemperatureWriteCnt - gTemperatureWriteIdx) * (duration + REGO6xx_REQ_PAUSE);
+
+    return waitTime;
+}
+
+/**
+ * Get the expected duration of a single heatpump transaction.
+ *
+ * @return Duration in ms
+ */
+static uint32_t getBusDuration(void)
+{
+    uint32_t duration = gRego6xxCtrl.getStatistics().avgDuration;
+
+    if (0U == duration)
+    {
+        duration = DEFAULT_BUS_DURATION;
+    }
+
+    return duration;
+}
+
+/**
+ * Get the Retry-After time for a rejected web request.
+ *
+ * @param[in] waitTime  Wait time in ms
+ *
+ * @return Retry-After time in s, at least 1 s.
+ */
+static uint16_t getRetryAfter(uint32_t waitTime)
+{
+    uint32_t retryAfter = (waitTime + 999UL) / 1000UL;
+
+    if (0U == retryAfter)
+    {
+        retryAfter = 1U;
+    }
+    else if (UINT16_MAX < retryAfter)
+    {
+        retryAfter = UINT16_MAX;
+    }
+    else
+    {
+        /* Nothing to do. */
+        ;
+    }
+
+    return static_cast<uint16_t>(retryAfter);
+}
+
+/**
+ * Signal that a cached sensor, LED or display value changed.
+ */
+static void setDataChanged(void)
+{
+    ++gDataGen;
+
+    return;
+}
+
+/**
+ * Get the entity tag of the current data generation.
+ * It is a weak one, because some replies contain e.g. the uptime.
+ *
+ * @param[out] eTag Entity tag buffer
+ * @param[in]  size Entity tag buffer size in bytes
+ */
+static void getDataETag(char* eTag, size_t size)
+{
+    (void)snprintf(eTag, size, "W/\"%04x\"", static_cast<unsigned int>(gDataGen));
+
+    return;
+}
+
+/**
+ * Has the client the current data already?
+ *
+ * @param[in] httpRequest   The http request
+ * @param[in] eTag          Entity tag of the current data generation
+ *
+ * @return If the client has the current data, it will return true otherwise false.
+ */
+static bool isDataCached(const HttpRequest& httpRequest, const char* eTag)
+{
+    const String&   ifNoneMatch = httpRequest.getIfNoneMatch();
+    bool            isCached    = false;
+
+    /* The weak comparison is used, which ignores the "W/" prefix. */
+    if ((0 != ifNoneMatch.equals("*")) ||
+        (0 <= ifNoneMatch.indexOf(&eTag[2U])))
+    {
+        isCached = true;
     }
+
+    return isCached;
+}
+
+/**
+ * Calculate a simple hash of the string, used to detect changes.
+ *
+ * @param[in] str   String
+ *
+ * @return Hash
+ */
+static uint16_t getHash(const String& str)
+{
+    uint16_t        hash    = 0U;
+    unsigned int    idx     = 0U;
+
+    while(str.length() > idx)
+    {
+        hash = (hash * 31U) + static_cast<uint8_t>(str[idx]);
+        ++idx;
+    }
+
+    return hash;
 }
 
 /**
  * Handle GET root access.
  *
- * @param[in] client        Ethernet client, used to send the response.
+ * @param[in] conn          Web connection, used to send the response.
  * @param[in] httpRequest   The http request itself.
  */
-static void handleRoot(EthernetClient& client, const HttpRequest& httpRequest)
+static void handleRoot(WebConnection& conn, const HttpRequest& httpRequest)
 {
-    ArduinoHttpServer::StreamHttpReply  httpReply(client, "text/html");
     String                              data;
 
+    (void)httpRequest;
+
     data += reinterpret_cast<const __FlashStringHelper*>(HTML_PAGE_HEAD);
     data += F("<h1>Rego6xx Server</h1>\r\n");
     data += reinterpret_cast<const __FlashStringHelper*>(HTML_PAGE_TAIL);
 
-    httpReply.send(data);
+    conn.sendReply(200U, F("text/html"), data);
 
     return;
 }
@@ -604,20 +1523,36 @@ static void handleRoot(EthernetClient& client, const HttpRequest& httpRequest)
 /**
  * Handle GET sensor access.
  *
- * @param[in] client        Ethernet client, used to send the response.
+ * @param[in] conn          Web connection, used to send the response.
  * @param[in] httpRequest   The http request itself.
  */
-static void handleSensorGetReq(EthernetClient& client, const HttpRequest& httpRequest)
+static void handleSensorGetReq(WebConnection& conn, const HttpRequest& httpRequest)
 {
-    ArduinoHttpServer::StreamHttpReply  httpReply(client, "application/json");
     String                              data;
-    String                              sensorName      = httpRequest.getResource()[2]; /* /api/sensors/<name> */
+    String                              sensorName      = httpRequest.getUriPart(2U); /* /api/sensors/<name> */
     DynamicJsonDocument                 jsonDoc(256);
     JsonObject                          jsonData        = jsonDoc.createNestedObject("data");
+    char                                eTag[DATA_ETAG_SIZE];
+
+    getDataETag(eTag, sizeof(eTag));
 
-    if (0 == sensorName.length())
+    /* All sensors in MessagePack format?
+     * Its entity tag would be the same as for JSON, therefore it has none.
+     */
+    if ((0 == sensorName.length()) &&
+        (true == httpRequest.isMsgPackAccepted()))
     {
-        jsonDoc["status"] = STATUS_ID_EPAR;
+        conn.sendStream(200U, F("application/msgpack"), writeSensorsMsgPack);
+    }
+    /* Client has the current data already? */
+    else if (true == isDataCached(httpRequest, eTag))
+    {
+        conn.sendNotModified(eTag);
+    }
+    /* All sensors? They are streamed, because of their size. */
+    else if (0 == sensorName.length())
+    {
+        conn.sendStream(200U, F("application/json"), writeSensorsJson, eTag);
     }
     else
     {
@@ -647,11 +1582,135 @@ static void handleSensorGetReq(EthernetClient& client, const HttpRequest& httpRe
 
             jsonDoc["status"] = STATUS_ID_OK;
         }
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data, eTag);
     }
 
-    (void)serializeJson(jsonDoc, data);
+    return;
+}
+
+/**
+ * Write a single item of all sensors in JSON format.
+ * Every sensor is a item, enclosed by the begin and the end of the document.
+ *
+ * @param[in] out   Output
+ * @param[in] idx   Item index
+ *
+ * @return If the item was written, it will return true. If there is no item anymore, it will return false.
+ */
+static bool writeSensorsJson(Print& out, uint16_t idx)
+{
+    bool isWritten = true;
+
+    if (TEMPERATURE_ID_MAX > idx)
+    {
+        StaticJsonDocument<JSON_OBJECT_SIZE(2)> jsonDoc;
+
+        (void)out.print((0U == idx) ? F("{\"data\":[") : F(","));
+
+        /* The name is not copied, it stays valid until the item is written. */
+        jsonDoc["name"]     = gTemperatures[idx].getName().c_str();
+        jsonDoc["value"]    = gTemperatures[idx].getTemperature();
+
+        (void)serializeJson(jsonDoc, out);
+    }
+    else if (TEMPERATURE_ID_MAX == idx)
+    {
+        (void)out.print(F("],\"status\":"));
+        (void)out.print(STATUS_ID_OK);
+        (void)out.print('}');
+    }
+    else
+    {
+        isWritten = false;
+    }
+
+    return isWritten;
+}
+
+/**
+ * Write a single item of all sensors in MessagePack format.
+ * The document is a map with the status and a map of sensor name to
+ * raw value in 0.1 °C, which needs no floating point conversion.
+ *
+ * @param[in] out   Output
+ * @param[in] idx   Item index
+ *
+ * @return If the item was written, it will return true. If there is no item anymore, it will return false.
+ */
+static bool writeSensorsMsgPack(Print& out, uint16_t idx)
+{
+    bool            isWritten   = true;
+    MsgPackWriter   writer(out);
+
+    if (TEMPERATURE_ID_MAX > idx)
+    {
+        if (0U == idx)
+        {
+            writer.writeMap(2U);
+            writer.writeString(F("status"));
+            writer.writeUInt(STATUS_ID_OK);
+            writer.writeString(F("data"));
+            writer.writeMap(TEMPERATURE_ID_MAX);
+        }
+
+        writer.writeString(gTemperatures[idx].getName());
+        writer.writeInt(static_cast<int16_t>(gTemperatures[idx].getRawTemperature()));
+    }
+    else
+    {
+        isWritten = false;
+    }
+
+    return isWritten;
+}
+
+/**
+ * Send all sensor values as single telemetry datagram in MessagePack format.
+ * It contains a sequence number, which lets the receiver detect lost
+ * datagrams, the uptime in ms and the raw values in 0.1 °C in the order of
+ * the temperature ids.
+ */
+static void sendTelemetry(void)
+{
+    if (LINK_STATUS_UP != gLinkStatus)
+    {
+        /* Nothing to do. */
+        ;
+    }
+    else if (0 == gTelemetryUdp.beginPacket(TELEMETRY_HOST_ADDR, TELEMETRY_PORT))
+    {
+        LOG_ERROR(F("Failed to start telemetry datagram."));
+    }
+    else
+    {
+        MsgPackWriter   writer(gTelemetryUdp);
+        uint8_t         idx     = 0U;
+
+        writer.writeMap(3U);
+        writer.writeString(F("seq"));
+        writer.writeUInt(gTelemetrySeq);
+        writer.writeString(F("ts"));
+        writer.writeUInt(millis());
+        writer.writeString(F("values"));
+        writer.writeArray(TEMPERATURE_ID_MAX);
+
+        while(TEMPERATURE_ID_MAX > idx)
+        {
+            writer.writeInt(static_cast<int16_t>(gTemperatures[idx].getRawTemperature()));
+            ++idx;
+        }
+
+        if (0 == gTelemetryUdp.endPacket())
+        {
+            LOG_ERROR(F("Failed to send telemetry datagram."));
+        }
+    }
 
-    httpReply.send(data);
+    /* Increased even if not sent, which shows the receiver the gap. */
+    ++gTelemetrySeq;
 
     return;
 }
@@ -659,460 +1718,2809 @@ static void handleSensorGetReq(EthernetClient& client, const HttpRequest& httpRe
 /**
  * Handle POST sensor access.
  *
- * @param[in] client        Ethernet client, used to send the response.
+ * @param[in] conn          Web connection, used to send the response.
  * @param[in] httpRequest   The http request itself.
  */
-static void handleSensorPostReq(EthernetClient& client, const HttpRequest& httpRequest)
+static void handleSensorPostReq(WebConnection& conn, const HttpRequest& httpRequest)
 {
-    ArduinoHttpServer::StreamHttpReply  httpReply(client, "application/json");
     String                              data;
     const char*                         body            = httpRequest.getBody();
-    DynamicJsonDocument                 jsonDoc(256);
+    DynamicJsonDocument                 jsonDoc(TEMPERATURE_WRITES_DOC_SIZE);
     DynamicJsonDocument                 jsonDocRsp(128);
+    bool                                isReplied       = false;
 
     /* If any temperature write is pending, a new can not be set. */
-    if ((nullptr != gRegoWriteTemperatureRsp) &&
-        (true == gRegoWriteTemperatureRsp->isUsed()))
+    if (true == isTemperatureWriteBusy())
     {
-        jsonDocRsp["status"] = STATUS_ID_EPENDING;
+        conn.sendServiceUnavailable(getRetryAfter(getBusWaitTime()));
+        isReplied = true;
     }
     /* Deserialization of JSON data failed? */
     else if (DeserializationError::Ok != deserializeJson(jsonDoc, body))
     {
         jsonDocRsp["status"] = STATUS_ID_EINPUT;
     }
-    else
+    /* Several temperatures at once? The reply is sent after all are written. */
+    else if (true == jsonDoc.is<JsonArray>())
     {
-        JsonObject  jsonObj = jsonDoc.as<JsonObject>();
+        uint32_t duration = jsonDoc.size() * (getBusDuration() + REGO6xx_REQ_PAUSE);
 
-        if ((true == jsonObj["name"].isNull()) ||
-            (true == jsonObj["value"].isNull()))
+        if (false == admitBusReq(conn, duration))
         {
-            jsonDocRsp["status"] = STATUS_ID_EPAR;
+            isReplied = true;
         }
         else
         {
-            String  name    = jsonObj["name"];
-            float   value   = jsonObj["value"].as<float>();
+            uint8_t     invalidIdx  = 0U;
+            StatusId    statusId    = requestTemperatureWrites(jsonDoc.as<JsonArray>(), invalidIdx);
 
-            if ((0 != name.equals("gt3Target")) ||
-                (0 != name.equals("gt3On")) ||
-                (0 != name.equals("gt3Off")))
+            if (STATUS_ID_OK == statusId)
             {
-                gTemperatureToWrite.setName(name);
-                gTemperatureToWrite.setTemperature(value);
-                gWriteTemperature = true;
-
-                jsonDocRsp["status"] = STATUS_ID_OK;
+                gTemperatureWriteConn = &conn;
+                conn.defer(continueSensorPostReq);
+                isReplied = true;
             }
             else
             {
-                jsonDocRsp["status"] = STATUS_ID_EPAR;
+                JsonObject jsonData = jsonDocRsp.createNestedObject("data");
+
+                jsonData["index"]       = invalidIdx;
+                jsonDocRsp["status"]    = statusId;
             }
         }
     }
+    else
+    {
+        JsonObject  jsonObj = jsonDoc.as<JsonObject>();
 
-    (void)serializeJson(jsonDocRsp, data);
-
-    httpReply.send(data);
-
-    return;
-}
-
-/**
+        if ((true == jsonObj["name"].isNull()) ||
+            (true == jsonObj["value"].isNull()))
+        {
+            jsonDocRsp["status"] = STATUS_ID_EPAR;
+        }
+        else
+        {
+            String  name    = jsonObj["name"];
+            float   value   = jsonObj["value"].as<float>();
+
+            jsonDocRsp["status"] = requestTemperatureWrite(name, value);
+        }
+    }
+
+    if (false == isReplied)
+    {
+        (void)serializeJson(jsonDocRsp, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+
+    return;
+}
+
+/**
+ * Continue POST sensor access with several temperatures.
+ * The reply is sent after all temperatures are written.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void continueSensorPostReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    (void)httpRequest;
+
+    /* All written? */
+    if (gTemperatureWriteCnt <= gTemperatureWriteIdx)
+    {
+        String              data;
+        DynamicJsonDocument jsonDoc(TEMPERATURE_WRITES_DOC_SIZE);
+        JsonArray           jsonData    = jsonDoc.createNestedArray("data");
+        StatusId            statusId    = STATUS_ID_OK;
+        uint8_t             idx         = 0U;
+
+        while(gTemperatureWriteCnt > idx)
+        {
+            const TemperatureWrite& temperatureWrite    = gTemperatureWrites[idx];
+            JsonObject              jsonWrite           = jsonData.createNestedObject();
+
+            jsonWrite["name"]   = gTemperatures[temperatureWrite.id].getName().c_str();
+            jsonWrite["status"] = temperatureWrite.statusId;
+
+            if (STATUS_ID_OK != temperatureWrite.statusId)
+            {
+                statusId = STATUS_ID_EINVALID;
+            }
+
+            ++idx;
+        }
+
+        jsonDoc["status"] = statusId;
+
+        gTemperatureWriteConn = nullptr;
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+
+    return;
+}
+
+/**
+ * Request to write a temperature value to the heatpump. It is written by
+ * the main loop, as soon as the controller is free.
+ *
+ * @param[in] name  Temperature name, only gt3Target, gt3On and gt3Off are writeable.
+ * @param[in] value Temperature value in °C
+ *
+ * @return Status
+ */
+static StatusId requestTemperatureWrite(const String& name, float value)
+{
+    StatusId        statusId    = STATUS_ID_OK;
+    TemperatureId   id          = TEMPERATURE_ID_MAX;
+
+    /* If any temperature write is pending, a new can not be set. */
+    if (true == isTemperatureWriteBusy())
+    {
+        statusId = STATUS_ID_EPENDING;
+    }
+    else if (false == getWriteableTemperature(name, id))
+    {
+        statusId = STATUS_ID_EPAR;
+    }
+    else
+    {
+        Temperature temperature;
+
+        temperature.setTemperature(value);
+
+        gTemperatureWrites[0U].id       = id;
+        gTemperatureWrites[0U].rawValue = temperature.getRawTemperature();
+        gTemperatureWrites[0U].statusId = STATUS_ID_OK;
+
+        gTemperatureWriteCnt    = 1U;
+        gTemperatureWriteIdx    = 0U;
+    }
+
+    return statusId;
+}
+
+/**
+ * Request to write several temperature values to the heatpump. All of them
+ * are validated first, only if all are valid they are written in order.
+ * A web request, which waits for the result, shall be deferred afterwards
+ * and registered as gTemperatureWriteConn.
+ *
+ * @param[in]   writes      Array of temperature writes, each with name and value in °C.
+ * @param[out]  invalidIdx  Index of the first invalid write, only set in case of a error.
+ *
+ * @return Status
+ */
+static StatusId requestTemperatureWrites(JsonArray writes, uint8_t& invalidIdx)
+{
+    StatusId    statusId    = STATUS_ID_OK;
+    size_t      cnt         = writes.size();
+    uint8_t     idx         = 0U;
+
+    /* If any temperature write is pending, a new can not be set. */
+    if (true == isTemperatureWriteBusy())
+    {
+        statusId = STATUS_ID_EPENDING;
+    }
+    else if ((0U == cnt) ||
+             (MAX_TEMPERATURE_WRITES < cnt))
+    {
+        statusId = STATUS_ID_EPAR;
+    }
+    else
+    {
+        /* The writes are only counted after all are valid, therefore nothing is written before. */
+        while((STATUS_ID_OK == statusId) && (cnt > idx))
+        {
+            JsonObject      jsonObj = writes[idx].as<JsonObject>();
+            TemperatureId   id      = TEMPERATURE_ID_MAX;
+
+            if ((true == jsonObj["name"].isNull()) ||
+                (true == jsonObj["value"].isNull()) ||
+                (false == getWriteableTemperature(jsonObj["name"].as<String>(), id)))
+            {
+                invalidIdx  = idx;
+                statusId    = STATUS_ID_EPAR;
+            }
+            else
+            {
+                Temperature temperature;
+
+                temperature.setTemperature(jsonObj["value"].as<float>());
+
+                gTemperatureWrites[idx].id          = id;
+                gTemperatureWrites[idx].rawValue    = temperature.getRawTemperature();
+                gTemperatureWrites[idx].statusId    = STATUS_ID_OK;
+
+                ++idx;
+            }
+        }
+
+        if (STATUS_ID_OK == statusId)
+        {
+            gTemperatureWriteCnt    = idx;
+            gTemperatureWriteIdx    = 0U;
+        }
+    }
+
+    return statusId;
+}
+
+/**
+ * Is any temperature write pending or waits a web request for its result?
+ *
+ * @return If busy, it will return true otherwise false.
+ */
+static bool isTemperatureWriteBusy(void)
+{
+    return ((gTemperatureWriteCnt > gTemperatureWriteIdx) || (nullptr != gTemperatureWriteConn));
+}
+
+/**
+ * Get the id of a writeable temperature by its name.
+ *
+ * @param[in]   name    Temperature name
+ * @param[out]  id      Temperature id
+ *
+ * @return If the temperature is writeable, it will return true otherwise false.
+ */
+static bool getWriteableTemperature(const String& name, TemperatureId& id)
+{
+    bool isWriteable = true;
+
+    if (0 != name.equals("gt3Target"))
+    {
+        id = TEMPERATURE_ID_GT3_TARGET;
+    }
+    else if (0 != name.equals("gt3On"))
+    {
+        id = TEMPERATURE_ID_GT3_ON;
+    }
+    else if (0 != name.equals("gt3Off"))
+    {
+        id = TEMPERATURE_ID_GT3_OFF;
+    }
+    else
+    {
+        isWriteable = false;
+    }
+
+    return isWriteable;
+}
+
+/**
+ * Get the system register address of a writeable temperature.
+ *
+ * @param[in] id    Temperature id
+ *
+ * @return System register address
+ */
+static Rego6xxCtrl::SysRegAddr getTemperatureSysRegAddr(TemperatureId id)
+{
+    Rego6xxCtrl::SysRegAddr sysRegAddr = Rego6xxCtrl::SYSREG_ADDR_GT3_TARGET;
+
+    switch(id)
+    {
+    case TEMPERATURE_ID_GT3_ON:
+        sysRegAddr = Rego6xxCtrl::SYSREG_ADDR_GT3_ON;
+        break;
+
+    case TEMPERATURE_ID_GT3_OFF:
+        sysRegAddr = Rego6xxCtrl::SYSREG_ADDR_GT3_OFF;
+        break;
+
+    case TEMPERATURE_ID_GT3_TARGET:
+    default:
+        break;
+    }
+
+    return sysRegAddr;
+}
+
+/**
  * Handle POST debug access.
+ * The request is deferred until the heatpump responded.
  *
- * @param[in] client        Ethernet client, used to send the response.
+ * @param[in] conn          Web connection, used to send the response.
  * @param[in] httpRequest   The http request itself.
  */
-static void handleDebugPostReq(EthernetClient& client, const HttpRequest& httpRequest)
+static void handleDebugPostReq(WebConnection& conn, const HttpRequest& httpRequest)
 {
-    ArduinoHttpServer::StreamHttpReply  httpReply(client, "application/json");
-    String                              data;
-    const char*                         body            = httpRequest.getBody();
-    DynamicJsonDocument                 jsonDoc(256);
-    DynamicJsonDocument                 jsonDocRsp(128);
-    JsonObject                          jsonData        = jsonDocRsp.createNestedObject("data");
+    uint8_t     cmdId   = 0U;
+    uint16_t    addr    = 0U;
+    uint16_t    value   = 0U;
+
+    if (false == getDebugCmd(httpRequest, cmdId, addr, value))
+    {
+        String              data;
+        DynamicJsonDocument jsonDoc(64);
+
+        jsonDoc["status"] = STATUS_ID_EINPUT;
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+    else if (true == admitBusReq(conn, getBusDuration()))
+    {
+        conn.defer(continueDebugPostReq, WEB_BUS_MAX_WAIT);
+    }
+    else
+    {
+        /* Rejected. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Continue POST debug access.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void continueDebugPostReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    /* Deadline exceeded, while waiting for the controller? */
+    if (true == dropExpiredBusReq(conn))
+    {
+        /* Nothing to do. */
+        ;
+    }
+    /* Heatpump request not started yet?
+     * The body is only parsed again, if the controller is free.
+     */
+    else if (nullptr == gWebBusConn)
+    {
+        uint8_t     cmdId   = 0U;
+        uint16_t    addr    = 0U;
+        uint16_t    value   = 0U;
+
+        if ((false == gRego6xxCtrl.isPending()) &&
+            (true == getDebugCmd(httpRequest, cmdId, addr, value)))
+        {
+            gWebBusRsp = gRego6xxCtrl.writeRaw(cmdId, addr, value);
+
+            if (nullptr != gWebBusRsp)
+            {
+                gWebBusConn = &conn;
+
+                /* A raw system register write outdates the cached value too. */
+                if (Rego6xxCtrl::CMD_ID_WRITE_SYSTEM_REG == cmdId)
+                {
+                    gSysRegCache.remove(addr);
+                }
+            }
+        }
+    }
+    /* Response received?
+     * Note, the there is already a timeout observation done by the raw response.
+     */
+    else if ((&conn == gWebBusConn) &&
+             (false == gWebBusRsp->isPending()))
+    {
+        const Rego6xxRawRsp*    rawRsp      = static_cast<const Rego6xxRawRsp*>(gWebBusRsp);
+        String                  data;
+        DynamicJsonDocument     jsonDoc(JSON_OBJECT_SIZE(2U) + JSON_OBJECT_SIZE(1U) + (2U * Rego6xxRawRsp::RSP_SIZE) + 1U);
+
+        /* The heatpump didn't respond at all? */
+        if (false == rawRsp->isValid())
+        {
+            jsonDoc["status"] = STATUS_ID_EINVALID;
+        }
+        else
+        {
+            JsonObject  jsonData    = jsonDoc.createNestedObject("data");
+            String      rsp;
+            size_t      idx         = 0U;
+
+            rsp.reserve(2U * rawRsp->getSize());
+
+            while(rawRsp->getSize() > idx)
+            {
+                char buffer[3];
+
+                sprintf(buffer, "%02X", rawRsp->getData()[idx]);
+                rsp += buffer;
+
+                ++idx;
+            }
+
+            jsonData["response"]    = rsp;
+            jsonDoc["status"]       = STATUS_ID_OK;
+        }
+
+        releaseWebBus();
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+    else
+    /* Wait for response or until the controller is free. */
+    {
+        /* Nothing to do. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Get the raw command of a debug request from the request body.
+ *
+ * @param[in]   httpRequest The http request itself.
+ * @param[out]  cmdId       Command id
+ * @param[out]  addr        Address
+ * @param[out]  value       Value
+ *
+ * @return If the body is valid, it will return true otherwise false.
+ */
+static bool getDebugCmd(const HttpRequest& httpRequest, uint8_t& cmdId, uint16_t& addr, uint16_t& value)
+{
+    bool                isValid = false;
+    DynamicJsonDocument jsonDoc(128);
+
+    if (DeserializationError::Ok == deserializeJson(jsonDoc, httpRequest.getBody()))
+    {
+        JsonObject jsonObj = jsonDoc.as<JsonObject>();
+
+        cmdId   = jsonObj["cmdId"].as<uint8_t>();
+        addr    = jsonObj["addr"].as<uint16_t>();
+        value   = jsonObj["value"].as<uint16_t>();
+        isValid = true;
+    }
+
+    return isValid;
+}
+
+/**
+ * Handle GET system register access.
+ * A single system register is served from the cache if possible, otherwise
+ * the request is deferred until the heatpump responded. Without address,
+ * the range given by the query parameters "from" and "to" is read.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleSysRegGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    String      addrStr = httpRequest.getUriPart(2U); /* /api/sysreg/<addr> */
+    uint16_t    addr    = 0U;
+    uint16_t    value   = 0U;
+
+    /* Read a range of system registers? */
+    if (0U == addrStr.length())
+    {
+        uint16_t fromAddr   = 0U;
+        uint16_t toAddr     = 0U;
+
+        if ((false == parseSysRegAddr(httpRequest.getQueryParam("from"), fromAddr)) ||
+            (false == parseSysRegAddr(httpRequest.getQueryParam("to"), toAddr)) ||
+            (fromAddr > toAddr) ||
+            (MAX_SYSREG_SCAN <= (toAddr - fromAddr)))
+        {
+            sendSysRegStatus(conn, STATUS_ID_EPAR);
+        }
+        /* Only one scan at a time. */
+        else if (nullptr != gSysRegScanConn)
+        {
+            conn.sendServiceUnavailable(getRetryAfter(getBusWaitTime()));
+        }
+        else if (true == admitBusReq(conn, (toAddr - fromAddr + 1U) * getBusDuration()))
+        {
+            gSysRegScanConn     = &conn;
+            gSysRegScanAddr     = fromAddr;
+            gSysRegScanCnt      = static_cast<uint8_t>(toAddr - fromAddr + 1U);
+            gSysRegScanIdx      = 0U;
+            gSysRegScanValid    = 0U;
+
+            conn.defer(continueSysRegScanGetReq, WEB_BUS_MAX_WAIT);
+        }
+        else
+        {
+            /* Rejected. */
+            ;
+        }
+    }
+    else if (false == parseSysRegAddr(addrStr, addr))
+    {
+        sendSysRegStatus(conn, STATUS_ID_EPAR);
+    }
+    else if (true == gSysRegCache.get(addr, value))
+    {
+        String              data;
+        DynamicJsonDocument jsonDoc(128);
+        JsonObject          jsonData    = jsonDoc.createNestedObject("data");
+
+        jsonData["addr"]    = addr;
+        jsonData["value"]   = value;
+        jsonDoc["status"]   = STATUS_ID_OK;
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+    else if (true == admitBusReq(conn, getBusDuration()))
+    {
+        conn.defer(continueSysRegGetReq, WEB_BUS_MAX_WAIT);
+    }
+    else
+    {
+        /* Rejected. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Continue GET system register access.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void continueSysRegGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    uint16_t addr = 0U;
+
+    /* The address was already checked by the handler. */
+    (void)parseSysRegAddr(httpRequest.getUriPart(2U), addr); /* /api/sysreg/<addr> */
+
+    /* Deadline exceeded, while waiting for the controller? */
+    if (true == dropExpiredBusReq(conn))
+    {
+        /* Nothing to do. */
+        ;
+    }
+    /* Heatpump request not started yet? */
+    else if (nullptr == gWebBusConn)
+    {
+        /* If the controller is busy, it will be tried again in the next call. */
+        gWebBusRsp = gRego6xxCtrl.readSysReg(static_cast<Rego6xxCtrl::SysRegAddr>(addr));
+
+        if (nullptr != gWebBusRsp)
+        {
+            gWebBusConn = &conn;
+        }
+    }
+    /* Response received?
+     * Note, the there is already a timeout observation done by the controller.
+     */
+    else if ((&conn == gWebBusConn) &&
+             (false == gWebBusRsp->isPending()))
+    {
+        const Rego6xxStdRsp*    stdRsp      = static_cast<const Rego6xxStdRsp*>(gWebBusRsp);
+        String                  data;
+        DynamicJsonDocument     jsonDoc(128);
+
+        /* Check response, the data and the destination address of the
+         * response message must be valid.
+         * If a timeout happened, the data is valid but the destination
+         * address won't match.
+         */
+        if ((false == stdRsp->isValid()) ||
+            (Rego6xxCtrl::DEV_ADDR_HOST != stdRsp->getDevAddr()))
+        {
+            jsonDoc["status"] = STATUS_ID_EINVALID;
+        }
+        else
+        {
+            JsonObject jsonData = jsonDoc.createNestedObject("data");
+
+            gSysRegCache.put(addr, stdRsp->getValue());
+
+            jsonData["addr"]    = addr;
+            jsonData["value"]   = stdRsp->getValue();
+            jsonDoc["status"]   = STATUS_ID_OK;
+        }
+
+        releaseWebBus();
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+    else
+    /* Wait for response or until the controller is free. */
+    {
+        /* Nothing to do. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Continue GET system register range access.
+ * The system registers are read one by one. The controller is released
+ * after every single one, so other requests are not blocked by the scan.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void continueSysRegScanGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    uint16_t addr = gSysRegScanAddr + gSysRegScanIdx;
+
+    (void)httpRequest;
+
+    /* All read? */
+    if (gSysRegScanCnt <= gSysRegScanIdx)
+    {
+        String              data;
+        DynamicJsonDocument jsonDoc(JSON_OBJECT_SIZE(2U) + JSON_ARRAY_SIZE(MAX_SYSREG_SCAN) + (MAX_SYSREG_SCAN * JSON_OBJECT_SIZE(2U)));
+        JsonArray           jsonData    = jsonDoc.createNestedArray("data");
+        uint8_t             idx         = 0U;
+
+        while(gSysRegScanCnt > idx)
+        {
+            JsonObject jsonSysReg = jsonData.createNestedObject();
+
+            jsonSysReg["addr"] = gSysRegScanAddr + idx;
+
+            /* A failed read has no value. */
+            if (0U != (gSysRegScanValid & (1U << idx)))
+            {
+                jsonSysReg["value"] = gSysRegScanValues[idx];
+            }
+
+            ++idx;
+        }
+
+        jsonDoc["status"] = STATUS_ID_OK;
+
+        gSysRegScanConn = nullptr;
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+    /* Cached? */
+    else if ((&conn != gWebBusConn) &&
+             (true == gSysRegCache.get(addr, gSysRegScanValues[gSysRegScanIdx])))
+    {
+        gSysRegScanValid |= (1U << gSysRegScanIdx);
+        ++gSysRegScanIdx;
+    }
+    /* Deadline exceeded, while waiting for the controller? */
+    else if (true == dropExpiredBusReq(conn))
+    {
+        gSysRegScanConn = nullptr;
+    }
+    /* Heatpump request not started yet? */
+    else if (nullptr == gWebBusConn)
+    {
+        /* If the controller is busy, it will be tried again in the next call. */
+        gWebBusRsp = gRego6xxCtrl.readSysReg(static_cast<Rego6xxCtrl::SysRegAddr>(addr));
+
+        if (nullptr != gWebBusRsp)
+        {
+            gWebBusConn = &conn;
+        }
+    }
+    /* Response received? */
+    else if ((&conn == gWebBusConn) &&
+             (false == gWebBusRsp->isPending()))
+    {
+        const Rego6xxStdRsp* stdRsp = static_cast<const Rego6xxStdRsp*>(gWebBusRsp);
+
+        if ((true == stdRsp->isValid()) &&
+            (Rego6xxCtrl::DEV_ADDR_HOST == stdRsp->getDevAddr()))
+        {
+            gSysRegScanValues[gSysRegScanIdx] = stdRsp->getValue();
+            gSysRegScanValid |= (1U << gSysRegScanIdx);
+
+            gSysRegCache.put(addr, stdRsp->getValue());
+        }
+
+        releaseWebBus();
+
+        ++gSysRegScanIdx;
+
+        /* Every single register has its own deadline. */
+        conn.defer(continueSysRegScanGetReq, WEB_BUS_MAX_WAIT);
+    }
+    else
+    /* Wait for response or until the controller is free. */
+    {
+        /* Nothing to do. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Handle POST system register access.
+ * The request is deferred until the heatpump confirmed the write.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleSysRegPostReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    uint16_t addr   = 0U;
+    uint16_t value  = 0U;
+
+    if (false == parseSysRegAddr(httpRequest.getUriPart(2U), addr)) /* /api/sysreg/<addr> */
+    {
+        sendSysRegStatus(conn, STATUS_ID_EPAR);
+    }
+    else if (false == getSysRegWriteValue(httpRequest, value))
+    {
+        sendSysRegStatus(conn, STATUS_ID_EINPUT);
+    }
+    else if (true == admitBusReq(conn, getBusDuration()))
+    {
+        conn.defer(continueSysRegPostReq, WEB_BUS_MAX_WAIT);
+    }
+    else
+    {
+        /* Rejected. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Continue POST system register access.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void continueSysRegPostReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    uint16_t addr = 0U;
+
+    /* The address was already checked by the handler. */
+    (void)parseSysRegAddr(httpRequest.getUriPart(2U), addr); /* /api/sysreg/<addr> */
+
+    /* Deadline exceeded, while waiting for the controller? */
+    if (true == dropExpiredBusReq(conn))
+    {
+        /* Nothing to do. */
+        ;
+    }
+    /* Heatpump request not started yet?
+     * The body is only parsed again, if the controller is free.
+     */
+    else if (nullptr == gWebBusConn)
+    {
+        uint16_t value = 0U;
+
+        if ((false == gRego6xxCtrl.isPending()) &&
+            (true == getSysRegWriteValue(httpRequest, value)))
+        {
+            gWebBusRsp = gRego6xxCtrl.writeSysReg(static_cast<Rego6xxCtrl::SysRegAddr>(addr), value);
+
+            if (nullptr != gWebBusRsp)
+            {
+                gWebBusConn = &conn;
+
+                /* The cached value is outdated, as soon as the write is sent,
+                 * even if the request is aborted afterwards. The heatpump may
+                 * limit the value, therefore it is read again next time.
+                 */
+                gSysRegCache.remove(addr);
+            }
+        }
+    }
+    /* Response received? */
+    else if ((&conn == gWebBusConn) &&
+             (false == gWebBusRsp->isPending()))
+    {
+        StatusId statusId = STATUS_ID_OK;
+
+        if ((false == gWebBusRsp->isValid()) ||
+            (Rego6xxCtrl::DEV_ADDR_HOST != gWebBusRsp->getDevAddr()))
+        {
+            statusId = STATUS_ID_EINVALID;
+        }
+
+        releaseWebBus();
+
+        sendSysRegStatus(conn, statusId);
+    }
+    else
+    /* Wait for response or until the controller is free. */
+    {
+        /* Nothing to do. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Parse a system register address, either decimal or hexadecimal with
+ * the prefix "0x".
+ *
+ * @param[in]   str     Address as string
+ * @param[out]  addr    System register address
+ *
+ * @return If the address is valid, it will return true otherwise false.
+ */
+static bool parseSysRegAddr(const String& str, uint16_t& addr)
+{
+    bool isValid = false;
+
+    if (0U < str.length())
+    {
+        char*           end     = nullptr;
+        unsigned long   value   = strtoul(str.c_str(), &end, 0);
+
+        if (('\0' == *end) &&
+            (0xFFFFUL >= value))
+        {
+            addr    = static_cast<uint16_t>(value);
+            isValid = true;
+        }
+    }
+
+    return isValid;
+}
+
+/**
+ * Get the value of a system register write from the request body.
+ *
+ * @param[in]   httpRequest The http request itself.
+ * @param[out]  value       Value, which to write
+ *
+ * @return If the value is valid, it will return true otherwise false.
+ */
+static bool getSysRegWriteValue(const HttpRequest& httpRequest, uint16_t& value)
+{
+    bool                isValid = false;
+    DynamicJsonDocument jsonDoc(64);
+
+    if (DeserializationError::Ok == deserializeJson(jsonDoc, httpRequest.getBody()))
+    {
+        JsonVariant jsonValue = jsonDoc["value"];
+
+        if (true == jsonValue.is<uint16_t>())
+        {
+            value   = jsonValue.as<uint16_t>();
+            isValid = true;
+        }
+    }
+
+    return isValid;
+}
+
+/**
+ * Send a system register reply, which contains only the status.
+ *
+ * @param[in] conn      Web connection, used to send the response.
+ * @param[in] statusId  Status
+ */
+static void sendSysRegStatus(WebConnection& conn, StatusId statusId)
+{
+    String              data;
+    DynamicJsonDocument jsonDoc(64);
+
+    jsonDoc["status"] = statusId;
+
+    (void)serializeJson(jsonDoc, data);
+
+    conn.sendReply(200U, F("application/json"), data);
+
+    return;
+}
+
+/**
+ * Handle GET last error access.
+ * The request is deferred until the heatpump responded.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleLastErrorGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    (void)httpRequest;
+
+    if (true == admitBusReq(conn, getBusDuration()))
+    {
+        conn.defer(continueLastErrorGetReq, WEB_BUS_MAX_WAIT);
+    }
+
+    return;
+}
+
+/**
+ * Continue GET last error access.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void continueLastErrorGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    (void)httpRequest;
+
+    /* Deadline exceeded, while waiting for the controller? */
+    if (true == dropExpiredBusReq(conn))
+    {
+        /* Nothing to do. */
+        ;
+    }
+    /* Heatpump request not started yet? */
+    else if (nullptr == gWebBusConn)
+    {
+        /* If the controller is busy, it will be tried again in the next call. */
+        gWebBusRsp = gRego6xxCtrl.readLastError();
+
+        if (nullptr != gWebBusRsp)
+        {
+            gWebBusConn = &conn;
+        }
+    }
+    /* Response received?
+     * Note, the there is already a timeout observation done by the controller.
+     */
+    else if ((&conn == gWebBusConn) &&
+             (false == gWebBusRsp->isPending()))
+    {
+        const Rego6xxErrorRsp*  errorRsp    = static_cast<const Rego6xxErrorRsp*>(gWebBusRsp);
+        String                  data;
+        DynamicJsonDocument     jsonDoc(256);
+        JsonObject              jsonData    = jsonDoc.createNestedObject("data");
+
+        /* Check response, the data and the destination address of the
+         * response message must be valid.
+         * If a timeout happened, the data is valid but the destination
+         * address won't match.
+         */
+        if ((false == errorRsp->isValid()) ||
+            (Rego6xxCtrl::DEV_ADDR_HOST != errorRsp->getDevAddr()))
+        {
+            jsonDoc["status"] = STATUS_ID_EINVALID;
+        }
+        else
+        {
+            jsonData["errorId"]     = errorRsp->getErrorId();
+            jsonData["log"]         = errorRsp->getErrorLog();
+            jsonData["description"] = errorRsp->getErrorDescription();
+
+            jsonDoc["status"] = STATUS_ID_OK;
+        }
+
+        releaseWebBus();
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+    else
+    /* Wait for response or until the controller is free. */
+    {
+        /* Nothing to do. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Handle GET front panel access.
+ * The LED states are read periodically, therefore the response contains
+ * the LED state of the last interval.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleFrontPanelGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    String                              data;
+    String                              ledName         = httpRequest.getUriPart(2U); /* /api/fronPanel/<name> */
+    DynamicJsonDocument                 jsonDoc(512);
+    JsonObject                          jsonData        = jsonDoc.createNestedObject("data");
+    FrontPanelLeds::LedId               ledId           = FrontPanelLeds::LED_ID_POWER;
+    char                                eTag[DATA_ETAG_SIZE];
+    bool                                isCached        = false;
+
+    getDataETag(eTag, sizeof(eTag));
+    isCached = isDataCached(httpRequest, eTag);
+
+    /* Client has the current data already? */
+    if (true == isCached)
+    {
+        conn.sendNotModified(eTag);
+    }
+    /* All LEDs requested? */
+    else if (0 == ledName.length())
+    {
+        JsonArray   jsonLeds    = jsonData.createNestedArray("leds");
+        uint8_t     idx         = 0U;
+
+        jsonData["state"]   = gFrontPanelLeds.getState();
+        jsonData["uptime"]  = millis();
+
+        while(FrontPanelLeds::LED_ID_MAX > idx)
+        {
+            JsonObject jsonLed = jsonLeds.createNestedObject();
+
+            ledId = static_cast<FrontPanelLeds::LedId>(idx);
+
+            jsonLed["name"]         = FrontPanelLeds::getName(ledId);
+            jsonLed["state"]        = gFrontPanelLeds.isOn(ledId);
+            jsonLed["lastChange"]   = gFrontPanelLeds.getLastChange(ledId);
+
+            ++idx;
+        }
+
+        jsonDoc["status"] = STATUS_ID_OK;
+    }
+    else if (false == FrontPanelLeds::getId(ledName, ledId))
+    {
+        jsonDoc["status"] = STATUS_ID_EPAR;
+    }
+    else
+    {
+        jsonData["name"]        = ledName;
+        jsonData["state"]       = gFrontPanelLeds.isOn(ledId);
+        jsonData["lastChange"]  = gFrontPanelLeds.getLastChange(ledId);
+
+        jsonDoc["status"] = STATUS_ID_OK;
+    }
+
+    if (false == isCached)
+    {
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data, eTag);
+    }
+
+    return;
+}
+
+/**
+ * Handle POST front panel access.
+ * The request is deferred until the heatpump confirmed it.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleFrontPanelPostReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    String                      hmiName = httpRequest.getUriPart(2U); /* /api/fronPanel/<name> */
+    Rego6xxCtrl::FrontPanelAddr addr    = Rego6xxCtrl::FRONTPANEL_ADDR_LEFT_BUTTON;
+    uint16_t                    value   = 0U;
+
+    if (false == getHmiAction(hmiName, addr, value))
+    {
+        String              data;
+        DynamicJsonDocument jsonDoc(64);
+
+        jsonDoc["status"] = STATUS_ID_EPAR;
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+    else if (true == admitBusReq(conn, getBusDuration()))
+    {
+        conn.defer(continueFrontPanelPostReq, WEB_BUS_MAX_WAIT);
+    }
+    else
+    {
+        /* Rejected. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Continue POST front panel access.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void continueFrontPanelPostReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    String hmiName = httpRequest.getUriPart(2U); /* /api/fronPanel/<name> */
+
+    /* Deadline exceeded, while waiting for the controller? */
+    if (true == dropExpiredBusReq(conn))
+    {
+        /* Nothing to do. */
+        ;
+    }
+    /* Heatpump request not started yet? */
+    else if (nullptr == gWebBusConn)
+    {
+        Rego6xxCtrl::FrontPanelAddr addr    = Rego6xxCtrl::FRONTPANEL_ADDR_LEFT_BUTTON;
+        uint16_t                    value   = 0U;
+
+        /* The HMI device was already checked by the handler. */
+        (void)getHmiAction(hmiName, addr, value);
+
+        /* If the controller is busy, it will be tried again in the next call. */
+        gWebBusRsp = gRego6xxCtrl.writeFrontPanel(addr, value);
+
+        if (nullptr != gWebBusRsp)
+        {
+            gWebBusConn = &conn;
+        }
+    }
+    /* Response received?
+     * Note, the there is already a timeout observation done by the controller.
+     */
+    else if ((&conn == gWebBusConn) &&
+             (false == gWebBusRsp->isPending()))
+    {
+        String              data;
+        DynamicJsonDocument jsonDoc(256);
+        JsonObject          jsonData    = jsonDoc.createNestedObject("data");
+
+        /* Check response, the data and the destination address of the
+         * response message must be valid.
+         * If a timeout happened, the data is valid but the destination
+         * address won't match.
+         */
+        if ((false == gWebBusRsp->isValid()) ||
+            (Rego6xxCtrl::DEV_ADDR_HOST != gWebBusRsp->getDevAddr()))
+        {
+            jsonDoc["status"] = STATUS_ID_EINVALID;
+        }
+        else
+        {
+            jsonData["name"]    = hmiName;
+
+            jsonDoc["status"] = STATUS_ID_OK;
+        }
+
+        releaseWebBus();
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+    else
+    /* Wait for response or until the controller is free. */
+    {
+        /* Nothing to do. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Handle POST front panel macro access.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleFrontPanelMacroPostReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    String                              data;
+    const char*                         body            = httpRequest.getBody();
+    DynamicJsonDocument                 jsonDoc(MACRO_DOC_SIZE);
+    DynamicJsonDocument                 jsonDocRsp(64);
+    bool                                isReplied       = false;
+
+    /* Any macro running? */
+    if (true == gFrontPanelMacro.isRunning())
+    {
+        conn.sendServiceUnavailable(getRetryAfter(getBusWaitTime()));
+        isReplied = true;
+    }
+    /* The first step must read the display in time. */
+    else if (false == admitBusReq(conn, getBusDuration()))
+    {
+        isReplied = true;
+    }
+    /* Deserialization of JSON data failed? */
+    else if (DeserializationError::Ok != deserializeJson(jsonDoc, body))
+    {
+        jsonDocRsp["status"] = STATUS_ID_EINPUT;
+    }
+    else
+    {
+        JsonObject          jsonObj     = jsonDoc.as<JsonObject>();
+        JsonArray           jsonSteps   = jsonObj["steps"].as<JsonArray>();
+        uint32_t            stepTimeout = FrontPanelMacro::STEP_TIMEOUT;
+        bool                isValid     = true;
+        size_t              idx         = 0U;
+        Rego6xxCtrl::Row    row         = Rego6xxCtrl::DISPLAY_ROW_1;
+
+        (void)gFrontPanelMacro.clear();
+
+        if ((true == jsonSteps.isNull()) ||
+            (0U == jsonSteps.size()))
+        {
+            isValid = false;
+        }
+
+        /* The root menu is optional. Without it, the macro starts in the
+         * current menu and stays where it failed.
+         */
+        if ((true == isValid) &&
+            (false == jsonObj["root"].isNull()))
+        {
+            JsonObject jsonRoot = jsonObj["root"];
+
+            if ((false == getDisplayRow(jsonRoot["row"].as<uint8_t>(), row)) ||
+                (false == gFrontPanelMacro.setRoot(row, jsonRoot["expected"].as<const char*>())))
+            {
+                isValid = false;
+            }
+        }
+
+        if ((true == isValid) &&
+            (false == jsonObj["timeout"].isNull()))
+        {
+            stepTimeout = jsonObj["timeout"].as<uint32_t>();
+
+            if (FrontPanelMacro::MIN_STEP_TIMEOUT > stepTimeout)
+            {
+                stepTimeout = FrontPanelMacro::MIN_STEP_TIMEOUT;
+            }
+            else if (FrontPanelMacro::MAX_STEP_TIMEOUT < stepTimeout)
+            {
+                stepTimeout = FrontPanelMacro::MAX_STEP_TIMEOUT;
+            }
+            else
+            {
+                /* Nothing to do. */
+                ;
+            }
+        }
+
+        while((true == isValid) && (jsonSteps.size() > idx))
+        {
+            JsonObject                  jsonStep    = jsonSteps[idx];
+            String                      hmiName     = jsonStep["action"];
+            Rego6xxCtrl::FrontPanelAddr addr        = Rego6xxCtrl::FRONTPANEL_ADDR_LEFT_BUTTON;
+            uint16_t                    value       = 0U;
+
+            if ((false == getDisplayRow(jsonStep["row"].as<uint8_t>(), row)) ||
+                (false == getHmiAction(hmiName, addr, value)) ||
+                (false == gFrontPanelMacro.addStep(row, jsonStep["expected"].as<const char*>(), addr, value)))
+            {
+                isValid = false;
+            }
+            else
+            {
+                ++idx;
+            }
+        }
+
+        if (false == isValid)
+        {
+            jsonDocRsp["status"] = STATUS_ID_EPAR;
+        }
+        else if (false == gFrontPanelMacro.start(stepTimeout))
+        {
+            jsonDocRsp["status"] = STATUS_ID_EINTERNAL;
+        }
+        else
+        {
+            /* Every step may take its timeout, the rest covers the root menu and the actions. */
+            conn.defer(continueFrontPanelMacroPostReq, WEB_BUS_MAX_WAIT + (idx * stepTimeout));
+            isReplied = true;
+        }
+    }
+
+    if (false == isReplied)
+    {
+        (void)serializeJson(jsonDocRsp, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+
+    return;
+}
+
+/**
+ * Continue POST front panel macro access.
+ * Note, every step is observed by the step timeout and the number of tries
+ * to reach the root menu is limited. If the deadline is exceeded anyway, the
+ * macro is aborted and returns to the root menu in the background.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void continueFrontPanelMacroPostReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    bool isFinished = false;
+
+    (void)httpRequest;
+
+    /* Macro finished? */
+    if (false == gFrontPanelMacro.isRunning())
+    {
+        isFinished = true;
+    }
+    else if (true == conn.isDeadlineExceeded())
+    {
+        gFrontPanelMacro.abort();
+        isFinished = true;
+    }
+    else
+    {
+        /* Wait until the macro finished. */
+        ;
+    }
+
+    if (true == isFinished)
+    {
+        String              data;
+        DynamicJsonDocument jsonDoc(192);
+        JsonObject          jsonData    = jsonDoc.createNestedObject("data");
+
+        jsonData["step"]    = gFrontPanelMacro.getStepIdx() + 1U;
+        jsonData["display"] = gFrontPanelMacro.getLastMsg();
+
+        switch(gFrontPanelMacro.getResult())
+        {
+        case FrontPanelMacro::RESULT_OK:
+            jsonDoc["status"] = STATUS_ID_OK;
+            break;
+
+        case FrontPanelMacro::RESULT_EINVALID:
+            jsonDoc["status"] = STATUS_ID_EINVALID;
+            break;
+
+        default:
+            jsonDoc["status"] = STATUS_ID_EABORTED;
+            break;
+        }
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+
+    return;
+}
+
+/**
+ * Handle GET display access.
+ * The request is deferred until the heatpump responded.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleDisplayGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    String              rowStr  = httpRequest.getUriPart(2U); /* /api/display/<row> */
+    Rego6xxCtrl::Row    row     = Rego6xxCtrl::DISPLAY_ROW_1;
+
+    /* Only the row ids 1 - 4 are valid. */
+    if ((1U != rowStr.length()) ||
+        (false == getDisplayRow(rowStr.toInt(), row)))
+    {
+        String              data;
+        DynamicJsonDocument jsonDoc(64);
+
+        jsonDoc["status"] = STATUS_ID_EPAR;
+
+        (void)serializeJson(jsonDoc, data);
+
+        conn.sendReply(200U, F("application/json"), data);
+    }
+    else if (true == admitBusReq(conn, getBusDuration()))
+    {
+        conn.defer(continueDisplayGetReq, WEB_BUS_MAX_WAIT);
+    }
+    else
+    {
+        /* Rejected. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Continue GET display access.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void continueDisplayGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    String rowStr = httpRequest.getUriPart(2U); /* /api/display/<row> */
+
+    /* Deadline exceeded, while waiting for the controller? */
+    if (true == dropExpiredBusReq(conn))
+    {
+        /* Nothing to do. */
+        ;
+    }
+    /* Heatpump request not started yet? */
+    else if (nullptr == gWebBusConn)
+    {
+        Rego6xxCtrl::Row row = Rego6xxCtrl::DISPLAY_ROW_1;
+
+        /* The row was already checked by the handler. */
+        (void)getDisplayRow(rowStr.toInt(), row);
+
+        /* If the controller is busy, it will be tried again in the next call. */
+        gWebBusRsp = gRego6xxCtrl.readDisplay(row);
+
+        if (nullptr != gWebBusRsp)
+        {
+            gWebBusConn = &conn;
+        }
+    }
+    /* Response received?
+     * Note, the there is already a timeout observation done by the controller.
+     */
+    else if ((&conn == gWebBusConn) &&
+             (false == gWebBusRsp->isPending()))
+    {
+        const Rego6xxDisplayRsp*    displayRsp  = static_cast<const Rego6xxDisplayRsp*>(gWebBusRsp);
+        String                      data;
+        DynamicJsonDocument         jsonDoc(256);
+        JsonObject                  jsonData    = jsonDoc.createNestedObject("data");
+        char                        eTag[DATA_ETAG_SIZE];
+        bool                        isValid     = false;
+
+        /* Check response, the data and the destination address of the
+         * response message must be valid.
+         * If a timeout happened, the data is valid but the destination
+         * address won't match.
+         */
+        if ((false == displayRsp->isValid()) ||
+            (Rego6xxCtrl::DEV_ADDR_HOST != displayRsp->getDevAddr()))
+        {
+            jsonDoc["status"] = STATUS_ID_EINVALID;
+        }
+        else
+        {
+            String      msg     = displayRsp->getMsg();
+            uint16_t    hash    = getHash(msg);
+            long        rowId   = rowStr.toInt();
+
+            if (gDisplayRowHashes[rowId - 1] != hash)
+            {
+                gDisplayRowHashes[rowId - 1] = hash;
+                setDataChanged();
+            }
+
+            jsonData["row"]     = rowId;
+            jsonData["display"] = msg;
+
+            jsonDoc["status"] = STATUS_ID_OK;
+
+            isValid = true;
+        }
+
+        releaseWebBus();
+
+        /* The display is always read, because it is not cached. Only the
+         * reply is saved, if the client has the current data already.
+         */
+        getDataETag(eTag, sizeof(eTag));
+
+        if ((true == isValid) &&
+            (true == isDataCached(httpRequest, eTag)))
+        {
+            conn.sendNotModified(eTag);
+        }
+        else
+        {
+            (void)serializeJson(jsonDoc, data);
+
+            conn.sendReply(200U, F("application/json"), data, (true == isValid) ? eTag : nullptr);
+        }
+    }
+    else
+    /* Wait for response or until the controller is free. */
+    {
+        /* Nothing to do. */
+        ;
+    }
+
+    return;
+}
+
+/**
+ * Handle GET events access.
+ * The connection is kept open and the client is served in the event stream
+ * handling. If all event client slots are used, the request is rejected.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleEventsGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    uint8_t idx     = 0U;
+
+    (void)httpRequest;
+
+    while((MAX_EVENT_CLIENTS > idx) && (true == gEventClients[idx].isUsed))
+    {
+        ++idx;
+    }
+
+    if (MAX_EVENT_CLIENTS <= idx)
+    {
+        LOG_ERROR(F("No event client slot available."));
+
+        /* Send a 503 back, which means "Service Unavailable" */
+        conn.sendError(503U);
+    }
+    else
+    {
+        EthernetClient& client = conn.getClient();
+
+        /* The event client takes over the connection, therefore the header
+         * is written directly.
+         */
+        client.print(F("HTTP/1.1 200 OK\r\n"
+                       "Content-Type: text/event-stream\r\n"
+                       "Cache-Control: no-cache\r\n"
+                       "Connection: keep-alive\r\n"
+                       "\r\n"));
+
+        gEventClients[idx].client   = client;
+        gEventClients[idx].seq      = gEventRing.getNextSeq();
+        gEventClients[idx].isUsed   = true;
+
+        conn.detach();
+
+        if (false == gEventHeartbeatTimer.isTimerRunning())
+        {
+            gEventHeartbeatTimer.start(EVENT_HEARTBEAT_PERIOD);
+        }
+    }
+
+    return;
+}
+
+/**
+ * Serve all clients, which are subscribed to the event stream.
+ * Per call at most one event is sent to every client and only if it fits
+ * into the transmit buffer. A client which is too slow, misses the events
+ * which are overwritten in the meantime. A client which has no room left
+ * even for the heartbeat, is stalled and closed.
+ */
+static void handleEventClients(void)
+{
+    uint8_t idx         = 0U;
+    bool    isHeartbeat = false;
+
+    if ((true == gEventHeartbeatTimer.isTimerRunning()) &&
+        (true == gEventHeartbeatTimer.isTimeout()))
+    {
+        isHeartbeat = true;
+        gEventHeartbeatTimer.start(EVENT_HEARTBEAT_PERIOD);
+    }
+
+    while(MAX_EVENT_CLIENTS > idx)
+    {
+        EventClient& eventClient = gEventClients[idx];
+
+        if (false == eventClient.isUsed)
+        {
+            /* Nothing to do. */
+            ;
+        }
+        else if (0 == eventClient.client.connected())
+        {
+            eventClient.client.stop();
+            eventClient.isUsed = false;
+        }
+        else
+        {
+            uint16_t            seq     = eventClient.seq;
+            EventRing::Event    event;
+
+            /* The sequence number is only taken over, if the event was sent. */
+            if (true == gEventRing.read(seq, event))
+            {
+                if (true == sendEvent(eventClient.client, event))
+                {
+                    eventClient.seq = seq;
+                }
+            }
+            else if (true == isHeartbeat)
+            {
+                const size_t HEARTBEAT_LEN = 3U;
+
+                /* A comment line is ignored by the client, but keeps the connection alive. */
+                if (static_cast<int>(HEARTBEAT_LEN) <= eventClient.client.availableForWrite())
+                {
+                    (void)eventClient.client.print(F(":\n\n"));
+                }
+                else
+                {
+                    LOG_INFO(F("Event client stalled, closed."));
+
+                    eventClient.client.stop();
+                    eventClient.isUsed = false;
+                }
+            }
+            else
+            {
+                /* Nothing to do. */
+                ;
+            }
+        }
+
+        ++idx;
+    }
+
+    return;
+}
+
+/**
+ * Stop all event streams, e.g. after the link went down.
+ */
+static void stopEventClients(void)
+{
+    uint8_t idx = 0U;
+
+    while(MAX_EVENT_CLIENTS > idx)
+    {
+        if (true == gEventClients[idx].isUsed)
+        {
+            gEventClients[idx].client.stop();
+            gEventClients[idx].isUsed = false;
+        }
+
+        ++idx;
+    }
+
+    gEventHeartbeatTimer.stop();
+
+    return;
+}
+
+/**
+ * Send a single event to the client in the server-sent events format.
+ *
+ * @param[in] client    Ethernet client
+ * @param[in] event     Event
+ *
+ * @return If the event was sent, it will return true otherwise false.
+ */
+static bool sendEvent(EthernetClient& client, const EventRing::Event& event)
+{
+    bool                isSent  = false;
+    String              data;
+    DynamicJsonDocument jsonDoc(96);
+
+    switch(event.type)
+    {
+    case EventRing::TYPE_SENSOR:
+        data = F("event: sensor\ndata: ");
+        jsonDoc["name"]     = gTemperatures[event.id].getName();
+        jsonDoc["value"]    = static_cast<float>(event.value) / 10.0F;
+        break;
+
+    case EventRing::TYPE_LED:
+        data = F("event: led\ndata: ");
+        jsonDoc["name"]     = FrontPanelLeds::getName(static_cast<FrontPanelLeds::LedId>(event.id));
+        jsonDoc["state"]    = (0 != event.value);
+        break;
+
+    case EventRing::TYPE_ALARM:
+        data = F("event: alarm\ndata: ");
+        jsonDoc["state"]    = (0 != event.value);
+        break;
+
+    case EventRing::TYPE_WRITE:
+        data = F("event: write\ndata: ");
+        if (TEMPERATURE_ID_MAX > event.id)
+        {
+            jsonDoc["name"] = gTemperatures[event.id].getName();
+        }
+        jsonDoc["status"]   = event.value;
+        break;
+
+    default:
+        break;
+    }
+
+    if (0 < data.length())
+    {
+        String json;
+
+        (void)serializeJson(jsonDoc, json);
+        data += json;
+        data += F("\n\n");
+
+        /* Write the event only as a whole, otherwise try it again later. */
+        if (static_cast<int>(data.length()) <= client.availableForWrite())
+        {
+            (void)client.print(data);
+            isSent = true;
+        }
+    }
+    else
+    {
+        /* Unknown events are skipped. */
+        isSent = true;
+    }
+
+    return isSent;
+}
+
+/**
+ * Handle the request for the metrics in the Prometheus text format.
+ * The metrics are streamed line by line, without building the whole body.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleMetricsGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    (void)httpRequest;
+
+    /* An item may be written several times, therefore the value is taken once. */
+    gMetricsLoopDurationMax = gLoopDurationMax;
+
+    conn.sendStream(200U, F("text/plain; version=0.0.4"), writeMetrics);
+
+    return;
+}
+
+/**
+ * Write a single item of the metrics in the Prometheus text format.
+ * The items are the temperature sensors, the front panel LEDs and afterwards
+ * the system metrics.
+ *
+ * @param[in] out   Output
+ * @param[in] idx   Item index
+ *
+ * @return If the item was written, it will return true. If there is no item anymore, it will return false.
+ */
+static bool writeMetrics(Print& out, uint16_t idx)
+{
+    bool                            isWritten   = true;
+    const Rego6xxCtrl::Statistics   statistics  = gRego6xxCtrl.getStatistics();
+
+    if (TEMPERATURE_ID_MAX > idx)
+    {
+        if (0U == idx)
+        {
+            writeMetricType(out, F("rego6xx_temperature_celsius"), F("gauge"));
+        }
+
+        (void)out.print(F("rego6xx_temperature_celsius{sensor=\""));
+        (void)out.print(gTemperatures[idx].getName());
+        (void)out.print(F("\"} "));
+        writeDecimal(out, static_cast<int16_t>(gTemperatures[idx].getRawTemperature()));
+        (void)out.print('\n');
+    }
+    else if ((TEMPERATURE_ID_MAX + FrontPanelLeds::LED_ID_MAX) > idx)
+    {
+        FrontPanelLeds::LedId ledId = static_cast<FrontPanelLeds::LedId>(idx - TEMPERATURE_ID_MAX);
+
+        if (FrontPanelLeds::LED_ID_POWER == ledId)
+        {
+            writeMetricType(out, F("rego6xx_led_state"), F("gauge"));
+        }
+
+        (void)out.print(F("rego6xx_led_state{led=\""));
+        (void)out.print(FrontPanelLeds::getName(ledId));
+        (void)out.print(F("\"} "));
+        (void)out.print((true == gFrontPanelLeds.isOn(ledId)) ? '1' : '0');
+        (void)out.print('\n');
+    }
+    else
+    {
+        switch(idx - TEMPERATURE_ID_MAX - FrontPanelLeds::LED_ID_MAX)
+        {
+        case 0U:
+            writeMetric(out, F("rego6xx_bus_transactions_total"), F("counter"), statistics.transactions);
+            break;
+
+        case 1U:
+            writeMetric(out, F("rego6xx_bus_timeouts_total"), F("counter"), statistics.timeouts);
+            break;
+
+        case 2U:
+            writeMetric(out, F("rego6xx_bus_checksum_errors_total"), F("counter"), statistics.checksumErrors);
+            break;
+
+        case 3U:
+            writeMetric(out, F("rego6xx_web_queue_depth"), F("gauge"), getQueueDepth());
+            break;
+
+        case 4U:
+            writeMetric(out, F("rego6xx_loop_duration_max_microseconds"), F("gauge"), gMetricsLoopDurationMax);
+            break;
+
+        case 5U:
+            writeMetric(out, F("rego6xx_free_ram_bytes"), F("gauge"), getFreeRam());
+            break;
+
+        case 6U:
+            writeMetric(out, F("rego6xx_uptime_seconds"), F("gauge"), millis() / 1000UL);
+            break;
+
+        case 7U:
+        {
+            uint16_t utilization = gRego6xxCtrl.getUtilization();
+
+            writeMetricType(out, F("rego6xx_bus_utilization_ratio"), F("gauge"));
+
+            /* Utilization in 0.1 % as ratio with 3 fractional digits. */
+            (void)out.print(F("rego6xx_bus_utilization_ratio "));
+            (void)out.print(utilization / 1000U);
+            (void)out.print('.');
+            (void)out.print((utilization / 100U) % 10U);
+            (void)out.print((utilization / 10U) % 10U);
+            (void)out.print(utilization % 10U);
+            (void)out.print('\n');
+            break;
+        }
+
+        default:
+            isWritten = writeBusCmdMetrics(out, idx - TEMPERATURE_ID_MAX - FrontPanelLeds::LED_ID_MAX - 8U);
+            break;
+        }
+    }
+
+    /* The max. duration starts again, after the metrics are sent completely.
+     * An aborted request keeps it.
+     */
+    if (false == isWritten)
+    {
+        gLoopDurationMax = 0U;
+    }
+
+    return isWritten;
+}
+
+/**
+ * Write a metric, which has a single value.
+ *
+ * @param[in] out   Output
+ * @param[in] name  Metric name
+ * @param[in] type  Metric type, e.g. "counter" or "gauge"
+ * @param[in] value Value
+ */
+static void writeMetric(Print& out, const __FlashStringHelper* name, const __FlashStringHelper* type, uint32_t value)
+{
+    writeMetricType(out, name, type);
+
+    (void)out.print(name);
+    (void)out.print(' ');
+    (void)out.print(value);
+    (void)out.print('\n');
+
+    return;
+}
+
+/**
+ * Write a single item of the heatpump bus metrics per command. Every
+ * counter starts with its type line, followed by one line per command.
+ * The turnaround follows at the end. It is a histogram, if built with
+ * TURNAROUND_HISTOGRAM, otherwise a summary without quantiles.
+ *
+ * @param[in] out   Output
+ * @param[in] idx   Item index, relative to the first bus command metric
+ *
+ * @return If the item was written, it will return true. If there is no item anymore, it will return false.
+ */
+static bool writeBusCmdMetrics(Print& out, uint16_t idx)
+{
+    const uint16_t  NUM_COUNTERS        = 5U;
+    const uint16_t  ITEMS_PER_COUNTER   = 1U + Rego6xxCtrl::CMD_STATS_ID_MAX;
+#if defined(TURNAROUND_HISTOGRAM)
+    const uint16_t  NUM_BUCKET_ITEMS    = Rego6xxCtrl::NUM_TURNAROUND_BUCKETS;
+#else
+    const uint16_t  NUM_BUCKET_ITEMS    = 0U;
+#endif  /* defined(TURNAROUND_HISTOGRAM) */
+    const uint16_t  ITEMS_PER_HISTOGRAM = NUM_BUCKET_ITEMS + 2U;
+    const uint16_t  HISTOGRAM_IDX       = NUM_COUNTERS * ITEMS_PER_COUNTER;
+    const uint16_t  END_IDX             = HISTOGRAM_IDX + 1U + (Rego6xxCtrl::CMD_STATS_ID_MAX * ITEMS_PER_HISTOGRAM);
+    bool            isWritten           = true;
+
+    if (HISTOGRAM_IDX > idx)
+    {
+        uint8_t                     counterIdx  = static_cast<uint8_t>(idx / ITEMS_PER_COUNTER);
+        uint8_t                     itemIdx     = static_cast<uint8_t>(idx % ITEMS_PER_COUNTER);
+        uint32_t                    value       = 0U;
+        Rego6xxCtrl::CmdStatsId     id          = static_cast<Rego6xxCtrl::CmdStatsId>((0U == itemIdx) ? 0U : (itemIdx - 1U));
+        const __FlashStringHelper*  name        = getBusCmdCounter(counterIdx, gRego6xxCtrl.getCmdStatistics(id), value);
+
+        if (0U == itemIdx)
+        {
+            writeMetricType(out, name, F("counter"));
+        }
+        else
+        {
+            writeBusCmdSample(out, name, id);
+            (void)out.print(F("} "));
+            (void)out.print(value);
+            (void)out.print('\n');
+        }
+    }
+    else if (HISTOGRAM_IDX == idx)
+    {
+#if defined(TURNAROUND_HISTOGRAM)
+        writeMetricType(out, F("rego6xx_bus_cmd_turnaround_milliseconds"), F("histogram"));
+#else
+        writeMetricType(out, F("rego6xx_bus_cmd_turnaround_milliseconds"), F("summary"));
+#endif  /* defined(TURNAROUND_HISTOGRAM) */
+    }
+    else if (END_IDX > idx)
+    {
+        uint16_t                                offset      = idx - HISTOGRAM_IDX - 1U;
+        Rego6xxCtrl::CmdStatsId                 id          = static_cast<Rego6xxCtrl::CmdStatsId>(offset / ITEMS_PER_HISTOGRAM);
+        uint8_t                                 itemIdx     = static_cast<uint8_t>(offset % ITEMS_PER_HISTOGRAM);
+        const Rego6xxCtrl::CmdStatistics&       statistics  = gRego6xxCtrl.getCmdStatistics(id);
+
+#if defined(TURNAROUND_HISTOGRAM)
+        if (NUM_BUCKET_ITEMS > itemIdx)
+        {
+            uint32_t    count   = 0U;
+            uint8_t     bucket  = 0U;
+
+            /* The buckets are cumulative. */
+            while(itemIdx >= bucket)
+            {
+                count += statistics.turnaroundHistogram[bucket];
+                ++bucket;
+            }
+
+            writeBusCmdSample(out, F("rego6xx_bus_cmd_turnaround_milliseconds_bucket"), id);
+            (void)out.print(F(",le=\""));
+
+            if ((Rego6xxCtrl::NUM_TURNAROUND_BUCKETS - 1U) > itemIdx)
+            {
+                (void)out.print(Rego6xxCtrl::getTurnaroundBound(itemIdx));
+            }
+            else
+            {
+                (void)out.print(F("+Inf"));
+            }
+
+            (void)out.print(F("\"} "));
+            (void)out.print(count);
+        }
+        else
+#endif  /* defined(TURNAROUND_HISTOGRAM) */
+        if (NUM_BUCKET_ITEMS == itemIdx)
+        {
+            writeBusCmdSample(out, F("rego6xx_bus_cmd_turnaround_milliseconds_sum"), id);
+            (void)out.print(F("} "));
+            (void)out.print(statistics.turnaroundSum);
+        }
+        else
+        {
+            writeBusCmdSample(out, F("rego6xx_bus_cmd_turnaround_milliseconds_count"), id);
+            (void)out.print(F("} "));
+            (void)out.print(statistics.completed);
+        }
+
+        (void)out.print('\n');
+    }
+    else
+    {
+        isWritten = false;
+    }
+
+    return isWritten;
+}
+
+/**
+ * Get a counter of the heatpump bus command statistics.
+ *
+ * @param[in]  counterIdx   Counter index
+ * @param[in]  statistics   Command statistics
+ * @param[out] value        Counter value
+ *
+ * @return Metric name of the counter
+ */
+static const __FlashStringHelper* getBusCmdCounter(uint8_t counterIdx, const Rego6xxCtrl::CmdStatistics& statistics, uint32_t& value)
+{
+    const __FlashStringHelper* name = nullptr;
+
+    switch(counterIdx)
+    {
+    case 0U:
+        name    = F("rego6xx_bus_cmd_issued_total");
+        value   = statistics.issued;
+        break;
+
+    case 1U:
+        name    = F("rego6xx_bus_cmd_completed_total");
+        value   = statistics.completed;
+        break;
+
+    case 2U:
+        name    = F("rego6xx_bus_cmd_timeouts_total");
+        value   = statistics.timeouts;
+        break;
+
+    case 3U:
+        name    = F("rego6xx_bus_cmd_checksum_errors_total");
+        value   = statistics.checksumErrors;
+        break;
+
+    default:
+        name    = F("rego6xx_bus_cmd_wrong_dev_addr_total");
+        value   = statistics.wrongDevAddrs;
+        break;
+    }
+
+    return name;
+}
+
+/**
+ * Write the begin of a sample of a heatpump bus command metric, which is
+ * the metric name and the command label. Further labels and the closing
+ * brace follow by the caller.
+ *
+ * @param[in] out   Output
+ * @param[in] name  Metric name
+ * @param[in] id    Command statistics id
+ */
+static void writeBusCmdSample(Print& out, const __FlashStringHelper* name, Rego6xxCtrl::CmdStatsId id)
+{
+    (void)out.print(name);
+    (void)out.print(F("{cmd=\""));
+    (void)out.print(getCmdStatsName(id));
+    (void)out.print('"');
+
+    return;
+}
+
+/**
+ * Get the name of a command statistics id, used as metric label.
+ *
+ * @param[in] id    Command statistics id
+ *
+ * @return Name
+ */
+static const __FlashStringHelper* getCmdStatsName(Rego6xxCtrl::CmdStatsId id)
+{
+    const __FlashStringHelper* name = F("other");
+
+    switch(id)
+    {
+    case Rego6xxCtrl::CMD_STATS_ID_READ_FRONT_PANEL:
+        name = F("readFrontPanel");
+        break;
+
+    case Rego6xxCtrl::CMD_STATS_ID_WRITE_FRONT_PANEL:
+        name = F("writeFrontPanel");
+        break;
+
+    case Rego6xxCtrl::CMD_STATS_ID_READ_SYSTEM_REG:
+        name = F("readSysReg");
+        break;
+
+    case Rego6xxCtrl::CMD_STATS_ID_WRITE_SYSTEM_REG:
+        name = F("writeSysReg");
+        break;
+
+    case Rego6xxCtrl::CMD_STATS_ID_READ_DISPLAY:
+        name = F("readDisplay");
+        break;
+
+    case Rego6xxCtrl::CMD_STATS_ID_READ_LAST_ERROR:
+        name = F("readLastError");
+        break;
+
+    default:
+        break;
+    }
+
+    return name;
+}
+
+/**
+ * Handle the request for the profile of the main loop. The profile is
+ * streamed and cleared afterwards, so every request gets the profile since
+ * the previous one.
+ *
+ * @param[in] conn          Web connection, used to send the response.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleLoopGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    (void)httpRequest;
+
+    /* The items are written over several iterations from the running
+     * profiler. A snapshot would cost as much RAM as the profiler itself,
+     * while the items differ only by the few iterations meanwhile.
+     */
+    conn.sendStream(200U, F("application/json"), writeLoopProfile);
+
+    return;
+}
+
+/**
+ * Write a single item of the main loop profile in JSON format.
+ * The items are the iteration summary, the longest stall, every phase,
+ * every histogram bucket if built with LOOP_HISTOGRAM and the end. The
+ * profile is cleared, after it
+ * was sent completely. All durations are in us.
+ *
+ * @param[in] out   Output
+ * @param[in] idx   Item index
+ *
+ * @return If the item was written, it will return true. If there is no item anymore, it will return false.
+ */
+static bool writeLoopProfile(Print& out, uint16_t idx)
+{
+    const uint16_t  PHASES_IDX      = 2U;
+    const uint16_t  HISTOGRAM_IDX   = PHASES_IDX + LOOP_PHASE_MAX;
+#if defined(LOOP_HISTOGRAM)
+    const uint16_t  END_IDX         = HISTOGRAM_IDX + LoopProfiler::NUM_BUCKETS;
+#else
+    const uint16_t  END_IDX         = HISTOGRAM_IDX;
+#endif  /* defined(LOOP_HISTOGRAM) */
+    bool            isWritten       = true;
+
+    if (0U == idx)
+    {
+        (void)out.print(F("{\"data\":{\"iterations\":"));
+        (void)out.print(gLoopProfiler.getIterations());
+        (void)out.print(F(",\"durationAvg\":"));
+        (void)out.print(gLoopProfiler.getDurationAvg());
+        (void)out.print(F(",\"durationMax\":"));
+        (void)out.print(gLoopProfiler.getDurationMax());
+    }
+    else if (1U == idx)
+    {
+        (void)out.print(F(",\"stall\":{\"duration\":"));
+        (void)out.print(gLoopProfiler.getStallDuration());
+        (void)out.print(F(",\"phase\":\""));
+        (void)out.print(getLoopPhaseName(gLoopProfiler.getStallPhase()));
+        (void)out.print(F("\",\"cause\":\""));
+        (void)out.print(gLoopProfiler.getStallCause());
+        (void)out.print(F("\",\"timestamp\":"));
+        (void)out.print(gLoopProfiler.getStallTimestamp());
+        (void)out.print('}');
+    }
+    else if (HISTOGRAM_IDX > idx)
+    {
+        uint8_t phase = static_cast<uint8_t>(idx - PHASES_IDX);
+
+        (void)out.print((0U == phase) ? F(",\"phases\":[") : F(","));
+        (void)out.print(F("{\"name\":\""));
+        (void)out.print(getLoopPhaseName(phase));
+        (void)out.print(F("\",\"avg\":"));
+        (void)out.print(gLoopProfiler.getPhaseAvg(phase));
+        (void)out.print(F(",\"max\":"));
+        (void)out.print(gLoopProfiler.getPhaseMax(phase));
+        (void)out.print('}');
+    }
+#if defined(LOOP_HISTOGRAM)
+    else if (END_IDX > idx)
+    {
+        uint8_t bucket = static_cast<uint8_t>(idx - HISTOGRAM_IDX);
+
+        (void)out.print((0U == bucket) ? F("],\"histogram\":[") : F(","));
+        (void)out.print('{');
+
+        /* The last bucket has no upper bound. */
+        if ((LoopProfiler::NUM_BUCKETS - 1U) > bucket)
+        {
+            (void)out.print(F("\"le\":"));
+            (void)out.print(LoopProfiler::getBucketBound(bucket));
+            (void)out.print(',');
+        }
+
+        (void)out.print(F("\"count\":"));
+        (void)out.print(gLoopProfiler.getBucketCount(bucket));
+        (void)out.print('}');
+    }
+#endif  /* defined(LOOP_HISTOGRAM) */
+    else if (END_IDX == idx)
+    {
+        (void)out.print(F("]},\"status\":"));
+        (void)out.print(STATUS_ID_OK);
+        (void)out.print('}');
+    }
+    else
+    {
+        isWritten = false;
+    }
+
+    /* The profile starts again, after it was sent completely.
+     * An aborted request keeps it.
+     */
+    if (false == isWritten)
+    {
+        gLoopProfiler.reset();
+    }
+
+    return isWritten;
+}
+
+/**
+ * Get the name of a main loop phase.
+ *
+ * @param[in] phase Loop phase
+ *
+ * @return Name. If the phase is unknown, it will be empty.
+ */
+static const __FlashStringHelper* getLoopPhaseName(uint8_t phase)
+{
+    const __FlashStringHelper* name = F("");
+
+    switch(phase)
+    {
+    case LOOP_PHASE_NETWORK:
+        name = F("network");
+        break;
+
+    case LOOP_PHASE_EVENTS:
+        name = F("events");
+        break;
+
+    case LOOP_PHASE_MQTT:
+        name = F("mqtt");
+        break;
+
+    case LOOP_PHASE_WEB:
+        name = F("web");
+        break;
+
+    case LOOP_PHASE_TEMPERATURE_WRITE:
+        name = F("temperatureWrite");
+        break;
+
+    case LOOP_PHASE_LED_READ:
+        name = F("ledRead");
+        break;
+
+    case LOOP_PHASE_SENSOR_READ:
+        name = F("sensorRead");
+        break;
+
+    case LOOP_PHASE_REGO6XX:
+        name = F("rego6xx");
+        break;
+
+    default:
+        break;
+    }
+
+    return name;
+}
+
+#if defined(SERIAL_CAPTURE)
+
+/**
+ * Export the captured bytes of the serial line to the heatpump, see
+ * SerialCapture for the format. The export contains the entries, which
+ * are captured at the time of the request.
+ *
+ * @param[in] conn          The web connection, used for the reply.
+ * @param[in] httpRequest   The http request itself.
+ */
+static void handleCaptureGetReq(WebConnection& conn, const HttpRequest& httpRequest)
+{
+    (void)httpRequest;
+
+    /* A concurrent export starts over with the current entries. */
+    gCaptureExportCnt = gSerialCapture.getCount();
+    gCaptureExportSeq = gSerialCapture.getNextSeq() - gCaptureExportCnt;
+
+    conn.sendStream(200U, F("application/octet-stream"), writeCapture);
+
+    return;
+}
+
+/**
+ * Write a single item of the captured bytes. The first item is the header,
+ * all others contain several entries. A entry, which was overwritten in the
+ * meantime, is marked as lost.
+ *
+ * @param[in] out   Output
+ * @param[in] idx   Item index
+ *
+ * @return If the item was written, it will return true. If there is no item anymore, it will return false.
+ */
+static bool writeCapture(Print& out, uint16_t idx)
+{
+    bool isWritten = true;
+
+    if (0U == idx)
+    {
+        SerialCapture::writeHeader(out, gCaptureExportCnt);
+    }
+    else if (gCaptureExportCnt <= ((idx - 1U) * CAPTURE_ENTRIES_PER_ITEM))
+    {
+        isWritten = false;
+    }
+    else
+    {
+        uint16_t entryIdx   = (idx - 1U) * CAPTURE_ENTRIES_PER_ITEM;
+        uint16_t entryEnd   = entryIdx + CAPTURE_ENTRIES_PER_ITEM;
+
+        if (gCaptureExportCnt < entryEnd)
+        {
+            entryEnd = gCaptureExportCnt;
+        }
+
+        while(entryEnd > entryIdx)
+        {
+            SerialCapture::Entry entry;
+
+            if (false == gSerialCapture.getEntry(gCaptureExportSeq + entryIdx, entry))
+            {
+                entry.flags = SerialCapture::FLAG_LOST;
+                entry.data  = 0U;
+                entry.delta = 0U;
+            }
+            else if (0U == entryIdx)
+            {
+                /* The trace starts with the first exported entry. */
+                entry.flags &= ~SerialCapture::FLAG_DELTA_MASK;
+                entry.delta  = 0U;
+            }
+            else
+            {
+                /* Nothing to do. */
+                ;
+            }
+
+            SerialCapture::writeEntry(out, entry);
+            ++entryIdx;
+        }
+    }
+
+    return isWritten;
+}
+
+#endif  /* defined(SERIAL_CAPTURE) */
+
+/**
+ * Write the type line of a metric.
+ *
+ * @param[in] out   Output
+ * @param[in] name  Metric name
+ * @param[in] type  Metric type, e.g. "counter" or "gauge"
+ */
+static void writeMetricType(Print& out, const __FlashStringHelper* name, const __FlashStringHelper* type)
+{
+    (void)out.print(F("# TYPE "));
+    (void)out.print(name);
+    (void)out.print(' ');
+    (void)out.print(type);
+    (void)out.print('\n');
+
+    return;
+}
+
+/**
+ * Write a value in 0.1 units as decimal number with one fractional digit,
+ * e.g. -123 as "-12.3". No floating point arithmetic is used.
+ *
+ * @param[in] out   Output
+ * @param[in] value Value in 0.1 units
+ */
+static void writeDecimal(Print& out, int16_t value)
+{
+    uint16_t absValue = static_cast<uint16_t>(value);
+
+    if (0 > value)
+    {
+        (void)out.print('-');
+        absValue = static_cast<uint16_t>(-static_cast<int32_t>(value));
+    }
+
+    (void)out.print(absValue / 10U);
+    (void)out.print('.');
+    (void)out.print(absValue % 10U);
+
+    return;
+}
+
+/**
+ * Get the number of web requests, which are deferred and wait for the heatpump.
+ *
+ * @return Number of deferred web requests
+ */
+static uint16_t getQueueDepth(void)
+{
+    uint16_t    depth   = 0U;
+    uint8_t     idx     = 0U;
+
+    while(MAX_WEB_CONNECTIONS > idx)
+    {
+        if (true == gWebConnections[idx].isDeferred())
+        {
+            ++depth;
+        }
+
+        ++idx;
+    }
+
+    return depth;
+}
+
+/**
+ * Is any web request in progress? A connection, which is kept open and waits
+ * for the next request, doesn't count.
+ *
+ * @return If a web request is in progress, it will return true otherwise false.
+ */
+static bool isWebReqInProgress(void)
+{
+    bool    isInProgress    = false;
+    uint8_t idx             = 0U;
+
+    while((false == isInProgress) && (MAX_WEB_CONNECTIONS > idx))
+    {
+        if ((true == gWebConnections[idx].isUsed()) &&
+            (false == gWebConnections[idx].isIdle()))
+        {
+            isInProgress = true;
+        }
+
+        ++idx;
+    }
+
+    return isInProgress;
+}
+
+/**
+ * Get the free RAM between the heap and the stack.
+ * Note, freed memory inside the heap is not considered.
+ *
+ * @return Free RAM in bytes
+ */
+static uint16_t getFreeRam(void)
+{
+    uint16_t freeRam = 0U;
+
+#if defined(__AVR__)
+    char    stackTop;
+    char*   heapEnd = (nullptr == __brkval) ? &__heap_start : __brkval;
+
+    freeRam = static_cast<uint16_t>(&stackTop - heapEnd);
+#endif  /* defined(__AVR__) */
+
+    return freeRam;
+}
+
+/**
+ * Handle the MQTT client. After a new connection the complete state is
+ * published, afterwards every change. Only one message is published per
+ * call, the next one follows in the next call.
+ */
+static void handleMqtt(void)
+{
+    /* The connect to the broker blocks the main loop for a moment. It waits
+     * until no heatpump response is pending and no web request is in progress,
+     * otherwise they would be delayed or time out.
+     */
+    if ((false == gMqttClient.isConnectDue()) ||
+        ((false == gRego6xxCtrl.isPending()) &&
+         (false == isWebReqInProgress())))
+    {
+        gMqttClient.process();
+    }
+
+    /* Connection state changed? After a new connection, all retained
+     * topics are published again, because the broker may have lost them.
+     */
+    if (gIsMqttConnected != gMqttClient.isConnected())
+    {
+        gIsMqttConnected    = gMqttClient.isConnected();
+        gMqttStateIdx       = 0U;
+        gMqttEventSeq       = gEventRing.getNextSeq();
+    }
+
+    if (false == gIsMqttConnected)
+    {
+        /* Nothing to do. */
+        ;
+    }
+    /* Publish complete state? */
+    else if (TEMPERATURE_ID_MAX > gMqttStateIdx)
+    {
+        if (true == publishMqttSensor(gMqttStateIdx, static_cast<int16_t>(gTemperatures[gMqttStateIdx].getRawTemperature())))
+        {
+            ++gMqttStateIdx;
+        }
+    }
+    else if ((TEMPERATURE_ID_MAX + FrontPanelLeds::LED_ID_MAX) > gMqttStateIdx)
+    {
+        FrontPanelLeds::LedId ledId = static_cast<FrontPanelLeds::LedId>(gMqttStateIdx - TEMPERATURE_ID_MAX);
+
+        if (true == publishMqttLed(ledId, gFrontPanelLeds.isOn(ledId)))
+        {
+            ++gMqttStateIdx;
+        }
+    }
+    /* Publish changes */
+    else
+    {
+        uint16_t            seq     = gMqttEventSeq;
+        EventRing::Event    event;
+        bool                isSent  = true;
+
+        if (true == gEventRing.read(seq, event))
+        {
+            switch(event.type)
+            {
+            case EventRing::TYPE_SENSOR:
+                isSent = publishMqttSensor(event.id, event.value);
+                break;
+
+            case EventRing::TYPE_LED:
+            case EventRing::TYPE_ALARM:
+                isSent = publishMqttLed(static_cast<FrontPanelLeds::LedId>(event.id), (0 != event.value));
+                break;
+
+            case EventRing::TYPE_WRITE:
+            default:
+                /* Not published. */
+                break;
+            }
+
+            /* If not sent, it is tried again in the next call. */
+            if (true == isSent)
+            {
+                gMqttEventSeq = seq;
+            }
+        }
+    }
+
+    return;
+}
 
-    /* Any command pending? */
-    if (true == gRego6xxCtrl.isPending())
+/**
+ * Handle the front panel action, which was requested via MQTT.
+ * It is written, as soon as the controller is free.
+ */
+static void handleMqttFrontPanelReq(void)
+{
+    if (false == gMqttFrontPanelReq)
     {
-        jsonDocRsp["status"] = STATUS_ID_EPENDING;
+        /* Nothing to do. */
+        ;
     }
-    /* Deserialization of JSON data failed? */
-    else if (DeserializationError::Ok != deserializeJson(jsonDoc, body))
+    /* Not started yet? If the controller is busy, it will be tried again in the next call. */
+    else if (nullptr == gMqttBusRsp)
     {
-        jsonDocRsp["status"] = STATUS_ID_EINPUT;
+        gMqttBusRsp = gRego6xxCtrl.writeFrontPanel(gMqttFrontPanelAddr, gMqttFrontPanelValue);
     }
-    else
+    /* Response received? */
+    else if (false == gMqttBusRsp->isPending())
     {
-        JsonObject  jsonObj = jsonDoc.as<JsonObject>();
-        uint8_t     cmdId   = jsonObj["cmdId"].as<uint8_t>();
-        uint16_t    addr    = jsonObj["addr"].as<uint16_t>();
-        uint16_t    value   = jsonObj["value"].as<uint16_t>();
-        String      rsp     = gRego6xxCtrl.writeDbg(cmdId, addr, value);
-
-        jsonData["response"] = rsp;
-        jsonDocRsp["status"] = STATUS_ID_OK;
-    }
+        if ((false == gMqttBusRsp->isValid()) ||
+            (Rego6xxCtrl::DEV_ADDR_HOST != gMqttBusRsp->getDevAddr()))
+        {
+            LOG_ERROR(F("Front panel action failed."));
+        }
 
-    (void)serializeJson(jsonDocRsp, data);
+        gRego6xxCtrl.release();
 
-    httpReply.send(data);
+        gMqttBusRsp         = nullptr;
+        gMqttFrontPanelReq  = false;
+    }
+    else
+    /* Wait for response. */
+    {
+        /* Nothing to do. */
+        ;
+    }
 
     return;
 }
 
 /**
- * Handle GET last error access.
+ * Publish a temperature sensor value via MQTT.
  *
- * @param[in] client        Ethernet client, used to send the response.
- * @param[in] httpRequest   The http request itself.
+ * @param[in] idx       Temperature id
+ * @param[in] rawValue  Raw value in 0.1 °C
+ *
+ * @return If published, it will return true otherwise false.
  */
-static void handleLastErrorGetReq(EthernetClient& client, const HttpRequest& httpRequest)
+static bool publishMqttSensor(uint8_t idx, int16_t rawValue)
 {
-    ArduinoHttpServer::StreamHttpReply  httpReply(client, "application/json");
-    String                              data;
-    DynamicJsonDocument                 jsonDoc(256);
-    JsonObject                          jsonData        = jsonDoc.createNestedObject("data");
+    bool isPublished = true;
 
-    /* Any command pending? */
-    if (true == gRego6xxCtrl.isPending())
+    if (TEMPERATURE_ID_MAX > idx)
     {
-        jsonDoc["status"] = STATUS_ID_EPENDING;
-    }
-    else
-    {
-        const Rego6xxErrorRsp*  errorRsp = gRego6xxCtrl.readLastError();
-
-        if (nullptr == errorRsp)
-        {
-            jsonDoc["status"] = STATUS_ID_EINTERNAL;
-        }
-        else
-        {
-            /* Wait till response arrived.
-             * Note, the there is already a timeout observation done by the controller.
-             */
-            while(true == errorRsp->isPending())
-            {
-                gRego6xxCtrl.process();
-            }
-
-            /* Check response, the data and the destination address of the
-             * response message must be valid.
-             * If a timeout happened, the data is valid but the destination
-             * address won't match.
-             */
-            if ((false == errorRsp->isValid()) ||
-                (Rego6xxCtrl::DEV_ADDR_HOST != errorRsp->getDevAddr()))
-            {
-                jsonDoc["status"] = STATUS_ID_EINVALID;
-            }
-            else
-            {
-                jsonData["errorId"]     = errorRsp->getErrorId();
-                jsonData["log"]         = errorRsp->getErrorLog();
-                jsonData["description"] = errorRsp->getErrorDescription();
+        char        payload[8U];
+        LineBuffer  payloadBuffer(payload, sizeof(payload));
 
-                jsonDoc["status"] = STATUS_ID_OK;
-            }
+        writeDecimal(payloadBuffer, rawValue);
 
-            gRego6xxCtrl.release();
-        }
+        isPublished = publishMqtt(F("rego6xx/sensors/"), gTemperatures[idx].getName().c_str(), payload);
     }
 
-    (void)serializeJson(jsonDoc, data);
-
-    httpReply.send(data);
-
-    return;
+    return isPublished;
 }
 
 /**
- * Handle GET front panel access.
+ * Publish a front panel LED state via MQTT.
+ * The alarm LED has its own topic.
  *
- * @param[in] client        Ethernet client, used to send the response.
- * @param[in] httpRequest   The http request itself.
+ * @param[in] ledId LED id
+ * @param[in] isOn  Is LED on?
+ *
+ * @return If published, it will return true otherwise false.
  */
-static void handleFrontPanelGetReq(EthernetClient& client, const HttpRequest& httpRequest)
+static bool publishMqttLed(FrontPanelLeds::LedId ledId, bool isOn)
 {
-    ArduinoHttpServer::StreamHttpReply  httpReply(client, "application/json");
-    String                              data;
-    String                              ledName         = httpRequest.getResource()[2]; /* /api/fronPanel/<name> */
-    DynamicJsonDocument                 jsonDoc(256);
-    JsonObject                          jsonData        = jsonDoc.createNestedObject("data");
+    bool        isPublished = true;
+    const char* payload     = (true == isOn) ? "1" : "0";
 
-    if (0 == ledName.length())
+    if (FrontPanelLeds::LED_ID_ALARM == ledId)
     {
-        jsonDoc["status"] = STATUS_ID_EPAR;
+        isPublished = publishMqtt(F("rego6xx/alarm"), nullptr, payload);
+    }
+    else if (FrontPanelLeds::LED_ID_MAX > ledId)
+    {
+        isPublished = publishMqtt(F("rego6xx/leds/"), FrontPanelLeds::getName(ledId), payload);
     }
     else
     {
-        const Rego6xxBoolRsp*   boolRsp     = nullptr;
-        bool                    isNoMatch   = false;
-
-        if (0 != ledName.equalsIgnoreCase("power"))
-        {
-            boolRsp = gRego6xxCtrl.readFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_POWER_LED);
-        }
-        else if (0 != ledName.equalsIgnoreCase("pump"))
-        {
-            boolRsp = gRego6xxCtrl.readFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_PUMP_LED);
-        }
-        else if (0 != ledName.equalsIgnoreCase("heating"))
-        {
-            boolRsp = gRego6xxCtrl.readFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_HEATING_LED);
-        }
-        else if (0 != ledName.equalsIgnoreCase("boiler"))
-        {
-            boolRsp = gRego6xxCtrl.readFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_BOILER_LED);
-        }
-        else if (0 != ledName.equalsIgnoreCase("alarm"))
-        {
-            boolRsp = gRego6xxCtrl.readFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_ALARM_LED);
-        }
-        else
-        {
-            /* No match */
-            isNoMatch = true;
-        }
+        /* Unknown LED is skipped. */
+        ;
+    }
 
-        /* Really no match or not possible? */
-        if (nullptr == boolRsp)
-        {
-            if (false == isNoMatch)
-            {
-                jsonDoc["status"] = STATUS_ID_EINTERNAL;
-            }
-            else
-            {
-                jsonDoc["status"] = STATUS_ID_EPAR;
-            }
-        }
-        else
-        {
-            /* Wait till response arrived.
-             * Note, the there is already a timeout observation done by the controller.
-             */
-            while(true == boolRsp->isPending())
-            {
-                gRego6xxCtrl.process();
-            }
+    return isPublished;
+}
 
-            /* Check response, the data and the destination address of the
-             * response message must be valid.
-             * If a timeout happened, the data is valid but the destination
-             * address won't match.
-             */
-            if ((false == boolRsp->isValid()) ||
-                (Rego6xxCtrl::DEV_ADDR_HOST != boolRsp->getDevAddr()))
-            {
-                jsonDoc["status"] = STATUS_ID_EINVALID;
-            }
-            else
-            {
-                jsonData["name"]    = ledName;
-                jsonData["state"]   = boolRsp->getValue();
+/**
+ * Publish a retained MQTT message.
+ *
+ * @param[in] topicBase Topic or its first part
+ * @param[in] name      Last part of the topic. Use nullptr for none.
+ * @param[in] payload   Payload
+ *
+ * @return If published, it will return true otherwise false.
+ */
+static bool publishMqtt(const __FlashStringHelper* topicBase, const char* name, const char* payload)
+{
+    char        topic[MQTT_TOPIC_SIZE];
+    LineBuffer  topicBuffer(topic, sizeof(topic));
 
-                jsonDoc["status"] = STATUS_ID_OK;
-            }
+    (void)topicBuffer.print(topicBase);
 
-            gRego6xxCtrl.release();
-        }
+    if (nullptr != name)
+    {
+        (void)topicBuffer.print(name);
     }
 
-    (void)serializeJson(jsonDoc, data);
-
-    httpReply.send(data);
-
-    return;
+    return gMqttClient.publish(topic, payload, true);
 }
 
 /**
- * Handle POST front panel access.
+ * Handle a received MQTT command.
+ * Topics:
+ * - rego6xx/cmd/sensors/<name> with the temperature in °C as payload.
+ * - rego6xx/cmd/frontPanel/<hmiDevice>, payload is not used.
  *
- * @param[in] client        Ethernet client, used to send the response.
- * @param[in] httpRequest   The http request itself.
+ * @param[in] topic     Topic
+ * @param[in] payload   Payload
  */
-static void handleFrontPanelPostReq(EthernetClient& client, const HttpRequest& httpRequest)
+static void onMqttMessage(const char* topic, const char* payload)
 {
-    ArduinoHttpServer::StreamHttpReply  httpReply(client, "application/json");
-    String                              data;
-    String                              hmiName         = httpRequest.getResource()[2]; /* /api/fronPanel/<name> */
-    DynamicJsonDocument                 jsonDoc(256);
-    JsonObject                          jsonData        = jsonDoc.createNestedObject("data");
+    const char  SENSOR_CMD[]        = "rego6xx/cmd/sensors/";
+    const char  FRONT_PANEL_CMD[]   = "rego6xx/cmd/frontPanel/";
 
-    if (0 == hmiName.length())
+    if (0 == strncmp(topic, SENSOR_CMD, sizeof(SENSOR_CMD) - 1U))
     {
-        jsonDoc["status"] = STATUS_ID_EPAR;
-    }
-    else
-    {
-        const Rego6xxConfirmRsp*    confirmRsp  = nullptr;
-        bool                        isNoMatch   = false;
-
-        if (0 != hmiName.equalsIgnoreCase("buttonL"))
-        {
-            confirmRsp = gRego6xxCtrl.writeFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_LEFT_BUTTON, 1);
-        }
-        else if (0 != hmiName.equalsIgnoreCase("buttonM"))
-        {
-            confirmRsp = gRego6xxCtrl.writeFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_MIDDLE_BUTTON, 1);
-        }
-        else if (0 != hmiName.equalsIgnoreCase("buttonR"))
-        {
-            confirmRsp = gRego6xxCtrl.writeFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_RIGHT_BUTTON, 1);
-        }
-        else if (0 != hmiName.equalsIgnoreCase("wheelTL"))
-        {
-            confirmRsp = gRego6xxCtrl.writeFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, 0x1FFF);
-        }
-        else if (0 != hmiName.equalsIgnoreCase("wheelTR"))
+        if (STATUS_ID_OK != requestTemperatureWrite(&topic[sizeof(SENSOR_CMD) - 1U], static_cast<float>(atof(payload))))
         {
-            confirmRsp = gRego6xxCtrl.writeFrontPanel(Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, 1);
+            LOG_ERROR(F("MQTT temperature write rejected."));
         }
-        else
+    }
+    else if (0 == strncmp(topic, FRONT_PANEL_CMD, sizeof(FRONT_PANEL_CMD) - 1U))
+    {
+        /* Only one front panel action can be pending. */
+        if (true == gMqttFrontPanelReq)
         {
-            /* No match */
-            isNoMatch = true;
+            LOG_ERROR(F("MQTT front panel action rejected, because one is pending."));
         }
-
-        /* Really no match or not possible? */
-        if (nullptr == confirmRsp)
+        else if (false == getHmiAction(&topic[sizeof(FRONT_PANEL_CMD) - 1U], gMqttFrontPanelAddr, gMqttFrontPanelValue))
         {
-            if (false == isNoMatch)
-            {
-                jsonDoc["status"] = STATUS_ID_EINTERNAL;
-            }
-            else
-            {
-                jsonDoc["status"] = STATUS_ID_EPAR;
-            }
+            LOG_ERROR(F("MQTT front panel action unknown."));
         }
         else
         {
-            /* Wait till response arrived.
-             * Note, the there is already a timeout observation done by the controller.
-             */
-            while(true == confirmRsp->isPending())
-            {
-                gRego6xxCtrl.process();
-            }
-
-            /* Check response, the data and the destination address of the
-             * response message must be valid.
-             * If a timeout happened, the data is valid but the destination
-             * address won't match.
-             */
-            if ((false == confirmRsp->isValid()) ||
-                (Rego6xxCtrl::DEV_ADDR_HOST != confirmRsp->getDevAddr()))
-            {
-                jsonDoc["status"] = STATUS_ID_EINVALID;
-            }
-            else
-            {
-                jsonData["name"]    = hmiName;
-
-                jsonDoc["status"] = STATUS_ID_OK;
-            }
-
-            gRego6xxCtrl.release();
+            gMqttFrontPanelReq = true;
         }
     }
-
-    (void)serializeJson(jsonDoc, data);
-
-    httpReply.send(data);
+    else
+    {
+        /* Unknown command is skipped. */
+        ;
+    }
 
     return;
 }
 
 /**
- * Handle GET display access.
+ * Get the front panel action by the name of the HMI device.
  *
- * @param[in] client        Ethernet client, used to send the response.
- * @param[in] httpRequest   The http request itself.
+ * @param[in]   hmiName Name of the HMI device, e.g. "buttonL"
+ * @param[out]  addr    Front panel address
+ * @param[out]  value   Value which to write to the front panel address
+ *
+ * @return If the HMI device is known, it will return true otherwise false.
  */
-static void handleDisplayGetReq(EthernetClient& client, const HttpRequest& httpRequest)
+static bool getHmiAction(const String& hmiName, Rego6xxCtrl::FrontPanelAddr& addr, uint16_t& value)
 {
-    ArduinoHttpServer::StreamHttpReply  httpReply(client, "application/json");
-    String                              data;
-    DynamicJsonDocument                 jsonDoc(256);
-    JsonObject                          jsonData        = jsonDoc.createNestedObject("data");
-    String                              rowStr          = httpRequest.getResource()[2]; /* /api/display/<row> */
+    bool isFound = true;
 
-    if (0 == rowStr.length())
+    if (0 != hmiName.equalsIgnoreCase("buttonL"))
     {
-        jsonDoc["status"] = STATUS_ID_EPAR;
+        addr    = Rego6xxCtrl::FRONTPANEL_ADDR_LEFT_BUTTON;
+        value   = 1U;
+    }
+    else if (0 != hmiName.equalsIgnoreCase("buttonM"))
+    {
+        addr    = Rego6xxCtrl::FRONTPANEL_ADDR_MIDDLE_BUTTON;
+        value   = 1U;
+    }
+    else if (0 != hmiName.equalsIgnoreCase("buttonR"))
+    {
+        addr    = Rego6xxCtrl::FRONTPANEL_ADDR_RIGHT_BUTTON;
+        value   = 1U;
+    }
+    else if (0 != hmiName.equalsIgnoreCase("wheelTL"))
+    {
+        addr    = Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL;
+        value   = 0x1FFFU;
+    }
+    else if (0 != hmiName.equalsIgnoreCase("wheelTR"))
+    {
+        addr    = Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL;
+        value   = 1U;
     }
     else
     {
-        const Rego6xxDisplayRsp*    displayRsp  = nullptr;
+        isFound = false;
+    }
 
-        if (rowStr == "1")
-        {
-            displayRsp = gRego6xxCtrl.readDisplay(Rego6xxCtrl::DISPLAY_ROW_1);
-        }
-        else if (rowStr == "2")
-        {
-            displayRsp = gRego6xxCtrl.readDisplay(Rego6xxCtrl::DISPLAY_ROW_2);
-        }
-        else if (rowStr == "3")
-        {
-            displayRsp = gRego6xxCtrl.readDisplay(Rego6xxCtrl::DISPLAY_ROW_3);
-        }
-        else if (rowStr == "4")
-        {
-            displayRsp = gRego6xxCtrl.readDisplay(Rego6xxCtrl::DISPLAY_ROW_4);
-        }
-        else
-        {
-            ;
-        }
+    return isFound;
+}
 
-        /* Invalid parameter? */
-        if (nullptr == displayRsp)
-        {
-            jsonDoc["status"] = STATUS_ID_EPAR;
-        }
-        else
-        {
-            /* Wait till response arrived.
-             * Note, the there is already a timeout observation done by the controller.
-             */
-            while(true == displayRsp->isPending())
-            {
-                gRego6xxCtrl.process();
-            }
+/**
+ * Get the display row by its row id, which starts at 1.
+ *
+ * @param[in]   rowId   Row id [1; 4]
+ * @param[out]  row     Display row
+ *
+ * @return If the row id is valid, it will return true otherwise false.
+ */
+static bool getDisplayRow(uint8_t rowId, Rego6xxCtrl::Row& row)
+{
+    bool isValid = true;
 
-            /* Check response, the data and the destination address of the
-             * response message must be valid.
-             * If a timeout happened, the data is valid but the destination
-             * address won't match.
-             */
-            if ((false == displayRsp->isValid()) ||
-                (Rego6xxCtrl::DEV_ADDR_HOST != displayRsp->getDevAddr()))
-            {
-                jsonDoc["status"] = STATUS_ID_EINVALID;
-            }
-            else
-            {
-                jsonData["row"]     = rowStr.toInt();
-                jsonData["display"] = displayRsp->getMsg();
+    switch(rowId)
+    {
+    case 1:
+        row = Rego6xxCtrl::DISPLAY_ROW_1;
+        break;
 
-                jsonDoc["status"] = STATUS_ID_OK;
-            }
+    case 2:
+        row = Rego6xxCtrl::DISPLAY_ROW_2;
+        break;
 
-            gRego6xxCtrl.release();
-        }
-    }
+    case 3:
+        row = Rego6xxCtrl::DISPLAY_ROW_3;
+        break;
 
-    (void)serializeJson(jsonDoc, data);
+    case 4:
+        row = Rego6xxCtrl::DISPLAY_ROW_4;
+        break;
 
-    httpReply.send(data);
+    default:
+        isValid = false;
+        break;
+    }
 
-    return;
+    return isValid;
 }
 
 /**
@@ -1209,4 +4617,96 @@ static const Rego6xxStdRsp* readNextTemperatures(const TemperatureId& lastTemper
     }
 
     return stdRsp;
-}
\ No newline at end of file
+}
+
+/**
+ * Read next front panel LED from heatpump.
+ *
+ * @param[in] lastLed   LED id of last read LED
+ * @param[in] nextLed   LED id of next LED read
+ *
+ * @return Rego6xx boolean response. A nullptr signals that all LEDs were read.
+ */
+static const Rego6xxBoolRsp* readNextLed(const FrontPanelLeds::LedId& lastLed, FrontPanelLeds::LedId& nextLed)
+{
+    const Rego6xxBoolRsp*   boolRsp = nullptr;
+
+    if (FrontPanelLeds::LED_ID_MAX <= lastLed)
+    {
+        nextLed = FrontPanelLeds::LED_ID_POWER;
+    }
+    else
+    {
+        nextLed = static_cast<FrontPanelLeds::LedId>(lastLed + 1);
+    }
+
+    if (FrontPanelLeds::LED_ID_MAX != nextLed)
+    {
+        boolRsp = gRego6xxCtrl.readFrontPanel(FrontPanelLeds::getAddr(nextLed));
+    }
+
+    return boolRsp;
+}
+
+/**
+ * Log the changed front panel LEDs.
+ *
+ * @param[in] changed   Bitmask of the changed LEDs
+ * @param[in] state     Bitmask of the current LED states
+ */
+static void logLedChanges(uint8_t changed, uint8_t state)
+{
+    uint8_t idx = 0U;
+
+    while(FrontPanelLeds::LED_ID_MAX > idx)
+    {
+        if (0U != (changed & (1U << idx)))
+        {
+            String tmp = F("LED ");
+
+            tmp += FrontPanelLeds::getName(static_cast<FrontPanelLeds::LedId>(idx));
+            tmp += (0U != (state & (1U << idx))) ? F(" on") : F(" off");
+            LOG_INFO(tmp.c_str());
+        }
+
+        ++idx;
+    }
+
+    return;
+}
+
+/**
+ * Push the changed front panel LEDs to the event ring buffer.
+ * The alarm LED is reported as alarm event. The LED changes are also
+ * considered in the data generation.
+ *
+ * @param[in] changed   Bitmask of the changed LEDs
+ * @param[in] state     Bitmask of the current LED states
+ */
+static void pushLedEvents(uint8_t changed, uint8_t state)
+{
+    uint8_t idx = 0U;
+
+    setDataChanged();
+
+    while(FrontPanelLeds::LED_ID_MAX > idx)
+    {
+        if (0U != (changed & (1U << idx)))
+        {
+            int16_t value = (0U != (state & (1U << idx))) ? 1 : 0;
+
+            if (FrontPanelLeds::LED_ID_ALARM == idx)
+            {
+                gEventRing.push(EventRing::TYPE_ALARM, idx, value);
+            }
+            else
+            {
+                gEventRing.push(EventRing::TYPE_LED, idx, value);
+            }
+        }
+
+        ++idx;
+    }
+
+    return;
+}
@@ -35,9 +35,29 @@
 #include <unity.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
 
 #include <Temperature.h>
 
+#include "EventRing.h"
+#include "FrontPanelMacro.h"
+#include "HttpRequest.h"
+#include "LineBuffer.h"
+#include "LoopProfiler.h"
+#include "MsgPackWriter.h"
+#include "MqttClient.h"
+#include "SysRegCache.h"
+#include "SerialCapture.h"
+#include "SerialReplay.h"
+#include "Rego6xxCtrl.h"
+#include "Rego6xxSim.h"
+
 /******************************************************************************
  * Macros
  *****************************************************************************/
@@ -46,16 +66,105 @@
  * Types and Classes
  *****************************************************************************/
 
+/**
+ * Stream, which reads a text from memory.
+ */
+class TextStream : public Stream
+{
+public:
+
+    /**
+     * Constructs the stream.
+     *
+     * @param[in] text  Text, which to read.
+     */
+    TextStream(const char* text) :
+        Stream(),
+        m_text(text),
+        m_size(strlen(text)),
+        m_readIdx(0U)
+    {
+    }
+
+    /**
+     * Destroys the stream.
+     */
+    ~TextStream()
+    {
+    }
+
+    int available() override
+    {
+        return static_cast<int>(m_size - m_readIdx);
+    }
+
+    int read() override
+    {
+        int data = -1;
+
+        if (m_size > m_readIdx)
+        {
+            data = static_cast<uint8_t>(m_text[m_readIdx]);
+            ++m_readIdx;
+        }
+
+        return data;
+    }
+
+    int peek() override
+    {
+        return (m_size > m_readIdx) ? static_cast<uint8_t>(m_text[m_readIdx]) : -1;
+    }
+
+    size_t write(uint8_t data) override
+    {
+        (void)data;
+        return 0U;
+    }
+
+private:
+
+    const char* m_text;     /**< Text */
+    size_t      m_size;     /**< Text length in characters */
+    size_t      m_readIdx;  /**< Read index */
+};
+
 /******************************************************************************
  * Prototypes
  *****************************************************************************/
 
 static void testTemperature(void);
+static void testEventRing(void);
+static void testHttpRequest(void);
+static HttpRequest::Status parseHttpRequest(HttpRequest& request, const char* text);
+static void testMsgPackWriter(void);
+static void testMqttClient(void);
+static int openBroker(uint16_t& port);
+static size_t receiveFromClient(int fd, uint8_t* buffer, size_t size);
+static void processMqttClient(MqttClient& client);
+static void onMqttMessage(const char* topic, const char* payload);
+static void testSysRegCache(void);
+static void testRego6xxCtrlTimeout(void);
+static void testRego6xxCtrlWrongDevAddr(void);
+static const Rego6xxStdRsp* waitForRsp(Rego6xxCtrl& ctrl, const Rego6xxStdRsp* rsp, uint32_t& duration);
+static void testFrontPanelMacro(void);
+static uint32_t runMacro(FrontPanelMacro& macro, Rego6xxCtrl& ctrl, bool isAborted);
+static void testLoopProfiler(void);
+static void testSerialCapture(void);
 
 /******************************************************************************
  * Variables
  *****************************************************************************/
 
+/** Number of received MQTT messages. */
+static uint8_t  gMqttMsgCnt         = 0U;
+
+/** Topic of the last received MQTT message. */
+static char     gMqttTopic[32U];
+
+/** Payload of the last received MQTT message. */
+static char     gMqttPayload[32U];
+
 /******************************************************************************
  * External functions
  *****************************************************************************/
@@ -74,6 +183,16 @@ extern int main(int argc, char **argv)
     UNITY_BEGIN();
 
     RUN_TEST(testTemperature);
+    RUN_TEST(testEventRing);
+    RUN_TEST(testHttpRequest);
+    RUN_TEST(testMsgPackWriter);
+    RUN_TEST(testMqttClient);
+    RUN_TEST(testSysRegCache);
+    RUN_TEST(testRego6xxCtrlTimeout);
+    RUN_TEST(testRego6xxCtrlWrongDevAddr);
+    RUN_TEST(testFrontPanelMacro);
+    RUN_TEST(testLoopProfiler);
+    RUN_TEST(testSerialCapture);
 
     return UNITY_END();
 }
@@ -152,4 +271,962 @@ static void testTemperature(void)
 
     TEST_ASSERT_TRUE((TEMPERATURE_2_FLOAT - EPSILON_FLOAT) <= testTemperature.getTemperature());
     TEST_ASSERT_TRUE((TEMPERATURE_2_FLOAT + EPSILON_FLOAT) >= testTemperature.getTemperature());
-}
\ No newline at end of file
+}
+
+/**
+ * Test event ring buffer.
+ */
+static void testEventRing(void)
+{
+    EventRing           ring;
+    EventRing::Event    event;
+    uint16_t            seq     = ring.getNextSeq();
+    uint16_t            idx     = 0U;
+
+    /* Nothing pushed yet. */
+    TEST_ASSERT_FALSE(ring.read(seq, event));
+
+    ring.push(EventRing::TYPE_SENSOR, 1U, 312);
+    ring.push(EventRing::TYPE_LED, 2U, 1);
+
+    TEST_ASSERT_TRUE(ring.read(seq, event));
+    TEST_ASSERT_EQUAL_UINT16(0U, event.seq);
+    TEST_ASSERT_EQUAL_UINT8(EventRing::TYPE_SENSOR, event.type);
+    TEST_ASSERT_EQUAL_UINT8(1U, event.id);
+    TEST_ASSERT_EQUAL_INT16(312, event.value);
+
+    TEST_ASSERT_TRUE(ring.read(seq, event));
+    TEST_ASSERT_EQUAL_UINT16(1U, event.seq);
+    TEST_ASSERT_EQUAL_UINT8(EventRing::TYPE_LED, event.type);
+
+    TEST_ASSERT_FALSE(ring.read(seq, event));
+    TEST_ASSERT_EQUAL_UINT16(2U, seq);
+
+    /* A slow reader continues with the oldest event, which is not overwritten. */
+    while((EventRing::MAX_EVENTS + 2U) > idx)
+    {
+        ring.push(EventRing::TYPE_SENSOR, 0U, static_cast<int16_t>(idx));
+        ++idx;
+    }
+
+    TEST_ASSERT_TRUE(ring.read(seq, event));
+    TEST_ASSERT_EQUAL_UINT16(4U, event.seq);
+    TEST_ASSERT_EQUAL_INT16(2, event.value);
+
+    idx = 1U;
+    while(EventRing::MAX_EVENTS > idx)
+    {
+        TEST_ASSERT_TRUE(ring.read(seq, event));
+        ++idx;
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(11U, event.seq);
+    TEST_ASSERT_FALSE(ring.read(seq, event));
+
+    /* Sequence number wraps around. */
+    while(UINT16_MAX > ring.getNextSeq())
+    {
+        ring.push(EventRing::TYPE_ALARM, 0U, 0);
+    }
+
+    seq = ring.getNextSeq();
+
+    ring.push(EventRing::TYPE_WRITE, 0U, 1);
+    ring.push(EventRing::TYPE_WRITE, 0U, 2);
+
+    TEST_ASSERT_TRUE(ring.read(seq, event));
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, event.seq);
+    TEST_ASSERT_EQUAL_INT16(1, event.value);
+
+    TEST_ASSERT_TRUE(ring.read(seq, event));
+    TEST_ASSERT_EQUAL_UINT16(0U, event.seq);
+    TEST_ASSERT_EQUAL_INT16(2, event.value);
+
+    TEST_ASSERT_FALSE(ring.read(seq, event));
+}
+
+/**
+ * Test http request parser and its limits.
+ */
+static void testHttpRequest(void)
+{
+    HttpRequest request;
+    char        text[HttpRequest::MAX_LINE_LEN + 64U];
+    char        longText[HttpRequest::MAX_LINE_LEN + 1U];
+
+    memset(longText, 'a', HttpRequest::MAX_LINE_LEN);
+    longText[HttpRequest::MAX_LINE_LEN] = '\0';
+
+    /* Request, which is received in two parts. */
+    TEST_ASSERT_EQUAL_INT(HttpRequest::STATUS_PENDING, parseHttpRequest(request, "GET /api/sysreg/0x0209?cnt=4 HTTP/1.1\r\nAccept: application/msgpack\r\n"));
+    TEST_ASSERT_FALSE(request.isEmpty());
+    TEST_ASSERT_EQUAL_INT(HttpRequest::STATUS_COMPLETE, parseHttpRequest(request, "Connection: close\r\n\r\n"));
+    TEST_ASSERT_EQUAL_INT(HttpRequest::METHOD_GET, request.getMethod());
+    TEST_ASSERT_EQUAL_STRING("/api/sysreg/0x0209", request.getUri().c_str());
+    TEST_ASSERT_EQUAL_STRING("0x0209", request.getUriPart(2U).c_str());
+    TEST_ASSERT_EQUAL_STRING("4", request.getQueryParam("cnt").c_str());
+    TEST_ASSERT_TRUE(request.isMsgPackAccepted());
+    TEST_ASSERT_TRUE(request.isHttp11());
+    TEST_ASSERT_FALSE(request.isKeepAlive());
+
+    /* HTTP/1.0 closes the connection by default. */
+    request.clear();
+    TEST_ASSERT_TRUE(request.isEmpty());
+    TEST_ASSERT_EQUAL_INT(HttpRequest::STATUS_COMPLETE, parseHttpRequest(request, "\r\nHEAD / HTTP/1.0\r\n\r\n"));
+    TEST_ASSERT_EQUAL_INT(HttpRequest::METHOD_HEAD, request.getMethod());
+    TEST_ASSERT_FALSE(request.isHttp11());
+    TEST_ASSERT_FALSE(request.isKeepAlive());
+    TEST_ASSERT_FALSE(request.isMsgPackAccepted());
+
+    /* The body is limited by the content length, the rest stays in the stream. */
+    request.clear();
+    TEST_ASSERT_EQUAL_INT(HttpRequest::STATUS_COMPLETE, parseHttpRequest(request, "POST /api/sensors HTTP/1.1\r\nContent-Length: 4\r\n\r\n{\"a\"}GET"));
+    TEST_ASSERT_EQUAL_INT(HttpRequest::METHOD_POST, request.getMethod());
+    TEST_ASSERT_EQUAL_STRING("{\"a\"", request.getBody());
+    TEST_ASSERT_TRUE(request.isKeepAlive());
+
+    /* Request line, which is too long. */
+    request.clear();
+    (void)snprintf(text, sizeof(text), "GET /%s HTTP/1.1\r\n\r\n", longText);
+    TEST_ASSERT_EQUAL_INT(HttpRequest::STATUS_ERROR, parseHttpRequest(request, text));
+    TEST_ASSERT_EQUAL_UINT16(414U, request.getErrorCode());
+
+    /* Header field, which is too long, is skipped. */
+    request.clear();
+    (void)snprintf(text, sizeof(text), "GET / HTTP/1.1\r\nX-Long: %s\r\n\r\n", longText);
+    TEST_ASSERT_EQUAL_INT(HttpRequest::STATUS_COMPLETE, parseHttpRequest(request, text));
+
+    /* Body, which is too large. */
+    request.clear();
+    (void)snprintf(text, sizeof(text), "POST / HTTP/1.1\r\nContent-Length: %u\r\n\r\n", static_cast<unsigned int>(HttpRequest::MAX_BODY_SIZE + 1U));
+    TEST_ASSERT_EQUAL_INT(HttpRequest::STATUS_ERROR, parseHttpRequest(request, text));
+    TEST_ASSERT_EQUAL_UINT16(413U, request.getErrorCode());
+
+    /* Unknown method */
+    request.clear();
+    TEST_ASSERT_EQUAL_INT(HttpRequest::STATUS_ERROR, parseHttpRequest(request, "PATCH / HTTP/1.1\r\n\r\n"));
+    TEST_ASSERT_EQUAL_UINT16(501U, request.getErrorCode());
+
+    /* Malformed request line and header field */
+    request.clear();
+    TEST_ASSERT_EQUAL_INT(HttpRequest::STATUS_ERROR, parseHttpRequest(request, "GET /\r\n\r\n"));
+    TEST_ASSERT_EQUAL_UINT16(400U, request.getErrorCode());
+
+    request.clear();
+    TEST_ASSERT_EQUAL_INT(HttpRequest::STATUS_ERROR, parseHttpRequest(request, "GET index.html HTTP/1.1\r\n\r\n"));
+    TEST_ASSERT_EQUAL_UINT16(400U, request.getErrorCode());
+
+    request.clear();
+    TEST_ASSERT_EQUAL_INT(HttpRequest::STATUS_ERROR, parseHttpRequest(request, "GET / HTTP/1.1\r\nHost\r\n\r\n"));
+    TEST_ASSERT_EQUAL_UINT16(400U, request.getErrorCode());
+}
+
+/**
+ * Parse a http request from a text.
+ *
+ * @param[in] request   Http request
+ * @param[in] text      Text, which contains the request or a part of it.
+ *
+ * @return Parse status
+ */
+static HttpRequest::Status parseHttpRequest(HttpRequest& request, const char* text)
+{
+    TextStream stream(text);
+
+    return request.parse(stream);
+}
+
+/**
+ * Test MessagePack writer type encodings, every one at its format limits.
+ */
+static void testMsgPackWriter(void)
+{
+    char            buffer[64U];
+    LineBuffer      out(buffer, sizeof(buffer));
+    MsgPackWriter   writer(out);
+    char            str[33U];
+
+    const uint8_t   EXPECTED_INTS[]     =
+    {
+        0x00U,                                  /* 0 */
+        0x7fU,                                  /* 127 */
+        0xccU, 0x80U,                           /* 128 */
+        0xccU, 0xffU,                           /* 255 */
+        0xcdU, 0x01U, 0x00U,                    /* 256 */
+        0xcdU, 0xffU, 0xffU,                    /* 65535 */
+        0xceU, 0x00U, 0x01U, 0x00U, 0x00U,      /* 65536 */
+        0xffU,                                  /* -1 */
+        0xe0U,                                  /* -32 */
+        0xd0U, 0xdfU,                           /* -33 */
+        0xd0U, 0x80U,                           /* -128 */
+        0xd1U, 0xffU, 0x7fU,                    /* -129 */
+        0xd1U, 0x80U, 0x00U,                    /* -32768 */
+        0xd2U, 0xffU, 0xffU, 0x7fU, 0xffU       /* -32769 */
+    };
+
+    const uint8_t   EXPECTED_CONTAINERS[] =
+    {
+        0x82U,                                  /* Map with 2 pairs */
+        0xdeU, 0x00U, 0x10U,                    /* Map with 16 pairs */
+        0x90U,                                  /* Empty array */
+        0x9fU,                                  /* Array with 15 elements */
+        0xdcU, 0x01U, 0x00U,                    /* Array with 256 elements */
+        0xc3U,                                  /* true */
+        0xc2U,                                  /* false */
+        0xa0U,                                  /* Empty string */
+        0xa3U, 'g', 't', '1'                    /* String "gt1" */
+    };
+
+    writer.writeUInt(0U);
+    writer.writeUInt(127U);
+    writer.writeUInt(128U);
+    writer.writeUInt(255U);
+    writer.writeUInt(256U);
+    writer.writeUInt(65535U);
+    writer.writeUInt(65536U);
+    writer.writeInt(-1);
+    writer.writeInt(-32);
+    writer.writeInt(-33);
+    writer.writeInt(-128);
+    writer.writeInt(-129);
+    writer.writeInt(-32768);
+    writer.writeInt(-32769);
+
+    TEST_ASSERT_FALSE(out.isOverflow());
+    TEST_ASSERT_EQUAL_UINT32(sizeof(EXPECTED_INTS), out.length());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(EXPECTED_INTS, out.c_str(), sizeof(EXPECTED_INTS));
+
+    out.clear();
+
+    writer.writeMap(2U);
+    writer.writeMap(16U);
+    writer.writeArray(0U);
+    writer.writeArray(15U);
+    writer.writeArray(256U);
+    writer.writeBool(true);
+    writer.writeBool(false);
+    writer.writeString(static_cast<const char*>(nullptr));
+    writer.writeString(F("gt1"));
+
+    TEST_ASSERT_FALSE(out.isOverflow());
+    TEST_ASSERT_EQUAL_UINT32(sizeof(EXPECTED_CONTAINERS), out.length());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(EXPECTED_CONTAINERS, out.c_str(), sizeof(EXPECTED_CONTAINERS));
+
+    /* Strings with 31 and 32 characters, which is the limit of a fixstr. */
+    memset(str, 'x', sizeof(str) - 1U);
+    str[sizeof(str) - 2U] = '\0';
+
+    out.clear();
+    writer.writeString(str);
+    TEST_ASSERT_EQUAL_UINT32(1U + 31U, out.length());
+    TEST_ASSERT_EQUAL_UINT8(0xbfU, static_cast<uint8_t>(out.c_str()[0U]));
+
+    str[sizeof(str) - 2U] = 'x';
+    str[sizeof(str) - 1U] = '\0';
+
+    out.clear();
+    writer.writeString(String(str));
+    TEST_ASSERT_EQUAL_UINT32(2U + 32U, out.length());
+    TEST_ASSERT_EQUAL_UINT8(0xd9U, static_cast<uint8_t>(out.c_str()[0U]));
+    TEST_ASSERT_EQUAL_UINT8(32U, static_cast<uint8_t>(out.c_str()[1U]));
+    TEST_ASSERT_EQUAL_UINT8('x', static_cast<uint8_t>(out.c_str()[2U]));
+}
+
+/**
+ * Test MQTT client packet encoding and decoding, against a broker which
+ * is simulated by a local socket.
+ */
+static void testMqttClient(void)
+{
+    MqttClient      client;
+    uint16_t        port        = 0U;
+    int             listenFd    = openBroker(port);
+    int             fd          = -1;
+    int             flag        = 1;
+    uint8_t         buffer[256U];
+    size_t          size        = 0U;
+    size_t          idx         = 0U;
+
+    const uint8_t   CONNACK[]   = { 0x20U, 0x02U, 0x00U, 0x00U };
+
+    const uint8_t   ONLINE[]    =
+    {
+        0x31U, 0x0fU,                                               /* Retained publish, remaining length */
+        0x00U, 0x07U, 'r', 'e', 'g', 'o', '/', 's', 't',            /* Topic */
+        'o', 'n', 'l', 'i', 'n', 'e'                                /* Payload */
+    };
+
+    const uint8_t   PUBLISH[]   =
+    {
+        0x30U, 0x07U, 0x00U, 0x03U, 'a', '/', 'b', 'o', 'n',        /* QoS 0 */
+        0x31U, 0x07U, 0x00U, 0x03U, 'a', '/', 'c', 'o', 'n',        /* Retained, skipped */
+        0x32U, 0x0aU, 0x00U, 0x03U, 'a', '/', 'd', 0x00U, 0x01U,    /* QoS 1 with packet identifier */
+        'o', 'f', 'f'
+    };
+
+    const uint8_t   MALFORMED[] = { 0x30U, 0xffU, 0xffU, 0xffU, 0xffU };
+
+    TEST_ASSERT_TRUE(0 <= listenFd);
+
+    client.begin(IPAddress(127U, 0U, 0U, 1U), port, "rego", "rego/st", "rego/cmd", onMqttMessage);
+    TEST_ASSERT_TRUE(client.isConnectDue());
+    client.process();
+    TEST_ASSERT_FALSE(client.isConnectDue());
+
+    fd = accept(listenFd, nullptr, nullptr);
+    TEST_ASSERT_TRUE(0 <= fd);
+
+    /* Every packet shall be sent immediately. */
+    (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+    /* Connect packet with protocol name, level, flags and keep alive. */
+    size = receiveFromClient(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(12U <= size);
+    TEST_ASSERT_EQUAL_UINT8(0x10U, buffer[0U]);
+    TEST_ASSERT_EQUAL_UINT8(size - 2U, buffer[1U]);
+    TEST_ASSERT_EQUAL_MEMORY("\x00\x04MQTT\x04\x26\x00\x3c", &buffer[2U], 10U);
+    TEST_ASSERT_FALSE(client.isConnected());
+
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(sizeof(CONNACK)), send(fd, CONNACK, sizeof(CONNACK), 0));
+    processMqttClient(client);
+    TEST_ASSERT_TRUE(client.isConnected());
+
+    /* Online status, followed by the subscription. */
+    size = receiveFromClient(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(sizeof(ONLINE) < size);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ONLINE, buffer, sizeof(ONLINE));
+    TEST_ASSERT_EQUAL_UINT8(0x82U, buffer[sizeof(ONLINE)]);
+
+    /* A packet, which doesn't fit into the receive buffer, is skipped.
+     * Its remaining length of 130 bytes needs 2 bytes.
+     */
+    buffer[0U] = 0x30U;
+    buffer[1U] = 0x82U;
+    buffer[2U] = 0x01U;
+    buffer[3U] = 0x00U;
+    buffer[4U] = 0x01U;
+    memset(&buffer[5U], 'x', 130U - 2U);
+
+    idx = 0U;
+    while(sizeof(PUBLISH) > idx)
+    {
+        buffer[133U + idx] = PUBLISH[idx];
+        ++idx;
+    }
+
+    gMqttMsgCnt = 0U;
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(133U + sizeof(PUBLISH)), send(fd, buffer, 133U + sizeof(PUBLISH), 0));
+    processMqttClient(client);
+
+    TEST_ASSERT_EQUAL_UINT8(2U, gMqttMsgCnt);
+    TEST_ASSERT_EQUAL_STRING("a/d", gMqttTopic);
+    TEST_ASSERT_EQUAL_STRING("off", gMqttPayload);
+    TEST_ASSERT_TRUE(client.isConnected());
+
+    /* A remaining length with more than 4 bytes closes the connection. */
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(sizeof(MALFORMED)), send(fd, MALFORMED, sizeof(MALFORMED), 0));
+    processMqttClient(client);
+    TEST_ASSERT_FALSE(client.isConnected());
+    TEST_ASSERT_FALSE(client.isConnectDue());
+
+    (void)close(fd);
+    (void)close(listenFd);
+}
+
+/**
+ * Open a socket, which simulates the MQTT broker.
+ *
+ * @param[out] port Port, the broker listens on.
+ *
+ * @return Listening socket file descriptor. On failure, it will return -1.
+ */
+static int openBroker(uint16_t& port)
+{
+    int                 fd      = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in  addr;
+    socklen_t           addrLen = sizeof(addr);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family         = AF_INET;
+    addr.sin_addr.s_addr    = htonl(INADDR_LOOPBACK);
+    addr.sin_port           = 0U;
+
+    if ((0 > fd) ||
+        (0 != bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr))) ||
+        (0 != listen(fd, 1)) ||
+        (0 != getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addrLen)))
+    {
+        if (0 <= fd)
+        {
+            (void)close(fd);
+        }
+
+        fd = -1;
+    }
+    else
+    {
+        port = ntohs(addr.sin_port);
+    }
+
+    return fd;
+}
+
+/**
+ * Receive the data, which the MQTT client sent to the broker.
+ *
+ * @param[in]  fd       Socket file descriptor of the broker side.
+ * @param[out] buffer   Receive buffer
+ * @param[in]  size     Receive buffer size in bytes
+ *
+ * @return Number of received bytes
+ */
+static size_t receiveFromClient(int fd, uint8_t* buffer, size_t size)
+{
+    struct pollfd   pfd         = { fd, POLLIN, 0 };
+    ssize_t         received    = 0;
+
+    /* The client sends every packet at once, the first one is waited for. */
+    if (0 < poll(&pfd, 1U, 1000))
+    {
+        usleep(10000U);
+        received = recv(fd, buffer, size, MSG_DONTWAIT);
+    }
+
+    return (0 > received) ? 0U : static_cast<size_t>(received);
+}
+
+/**
+ * Process the MQTT client, until the data of the broker is received.
+ *
+ * @param[in] client    MQTT client
+ */
+static void processMqttClient(MqttClient& client)
+{
+    uint8_t cnt = 0U;
+
+    usleep(10000U);
+
+    while(10U > cnt)
+    {
+        client.process();
+        ++cnt;
+    }
+}
+
+/**
+ * Handle a received MQTT message.
+ *
+ * @param[in] topic     Topic
+ * @param[in] payload   Payload
+ */
+static void onMqttMessage(const char* topic, const char* payload)
+{
+    (void)snprintf(gMqttTopic, sizeof(gMqttTopic), "%s", topic);
+    (void)snprintf(gMqttPayload, sizeof(gMqttPayload), "%s", payload);
+
+    ++gMqttMsgCnt;
+}
+
+/**
+ * Test system register cache aging and eviction.
+ * Note, it waits until the cached values are too old.
+ */
+static void testSysRegCache(void)
+{
+    SysRegCache cache;
+    uint16_t    value   = 0U;
+    uint16_t    addr    = 0U;
+
+    TEST_ASSERT_FALSE(cache.get(0x0209U, value));
+
+    cache.put(0x0209U, 312U);
+    TEST_ASSERT_TRUE(cache.get(0x0209U, value));
+    TEST_ASSERT_EQUAL_UINT16(312U, value);
+
+    /* A value, which is put again, is updated and not cached twice. */
+    cache.put(0x0209U, 313U);
+    TEST_ASSERT_TRUE(cache.get(0x0209U, value));
+    TEST_ASSERT_EQUAL_UINT16(313U, value);
+
+    cache.remove(0x0209U);
+    TEST_ASSERT_FALSE(cache.get(0x0209U, value));
+
+    /* Fill the cache, every entry is older than the next one. */
+    while(SysRegCache::MAX_ENTRIES > addr)
+    {
+        cache.put(addr, addr + 100U);
+        delay(2U);
+        ++addr;
+    }
+
+    /* A removed entry is used again, before the oldest is replaced. */
+    cache.remove(3U);
+    cache.put(addr, addr + 100U);
+    TEST_ASSERT_TRUE(cache.get(0U, value));
+    TEST_ASSERT_FALSE(cache.get(3U, value));
+
+    /* The cache is full, the oldest entry is replaced. */
+    ++addr;
+    cache.put(addr, addr + 100U);
+    TEST_ASSERT_FALSE(cache.get(0U, value));
+    TEST_ASSERT_TRUE(cache.get(1U, value));
+    TEST_ASSERT_EQUAL_UINT16(101U, value);
+    TEST_ASSERT_TRUE(cache.get(addr, value));
+    TEST_ASSERT_EQUAL_UINT16(addr + 100U, value);
+
+    /* The values age. */
+    delay(SysRegCache::MAX_AGE);
+    TEST_ASSERT_FALSE(cache.get(1U, value));
+    TEST_ASSERT_FALSE(cache.get(addr, value));
+}
+
+/**
+ * Test the response timeout, derived from the baudrate, and the release of a
+ * pending response. The simulated heatpump keeps silent on request.
+ */
+static void testRego6xxCtrlTimeout(void)
+{
+    const uint32_t              BAUDRATE    = 19200U;
+    Rego6xxSim                  sim;
+    Rego6xxCtrl                 ctrl(sim);
+    const Rego6xxStdRsp*        rsp         = nullptr;
+    uint32_t                    duration    = 0U;
+    Rego6xxCtrl::Statistics     statistics;
+
+    sim.setBaudrate(BAUDRATE);
+    sim.setFaultProbability(Rego6xxSim::FAULT_SILENCE, 100U);
+    ctrl.setBaudrate(BAUDRATE);
+
+    /* The controller is busy, as long as a response is pending. */
+    rsp = ctrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+    TEST_ASSERT_NOT_NULL(rsp);
+    TEST_ASSERT_NULL(ctrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1));
+
+    /* A missing response times out after the min. response timeout, not after the default one. */
+    rsp = waitForRsp(ctrl, rsp, duration);
+    TEST_ASSERT_FALSE(rsp->isPending());
+    TEST_ASSERT_TRUE(rsp->isTimeout());
+    TEST_ASSERT_TRUE(100U <= duration);
+    TEST_ASSERT_TRUE(150U > duration);
+
+    statistics = ctrl.getStatistics();
+    TEST_ASSERT_EQUAL_UINT32(1U, statistics.transactions);
+    TEST_ASSERT_EQUAL_UINT32(1U, statistics.timeouts);
+
+    ctrl.release();
+    TEST_ASSERT_FALSE(ctrl.isPending());
+
+    /* A released pending response frees the controller at once. */
+    rsp = ctrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+    TEST_ASSERT_NOT_NULL(rsp);
+    TEST_ASSERT_TRUE(rsp->isPending());
+    ctrl.release();
+    TEST_ASSERT_FALSE(ctrl.isPending());
+
+    /* The next request gets its response. */
+    sim.setFaultProbability(Rego6xxSim::FAULT_SILENCE, 0U);
+    rsp = ctrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+    TEST_ASSERT_NOT_NULL(rsp);
+
+    rsp = waitForRsp(ctrl, rsp, duration);
+    TEST_ASSERT_FALSE(rsp->isTimeout());
+    TEST_ASSERT_TRUE(rsp->isValid());
+
+    statistics = ctrl.getStatistics();
+    TEST_ASSERT_EQUAL_UINT32(3U, statistics.transactions);
+    TEST_ASSERT_EQUAL_UINT32(1U, statistics.timeouts);
+
+    ctrl.release();
+}
+
+/**
+ * Test the rejection of a response with a wrong device address, which is
+ * otherwise complete and has a valid checksum.
+ */
+static void testRego6xxCtrlWrongDevAddr(void)
+{
+    Rego6xxSim                  sim;
+    Rego6xxCtrl                 ctrl(sim);
+    const Rego6xxStdRsp*        rsp         = nullptr;
+    uint32_t                    duration    = 0U;
+    Rego6xxCtrl::Statistics     statistics;
+
+    sim.setFaultProbability(Rego6xxSim::FAULT_WRONG_DEV_ADDR, 100U);
+
+    rsp = ctrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+    TEST_ASSERT_NOT_NULL(rsp);
+
+    rsp = waitForRsp(ctrl, rsp, duration);
+    TEST_ASSERT_EQUAL(Rego6xxSim::FAULT_WRONG_DEV_ADDR, sim.getLastFault());
+    TEST_ASSERT_FALSE(rsp->isPending());
+    TEST_ASSERT_FALSE(rsp->isTimeout());
+    TEST_ASSERT_TRUE(rsp->isRejected());
+    TEST_ASSERT_FALSE(rsp->isValid());
+
+    /* It is counted as wrong device address only. */
+    {
+        const Rego6xxCtrl::CmdStatistics& cmdStatistics = ctrl.getCmdStatistics(Rego6xxCtrl::CMD_STATS_ID_READ_SYSTEM_REG);
+
+        TEST_ASSERT_EQUAL_UINT32(1U, cmdStatistics.issued);
+        TEST_ASSERT_EQUAL_UINT32(1U, cmdStatistics.wrongDevAddrs);
+        TEST_ASSERT_EQUAL_UINT32(0U, cmdStatistics.checksumErrors);
+        TEST_ASSERT_EQUAL_UINT32(0U, cmdStatistics.timeouts);
+    }
+
+    statistics = ctrl.getStatistics();
+    TEST_ASSERT_EQUAL_UINT32(0U, statistics.checksumErrors);
+    TEST_ASSERT_EQUAL_UINT32(0U, statistics.timeouts);
+
+    ctrl.release();
+
+    /* The next response with the host address is accepted again. */
+    sim.setFaultProbability(Rego6xxSim::FAULT_WRONG_DEV_ADDR, 0U);
+    rsp = ctrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+    TEST_ASSERT_NOT_NULL(rsp);
+
+    rsp = waitForRsp(ctrl, rsp, duration);
+    TEST_ASSERT_FALSE(rsp->isRejected());
+    TEST_ASSERT_TRUE(rsp->isValid());
+    TEST_ASSERT_EQUAL_UINT32(1U, ctrl.getCmdStatistics(Rego6xxCtrl::CMD_STATS_ID_READ_SYSTEM_REG).wrongDevAddrs);
+
+    ctrl.release();
+}
+
+/**
+ * Process the controller, until the response is not pending anymore, but at
+ * most for 1 s.
+ *
+ * @param[in]   ctrl        Rego6xx controller
+ * @param[in]   rsp         Pending response
+ * @param[out]  duration    Duration in ms until the response was complete.
+ *
+ * @return Response
+ */
+static const Rego6xxStdRsp* waitForRsp(Rego6xxCtrl& ctrl, const Rego6xxStdRsp* rsp, uint32_t& duration)
+{
+    const uint32_t  MAX_WAIT    = 1000U;
+    uint32_t        begin       = millis();
+
+    while((true == rsp->isPending()) &&
+          (MAX_WAIT > (millis() - begin)))
+    {
+        ctrl.process();
+        delay(1U);
+    }
+
+    duration = millis() - begin;
+
+    return rsp;
+}
+
+/**
+ * Test the front panel macro against the simulated heatpump, which shows
+ * the title of the current menu page in the 2nd display row. The wheel
+ * selects the next page, the left button returns to the first page.
+ */
+static void testFrontPanelMacro(void)
+{
+    const uint16_t      WHEEL_RIGHT = 1U;
+    Rego6xxSim          sim;
+    Rego6xxCtrl         ctrl(sim);
+    FrontPanelMacro     macro(ctrl);
+    uint8_t             idx         = 0U;
+    uint32_t            duration    = 0U;
+
+    /* Invalid macros */
+    TEST_ASSERT_FALSE(macro.start(FrontPanelMacro::STEP_TIMEOUT));
+    TEST_ASSERT_FALSE(macro.addStep(Rego6xxCtrl::DISPLAY_ROW_2, "123456789012345678901", Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, WHEEL_RIGHT));
+    TEST_ASSERT_FALSE(macro.addStep(Rego6xxCtrl::DISPLAY_ROW_2, nullptr, Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, WHEEL_RIGHT));
+
+    while(FrontPanelMacro::MAX_STEPS > idx)
+    {
+        TEST_ASSERT_TRUE(macro.addStep(Rego6xxCtrl::DISPLAY_ROW_2, "", Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, WHEEL_RIGHT));
+        ++idx;
+    }
+
+    TEST_ASSERT_FALSE(macro.addStep(Rego6xxCtrl::DISPLAY_ROW_2, "", Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, WHEEL_RIGHT));
+    TEST_ASSERT_TRUE(macro.clear());
+
+    /* Every step waits for its page, before the wheel is turned. */
+    TEST_ASSERT_TRUE(macro.addStep(Rego6xxCtrl::DISPLAY_ROW_2, "GT1 Radiator", Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, WHEEL_RIGHT));
+    TEST_ASSERT_TRUE(macro.addStep(Rego6xxCtrl::DISPLAY_ROW_2, "GT? Outdoor", Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, WHEEL_RIGHT));
+    TEST_ASSERT_TRUE(macro.start(FrontPanelMacro::STEP_TIMEOUT));
+    TEST_ASSERT_TRUE(macro.isRunning());
+    TEST_ASSERT_FALSE(macro.clear());
+
+    (void)runMacro(macro, ctrl, false);
+    TEST_ASSERT_EQUAL(FrontPanelMacro::RESULT_OK, macro.getResult());
+    TEST_ASSERT_EQUAL_UINT8(1U, macro.getStepIdx());
+    TEST_ASSERT_EQUAL_STRING("GT2 Outdoor", macro.getLastMsg().c_str());
+
+    /* The root menu is reached with the left button, before the first step. */
+    TEST_ASSERT_TRUE(macro.clear());
+    TEST_ASSERT_TRUE(macro.setRoot(Rego6xxCtrl::DISPLAY_ROW_2, "GT1 Radiator"));
+    TEST_ASSERT_TRUE(macro.addStep(Rego6xxCtrl::DISPLAY_ROW_2, "GT1 Radiator", Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, WHEEL_RIGHT));
+    TEST_ASSERT_TRUE(macro.start(FrontPanelMacro::STEP_TIMEOUT));
+
+    (void)runMacro(macro, ctrl, false);
+    TEST_ASSERT_EQUAL(FrontPanelMacro::RESULT_OK, macro.getResult());
+
+    /* A page, which isn't shown within the step timeout, fails the macro.
+     * Afterwards it returns to the root menu.
+     */
+    TEST_ASSERT_TRUE(macro.clear());
+    TEST_ASSERT_TRUE(macro.setRoot(Rego6xxCtrl::DISPLAY_ROW_2, "GT1 Radiator"));
+    TEST_ASSERT_TRUE(macro.addStep(Rego6xxCtrl::DISPLAY_ROW_2, "GT1 Radiator", Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, WHEEL_RIGHT));
+    TEST_ASSERT_TRUE(macro.addStep(Rego6xxCtrl::DISPLAY_ROW_2, "Heat curve", Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, WHEEL_RIGHT));
+    TEST_ASSERT_TRUE(macro.start(FrontPanelMacro::MIN_STEP_TIMEOUT));
+
+    (void)runMacro(macro, ctrl, false);
+    TEST_ASSERT_EQUAL(FrontPanelMacro::RESULT_EMISMATCH, macro.getResult());
+    TEST_ASSERT_EQUAL_UINT8(1U, macro.getStepIdx());
+    TEST_ASSERT_EQUAL_STRING("GT1 Radiator return", macro.getLastMsg().c_str());
+
+    /* An aborted macro finishes long before its step timeout. */
+    TEST_ASSERT_TRUE(macro.clear());
+    TEST_ASSERT_TRUE(macro.addStep(Rego6xxCtrl::DISPLAY_ROW_2, "Heat curve", Rego6xxCtrl::FRONTPANEL_ADDR_WHEEL, WHEEL_RIGHT));
+    TEST_ASSERT_TRUE(macro.start(FrontPanelMacro::MAX_STEP_TIMEOUT));
+
+    duration = runMacro(macro, ctrl, true);
+    TEST_ASSERT_EQUAL(FrontPanelMacro::RESULT_EABORTED, macro.getResult());
+    TEST_ASSERT_TRUE(FrontPanelMacro::MIN_STEP_TIMEOUT > duration);
+}
+
+/**
+ * Process the macro and the controller, until the macro is not running
+ * anymore, but at most for 15 s.
+ *
+ * @param[in] macro     Front panel macro
+ * @param[in] ctrl      Rego6xx controller
+ * @param[in] isAborted Abort the macro after its first heatpump request?
+ *
+ * @return Duration in ms until the macro finished.
+ */
+static uint32_t runMacro(FrontPanelMacro& macro, Rego6xxCtrl& ctrl, bool isAborted)
+{
+    const uint32_t  MAX_WAIT    = (15UL * 1000UL);
+    uint32_t        begin       = millis();
+
+    while((true == macro.isRunning()) &&
+          (MAX_WAIT > (millis() - begin)))
+    {
+        macro.process();
+        ctrl.process();
+
+        if ((true == isAborted) &&
+            (true == ctrl.isPending()))
+        {
+            macro.abort();
+        }
+
+        delay(1U);
+    }
+
+    return millis() - begin;
+}
+
+/**
+ * Test the main loop profiler: the histogram buckets, the stall with its
+ * cause and the reset.
+ */
+static void testLoopProfiler(void)
+{
+    LoopProfiler    profiler;
+
+#if defined(LOOP_HISTOGRAM)
+    uint8_t         bucket      = 0U;
+    uint32_t        count       = 0U;
+
+    /* A duration, which is equal to the bound of a bucket, belongs to it. */
+    TEST_ASSERT_EQUAL_UINT8(0U, LoopProfiler::getBucket(0U));
+
+    while((LoopProfiler::NUM_BUCKETS - 1U) > bucket)
+    {
+        TEST_ASSERT_EQUAL_UINT8(bucket, LoopProfiler::getBucket(LoopProfiler::getBucketBound(bucket)));
+        TEST_ASSERT_EQUAL_UINT8(bucket + 1U, LoopProfiler::getBucket(LoopProfiler::getBucketBound(bucket) + 1U));
+        ++bucket;
+    }
+
+    /* The last bucket has no upper bound. */
+    TEST_ASSERT_EQUAL_UINT8(LoopProfiler::NUM_BUCKETS - 1U, LoopProfiler::getBucket(UINT32_MAX));
+#endif  /* defined(LOOP_HISTOGRAM) */
+
+    TEST_ASSERT_EQUAL_UINT32(0U, profiler.getIterations());
+    TEST_ASSERT_EQUAL_UINT8(LoopProfiler::NO_PHASE, profiler.getStallPhase());
+
+    /* The longest phase is the cause of the stall, refined by its longest section. */
+    profiler.beginIteration();
+    profiler.enterPhase(0U);
+    profiler.enterPhase(1U);
+    profiler.setCause("GET /a\"b\\c\td0123456789", 100U);
+    profiler.setCause("GET /short", 50U);
+    delay(2U);
+    profiler.enterPhase(2U);
+    profiler.endIteration();
+
+    TEST_ASSERT_EQUAL_UINT32(1U, profiler.getIterations());
+    TEST_ASSERT_TRUE(2000U <= profiler.getDurationMax());
+    TEST_ASSERT_TRUE(2000U <= profiler.getPhaseMax(1U));
+    TEST_ASSERT_EQUAL_UINT32(profiler.getDurationMax(), profiler.getStallDuration());
+    TEST_ASSERT_EQUAL_UINT8(1U, profiler.getStallPhase());
+    TEST_ASSERT_EQUAL_STRING("GET /a?b?c?d0123", profiler.getStallCause());
+
+    /* A shorter iteration doesn't replace the stall. */
+    profiler.beginIteration();
+    profiler.enterPhase(0U);
+    profiler.setCause("GET /", 10U);
+    profiler.endIteration();
+
+    TEST_ASSERT_EQUAL_UINT32(2U, profiler.getIterations());
+    TEST_ASSERT_EQUAL_UINT8(1U, profiler.getStallPhase());
+    TEST_ASSERT_EQUAL_STRING("GET /a?b?c?d0123", profiler.getStallCause());
+
+#if defined(LOOP_HISTOGRAM)
+    bucket = 0U;
+
+    while(LoopProfiler::NUM_BUCKETS > bucket)
+    {
+        count += profiler.getBucketCount(bucket);
+        ++bucket;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(2U, count);
+#endif  /* defined(LOOP_HISTOGRAM) */
+
+    /* The reset clears all measurements. */
+    profiler.reset();
+
+    TEST_ASSERT_EQUAL_UINT32(0U, profiler.getIterations());
+    TEST_ASSERT_EQUAL_UINT32(0U, profiler.getStallDuration());
+    TEST_ASSERT_EQUAL_UINT8(LoopProfiler::NO_PHASE, profiler.getStallPhase());
+    TEST_ASSERT_EQUAL_STRING("", profiler.getStallCause());
+}
+
+/**
+ * Test the capture of a heatpump transaction, its export and the replay
+ * of the exported trace, which stands in for the heatpump.
+ */
+static void testSerialCapture(void)
+{
+    const uint32_t          BAUDRATE        = 19200U;
+    const uint16_t          MAX_ENTRIES     = 16U;
+    const uint16_t          CMD_SIZE        = 9U;
+    const uint16_t          NUM_ENTRIES     = CMD_SIZE + 5U;    /* Command and standard response */
+    const uint16_t          MAX_RING        = 8U;
+    Rego6xxSim              sim;
+    SerialCapture::Entry    entries[MAX_ENTRIES];
+    SerialCapture           capture(sim, entries, MAX_ENTRIES);
+    SerialCapture::Entry    ring[MAX_RING];
+    SerialCapture           ringCapture(sim, ring, MAX_RING);
+    SerialCapture::Entry    entry;
+    SerialReplay            replay;
+    char                    trace[SerialCapture::HEADER_SIZE + (MAX_ENTRIES * SerialCapture::ENTRY_SIZE) + 1U];
+    LineBuffer              out(trace, sizeof(trace));
+    const Rego6xxStdRsp*    rsp             = nullptr;
+    uint16_t                value           = 0U;
+    uint16_t                seq             = 0U;
+    uint32_t                duration        = 0U;
+
+    sim.setBaudrate(BAUDRATE);
+
+    /* Capture a single transaction. */
+    {
+        Rego6xxCtrl ctrl(capture);
+
+        ctrl.setBaudrate(BAUDRATE);
+        rsp = ctrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+        TEST_ASSERT_NOT_NULL(rsp);
+
+        rsp = waitForRsp(ctrl, rsp, duration);
+        TEST_ASSERT_TRUE(rsp->isValid());
+        value = rsp->getValue();
+
+        ctrl.release();
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(NUM_ENTRIES, capture.getCount());
+    TEST_ASSERT_EQUAL_UINT16(NUM_ENTRIES, capture.getNextSeq());
+    TEST_ASSERT_FALSE(capture.getEntry(NUM_ENTRIES, entry));
+
+    /* The first entry is the transmitted device address, without predecessor. */
+    TEST_ASSERT_TRUE(capture.getEntry(0U, entry));
+    TEST_ASSERT_EQUAL_UINT8(0U, entry.flags & SerialCapture::FLAG_RX);
+    TEST_ASSERT_EQUAL_UINT8(Rego6xxCtrl::DEV_ADDR_HEATPUMP, entry.data);
+    TEST_ASSERT_EQUAL_UINT32(0U, SerialCapture::getDelta(entry));
+
+    /* The response follows after the transmission of the command. */
+    TEST_ASSERT_TRUE(capture.getEntry(CMD_SIZE, entry));
+    TEST_ASSERT_EQUAL_UINT8(SerialCapture::FLAG_RX, entry.flags & SerialCapture::FLAG_RX);
+    TEST_ASSERT_EQUAL_UINT8(Rego6xxCtrl::DEV_ADDR_HOST, entry.data);
+    TEST_ASSERT_TRUE(0U < SerialCapture::getDelta(entry));
+
+    /* Export the trace. */
+    SerialCapture::writeHeader(out, capture.getCount());
+
+    while(capture.getNextSeq() != seq)
+    {
+        TEST_ASSERT_TRUE(capture.getEntry(seq, entry));
+        SerialCapture::writeEntry(out, entry);
+        ++seq;
+    }
+
+    TEST_ASSERT_FALSE(out.isOverflow());
+    TEST_ASSERT_EQUAL(SerialCapture::HEADER_SIZE + (NUM_ENTRIES * SerialCapture::ENTRY_SIZE), out.length());
+
+    /* A truncated trace is rejected. */
+    TEST_ASSERT_FALSE(replay.load(reinterpret_cast<const uint8_t*>(trace), out.length() - 1U));
+    TEST_ASSERT_TRUE(replay.load(reinterpret_cast<const uint8_t*>(trace), out.length()));
+
+    /* The replay answers the same command like the heatpump. */
+    {
+        Rego6xxCtrl ctrl(replay);
+
+        ctrl.setBaudrate(BAUDRATE);
+        rsp = ctrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+        TEST_ASSERT_NOT_NULL(rsp);
+
+        rsp = waitForRsp(ctrl, rsp, duration);
+        TEST_ASSERT_TRUE(rsp->isValid());
+        TEST_ASSERT_EQUAL_UINT16(value, rsp->getValue());
+        TEST_ASSERT_EQUAL_UINT16(0U, replay.getMismatches());
+        TEST_ASSERT_TRUE(replay.isFinished());
+
+        ctrl.release();
+    }
+
+    /* A different command is counted as mismatch. */
+    TEST_ASSERT_TRUE(replay.load(reinterpret_cast<const uint8_t*>(trace), out.length()));
+
+    {
+        Rego6xxCtrl ctrl(replay);
+
+        ctrl.setBaudrate(BAUDRATE);
+        rsp = ctrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT2);
+        TEST_ASSERT_NOT_NULL(rsp);
+
+        (void)waitForRsp(ctrl, rsp, duration);
+        TEST_ASSERT_TRUE(0U < replay.getMismatches());
+
+        ctrl.release();
+    }
+
+    /* If the ring buffer is full, the oldest entries are overwritten. */
+    {
+        Rego6xxCtrl ctrl(ringCapture);
+
+        ctrl.setBaudrate(BAUDRATE);
+        rsp = ctrl.readSysReg(Rego6xxCtrl::SYSREG_ADDR_GT1);
+        TEST_ASSERT_NOT_NULL(rsp);
+
+        (void)waitForRsp(ctrl, rsp, duration);
+
+        ctrl.release();
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(MAX_RING, ringCapture.getCount());
+    TEST_ASSERT_EQUAL_UINT16(NUM_ENTRIES, ringCapture.getNextSeq());
+    TEST_ASSERT_FALSE(ringCapture.getEntry(NUM_ENTRIES - MAX_RING - 1U, entry));
+    TEST_ASSERT_TRUE(ringCapture.getEntry(NUM_ENTRIES - MAX_RING, entry));
+    TEST_ASSERT_TRUE(ringCapture.getEntry(NUM_ENTRIES - 1U, entry));
+    TEST_ASSERT_EQUAL_UINT8(SerialCapture::FLAG_RX, entry.flags & SerialCapture::FLAG_RX);
+}